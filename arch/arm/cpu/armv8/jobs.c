@@ -0,0 +1,162 @@
+/*
+ * Secondary CPUs for jobs, started through PSCI
+ *
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <jobs.h>
+#include <malloc.h>
+#include <asm/psci.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#ifndef CONFIG_JOB_STACK_SIZE
+#define CONFIG_JOB_STACK_SIZE	(16 << 10)
+#endif
+
+#define MPIDR_AFFINITY_MASK	0xff00ffffffULL
+#define JOB_CPU_OFF_TIMEOUT_MS	100
+
+/* What armv8_job_cpu_entry needs, at the offsets it expects */
+struct armv8_job_cpu {
+	ulong sp;
+	gd_t *gd;
+	struct job_cpu *cpu;
+	void *stack;
+};
+
+void armv8_job_cpu_entry(void);
+
+/* CPUs other than the boot CPU */
+static u64 cpu_mpidrs[JOB_MAX_CPUS - 1];
+
+static u64 mpidr_affinity(void)
+{
+	u64 mpidr;
+
+	asm volatile("mrs %0, mpidr_el1" : "=r" (mpidr));
+
+	return mpidr & MPIDR_AFFINITY_MASK;
+}
+
+static long psci_call(ulong fn, ulong arg0, ulong arg1, ulong arg2)
+{
+	register ulong x0 asm("x0") = fn;
+	register ulong x1 asm("x1") = arg0;
+	register ulong x2 asm("x2") = arg1;
+	register ulong x3 asm("x3") = arg2;
+
+	asm volatile("smc #0"
+		     : "+r" (x0), "+r" (x1), "+r" (x2), "+r" (x3)
+		     :
+		     : "x4", "x5", "x6", "x7", "x8", "x9", "x10", "x11",
+		       "x12", "x13", "x14", "x15", "x16", "x17", "memory");
+
+	return x0;
+}
+
+__weak int psci_job_cpus(const u64 **mpidrp)
+{
+	return 0;
+}
+
+int arch_job_cpus(void)
+{
+	const u64 *mpidrs;
+	u64 self = mpidr_affinity();
+	int i, count = 0;
+	int nr;
+
+	/*
+	 * Secondary CPUs run with the MMU and caches off, so they would not
+	 * see what the boot CPU has in its data cache
+	 */
+	if (dcache_status())
+		return 0;
+
+	nr = psci_job_cpus(&mpidrs);
+	for (i = 0; i < nr && count < ARRAY_SIZE(cpu_mpidrs); i++) {
+		if ((mpidrs[i] & MPIDR_AFFINITY_MASK) != self)
+			cpu_mpidrs[count++] = mpidrs[i] & MPIDR_AFFINITY_MASK;
+	}
+
+	return count;
+}
+
+int arch_job_cpu_start(struct job_cpu *cpu)
+{
+	struct armv8_job_cpu *priv;
+	long ret;
+
+	priv = calloc(1, sizeof(*priv));
+	if (!priv)
+		return -ENOMEM;
+	priv->stack = memalign(16, CONFIG_JOB_STACK_SIZE);
+	if (!priv->stack) {
+		free(priv);
+		return -ENOMEM;
+	}
+	priv->sp = (ulong)priv->stack + CONFIG_JOB_STACK_SIZE;
+	priv->gd = (gd_t *)gd;
+	priv->cpu = cpu;
+	cpu->priv = priv;
+	cpu->id = cpu_mpidrs[cpu->index - 1];
+
+	ret = psci_call(ARM_PSCI_0_2_FN64_CPU_ON, cpu->id,
+			(ulong)armv8_job_cpu_entry, (ulong)priv);
+	if (ret != ARM_PSCI_RET_SUCCESS) {
+		debug("%s: CPU %lx: PSCI error %ld\n", __func__, cpu->id, ret);
+		cpu->priv = NULL;
+		free(priv->stack);
+		free(priv);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Called from armv8_job_cpu_entry on the new CPU's stack */
+void armv8_job_cpu_run(struct job_cpu *cpu)
+{
+	job_cpu_main(cpu);
+	arch_job_cpu_stop(cpu);
+}
+
+void arch_job_cpu_stop(struct job_cpu *cpu)
+{
+	psci_call(ARM_PSCI_0_2_FN_CPU_OFF, 0, 0, 0);
+}
+
+int arch_job_cpu_wait_off(struct job_cpu *cpu)
+{
+	struct armv8_job_cpu *priv = cpu->priv;
+	ulong start = get_timer(0);
+
+	while (psci_call(ARM_PSCI_0_2_FN64_AFFINITY_INFO, cpu->id, 0, 0) !=
+	       ARM_PSCI_AFFINITY_OFF) {
+		if (get_timer(start) > JOB_CPU_OFF_TIMEOUT_MS)
+			return -ETIMEDOUT;
+	}
+
+	/* Nothing runs on the stack now */
+	cpu->priv = NULL;
+	free(priv->stack);
+	free(priv);
+
+	return 0;
+}
+
+ulong arch_job_cpu_id(void)
+{
+	return mpidr_affinity();
+}
+
+void arch_job_idle(void)
+{
+	/* Poll the timer, not memory, and leave the watchdog alone */
+	__udelay(1);
+}
@@ -8,6 +8,7 @@
  */
 #include <common.h>
 #include <asm/io.h>
+#include <asm/psci.h>
 
 #define PRR 0xFF000044
 
@@ -37,3 +38,18 @@ u32 rcar_get_cpu_rev_fraction(void)
 
 	return (u32)(product & 0x0000000F);
 }
+
+#ifdef CONFIG_JOBS
+/* Four Cortex-A57 cores in cluster 0, four Cortex-A53 cores in cluster 1 */
+static const u64 r8a7795_mpidrs[] = {
+	0x000, 0x001, 0x002, 0x003,
+	0x100, 0x101, 0x102, 0x103,
+};
+
+int psci_job_cpus(const u64 **mpidrp)
+{
+	*mpidrp = r8a7795_mpidrs;
+
+	return ARRAY_SIZE(r8a7795_mpidrs);
+}
+#endif
@@ -27,13 +27,41 @@
 #define ARM_PSCI_FN_CPU_ON		ARM_PSCI_FN(2)
 #define ARM_PSCI_FN_MIGRATE		ARM_PSCI_FN(3)
 
+/* PSCI 0.2 interface, as ARM Trusted Firmware provides it */
+#define ARM_PSCI_0_2_FN_BASE		0x84000000
+#define ARM_PSCI_0_2_FN(n)		(ARM_PSCI_0_2_FN_BASE + (n))
+#define ARM_PSCI_0_2_FN64_BASE		0xc4000000
+#define ARM_PSCI_0_2_FN64(n)		(ARM_PSCI_0_2_FN64_BASE + (n))
+
+#define ARM_PSCI_0_2_FN_CPU_OFF		ARM_PSCI_0_2_FN(2)
+#define ARM_PSCI_0_2_FN64_CPU_ON	ARM_PSCI_0_2_FN64(3)
+#define ARM_PSCI_0_2_FN64_AFFINITY_INFO	ARM_PSCI_0_2_FN64(4)
+
 #define ARM_PSCI_RET_SUCCESS		0
 #define ARM_PSCI_RET_NI			(-1)
 #define ARM_PSCI_RET_INVAL		(-2)
 #define ARM_PSCI_RET_DENIED		(-3)
+#define ARM_PSCI_RET_ALREADY_ON		(-4)
+#define ARM_PSCI_RET_ON_PENDING		(-5)
+
+/* AFFINITY_INFO results */
+#define ARM_PSCI_AFFINITY_ON		0
+#define ARM_PSCI_AFFINITY_OFF		1
+#define ARM_PSCI_AFFINITY_ON_PENDING	2
 
 #ifndef __ASSEMBLY__
 int psci_update_dt(void *fdt);
+
+/**
+ * psci_job_cpus() - List the CPUs which firmware can start for jobs
+ *
+ * SoCs provide this for CONFIG_JOBS; by default no CPUs are listed. The list
+ * may include the boot CPU, which is left out.
+ *
+ * @mpidrp:	Returns the MPIDR affinity fields of each CPU
+ * @return number of CPUs in the list
+ */
+int psci_job_cpus(const u64 **mpidrp);
 #endif /* ! __ASSEMBLY__ */
 
 #endif /* __ARM_PSCI_H__ */
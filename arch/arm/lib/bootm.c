@@ -15,6 +15,7 @@
 #include <common.h>
 #include <command.h>
 #include <image.h>
+#include <jobs.h>
 #include <u-boot/zlib.h>
 #include <asm/byteorder.h>
 #include <libfdt.h>
@@ -79,6 +80,9 @@ static void announce_and_cleanup(int fake)
 #ifdef CONFIG_BOOTSTAGE_REPORT
 	bootstage_report();
 #endif
+	/* The OS starts the secondary CPUs itself */
+	jobs_stop();
+	console_flush();
 
 #ifdef CONFIG_USB_DEVICE
 	udc_disconnect();
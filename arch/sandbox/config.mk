@@ -3,7 +3,10 @@
 
 PLATFORM_CPPFLAGS += -D__SANDBOX__ -U_FORTIFY_SOURCE
 PLATFORM_CPPFLAGS += -DCONFIG_ARCH_MAP_SYSMEM
-PLATFORM_LIBS += -lrt
+PLATFORM_LIBS += -lrt -lpthread
+
+# Let the linker drop code that is never called, as other archs do
+PLATFORM_RELFLAGS += -ffunction-sections -fdata-sections
 
 # Define this to avoid linking with SDL, which requires SDL libraries
 # This can solve 'sdl-config: Command not found' errors
@@ -16,7 +19,7 @@ PLATFORM_CPPFLAGS += $(shell sdl-config --cflags)
 endif
 endif
 
-cmd_u-boot__ = $(CC) -o $@ -T u-boot.lds \
+cmd_u-boot__ = $(CC) -o $@ -T u-boot.lds -Wl,--gc-sections \
 	-Wl,--start-group $(u-boot-main) -Wl,--end-group \
 	$(PLATFORM_LIBS) -Wl,-Map -Wl,u-boot.map
 
@@ -12,6 +12,7 @@ DECLARE_GLOBAL_DATA_PTR;
 
 void reset_cpu(ulong ignored)
 {
+	console_flush_fatal();
 	if (state_uninit())
 		os_exit(2);
 
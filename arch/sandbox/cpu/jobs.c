@@ -0,0 +1,55 @@
+/*
+ * Host threads standing in for secondary CPUs
+ *
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <jobs.h>
+#include <os.h>
+
+#define SANDBOX_JOB_CPUS	3
+
+int arch_job_cpus(void)
+{
+	return SANDBOX_JOB_CPUS;
+}
+
+static void sandbox_job_cpu(void *arg)
+{
+	struct job_cpu *cpu = arg;
+
+	job_cpu_main(cpu);
+	arch_job_cpu_stop(cpu);
+}
+
+int arch_job_cpu_start(struct job_cpu *cpu)
+{
+	if (os_thread_start(sandbox_job_cpu, cpu, &cpu->id))
+		return -EAGAIN;
+
+	return 0;
+}
+
+void arch_job_cpu_stop(struct job_cpu *cpu)
+{
+	/* The thread ends when it returns */
+}
+
+int arch_job_cpu_wait_off(struct job_cpu *cpu)
+{
+	return os_thread_join(cpu->id) ? -ETIMEDOUT : 0;
+}
+
+ulong arch_job_cpu_id(void)
+{
+	return os_thread_self();
+}
+
+void arch_job_idle(void)
+{
+	os_usleep(10);
+}
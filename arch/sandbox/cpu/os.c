@@ -7,6 +7,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -203,6 +204,50 @@ uint64_t __attribute__((no_instrument_function)) os_get_nsec(void)
 #endif
 }
 
+struct os_thread {
+	void (*func)(void *arg);
+	void *arg;
+};
+
+static void *os_thread_run(void *data)
+{
+	struct os_thread thread = *(struct os_thread *)data;
+
+	os_free(data);
+	thread.func(thread.arg);
+
+	return NULL;
+}
+
+int os_thread_start(void (*func)(void *arg), void *arg, ulong *idp)
+{
+	struct os_thread *thread;
+	pthread_t id;
+
+	thread = os_malloc(sizeof(*thread));
+	if (!thread)
+		return -1;
+	thread->func = func;
+	thread->arg = arg;
+	if (pthread_create(&id, NULL, os_thread_run, thread)) {
+		os_free(thread);
+		return -1;
+	}
+	*idp = (ulong)id;
+
+	return 0;
+}
+
+int os_thread_join(ulong id)
+{
+	return pthread_join((pthread_t)id, NULL) ? -1 : 0;
+}
+
+ulong os_thread_self(void)
+{
+	return (ulong)pthread_self();
+}
+
 static char *short_opts;
 static struct option *long_opts;
 
@@ -83,8 +83,10 @@ int sandbox_main_loop_init(void)
 		cli_init();
 
 		retval = run_command_list(state->cmd, -1, 0);
-		if (!state->interactive)
+		if (!state->interactive) {
+			console_flush();
 			os_exit(retval);
+		}
 	}
 
 	return 0;
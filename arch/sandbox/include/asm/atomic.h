@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __ASM_SANDBOX_ATOMIC_H
+#define __ASM_SANDBOX_ATOMIC_H
+
+/*
+ * Sandbox runs U-Boot in a single host thread, so plain memory accesses
+ * are atomic enough. atomic64_t is provided for asm-generic/atomic-long.h
+ * on 64-bit hosts.
+ */
+
+typedef struct { volatile int counter; } atomic_t;
+typedef struct { volatile long long counter; } atomic64_t;
+
+#define ATOMIC_INIT(i)		{ (i) }
+#define ATOMIC64_INIT(i)	{ (i) }
+
+#define atomic_read(v)		((v)->counter)
+#define atomic_set(v, i)	(((v)->counter) = (i))
+#define atomic_add(i, v)	((void)((v)->counter += (i)))
+#define atomic_sub(i, v)	((void)((v)->counter -= (i)))
+#define atomic_inc(v)		atomic_add(1, v)
+#define atomic_dec(v)		atomic_sub(1, v)
+#define atomic_add_return(i, v)	((v)->counter += (i))
+#define atomic_sub_return(i, v)	((v)->counter -= (i))
+#define atomic_dec_and_test(v)	(atomic_sub_return(1, v) == 0)
+#define atomic_add_negative(i, v)	(atomic_add_return(i, v) < 0)
+
+#define atomic64_read(v)	((v)->counter)
+#define atomic64_set(v, i)	(((v)->counter) = (i))
+#define atomic64_add(i, v)	((void)((v)->counter += (i)))
+#define atomic64_sub(i, v)	((void)((v)->counter -= (i)))
+#define atomic64_inc(v)		atomic64_add(1, v)
+#define atomic64_dec(v)		atomic64_sub(1, v)
+#define atomic64_add_return(i, v)	((v)->counter += (i))
+#define atomic64_sub_return(i, v)	((v)->counter -= (i))
+#define atomic64_inc_return(v)	atomic64_add_return(1, v)
+#define atomic64_dec_return(v)	atomic64_sub_return(1, v)
+#define atomic64_sub_and_test(i, v)	(atomic64_sub_return(i, v) == 0)
+#define atomic64_dec_and_test(v)	(atomic64_dec_return(v) == 0)
+#define atomic64_inc_and_test(v)	(atomic64_inc_return(v) == 0)
+#define atomic64_add_negative(i, v)	(atomic64_add_return(i, v) < 0)
+
+static inline long long atomic64_cmpxchg(atomic64_t *v, long long old,
+					 long long new)
+{
+	long long val = v->counter;
+
+	if (val == old)
+		v->counter = new;
+
+	return val;
+}
+
+static inline long long atomic64_xchg(atomic64_t *v, long long new)
+{
+	long long val = v->counter;
+
+	v->counter = new;
+
+	return val;
+}
+
+static inline int atomic64_add_unless(atomic64_t *v, long long a, long long u)
+{
+	if (v->counter == u)
+		return 0;
+	v->counter += a;
+
+	return 1;
+}
+
+#define atomic64_inc_not_zero(v)	atomic64_add_unless((v), 1, 0)
+
+#endif
@@ -48,6 +48,9 @@ phys_addr_t map_to_sysmem(const void *ptr);
 #define writew(v, addr)
 #define writel(v, addr)
 
+/* Jobs may run on host threads, see arch/sandbox/cpu/jobs.c */
+#define mb()		__sync_synchronize()
+
 #include <iotrace.h>
 
 #endif
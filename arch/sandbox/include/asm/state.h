@@ -59,6 +59,8 @@ struct sandbox_state {
 	bool ignore_missing_state_on_read;	/* No error if state missing */
 	bool show_lcd;			/* Show LCD on start-up */
 	enum state_terminal_raw term_raw;	/* Terminal raw/cooked */
+	const char *nand_spec;		/* NAND simulator file and options */
+	bool spi_pio;			/* SPI bus has no read_flash() */
 
 	/* Pointer to information for each SPI bus/cs */
 	struct sandbox_spi_info spi[CONFIG_SANDBOX_SPI_MAX_BUS]
@@ -43,6 +43,7 @@ void bootm_announce_and_cleanup(void)
 #ifdef CONFIG_BOOTSTAGE_REPORT
 	bootstage_report();
 #endif
+	console_flush();
 	board_final_cleanup();
 }
 
@@ -25,6 +25,7 @@
 #include <ide.h>
 #endif
 #include <initcall.h>
+#include <jobs.h>
 #ifdef CONFIG_PS2KBD
 #include <keyboard.h>
 #endif
@@ -279,6 +280,25 @@ static int initr_noncached(void)
 }
 #endif
 
+#ifdef CONFIG_OF_LIBFDT_INDEX
+static int initr_fdt_index(void)
+{
+	/* Not fatal: lookups scan the tree without an index */
+	if (gd->fdt_blob)
+		fdt_index_build(gd->fdt_blob);
+	return 0;
+}
+#endif
+
+#ifdef CONFIG_JOBS
+static int initr_jobs(void)
+{
+	/* Not fatal: without secondary CPUs, jobs run on this one */
+	jobs_init();
+	return 0;
+}
+#endif
+
 #ifdef CONFIG_DM
 static int initr_dm(void)
 {
@@ -710,6 +730,9 @@ init_fnc_t init_sequence_r[] = {
 	initr_noncached,
 #endif
 	bootstage_relocate,
+#ifdef CONFIG_OF_LIBFDT_INDEX
+	initr_fdt_index,
+#endif
 #ifdef CONFIG_DM
 	initr_dm,
 #endif
@@ -728,6 +751,9 @@ init_fnc_t init_sequence_r[] = {
 	stdio_init_tables,
 	initr_serial,
 	initr_announce,
+#ifdef CONFIG_JOBS
+	initr_jobs,
+#endif
 	INIT_FUNC_WATCHDOG_RESET
 #ifdef CONFIG_NEEDS_MANUAL_RELOC
 	initr_manual_reloc_cmdtable,
@@ -11,6 +11,7 @@
 #include <bzlib.h>
 #include <errno.h>
 #include <fdt_support.h>
+#include <hash.h>
 #include <lmb.h>
 #include <malloc.h>
 #include <asm/io.h>
@@ -417,9 +418,11 @@ static int bootm_load_os(bootm_headers_t *images, unsigned long *load_end,
 				 load_buf, image_buf, image_len,
 				 CONFIG_SYS_BOOTM_LEN, load_end);
 	if (err) {
+		hash_read_stop();
 		bootstage_error(BOOTSTAGE_ID_DECOMP_IMAGE);
 		return err;
 	}
+	hash_read_drop(load_buf, *load_end - load);
 	flush_cache(load, (*load_end - load) * sizeof(ulong));
 
 	debug("   kernel loaded at 0x%08lx, end = 0x%08lx\n", load, *load_end);
@@ -595,6 +598,9 @@ int do_bootm_states(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 		argc = 0;	/* consume the args */
 	}
 
+	/* Images are found; hashes worked out ahead must not outlive them */
+	fit_image_hash_flush();
+
 	/* Load the OS */
 	if (!ret && (states & BOOTM_STATE_LOADOS)) {
 		ulong load_end;
@@ -15,6 +15,7 @@
 #include <common.h>
 #include <libfdt.h>
 #include <malloc.h>
+#include <trace.h>
 #include <linux/compiler.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -292,6 +293,65 @@ void bootstage_report(void)
 	}
 }
 
+int bootstage_list_marks(void *buff, int buff_size, unsigned *needed)
+{
+	struct trace_output_hdr *output_hdr = NULL;
+	struct bootstage_record *rec;
+	void *end, *ptr = buff;
+	const char *name;
+	uint32_t offset;
+	char buf[20];
+	int id, upto;
+
+	end = buff ? buff + buff_size : NULL;
+
+	/* Place some header information */
+	if (ptr + sizeof(struct trace_output_hdr) < end)
+		output_hdr = ptr;
+	ptr += sizeof(struct trace_output_hdr);
+
+	/* Move the marks onto the timer used for the call trace */
+	offset = timer_get_us() - timer_get_boot_us();
+
+	for (id = upto = 0, rec = record; id < BOOTSTAGE_ID_COUNT;
+	     id++, rec++) {
+		if (!rec->time_us)
+			continue;
+		if (ptr + sizeof(struct trace_output_mark) < end) {
+			struct trace_output_mark *mark = ptr;
+
+			if (rec->start_us) {
+				mark->time_us = rec->time_us;
+				mark->flags = TRACE_MARKF_ACCUM;
+			} else {
+				mark->time_us = (rec->time_us + offset) &
+					FUNCF_TIMESTAMP_MASK;
+				mark->flags = 0;
+			}
+			/* The first record stands for reset, as in the report */
+			if (rec->id == BOOTSTAGE_ID_START && !rec->name)
+				name = "reset";
+			else
+				name = get_record_name(buf, sizeof(buf), rec);
+			strlcpy(mark->name, name, sizeof(mark->name));
+			upto++;
+		}
+		ptr += sizeof(struct trace_output_mark);
+	}
+
+	/* Update the header */
+	if (output_hdr) {
+		output_hdr->rec_count = upto;
+		output_hdr->type = TRACE_CHUNK_MARKS;
+	}
+
+	/* Work out how must of the buffer we used */
+	*needed = ptr - buff;
+	if (ptr > end)
+		return -1;
+	return 0;
+}
+
 ulong __timer_get_boot_us(void)
 {
 	static ulong base_time;
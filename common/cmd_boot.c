@@ -10,6 +10,7 @@
  */
 #include <common.h>
 #include <command.h>
+#include <jobs.h>
 #include <net.h>
 
 #ifdef CONFIG_CMD_GO
@@ -34,6 +35,9 @@ static int do_go(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 
 	printf ("## Starting application at 0x%08lX ...\n", addr);
 
+	/* The application may start the secondary CPUs itself */
+	jobs_stop();
+
 	/*
 	 * pass address parameter as argv[0] (aka command name),
 	 * and all remaining args
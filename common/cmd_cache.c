@@ -10,6 +10,7 @@
  */
 #include <common.h>
 #include <command.h>
+#include <jobs.h>
 #include <linux/compiler.h>
 
 static int parse_argv(const char *);
@@ -61,6 +62,11 @@ static int do_dcache(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 			dcache_disable();
 			break;
 		case 1:
+			/*
+			 * Secondary CPUs running jobs have their caches off
+			 * and would not see what is in this one's
+			 */
+			jobs_stop();
 			dcache_enable();
 			break;
 		case 2:
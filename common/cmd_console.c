@@ -52,3 +52,33 @@ U_BOOT_CMD(
 	"print console devices and information",
 	""
 );
+
+#ifdef CONFIG_CONSOLE_TX_BUFFER
+static int do_console(cmd_tbl_t *cmdtp, int flag, int argc,
+		      char * const argv[])
+{
+	if (argc == 2 && !strcmp(argv[1], "log")) {
+		console_show_log();
+	} else if (argc == 2 && !strcmp(argv[1], "quiet")) {
+		printf("quiet %s\n", console_get_quiet() ? "on" : "off");
+	} else if (argc == 3 && !strcmp(argv[1], "quiet")) {
+		if (!strcmp(argv[2], "on"))
+			console_set_quiet(1);
+		else if (!strcmp(argv[2], "off"))
+			console_set_quiet(0);
+		else
+			return CMD_RET_USAGE;
+	} else {
+		return CMD_RET_USAGE;
+	}
+
+	return 0;
+}
+
+U_BOOT_CMD(
+	console,	3,	1,	do_console,
+	"console output log",
+	"log - print the latest console output\n"
+	"console quiet [on|off] - only record console output while on"
+);
+#endif
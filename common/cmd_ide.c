@@ -14,6 +14,7 @@
 #include <watchdog.h>
 #include <command.h>
 #include <image.h>
+#include <hash.h>
 #include <asm/byteorder.h>
 #include <asm/io.h>
 
@@ -207,6 +208,8 @@ int do_ide(cmd_tbl_t *cmdtp, int flag, int argc, char *const argv[])
 			/* flush cache after read */
 			flush_cache(addr,
 				    cnt * ide_dev_desc[curr_device].blksz);
+			hash_read_drop((void *)addr,
+				       cnt * ide_dev_desc[curr_device].blksz);
 
 			printf("%ld blocks read: %s\n",
 			       n, (n == cnt) ? "OK" : "ERROR");
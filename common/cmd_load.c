@@ -10,6 +10,7 @@
  */
 #include <common.h>
 #include <command.h>
+#include <hash.h>
 #include <s_record.h>
 #include <net.h>
 #include <exports.h>
@@ -162,6 +163,7 @@ static ulong load_serial(long offset)
 		    } else
 #endif
 		    {
+			hash_read_drop((char *)store_addr, binlen);
 			memcpy((char *)(store_addr), binbuf, binlen);
 		    }
 		    if ((store_addr) < start_addr)
@@ -626,6 +628,7 @@ static void bin_data_char(char new_char)
 {
 	switch (os_data_state) {
 	case 0:					/* data */
+		hash_read_drop(os_data_addr, 1);
 		*os_data_addr++ = new_char;
 		break;
 	}
@@ -983,6 +986,7 @@ static ulong load_serial_ymodem(ulong offset, int mode)
 			} else
 #endif
 			{
+				hash_read_drop((char *)store_addr, res);
 				memcpy((char *)(store_addr), ymodemBuf,
 					res);
 			}
@@ -198,6 +198,7 @@ static int do_mem_mw(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 
 	bytes = size * count;
 	buf = map_sysmem(addr, bytes);
+	hash_read_drop(buf, bytes);
 	while (count-- > 0) {
 		if (size == 4)
 			*((u32 *)buf) = (u32)writeval;
@@ -439,6 +440,7 @@ static int do_mem_cp(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 #endif
 	   ){
 		int rc;
+		hash_read_drop((char *)dest, count * size);
 		rc = read_dataflash(addr, count * size, (char *) dest);
 		if (rc != 1) {
 			dataflash_perror (rc);
@@ -464,6 +466,7 @@ static int do_mem_cp(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	bytes = size * count;
 	buf = map_sysmem(dest, bytes);
 	src = map_sysmem(addr, bytes);
+	hash_read_drop(buf, bytes);
 	while (count-- > 0) {
 		if (size == 4)
 			*((u32 *)buf) = *((u32  *)src);
@@ -643,6 +646,7 @@ static int do_mem_loopw(cmd_tbl_t *cmdtp, int flag, int argc,
 
 	bytes = size * length;
 	buf = map_sysmem(addr, bytes);
+	hash_read_drop(buf, bytes);
 
 	/* We want to optimize the loops to run as fast as possible.
 	 * If we have only one object, just run infinite loops.
@@ -1040,6 +1044,8 @@ static int do_mem_mtest(cmd_tbl_t *cmdtp, int flag, int argc,
 
 	buf = map_sysmem(start, end - start);
 	dummy = map_sysmem(CONFIG_SYS_MEMTEST_SCRATCH, sizeof(vu_long));
+	hash_read_drop((void *)buf, end - start + 1);
+	hash_read_drop((void *)dummy, sizeof(vu_long));
 	for (iteration = 0;
 			!iteration_limit || iteration < iteration_limit;
 			iteration++) {
@@ -1187,6 +1193,7 @@ mod_mem(cmd_tbl_t *cmdtp, int incrflag, int flag, int argc, char * const argv[])
 				/* good enough to not time out
 				 */
 				bootretry_reset_cmd_timeout();
+				hash_read_drop(ptr, size);
 				if (size == 4)
 					*((u32 *)ptr) = i;
 #ifdef CONFIG_SYS_SUPPORT_64BIT_DATA
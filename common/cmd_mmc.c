@@ -7,6 +7,7 @@
 
 #include <common.h>
 #include <command.h>
+#include <hash.h>
 #include <mmc.h>
 
 static int curr_device = -1;
@@ -350,10 +351,14 @@ static int do_mmc_read(cmd_tbl_t *cmdtp, int flag,
 	printf("\nMMC read: dev # %d, block # %d, count %d ... ",
 	       curr_device, blk, cnt);
 
+	hash_read_start(getenv("loadhash"), addr);
 	n = mmc->block_dev.block_read(curr_device, blk, cnt, addr);
 	/* flush cache after read */
 	flush_cache((ulong)addr, cnt * 512); /* FIXME */
 	printf("%d blocks read: %s\n", n, (n == cnt) ? "OK" : "ERROR");
+	if (n != cnt || hash_read_finish(cnt * mmc->read_bl_len))
+		hash_read_stop();
+	hash_read_setenv("loadsum", addr, cnt * mmc->read_bl_len);
 
 	return (n == cnt) ? CMD_RET_SUCCESS : CMD_RET_FAILURE;
 }
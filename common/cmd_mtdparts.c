@@ -457,6 +457,9 @@ static int part_del(struct mtd_device *dev, struct part_info *part)
 	}
 
 	list_del(&part->link);
+#if defined(CONFIG_CMD_JFFS2)
+	jffs2_free_cache(part);
+#endif
 	free(part);
 	dev->num_parts--;
 
@@ -483,6 +486,9 @@ static void part_delall(struct list_head *head)
 		part_tmp = list_entry(entry, struct part_info, link);
 
 		list_del(entry);
+#if defined(CONFIG_CMD_JFFS2)
+		jffs2_free_cache(part_tmp);
+#endif
 		free(part_tmp);
 	}
 }
@@ -22,9 +22,11 @@
 #include <common.h>
 #include <linux/mtd/mtd.h>
 #include <command.h>
+#include <hash.h>
 #include <watchdog.h>
 #include <malloc.h>
 #include <asm/byteorder.h>
+#include <asm/io.h>
 #include <jffs2/jffs2.h>
 #include <nand.h>
 
@@ -636,11 +638,15 @@ static int do_nand(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 		return ret == 0 ? 1 : 0;
 	}
 
-	if (strncmp(cmd, "read", 4) == 0 || strncmp(cmd, "write", 5) == 0) {
+	if (strncmp(cmd, "read", 4) == 0 || strncmp(cmd, "write", 5) == 0 ||
+	    strcmp(cmd, "update") == 0) {
 		size_t rwsize;
 		ulong pagecount = 1;
 		int read;
 		int raw = 0;
+		int flags = WITH_WR_VERIFY;
+		struct nand_update_stats stats;
+		u_char *buf;
 
 		if (argc < 4)
 			goto usage;
@@ -648,7 +654,10 @@ static int do_nand(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 		addr = (ulong)simple_strtoul(argv[2], NULL, 16);
 
 		read = strncmp(cmd, "read", 4) == 0; /* 1 = read, 0 = write */
-		printf("\nNAND %s: ", read ? "read" : "write");
+		if (strcmp(cmd, "update") == 0)
+			flags |= WITH_UPDATE;
+		printf("\nNAND %s: ", read ? "read" :
+		       flags & WITH_UPDATE ? "update" : "write");
 
 		s = strchr(cmd, '.');
 
@@ -683,32 +692,35 @@ static int do_nand(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 		}
 
 		nand = &nand_info[dev];
+		buf = map_sysmem(addr, rwsize);
+		if (read)
+			hash_read_drop(buf, rwsize);
 
 		if (!s || !strcmp(s, ".jffs2") ||
 		    !strcmp(s, ".e") || !strcmp(s, ".i")) {
 			if (read)
 				ret = nand_read_skip_bad(nand, off, &rwsize,
 							 NULL, maxsize,
-							 (u_char *)addr);
+							 buf);
 			else
-				ret = nand_write_skip_bad(nand, off, &rwsize,
-							  NULL, maxsize,
-							  (u_char *)addr,
-							  WITH_WR_VERIFY);
+				ret = nand_update_skip_bad(nand, off, &rwsize,
+							   NULL, maxsize,
+							   buf, flags, &stats);
 #ifdef CONFIG_CMD_NAND_TRIMFFS
 		} else if (!strcmp(s, ".trimffs")) {
 			if (read) {
 				printf("Unknown nand command suffix '%s'\n", s);
+				unmap_sysmem(buf);
 				return 1;
 			}
 			ret = nand_write_skip_bad(nand, off, &rwsize, NULL,
-						maxsize, (u_char *)addr,
+						maxsize, buf,
 						WITH_DROP_FFS | WITH_WR_VERIFY);
 #endif
 		} else if (!strcmp(s, ".oob")) {
 			/* out-of-band data */
 			mtd_oob_ops_t ops = {
-				.oobbuf = (u8 *)addr,
+				.oobbuf = buf,
 				.ooblen = rwsize,
 				.mode = MTD_OPS_RAW
 			};
@@ -718,12 +730,17 @@ static int do_nand(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 			else
 				ret = mtd_write_oob(nand, off, &ops);
 		} else if (raw) {
-			ret = raw_access(nand, addr, off, pagecount, read);
+			ret = raw_access(nand, (ulong)buf, off, pagecount, read);
 		} else {
 			printf("Unknown nand command suffix '%s'.\n", s);
+			unmap_sysmem(buf);
 			return 1;
 		}
+		unmap_sysmem(buf);
 
+		if ((flags & WITH_UPDATE) && !ret)
+			printf("%zu bytes unchanged, %zu erased, %zu programmed,",
+			       stats.unchanged, stats.erased, stats.programmed);
 		printf(" %zu bytes %s: %s\n", rwsize,
 		       read ? "read" : "written", ret ? "ERROR" : "OK");
 
@@ -772,6 +789,15 @@ static int do_nand(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 			--argc;
 			++argv;
 		}
+#if defined(CONFIG_NAND_BBT_ENV) && defined(CONFIG_CMD_SAVEENV) && \
+	!defined(CONFIG_ENV_IS_NOWHERE)
+		/* Keep the saved copy of the RAM based table up to date */
+		if (!(((struct nand_chip *)nand->priv)->bbt_options &
+		      NAND_BBT_USE_FLASH)) {
+			printf("Saving bad block table '%sbbt'\n", nand->name);
+			saveenv();
+		}
+#endif
 		return ret;
 	}
 
@@ -838,6 +864,9 @@ static char nand_help_text[] =
 	"nand write - addr off|partition size\n"
 	"    read/write 'size' bytes starting at offset 'off'\n"
 	"    to/from memory address 'addr', skipping bad blocks.\n"
+	"nand update - addr off|partition size\n"
+	"    like write, but erase and program only the blocks which differ\n"
+	"    from the data already in flash (no separate erase needed)\n"
 	"nand read.raw - addr off|partition [count]\n"
 	"nand write.raw - addr off|partition [count]\n"
 	"    Use read.raw/write.raw to avoid ECC and access the flash as-is.\n"
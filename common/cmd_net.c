@@ -11,6 +11,7 @@
 #include <common.h>
 #include <command.h>
 #include <net.h>
+#include <trace.h>
 
 static int netboot_common(enum proto_t, cmd_tbl_t *, int, char * const []);
 
@@ -228,7 +229,10 @@ static int netboot_common(enum proto_t proto, cmd_tbl_t *cmdtp, int argc,
 	}
 	bootstage_mark(BOOTSTAGE_ID_NET_START);
 
-	if ((size = NetLoop(proto)) < 0) {
+	trace_event_start(TRACE_EVENT_NET);
+	size = NetLoop(proto);
+	trace_event_end(TRACE_EVENT_NET, size > 0 ? size : 0);
+	if (size < 0) {
 		bootstage_error(BOOTSTAGE_ID_NET_NETLOOP_OK);
 		return 1;
 	}
@@ -30,6 +30,7 @@
 #include <environment.h>
 #include <search.h>
 #include <errno.h>
+#include <hash.h>
 #include <malloc.h>
 #include <watchdog.h>
 #include <linux/stddef.h>
@@ -897,8 +898,12 @@ NXTARG:		;
 	addr = simple_strtoul(argv[0], NULL, 16);
 	ptr = map_sysmem(addr, size);
 
-	if (size)
+	if (size) {
+		hash_read_drop(ptr, size);
 		memset(ptr, '\0', size);
+	} else {
+		hash_read_stop();
+	}
 
 	argc--;
 	argv++;
@@ -12,6 +12,7 @@
 
 #include <common.h>
 #include <command.h>
+#include <hash.h>
 #include <part.h>
 #include <sata.h>
 
@@ -175,6 +176,8 @@ static int do_sata(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 
 			/* flush cache after read */
 			flush_cache(addr, cnt * sata_dev_desc[sata_curr_device].blksz);
+			hash_read_drop((void *)addr,
+				       cnt * sata_dev_desc[sata_curr_device].blksz);
 
 			printf("%ld blocks read: %s\n",
 				n, (n==cnt) ? "OK" : "ERROR");
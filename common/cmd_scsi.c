@@ -10,6 +10,7 @@
  */
 #include <common.h>
 #include <command.h>
+#include <hash.h>
 #include <inttypes.h>
 #include <asm/processor.h>
 #include <scsi.h>
@@ -333,6 +334,8 @@ int do_scsi (cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 				printf ("\nSCSI read: device %d block # %ld, count %ld ... ",
 						scsi_curr_dev, blk, cnt);
 				n = scsi_read(scsi_curr_dev, blk, cnt, (ulong *)addr);
+				hash_read_drop((void *)addr,
+					       cnt * scsi_dev_desc[scsi_curr_dev].blksz);
 				printf ("%ld blocks read: %s\n",n,(n==cnt) ? "OK" : "ERROR");
 				return 0;
 			} else if (strcmp(argv[1], "write") == 0) {
@@ -9,6 +9,7 @@
 #include <common.h>
 #include <div64.h>
 #include <dm.h>
+#include <hash.h>
 #include <malloc.h>
 #include <spi.h>
 #include <spi_flash.h>
@@ -146,46 +147,135 @@ static int do_spi_flash_probe(int argc, char * const argv[])
 	return 0;
 }
 
+/* Number of sectors read back at once by 'sf update' */
+#define SF_UPDATE_SECTORS	16
+
+/* Statistics gathered by 'sf update' */
+struct sf_update_stats {
+	size_t skipped;		/* bytes already holding the right data */
+	size_t erased;		/* bytes erased */
+	size_t programmed;	/* bytes programmed */
+};
+
+static bool sf_is_erased(const char *buf, size_t len)
+{
+	while (len--) {
+		if (*buf++ != (char)0xff)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * Program the pages of a region which differ from what the flash holds,
+ * writing runs of adjacent pages at once.
+ *
+ * @param flash		flash context pointer
+ * @param offset	page-aligned flash offset of the region
+ * @param len		length of the region
+ * @param buf		data to write
+ * @param cur		current contents of the region, or NULL if erased
+ * @param stats		statistics to update
+ * @return 0 if ok, -ve on error
+ */
+static int spi_flash_program_changed(struct spi_flash *flash, u32 offset,
+		size_t len, const char *buf, const char *cur,
+		struct sf_update_stats *stats)
+{
+	size_t pos, todo, run = 0, start = 0;
+	bool changed;
+	int ret;
+
+	for (pos = 0; pos <= len; pos += todo) {
+		todo = min_t(size_t, len - pos, flash->page_size);
+		if (!todo)
+			changed = false;
+		else if (cur)
+			changed = memcmp(cur + pos, buf + pos, todo) != 0;
+		else
+			changed = !sf_is_erased(buf + pos, todo);
+		if (changed) {
+			if (!run)
+				start = pos;
+			run += todo;
+			continue;
+		}
+		if (run) {
+			ret = spi_flash_write(flash, offset + start, run,
+					      buf + start);
+			if (ret)
+				return ret;
+			stats->programmed += run;
+			run = 0;
+		}
+		if (!todo)
+			break;
+	}
+
+	return 0;
+}
+
 /**
- * Write a block of data to SPI flash, first checking if it is different from
- * what is already there.
+ * Write a sector of data to SPI flash, given what is already there.
  *
- * If the data being written is the same, then *skipped is incremented by len.
+ * If the data being written is the same, then stats->skipped is
+ * incremented by len. The sector is only erased if a page that must
+ * change is not already erased, and only the pages which change are
+ * programmed.
  *
  * @param flash		flash context pointer
  * @param offset	flash offset to write
  * @param len		number of bytes to write
  * @param buf		buffer to write from
- * @param cmp_buf	read buffer to use to compare data
- * @param skipped	Count of skipped data (incremented by this function)
+ * @param cmp_buf	current contents of the whole sector
+ * @param stats		statistics to update
  * @return NULL if OK, else a string containing the stage which failed
  */
 static const char *spi_flash_update_block(struct spi_flash *flash, u32 offset,
-		size_t len, const char *buf, char *cmp_buf, size_t *skipped)
+		size_t len, const char *buf, const char *cmp_buf,
+		struct sf_update_stats *stats)
 {
+	size_t pos, todo;
+	bool erase = false;
+
 	debug("offset=%#x, sector_size=%#x, len=%#zx\n",
 	      offset, flash->sector_size, len);
-	/* Read the entire sector so to allow for rewriting */
-	if (spi_flash_read(flash, offset, flash->sector_size, cmp_buf))
-		return "read";
 	/* Compare only what is meaningful (len) */
 	if (memcmp(cmp_buf, buf, len) == 0) {
 		debug("Skip region %x size %zx: no change\n",
 		      offset, len);
-		*skipped += len;
+		stats->skipped += len;
+		return NULL;
+	}
+	/* Pages which change can be programmed as-is if already erased */
+	for (pos = 0; pos < len && !erase; pos += todo) {
+		todo = min_t(size_t, len - pos, flash->page_size);
+		erase = memcmp(cmp_buf + pos, buf + pos, todo) &&
+			!sf_is_erased(cmp_buf + pos, todo);
+	}
+	if (!erase) {
+		debug("Program region %x size %zx: already erased\n",
+		      offset, len);
+		if (spi_flash_program_changed(flash, offset, len, buf,
+					      cmp_buf, stats))
+			return "write";
 		return NULL;
 	}
+
 	/* Erase the entire sector */
 	if (spi_flash_erase(flash, offset, flash->sector_size))
 		return "erase";
+	stats->erased += flash->sector_size;
 	/* Write the initial part of the block from the source */
-	if (spi_flash_write(flash, offset, len, buf))
+	if (spi_flash_program_changed(flash, offset, len, buf, NULL, stats))
 		return "write";
 	/* If it's a partial sector, rewrite the existing part */
 	if (len != flash->sector_size) {
 		/* Rewrite the original data to the end of the sector */
-		if (spi_flash_write(flash, offset + len,
-				    flash->sector_size - len, &cmp_buf[len]))
+		if (spi_flash_program_changed(flash, offset + len,
+					      flash->sector_size - len,
+					      &cmp_buf[len], NULL, stats))
 			return "write";
 	}
 
@@ -196,6 +286,9 @@ static const char *spi_flash_update_block(struct spi_flash *flash, u32 offset,
  * Update an area of SPI flash by erasing and writing any blocks which need
  * to change. Existing blocks with the correct data are left unchanged.
  *
+ * The flash is read back several sectors at a time, so that controllers
+ * which can read in bulk are kept busy.
+ *
  * @param flash		flash context pointer
  * @param offset	flash offset to write
  * @param len		number of bytes to write
@@ -209,20 +302,26 @@ static int spi_flash_update(struct spi_flash *flash, u32 offset,
 	char *cmp_buf;
 	const char *end = buf + len;
 	size_t todo;		/* number of bytes to do in this pass */
-	size_t skipped = 0;	/* statistics */
+	struct sf_update_stats stats = { 0 };
 	const ulong start_time = get_timer(0);
 	size_t scale = 1;
 	const char *start_buf = buf;
+	size_t buf_size, chunk, pos;
 	ulong delta;
 
 	if (end - buf >= 200)
 		scale = (end - buf) / 100;
-	cmp_buf = malloc(flash->sector_size);
+	buf_size = min_t(size_t, DIV_ROUND_UP(len, flash->sector_size),
+			 SF_UPDATE_SECTORS) * flash->sector_size;
+	cmp_buf = malloc(buf_size);
+	if (!cmp_buf) {
+		buf_size = flash->sector_size;
+		cmp_buf = malloc(buf_size);
+	}
 	if (cmp_buf) {
 		ulong last_update = get_timer(0);
 
-		for (; buf < end && !err_oper; buf += todo, offset += todo) {
-			todo = min_t(size_t, end - buf, flash->sector_size);
+		while (buf < end && !err_oper) {
 			if (get_timer(last_update) > 100) {
 				printf("   \rUpdating, %zu%% %lu B/s",
 				       100 - (end - buf) / scale,
@@ -230,8 +329,23 @@ static int spi_flash_update(struct spi_flash *flash, u32 offset,
 							 start_time));
 				last_update = get_timer(0);
 			}
-			err_oper = spi_flash_update_block(flash, offset, todo,
-					buf, cmp_buf, &skipped);
+			/* Read back whole sectors, not going past the flash */
+			chunk = roundup(min_t(size_t, end - buf, buf_size),
+					flash->sector_size);
+			chunk = min_t(size_t, chunk, flash->size - offset);
+			if (spi_flash_read(flash, offset, chunk, cmp_buf)) {
+				err_oper = "read";
+				break;
+			}
+			for (pos = 0; pos < chunk && buf < end && !err_oper;
+			     pos += flash->sector_size, buf += todo,
+			     offset += todo) {
+				todo = min_t(size_t, end - buf,
+					     flash->sector_size);
+				err_oper = spi_flash_update_block(flash, offset,
+						todo, buf, cmp_buf + pos,
+						&stats);
+			}
 		}
 	} else {
 		err_oper = "malloc";
@@ -244,9 +358,11 @@ static int spi_flash_update(struct spi_flash *flash, u32 offset,
 	}
 
 	delta = get_timer(start_time);
-	printf("%zu bytes written, %zu bytes skipped", len - skipped,
-	       skipped);
-	printf(" in %ld.%lds, speed %ld B/s\n",
+	printf("%zu bytes written, %zu bytes skipped", len - stats.skipped,
+	       stats.skipped);
+	printf(" (%zu erased, %zu programmed)", stats.erased,
+	       stats.programmed);
+	printf(" in %ld.%03lds, speed %ld B/s\n",
 	       delta / 1000, delta % 1000, bytes_per_second(len, start_time));
 
 	return 0;
@@ -291,16 +407,25 @@ static int do_spi_flash_read_write(int argc, char * const argv[])
 		ret = spi_flash_update(flash, offset, len, buf);
 	} else if (strncmp(argv[0], "read", 4) == 0 ||
 			strncmp(argv[0], "write", 5) == 0) {
+		const ulong start_time = get_timer(0);
+		ulong delta;
 		int read;
 
 		read = strncmp(argv[0], "read", 4) == 0;
-		if (read)
+		if (read) {
+			hash_read_drop(buf, len);
 			ret = spi_flash_read(flash, offset, len, buf);
-		else
+		} else {
 			ret = spi_flash_write(flash, offset, len, buf);
+		}
+		delta = get_timer(start_time);
 
-		printf("SF: %zu bytes @ %#x %s: %s\n", (size_t)len, (u32)offset,
+		printf("SF: %zu bytes @ %#x %s: %s", (size_t)len, (u32)offset,
 		       read ? "Read" : "Written", ret ? "ERROR" : "OK");
+		if (!ret)
+			printf(" in %ld.%03lds, speed %ld B/s", delta / 1000,
+			       delta % 1000, bytes_per_second(len, start_time));
+		putc('\n');
 	}
 
 	unmap_physmem(buf, len);
@@ -14,6 +14,7 @@
 #include <common.h>
 #include <command.h>
 #include <exports.h>
+#include <hash.h>
 
 #include <nand.h>
 #include <onenand_uboot.h>
@@ -22,6 +23,7 @@
 #include <linux/err.h>
 #include <ubi_uboot.h>
 #include <asm/errno.h>
+#include <asm/io.h>
 #include <jffs2/load_kernel.h>
 
 #undef ubi_msg
@@ -85,6 +87,10 @@ static void display_ubi_info(struct ubi_device *ubi)
 	ubi_msg("number of PEBs reserved for bad PEB handling: %d",
 			ubi->beb_rsvd_pebs);
 	ubi_msg("max/mean erase counter: %d/%d", ubi->max_ec, ubi->mean_ec);
+	if (ubi->attach_us)
+		ubi_msg("attach time: read %lu ms, scan %lu ms, build %lu ms, total %lu ms",
+			ubi->attach_read_us / 1000, ubi->attach_scan_us / 1000,
+			ubi->attach_build_us / 1000, ubi->attach_us / 1000);
 }
 
 static int ubi_info(int layout)
@@ -513,6 +519,7 @@ static int do_ubi(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
 	int64_t size = 0;
 	ulong addr = 0;
+	void *buf;
 
 	if (argc < 2)
 		return CMD_RET_USAGE;
@@ -608,21 +615,23 @@ static int do_ubi(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 
 		addr = simple_strtoul(argv[2], NULL, 16);
 		size = simple_strtoul(argv[4], NULL, 16);
+		buf = map_sysmem(addr, size);
 
 		if (strlen(argv[1]) == 10 &&
 		    strncmp(argv[1] + 5, ".part", 5) == 0) {
 			if (argc < 6) {
 				ret = ubi_volume_continue_write(argv[3],
-						(void *)addr, size);
+						buf, size);
 			} else {
 				size_t full_size;
 				full_size = simple_strtoul(argv[5], NULL, 16);
 				ret = ubi_volume_begin_write(argv[3],
-						(void *)addr, size, full_size);
+						buf, size, full_size);
 			}
 		} else {
-			ret = ubi_volume_write(argv[3], (void *)addr, size);
+			ret = ubi_volume_write(argv[3], buf, size);
 		}
+		unmap_sysmem(buf);
 		if (!ret) {
 			printf("%lld bytes written to volume %s\n", size,
 			       argv[3]);
@@ -632,6 +641,8 @@ static int do_ubi(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	}
 
 	if (strncmp(argv[1], "read", 4) == 0) {
+		int ret;
+
 		size = 0;
 
 		/* E.g., read volume size */
@@ -650,7 +661,15 @@ static int do_ubi(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 			printf("Read %lld bytes from volume %s to %lx\n", size,
 			       argv[3], addr);
 
-			return ubi_volume_read(argv[3], (char *)addr, size);
+			buf = map_sysmem(addr, size);
+			if (size)
+				hash_read_drop(buf, size);
+			else
+				hash_read_stop();	/* the whole volume */
+			ret = ubi_volume_read(argv[3], buf, size);
+			unmap_sysmem(buf);
+
+			return ret;
 		}
 	}
 
@@ -15,6 +15,8 @@
 #include <common.h>
 #include <config.h>
 #include <command.h>
+#include <hash.h>
+#include <asm/io.h>
 
 #include "../fs/ubifs/ubifs.h"
 
@@ -136,6 +138,11 @@ static int do_ubifs_load(cmd_tbl_t *cmdtp, int flag, int argc,
 	}
 	debug("Loading file '%s' to address 0x%08x (size %d)\n", filename, addr, size);
 
+	/* The size of the whole file is not known yet */
+	if (size)
+		hash_read_drop(map_sysmem(addr, size), size);
+	else
+		hash_read_stop();
 	ret = ubifs_load(filename, addr, size);
 	if (ret) {
 		printf("** File not found %s **\n", filename);
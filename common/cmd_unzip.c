@@ -7,6 +7,7 @@
 
 #include <common.h>
 #include <command.h>
+#include <hash.h>
 
 static int do_unzip(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 {
@@ -25,8 +26,11 @@ static int do_unzip(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 			return CMD_RET_USAGE;
 	}
 
-	if (gunzip((void *) dst, dst_len, (void *) src, &src_len) != 0)
+	if (gunzip((void *) dst, dst_len, (void *) src, &src_len) != 0) {
+		hash_read_stop();
 		return 1;
+	}
+	hash_read_drop((void *)dst, src_len);
 
 	printf("Uncompressed size: %ld = 0x%lX\n", src_len, src_len);
 	setenv_hex("filesize", src_len);
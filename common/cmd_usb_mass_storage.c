@@ -8,6 +8,7 @@
 #include <errno.h>
 #include <common.h>
 #include <command.h>
+#include <div64.h>
 #include <g_dnl.h>
 #include <part.h>
 #include <usb.h>
@@ -39,6 +40,18 @@ static struct ums ums_dev = {
 	.name = "UMS disk",
 };
 
+static void ums_show_stats(const char *name, u64 bytes, ulong time)
+{
+	ulong kib = bytes >> 10;
+
+	if (!bytes)
+		return;
+	printf("UMS: %s %lu KiB, %lu ms on medium", name, kib, time);
+	if (time)
+		printf(" (%lu KiB/s)", (ulong)lldiv((u64)kib * 1000, time));
+	puts("\n");
+}
+
 struct ums *ums_init(const char *devtype, const char *devnum)
 {
 	block_dev_desc_t *block_dev;
@@ -55,6 +68,10 @@ struct ums *ums_init(const char *devtype, const char *devnum)
 	ums_dev.block_dev = block_dev;
 	ums_dev.start_sector = 0;
 	ums_dev.num_sectors = block_dev->lba;
+	ums_dev.read_bytes = 0;
+	ums_dev.write_bytes = 0;
+	ums_dev.read_time = 0;
+	ums_dev.write_time = 0;
 
 	printf("UMS: disk start sector: %#x, count: %#x\n",
 	       ums_dev.start_sector, ums_dev.num_sectors);
@@ -153,6 +170,8 @@ int do_usb_mass_storage(cmd_tbl_t *cmdtp, int flag,
 		}
 	}
 exit:
+	ums_show_stats("read", ums->read_bytes, ums->read_time);
+	ums_show_stats("written", ums->write_bytes, ums->write_time);
 	g_dnl_unregister();
 	return CMD_RET_SUCCESS;
 }
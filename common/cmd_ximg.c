@@ -16,6 +16,7 @@
 #include <command.h>
 #include <image.h>
 #include <watchdog.h>
+#include <hash.h>
 #if defined(CONFIG_BZIP2)
 #include <bzlib.h>
 #endif
@@ -181,6 +182,8 @@ do_imgextract(cmd_tbl_t * cmdtp, int flag, int argc, char * const argv[])
 	}
 
 	if (argc > 3) {
+		/* The part may land anywhere, forget what was hashed on read */
+		hash_read_stop();
 		switch (comp) {
 		case IH_COMP_NONE:
 #if defined(CONFIG_HW_WATCHDOG) || defined(CONFIG_WATCHDOG)
@@ -6,17 +6,38 @@
  */
 
 #include <common.h>
+#include <errno.h>
 #include <stdarg.h>
 #include <iomux.h>
+#include <jobs.h>
 #include <malloc.h>
 #include <os.h>
 #include <serial.h>
 #include <stdio_dev.h>
 #include <exports.h>
 #include <environment.h>
+#include <watchdog.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
+#ifdef CONFIG_JOBS
+/* Jobs on secondary CPUs may print */
+static struct job_lock output_lock;
+
+static inline void output_lock_take(void)
+{
+	job_lock(&output_lock);
+}
+
+static inline void output_lock_release(void)
+{
+	job_unlock(&output_lock);
+}
+#else
+static inline void output_lock_take(void) {}
+static inline void output_lock_release(void) {}
+#endif
+
 static int on_console(const char *name, const char *value, enum env_op op,
 	int flags)
 {
@@ -294,6 +315,185 @@ int serial_printf(const char *fmt, ...)
 	return i;
 }
 
+#if defined(CONFIG_CONSOLE_TX_BUFFER) && !defined(CONFIG_SPL_BUILD)
+/*
+ * Output to stdout is queued here and sent as the serial port can take it,
+ * so that printing does not wait for the UART. The buffer also keeps the
+ * last output as a log, which is all that quiet mode does with it.
+ */
+#ifndef CONFIG_CONSOLE_TX_BUFFER_SIZE
+#define CONFIG_CONSOLE_TX_BUFFER_SIZE	0x4000
+#endif
+#define TX_BUF_SIZE	((unsigned long)CONFIG_CONSOLE_TX_BUFFER_SIZE)
+#define TX_BUF_IDX(idx)	((idx) % TX_BUF_SIZE)
+
+static char tx_buf[CONFIG_CONSOLE_TX_BUFFER_SIZE];
+static unsigned long tx_head;	/* characters queued */
+static unsigned long tx_tail;	/* characters sent */
+static int tx_quiet;
+static int tx_busy;		/* sending, or printing the log */
+static int tx_cr_sent;		/* the '\r' before the next '\n' is sent */
+static unsigned long tx_lost;	/* unsent characters dropped while sending */
+
+/* The serial port can be polled when it is the only output device */
+static int tx_is_serial(void)
+{
+	struct stdio_dev *dev;
+
+#ifdef CONFIG_CONSOLE_MUX
+	if (cd_count[stdout] != 1)
+		return 0;
+	dev = console_devices[stdout][0];
+#else
+	dev = stdio_devices[stdout];
+#endif
+
+	if ((dev->flags & DEV_FLAGS_SYSTEM) && !strcmp(dev->name, "serial"))
+		return 1;
+#ifdef CONFIG_DM_SERIAL
+	/* or the stdio device of the current serial port */
+	return dev->priv == gd->cur_serial_dev;
+#else
+	return 0;
+#endif
+}
+
+static int tx_try_putc(const char c)
+{
+	int ret;
+
+	if (c == '\n' && !tx_cr_sent) {
+		ret = serial_try_putc('\r');
+		if (ret)
+			return ret;
+		tx_cr_sent = 1;
+	}
+	ret = serial_try_putc(c);
+	if (ret != -EAGAIN && ret != -ENOSYS)
+		tx_cr_sent = 0;
+
+	return ret;
+}
+
+static void tx_putc(const char c);
+
+/* Send queued output, stopping when the serial port is busy unless @wait */
+static void tx_drain(int wait)
+{
+	int serial;
+	char c;
+
+	output_lock_take();
+	if (tx_quiet || tx_busy) {
+		output_lock_release();
+		return;
+	}
+
+	if (tx_lost) {
+		char msg[48];
+		int i, len;
+
+		len = snprintf(msg, sizeof(msg),
+			       "\n** %lu characters of output lost **\n",
+			       tx_lost);
+		tx_lost = 0;
+		for (i = 0; i < len; i++)
+			tx_putc(msg[i]);
+	}
+
+	tx_busy = 1;
+	serial = tx_is_serial();
+	while (tx_tail != tx_head) {
+		c = tx_buf[TX_BUF_IDX(tx_tail)];
+		if (serial) {
+			switch (tx_try_putc(c)) {
+			case -EAGAIN:
+				if (!wait)
+					goto out;
+				WATCHDOG_RESET();
+				continue;
+			case -ENOSYS:
+				/* The driver can only wait, so let it */
+				serial = 0;
+				continue;
+			}
+		} else {
+			console_putc(stdout, c);
+		}
+		tx_tail++;
+	}
+out:
+	tx_busy = 0;
+	output_lock_release();
+}
+
+static void tx_putc(const char c)
+{
+	if (tx_head - tx_tail == TX_BUF_SIZE) {
+		while (!tx_quiet && !tx_busy && tx_head - tx_tail == TX_BUF_SIZE)
+			tx_drain(0);
+		/*
+		 * Nothing is sent when quiet, so drop the oldest. Output from
+		 * within the sending itself cannot wait for it, so the loss
+		 * is reported once sending carries on.
+		 */
+		if (tx_head - tx_tail == TX_BUF_SIZE) {
+			if (!tx_quiet)
+				tx_lost++;
+			tx_tail++;
+		}
+	}
+	tx_buf[TX_BUF_IDX(tx_head++)] = c;
+}
+
+void console_flush(void)
+{
+	tx_drain(1);
+}
+
+void console_flush_fatal(void)
+{
+	/*
+	 * Send what was recorded while quiet as well. This may be called
+	 * while sending, if that went wrong, so carry on from there.
+	 */
+	tx_quiet = 0;
+	tx_busy = 0;
+	tx_drain(1);
+}
+
+void console_set_quiet(int quiet)
+{
+	if (quiet)
+		tx_drain(1);
+	else if (tx_quiet)
+		tx_tail = tx_head;	/* what was recorded stays in the log */
+	tx_quiet = quiet;
+}
+
+int console_get_quiet(void)
+{
+	return tx_quiet;
+}
+
+void console_show_log(void)
+{
+	unsigned long i = 0;
+
+	console_flush();
+	if (tx_head > TX_BUF_SIZE)
+		i = tx_head - TX_BUF_SIZE;
+
+	/* Straight to stdout, even when quiet */
+	tx_busy = 1;
+	while (i < tx_head)
+		console_putc(stdout, tx_buf[TX_BUF_IDX(i++)]);
+	tx_busy = 0;
+}
+#else
+static inline void tx_drain(int wait) {}
+#endif
+
 int fgetc(int file)
 {
 	if (file < MAX_FILES) {
@@ -335,12 +535,30 @@ int ftstc(int file)
 
 void fputc(int file, const char c)
 {
+#if defined(CONFIG_CONSOLE_TX_BUFFER) && !defined(CONFIG_SPL_BUILD)
+	if (file == stdout) {
+		tx_putc(c);
+		tx_drain(0);
+		return;
+	}
+	/* Keep the order of stdout and stderr output */
+	tx_drain(1);
+#endif
 	if (file < MAX_FILES)
 		console_putc(file, c);
 }
 
 void fputs(int file, const char *s)
 {
+#if defined(CONFIG_CONSOLE_TX_BUFFER) && !defined(CONFIG_SPL_BUILD)
+	if (file == stdout) {
+		while (*s)
+			tx_putc(*s++);
+		tx_drain(0);
+		return;
+	}
+	tx_drain(1);
+#endif
 	if (file < MAX_FILES)
 		console_puts(file, s);
 }
@@ -377,6 +595,8 @@ int getc(void)
 		return 0;
 
 	if (gd->flags & GD_FLG_DEVINIT) {
+		/* Output is not waiting for anything else now */
+		tx_drain(1);
 		/* Get from the standard input */
 		return fgetc(stdin);
 	}
@@ -396,6 +616,7 @@ int tstc(void)
 		return 0;
 
 	if (gd->flags & GD_FLG_DEVINIT) {
+		tx_drain(0);
 		/* Test the standard input */
 		return ftstc(stdin);
 	}
@@ -469,6 +690,7 @@ void putc(const char c)
 	if (!gd->have_console)
 		return pre_console_putc(c);
 
+	output_lock_take();
 	if (gd->flags & GD_FLG_DEVINIT) {
 		/* Send to the standard output */
 		fputc(stdout, c);
@@ -477,6 +699,7 @@ void putc(const char c)
 		pre_console_putc(c);
 		serial_putc(c);
 	}
+	output_lock_release();
 }
 
 void puts(const char *s)
@@ -501,6 +724,7 @@ void puts(const char *s)
 	if (!gd->have_console)
 		return pre_console_puts(s);
 
+	output_lock_take();
 	if (gd->flags & GD_FLG_DEVINIT) {
 		/* Send to the standard output */
 		fputs(stdout, s);
@@ -509,6 +733,7 @@ void puts(const char *s)
 		pre_console_puts(s);
 		serial_puts(s);
 	}
+	output_lock_release();
 }
 
 int printf(const char *fmt, ...)
@@ -560,6 +785,8 @@ static int ctrlc_disabled = 0;	/* see disable_ctrl() */
 static int ctrlc_was_pressed = 0;
 int ctrlc(void)
 {
+	if (gd->flags & GD_FLG_DEVINIT)
+		tx_drain(0);
 #ifndef CONFIG_SANDBOX
 	if (!ctrlc_disabled && gd->have_console) {
 		if (tstc()) {
@@ -822,6 +1049,11 @@ done:
 	}
 #endif /* CONFIG_SYS_CONSOLE_ENV_OVERWRITE */
 
+#if defined(CONFIG_CONSOLE_TX_BUFFER) && !defined(CONFIG_SPL_BUILD)
+	if (getenv("quiet") != NULL)
+		console_set_quiet(1);
+#endif
+
 	gd->flags |= GD_FLG_DEVINIT;	/* device initialization completed */
 
 #if 0
@@ -898,6 +1130,11 @@ int console_init_r(void)
 		setenv(stdio_names[i], stdio_devices[i]->name);
 	}
 
+#if defined(CONFIG_CONSOLE_TX_BUFFER) && !defined(CONFIG_SPL_BUILD)
+	if (getenv("quiet") != NULL)
+		console_set_quiet(1);
+#endif
+
 	gd->flags |= GD_FLG_DEVINIT;	/* device initialization completed */
 
 #if 0
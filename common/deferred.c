@@ -0,0 +1,94 @@
+/*
+ * Deferred completion of slow hardware operations
+ *
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <deferred.h>
+#include <errno.h>
+
+static LIST_HEAD(deferred_list);
+
+void deferred_start(struct deferred *op, const char *name,
+		    int (*complete)(void *arg), void *arg)
+{
+	if (op->state != DEFERRED_IDLE)
+		list_del(&op->sibling_node);
+	op->name = name;
+	op->complete = complete;
+	op->arg = arg;
+	op->state = DEFERRED_PENDING;
+	op->ret = 0;
+	op->start_us = timer_get_us();
+	op->used_us = 0;
+	op->wait_us = 0;
+	list_add_tail(&op->sibling_node, &deferred_list);
+	debug("%s: '%s'\n", __func__, name);
+}
+
+int deferred_pending(struct deferred *op)
+{
+	return op->state == DEFERRED_PENDING;
+}
+
+int deferred_complete(struct deferred *op)
+{
+	switch (op->state) {
+	case DEFERRED_IDLE:
+		return -ENOENT;
+	case DEFERRED_DONE:
+		return op->ret;
+	}
+
+	op->used_us = timer_get_us();
+	op->ret = op->complete(op->arg);
+	op->wait_us = timer_get_us() - op->used_us;
+	op->state = DEFERRED_DONE;
+	debug("%s: '%s' returned %d after %lu us\n", __func__, op->name,
+	      op->ret, op->wait_us);
+
+	return op->ret;
+}
+
+void deferred_report(void)
+{
+	struct deferred *op;
+	ulong hidden, hidden_total = 0, wait_total = 0;
+
+	printf("Hidden us   Wait us  State    Name\n");
+	list_for_each_entry(op, &deferred_list, sibling_node) {
+		if (op->state == DEFERRED_DONE) {
+			hidden = op->used_us - op->start_us;
+			printf("%9lu %9lu  %-7s  %s\n", hidden, op->wait_us,
+			       op->ret ? "failed" : "done", op->name);
+		} else {
+			hidden = timer_get_us() - op->start_us;
+			printf("%9lu %9s  %-7s  %s\n", hidden, "-", "pending",
+			       op->name);
+		}
+		hidden_total += hidden;
+		wait_total += op->wait_us;
+	}
+	printf("%9lu %9lu  total\n", hidden_total, wait_total);
+}
+
+static int do_deferred(cmd_tbl_t *cmdtp, int flag, int argc,
+		       char * const argv[])
+{
+	deferred_report();
+
+	return 0;
+}
+
+U_BOOT_CMD(
+	deferred,	1,	1,	do_deferred,
+	"show hardware operations completed at first use",
+	"\n"
+	"    - for each operation started during init, show how long it\n"
+	"      ran alongside other work before it was needed (hidden), and\n"
+	"      how long its first use still waited for it"
+);
@@ -936,6 +936,54 @@ struct mallinfo mALLINFo();
 #include <malloc.h>
 #include <asm/io.h>
 
+#ifdef CONFIG_JOBS
+#include <jobs.h>
+
+/*
+ * Jobs on secondary CPUs may allocate memory. The allocator is built here
+ * under other names, and the public functions at the end of this file call
+ * it with a lock held.
+ */
+#undef cALLOc
+#undef fREe
+#undef mALLOc
+#undef mEMALIGn
+#undef rEALLOc
+#undef vALLOc
+#undef pvALLOc
+#undef mALLOPt
+#define cALLOc		calloc_unlocked
+#define fREe		free_unlocked
+#define mALLOc		malloc_unlocked
+#define mEMALIGn	memalign_unlocked
+#define rEALLOc		realloc_unlocked
+#define vALLOc		valloc_unlocked
+#define pvALLOc		pvalloc_unlocked
+#define mALLOPt		mallopt_unlocked
+#define malloc_trim	malloc_trim_unlocked
+#define malloc_usable_size	malloc_usable_size_unlocked
+
+static void *cALLOc(size_t n, size_t elem_size);
+static void fREe(void *mem);
+static void *mALLOc(size_t bytes);
+static void *mEMALIGn(size_t alignment, size_t bytes);
+static void *rEALLOc(void *oldmem, size_t bytes);
+static void *vALLOc(size_t bytes);
+static void *pvALLOc(size_t bytes);
+static int mALLOPt(int param_number, int value);
+static int malloc_trim(size_t pad);
+static size_t malloc_usable_size(void *mem);
+
+#ifdef DEBUG
+#undef mALLINFo
+#define mALLINFo	mallinfo_unlocked
+#define malloc_stats	malloc_stats_unlocked
+
+static struct mallinfo mALLINFo(void);
+static void malloc_stats(void);
+#endif
+#endif
+
 #ifdef DEBUG
 #if __STD_C
 static void malloc_update_mallinfo (void);
@@ -3261,6 +3309,141 @@ int mALLOPt(param_number, value) int param_number; int value;
   }
 }
 
+#ifdef CONFIG_JOBS
+static struct job_lock malloc_lock;
+
+void *malloc(size_t bytes)
+{
+	void *ptr;
+
+	job_lock(&malloc_lock);
+	ptr = malloc_unlocked(bytes);
+	job_unlock(&malloc_lock);
+
+	return ptr;
+}
+
+void free(void *mem)
+{
+	job_lock(&malloc_lock);
+	free_unlocked(mem);
+	job_unlock(&malloc_lock);
+}
+
+void *realloc(void *oldmem, size_t bytes)
+{
+	void *ptr;
+
+	job_lock(&malloc_lock);
+	ptr = realloc_unlocked(oldmem, bytes);
+	job_unlock(&malloc_lock);
+
+	return ptr;
+}
+
+void *memalign(size_t alignment, size_t bytes)
+{
+	void *ptr;
+
+	job_lock(&malloc_lock);
+	ptr = memalign_unlocked(alignment, bytes);
+	job_unlock(&malloc_lock);
+
+	return ptr;
+}
+
+void *valloc(size_t bytes)
+{
+	void *ptr;
+
+	job_lock(&malloc_lock);
+	ptr = valloc_unlocked(bytes);
+	job_unlock(&malloc_lock);
+
+	return ptr;
+}
+
+void *pvalloc(size_t bytes)
+{
+	void *ptr;
+
+	job_lock(&malloc_lock);
+	ptr = pvalloc_unlocked(bytes);
+	job_unlock(&malloc_lock);
+
+	return ptr;
+}
+
+void *calloc(size_t n, size_t elem_size)
+{
+	void *ptr;
+
+	job_lock(&malloc_lock);
+	ptr = calloc_unlocked(n, elem_size);
+	job_unlock(&malloc_lock);
+
+	return ptr;
+}
+
+#undef malloc_trim
+#undef malloc_usable_size
+
+int malloc_trim(size_t pad)
+{
+	int ret;
+
+	job_lock(&malloc_lock);
+	ret = malloc_trim_unlocked(pad);
+	job_unlock(&malloc_lock);
+
+	return ret;
+}
+
+size_t malloc_usable_size(void *mem)
+{
+	size_t size;
+
+	job_lock(&malloc_lock);
+	size = malloc_usable_size_unlocked(mem);
+	job_unlock(&malloc_lock);
+
+	return size;
+}
+
+int mallopt(int param_number, int value)
+{
+	int ret;
+
+	job_lock(&malloc_lock);
+	ret = mallopt_unlocked(param_number, value);
+	job_unlock(&malloc_lock);
+
+	return ret;
+}
+
+#ifdef DEBUG
+#undef malloc_stats
+
+struct mallinfo mallinfo(void)
+{
+	struct mallinfo info;
+
+	job_lock(&malloc_lock);
+	info = mallinfo_unlocked();
+	job_unlock(&malloc_lock);
+
+	return info;
+}
+
+void malloc_stats(void)
+{
+	job_lock(&malloc_lock);
+	malloc_stats_unlocked();
+	job_unlock(&malloc_lock);
+}
+#endif	/* DEBUG */
+#endif
+
 /*
 
 History:
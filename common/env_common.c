@@ -22,6 +22,9 @@ DECLARE_GLOBAL_DATA_PTR;
  * Default settings to be used when no valid environment is found
  */
 #include <env_default.h>
+#ifdef CONFIG_NAND_BBT_ENV
+#include <nand.h>
+#endif
 
 struct hsearch_data env_htab = {
 	.change_ok = env_flags_validate,
@@ -266,6 +269,10 @@ void env_relocate(void)
 	} else {
 		env_relocate_spec();
 	}
+#ifdef CONFIG_NAND_BBT_ENV
+	/* NAND may have been scanned to load the environment */
+	nand_env_ready();
+#endif
 }
 
 #if defined(CONFIG_AUTO_COMPLETE) && !defined(CONFIG_SPL_BUILD)
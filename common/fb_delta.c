@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <fb_delta.h>
+#include <hash.h>
+#include <malloc.h>
+#include <part.h>
+#include <div64.h>
+
+/* The manifest last checked, kept for the chunk runs that follow it */
+static struct {
+	block_dev_desc_t *dev_desc;
+	lbaint_t start;		/* first block of the partition */
+	unsigned int chunk_size;
+	unsigned int count;
+	u64 image_size;
+	u8 *digests;
+	u8 *changed;		/* bitmap, one bit per chunk */
+} delta;
+
+static void delta_free(void)
+{
+	free(delta.digests);
+	free(delta.changed);
+	delta.digests = NULL;
+	delta.changed = NULL;
+	delta.count = 0;
+}
+
+/* Bytes in chunks first .. first + n - 1, the last chunk may be short */
+static u64 chunk_bytes(unsigned int first, unsigned int n)
+{
+	u64 start = (u64)first * delta.chunk_size;
+	u64 end = start + (u64)n * delta.chunk_size;
+
+	return min(end, delta.image_size) - start;
+}
+
+static int chunk_matches(unsigned int chunk, const void *data,
+			 unsigned int len)
+{
+	u8 digest[FB_DELTA_DIGEST_SIZE];
+	int size = sizeof(digest);
+	int ret;
+
+	ret = hash_block("sha256", data, len, digest, &size);
+	if (ret)
+		return ret;
+
+	return !memcmp(digest, delta.digests + chunk * FB_DELTA_DIGEST_SIZE,
+		       FB_DELTA_DIGEST_SIZE);
+}
+
+int fb_delta_check(block_dev_desc_t *dev_desc, disk_partition_t *info,
+		   void *manifest, unsigned int size, void *buf,
+		   unsigned int buf_size)
+{
+	struct fb_delta_header *hdr = manifest;
+	unsigned int chunk_size, count, per_read, chunk, changed = 0;
+	u64 image_size;
+	lbaint_t blk, blkcnt;
+	ulong start;
+	int i, ret;
+
+	delta_free();
+	if (size < sizeof(*hdr))
+		return -EINVAL;
+	chunk_size = le32_to_cpu(hdr->chunk_size);
+	count = le32_to_cpu(hdr->chunk_count);
+	image_size = le64_to_cpu(hdr->image_size);
+
+	if (!chunk_size || chunk_size % info->blksz ||
+	    image_size % info->blksz || !image_size) {
+		error("delta chunks not aligned to %lu byte blocks\n",
+		      info->blksz);
+		return -EINVAL;
+	}
+	if (image_size > (u64)info->size * info->blksz) {
+		error("delta image too large for partition\n");
+		return -EFBIG;
+	}
+	if (count != DIV_ROUND_UP(image_size, chunk_size) ||
+	    size < sizeof(*hdr) + (u64)count * FB_DELTA_DIGEST_SIZE) {
+		error("delta manifest truncated\n");
+		return -EINVAL;
+	}
+	if (buf_size < chunk_size) {
+		error("delta chunks larger than the %u byte buffer\n",
+		      buf_size);
+		return -ENOSPC;
+	}
+
+	/* The manifest may be overwritten by the partition data */
+	delta.digests = malloc(count * FB_DELTA_DIGEST_SIZE);
+	delta.changed = calloc(1, DIV_ROUND_UP(count, 8));
+	if (!delta.digests || !delta.changed) {
+		delta_free();
+		return -ENOMEM;
+	}
+	memcpy(delta.digests, hdr + 1, count * FB_DELTA_DIGEST_SIZE);
+	delta.dev_desc = dev_desc;
+	delta.start = info->start;
+	delta.chunk_size = chunk_size;
+	delta.count = count;
+	delta.image_size = image_size;
+
+	/* Hash as many chunks as fit in the buffer after each read */
+	start = get_timer(0);
+	per_read = buf_size / chunk_size;
+	blk = info->start;
+	for (chunk = 0; chunk < count; chunk += per_read) {
+		unsigned int n = min(per_read, count - chunk);
+
+		blkcnt = lldiv(chunk_bytes(chunk, n), info->blksz);
+		if (dev_desc->block_read(dev_desc->dev, blk, blkcnt, buf) !=
+		    blkcnt) {
+			error("failed reading from device %d\n", dev_desc->dev);
+			delta_free();
+			return -EIO;
+		}
+		blk += blkcnt;
+
+		for (i = 0; i < n; i++) {
+			ret = chunk_matches(chunk + i, buf + i * chunk_size,
+					    chunk_bytes(chunk + i, 1));
+			if (ret < 0) {
+				delta_free();
+				return ret;
+			}
+			if (!ret) {
+				delta.changed[(chunk + i) / 8] |=
+					1 << ((chunk + i) % 8);
+				changed++;
+			}
+		}
+	}
+
+	printf("Delta: %u of %u chunks of %u bytes differ (%lu ms)\n",
+	       changed, count, chunk_size, get_timer(start));
+
+	return changed;
+}
+
+int fb_delta_write(block_dev_desc_t *dev_desc, disk_partition_t *info,
+		   void *data, unsigned int size)
+{
+	struct fb_delta_header *hdr = data;
+	unsigned int first, n, i;
+	lbaint_t blkcnt, blks;
+	void *buf = hdr + 1;
+	u64 len;
+	int ret;
+
+	if (!delta.digests || delta.dev_desc != dev_desc ||
+	    delta.start != info->start) {
+		error("no delta manifest for this partition\n");
+		return -ENOENT;
+	}
+	first = le32_to_cpu(hdr->first);
+	n = le32_to_cpu(hdr->chunk_count);
+	if (le32_to_cpu(hdr->chunk_size) != delta.chunk_size ||
+	    le64_to_cpu(hdr->image_size) != delta.image_size ||
+	    !n || first >= delta.count || n > delta.count - first) {
+		error("delta chunks do not match the manifest\n");
+		return -EINVAL;
+	}
+	len = chunk_bytes(first, n);
+	if (size < sizeof(*hdr) + len) {
+		error("delta chunks truncated\n");
+		return -EINVAL;
+	}
+
+	/* Check the whole run before writing any of it */
+	for (i = 0; i < n; i++) {
+		ret = chunk_matches(first + i, buf + i * delta.chunk_size,
+				    chunk_bytes(first + i, 1));
+		if (ret < 0)
+			return ret;
+		if (!ret) {
+			error("delta chunk %u does not match its digest\n",
+			      first + i);
+			return -EBADMSG;
+		}
+	}
+
+	blkcnt = lldiv(len, info->blksz);
+	blks = dev_desc->block_write(dev_desc->dev, info->start +
+				     lldiv((u64)first * delta.chunk_size,
+					   info->blksz), blkcnt, buf);
+	if (blks != blkcnt) {
+		error("failed writing to device %d\n", dev_desc->dev);
+		return -EIO;
+	}
+
+	for (i = first; i < first + n; i++)
+		delta.changed[i / 8] &= ~(1 << (i % 8));
+	printf("........ wrote chunks %u to %u (%llu bytes)\n", first,
+	       first + n - 1, len);
+
+	return 0;
+}
+
+int fb_delta_map(unsigned int first, char *str, size_t len)
+{
+	unsigned int chunk, digit;
+	int i;
+
+	if (!delta.digests)
+		return -ENOENT;
+	if (first % 4 || first > delta.count || !len)
+		return -EINVAL;
+
+	for (chunk = first; chunk < delta.count && len > 1; chunk += 4) {
+		digit = 0;
+		for (i = 0; i < 4; i++) {
+			unsigned int c = chunk + i;
+
+			if (c < delta.count &&
+			    delta.changed[c / 8] & (1 << (c % 8)))
+				digit |= 8 >> i;
+		}
+		*str++ = "0123456789abcdef"[digit];
+		len--;
+	}
+	*str = '\0';
+
+	return 0;
+}
@@ -6,10 +6,12 @@
 
 #include <config.h>
 #include <common.h>
+#include <errno.h>
 #include <fb_mmc.h>
 #include <part.h>
 #include <aboot.h>
 #include <sparse_format.h>
+#include <fb_delta.h>
 #include <mmc.h>
 
 #ifndef CONFIG_FASTBOOT_GPT_NAME
@@ -65,6 +67,33 @@ static void write_raw_image(block_dev_desc_t *dev_desc, disk_partition_t *info,
 	fastboot_okay("");
 }
 
+#ifdef CONFIG_FASTBOOT_FLASH_DELTA
+static void write_delta(block_dev_desc_t *dev_desc, disk_partition_t *info,
+		void *buffer, unsigned int download_bytes)
+{
+	int ret;
+
+	if (is_delta_manifest(buffer)) {
+		/* The digests are copied, the buffer is free for reading */
+		ret = fb_delta_check(dev_desc, info, buffer, download_bytes,
+				     buffer, CONFIG_USB_FASTBOOT_BUF_SIZE);
+		if (ret >= 0)
+			ret = 0;
+	} else {
+		ret = fb_delta_write(dev_desc, info, buffer, download_bytes);
+	}
+
+	if (ret == -ENOENT)
+		fastboot_fail("no delta manifest for partition");
+	else if (ret == -EBADMSG)
+		fastboot_fail("delta chunk does not match manifest");
+	else if (ret)
+		fastboot_fail("delta flashing failed");
+	else
+		fastboot_okay("");
+}
+#endif
+
 void fb_mmc_flash_write(const char *cmd, void *download_buffer,
 			unsigned int download_bytes, char *response)
 {
@@ -104,6 +133,14 @@ void fb_mmc_flash_write(const char *cmd, void *download_buffer,
 		return;
 	}
 
+#ifdef CONFIG_FASTBOOT_FLASH_DELTA
+	if (is_delta_manifest(download_buffer) ||
+	    is_delta_chunks(download_buffer)) {
+		write_delta(dev_desc, &info, download_buffer, download_bytes);
+		return;
+	}
+#endif
+
 	if (is_sparse_image(download_buffer))
 		write_sparse_image(dev_desc, &info, cmd, download_buffer,
 				   download_bytes);
@@ -15,8 +15,11 @@
 #include <command.h>
 #include <malloc.h>
 #include <hw_sha.h>
+#include <watchdog.h>
 #include <asm/io.h>
 #include <asm/errno.h>
+#include <asm/unaligned.h>
+#include <libfdt.h>
 #else
 #include "mkimage.h"
 #include <time.h>
@@ -272,6 +275,7 @@ static void store_result(struct hash_algo *algo, const uint8_t *sum,
 
 		addr = simple_strtoul(dest, NULL, 16);
 		buf = map_sysmem(addr, algo->digest_size);
+		hash_read_drop(buf, algo->digest_size);
 		memcpy(buf, sum, algo->digest_size);
 		unmap_sysmem(buf);
 	}
@@ -355,6 +359,355 @@ void hash_show(struct hash_algo *algo, ulong addr, ulong len, uint8_t *output)
 		printf("%02x", output[i]);
 }
 
+#ifdef CONFIG_HASH_ON_READ
+DECLARE_GLOBAL_DATA_PTR;
+
+/*
+ * When the data read is a device tree, such as a FIT image, the values of its
+ * larger properties are also hashed on their own as they go past, so that a
+ * FIT check of an image's data can use the digest of that property.
+ */
+#define HASH_READ_PARTS		8
+#define HASH_READ_PART_MIN	0x1000
+
+struct hash_read_part {
+	const char *start;
+	const char *end;
+	const char *next;	/* End of the data hashed so far */
+	void *ctx;		/* Context while the part is being hashed */
+	bool valid;		/* @digest holds the digest of the part */
+	uint8_t digest[HASH_MAX_DIGEST_SIZE];
+};
+
+static struct {
+	struct hash_algo *algo;
+	void *ctx;
+	const char *start;	/* Buffer being read into */
+	const char *next;	/* End of the data hashed so far */
+	bool active;		/* A read is being hashed */
+	bool reread;		/* Data already hashed was read again */
+	bool valid;		/* @digest holds the digest of the last read */
+	ulong len;		/* Length of the last read */
+	uint8_t digest[HASH_MAX_DIGEST_SIZE];
+	bool fdt_checked;	/* The header was looked at */
+	const char *fdt_pos;	/* Next device tree tag, NULL when done */
+	const char *fdt_end;	/* End of the structure block */
+	struct hash_read_part *cur;	/* Part being hashed */
+	int part_count;
+	struct hash_read_part parts[HASH_READ_PARTS];
+} hash_read;
+
+static int hash_read_update(void *ctx, const char *buf, ulong len)
+{
+	struct hash_algo *algo = hash_read.algo;
+	ulong chunk;
+
+	do {
+		chunk = min_t(ulong, len, algo->chunk_size);
+		if (algo->hash_update(algo, ctx, buf, chunk, 0))
+			return -EIO;
+		buf += chunk;
+		len -= chunk;
+		WATCHDOG_RESET();
+	} while (len);
+
+	return 0;
+}
+
+static int hash_read_digest(void *ctx, uint8_t *digest)
+{
+	struct hash_algo *algo = hash_read.algo;
+	uint32_t crc;
+
+	if (algo->hash_finish(algo, ctx, digest, HASH_MAX_DIGEST_SIZE))
+		return -EIO;
+
+	/* The progressive crc32 is in CPU order, hash_block()'s big-endian */
+	if (algo->hash_finish == hash_finish_crc32) {
+		memcpy(&crc, digest, sizeof(crc));
+		crc = cpu_to_be32(crc);
+		memcpy(digest, &crc, sizeof(crc));
+	}
+
+	return 0;
+}
+
+/* Stop looking for parts, leaving those already hashed */
+static void hash_read_parts_stop(void)
+{
+	struct hash_read_part *part = hash_read.cur;
+
+	/* Finishing is the only way to free the context */
+	if (part)
+		hash_read.algo->hash_finish(hash_read.algo, part->ctx,
+					    part->digest,
+					    sizeof(part->digest));
+	hash_read.cur = NULL;
+	hash_read.fdt_pos = NULL;
+}
+
+static void hash_read_fdt_check(void)
+{
+	const struct fdt_header *fdt = (const void *)hash_read.start;
+	ulong size;
+
+	if (hash_read.next - hash_read.start < sizeof(*fdt))
+		return;
+	hash_read.fdt_checked = true;
+	if (fdt_check_header(fdt))
+		return;
+
+	size = fdt_version(fdt) >= 17 ? fdt_size_dt_struct(fdt) :
+	       fdt_totalsize(fdt) - fdt_off_dt_struct(fdt);
+	if (fdt_off_dt_struct(fdt) + size > fdt_totalsize(fdt))
+		return;
+	hash_read.fdt_pos = hash_read.start + fdt_off_dt_struct(fdt);
+	hash_read.fdt_end = hash_read.fdt_pos + size;
+}
+
+/* Tags are aligned from the start of the device tree, not in memory */
+static const char *hash_read_fdt_align(const char *pos)
+{
+	return hash_read.start + ALIGN(pos - hash_read.start, FDT_TAGSIZE);
+}
+
+/* Walk the device tree read so far, hashing large property values */
+static void hash_read_parts(void)
+{
+	const char *next = hash_read.next;
+	struct hash_read_part *part;
+	const char *pos;
+	ulong len;
+
+	if (!hash_read.fdt_checked)
+		hash_read_fdt_check();
+
+	for (;;) {
+		part = hash_read.cur;
+		if (part) {
+			len = min(next, part->end) - part->next;
+			if (len && hash_read_update(part->ctx, part->next, len))
+				goto err;
+			part->next += len;
+			if (part->next < part->end)
+				return;
+			hash_read.cur = NULL;
+			if (hash_read_digest(part->ctx, part->digest))
+				goto err;
+			part->valid = true;
+		}
+
+		pos = hash_read.fdt_pos;
+		if (!pos || pos + FDT_TAGSIZE > next)
+			return;
+		switch (get_unaligned_be32(pos)) {
+		case FDT_BEGIN_NODE:
+			for (pos += FDT_TAGSIZE; pos < next && *pos; pos++)
+				;
+			if (pos == next)
+				return;	/* the name is not all here yet */
+			pos = hash_read_fdt_align(pos + 1);
+			break;
+		case FDT_END_NODE:
+		case FDT_NOP:
+			pos += FDT_TAGSIZE;
+			break;
+		case FDT_PROP:
+			if (pos + sizeof(struct fdt_property) > next)
+				return;
+			len = get_unaligned_be32(pos + FDT_TAGSIZE);
+			pos += sizeof(struct fdt_property);
+			if (len > hash_read.fdt_end - pos) {
+				hash_read_parts_stop();
+				return;
+			}
+			if (len >= HASH_READ_PART_MIN &&
+			    hash_read.part_count < HASH_READ_PARTS) {
+				part = &hash_read.parts[hash_read.part_count];
+				if (hash_read.algo->hash_init(hash_read.algo,
+							      &part->ctx))
+					goto err;
+				hash_read.part_count++;
+				part->start = pos;
+				part->next = pos;
+				part->end = pos + len;
+				part->valid = false;
+				hash_read.cur = part;
+			}
+			pos = hash_read_fdt_align(pos + len);
+			break;
+		default:
+			/* FDT_END, or not a device tree after all */
+			hash_read.fdt_pos = NULL;
+			continue;
+		}
+		hash_read.fdt_pos = pos < hash_read.fdt_end ? pos : NULL;
+	}
+
+err:
+	hash_read_parts_stop();
+	hash_read.part_count = 0;
+}
+
+int hash_read_start(const char *algo_name, void *buf)
+{
+	struct hash_algo *algo;
+	int ret;
+
+	hash_read_stop();
+	if (!algo_name)
+		return 0;
+	ret = hash_progressive_lookup_algo(algo_name, &algo);
+	if (ret) {
+		printf("Unknown hash algorithm '%s'\n", algo_name);
+		return ret;
+	}
+	if (algo->hash_init(algo, &hash_read.ctx))
+		return -ENOMEM;
+
+	hash_read.algo = algo;
+	hash_read.start = buf;
+	hash_read.next = buf;
+	hash_read.reread = false;
+	hash_read.fdt_checked = false;
+	hash_read.active = true;
+
+	return 0;
+}
+
+void hash_read_data(const void *buf, ulong len)
+{
+	const char *ptr = buf;
+
+	/* Nothing is hashed before relocation */
+	if (!(gd->flags & GD_FLG_RELOC))
+		return;
+	if (!hash_read.active) {
+		hash_read_drop(buf, len);
+		return;
+	}
+
+	if (ptr == hash_read.next && !hash_read.reread) {
+		if (hash_read_update(hash_read.ctx, ptr, len)) {
+			/* The context is gone, so give up */
+			hash_read.active = false;
+			hash_read_parts_stop();
+			hash_read.part_count = 0;
+			return;
+		}
+		hash_read.next += len;
+		hash_read_parts();
+	} else if (ptr < hash_read.next && ptr + len > hash_read.start) {
+		hash_read.reread = true;
+	}
+}
+
+int hash_read_finish(ulong len)
+{
+	struct hash_algo *algo = hash_read.algo;
+	const char *end = hash_read.start + len;
+
+	if (!hash_read.active)
+		return -ENOENT;
+	hash_read.active = false;
+
+	/* What was hashed on the way may not be what is in memory now */
+	if (hash_read.reread || hash_read.next > end) {
+		if (algo->hash_finish(algo, hash_read.ctx, hash_read.digest,
+				      sizeof(hash_read.digest)) ||
+		    algo->hash_init(algo, &hash_read.ctx))
+			return -EIO;
+		hash_read.next = hash_read.start;
+		hash_read_parts_stop();
+		hash_read.part_count = 0;
+		hash_read.fdt_checked = false;
+	}
+	debug("%s: %lu of %lu bytes hashed as they were read\n", __func__,
+	      (ulong)(hash_read.next - hash_read.start), len);
+
+	if ((hash_read.next < end &&
+	     hash_read_update(hash_read.ctx, hash_read.next,
+			      end - hash_read.next)) ||
+	    hash_read_digest(hash_read.ctx, hash_read.digest))
+		return -EIO;
+
+	/* Parts still open are finished from memory too */
+	hash_read.next = end;
+	hash_read_parts();
+	hash_read_parts_stop();
+	hash_read.len = len;
+	hash_read.valid = true;
+
+	return 0;
+}
+
+void hash_read_stop(void)
+{
+	/* Finishing is the only way to free the context */
+	if (hash_read.active)
+		hash_read.algo->hash_finish(hash_read.algo, hash_read.ctx,
+					    hash_read.digest,
+					    sizeof(hash_read.digest));
+	hash_read_parts_stop();
+	hash_read.active = false;
+	hash_read.valid = false;
+	hash_read.part_count = 0;
+}
+
+void hash_read_drop(const void *buf, ulong len)
+{
+	const char *ptr = buf;
+	struct hash_read_part *part;
+	int i;
+
+	if (hash_read.valid && ptr < hash_read.start + hash_read.len &&
+	    ptr + len > hash_read.start)
+		hash_read.valid = false;
+	for (i = 0; i < hash_read.part_count; i++) {
+		part = &hash_read.parts[i];
+		if (ptr < part->end && ptr + len > part->start)
+			part->valid = false;
+	}
+}
+
+int hash_read_lookup(const char *algo_name, const void *data, ulong len,
+		     uint8_t *output, int *output_size)
+{
+	const uint8_t *digest = NULL;
+	struct hash_read_part *part;
+	int i;
+
+	if (hash_read.active || !hash_read.algo ||
+	    strcmp(hash_read.algo->name, algo_name))
+		return -ENOENT;
+	if (hash_read.valid && hash_read.start == data &&
+	    hash_read.len == len)
+		digest = hash_read.digest;
+	for (i = 0; !digest && i < hash_read.part_count; i++) {
+		part = &hash_read.parts[i];
+		if (part->valid && part->start == data &&
+		    part->end - part->start == len)
+			digest = part->digest;
+	}
+	if (!digest)
+		return -ENOENT;
+
+	memcpy(output, digest, hash_read.algo->digest_size);
+	if (output_size)
+		*output_size = hash_read.algo->digest_size;
+
+	return 0;
+}
+
+void hash_read_setenv(const char *varname, const void *data, ulong len)
+{
+	if (hash_read.valid && hash_read.start == data && hash_read.len == len)
+		store_result(hash_read.algo, hash_read.digest, varname, 1);
+	else
+		setenv(varname, NULL);
+}
+#endif
+
 int hash_block(const char *algo_name, const void *data, unsigned int len,
 	       uint8_t *output, int *output_size)
 {
@@ -372,7 +725,8 @@ int hash_block(const char *algo_name, const void *data, unsigned int len,
 	}
 	if (output_size)
 		*output_size = algo->digest_size;
-	algo->hash_func_ws(data, len, output, algo->chunk_size);
+	if (hash_read_lookup(algo_name, data, len, output, NULL))
+		algo->hash_func_ws(data, len, output, algo->chunk_size);
 
 	return 0;
 }
@@ -406,7 +760,8 @@ int hash_command(const char *algo_name, int flags, cmd_tbl_t *cmdtp, int flag,
 		}
 
 		buf = map_sysmem(addr, len);
-		algo->hash_func_ws(buf, len, output, algo->chunk_size);
+		if (hash_read_lookup(algo->name, buf, len, output, NULL))
+			algo->hash_func_ws(buf, len, output, algo->chunk_size);
 		unmap_sysmem(buf);
 
 		/* Try to avoid code bloat when verify is not needed */
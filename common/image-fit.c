@@ -16,6 +16,8 @@
 #else
 #include <common.h>
 #include <errno.h>
+#include <jobs.h>
+#include <malloc.h>
 #include <asm/io.h>
 DECLARE_GLOBAL_DATA_PTR;
 #endif /* !USE_HOSTCC*/
@@ -262,6 +264,7 @@ static void fit_image_print_data(const void *fit, int noffset, const char *p,
 	const char *keyname;
 	uint8_t *value;
 	int value_len;
+	ulong segment_size;
 	char *algo;
 	int required;
 	int ret, i;
@@ -282,6 +285,10 @@ static void fit_image_print_data(const void *fit, int noffset, const char *p,
 		printf(" (required)");
 	printf("\n");
 
+	if (!fit_image_hash_get_segment_size(fit, noffset, &segment_size) &&
+	    segment_size)
+		printf("%s  %s segment: %lu bytes\n", p, type, segment_size);
+
 	ret = fit_image_hash_get_value(fit, noffset, &value,
 					&value_len);
 	printf("%s  %s value:   ", p, type);
@@ -850,6 +857,39 @@ static int fit_image_hash_get_ignore(const void *fit, int noffset, int *ignore)
 	return 0;
 }
 
+/**
+ * fit_image_hash_get_segment_size - get hash segment size
+ * @fit: pointer to the FIT format image header
+ * @noffset: hash node offset
+ * @segment_size: pointer to a ulong, will hold the segment size
+ *
+ * fit_image_hash_get_segment_size() finds the segment size property in a
+ * given hash node. If it is present, the hash value is a hash of the
+ * hashes of each segment of the image data, see calculate_segment_hash().
+ *
+ * returns:
+ *     0, on success (segment size is 0 if the property is not present)
+ *     -1, on invalid property
+ */
+int fit_image_hash_get_segment_size(const void *fit, int noffset,
+				    ulong *segment_size)
+{
+	const fdt32_t *value;
+	int len;
+
+	*segment_size = 0;
+	value = fdt_getprop(fit, noffset, FIT_SEGMENT_SIZE_PROP, &len);
+	if (value == NULL)
+		return 0;
+	if (len != sizeof(*value) || !fdt32_to_cpu(*value)) {
+		fit_get_debug(fit, noffset, FIT_SEGMENT_SIZE_PROP, len);
+		return -1;
+	}
+	*segment_size = fdt32_to_cpu(*value);
+
+	return 0;
+}
+
 /**
  * fit_set_timestamp - set node timestamp property
  * @fit: pointer to the FIT format image header
@@ -925,6 +965,313 @@ int calculate_hash(const void *data, int data_len, const char *algo,
 	return 0;
 }
 
+/* Hashes of the segments of some data, see calculate_segment_hash() */
+struct fit_segments {
+	const void *data;
+	int data_len;
+	ulong segment_size;
+	const char *algo;
+	uint8_t *list;		/* FIT_MAX_HASH_LEN bytes per segment */
+	int count;
+	int step;		/* hash every @step'th segment */
+};
+
+static int fit_hash_segment_range(struct fit_segments *seg, int first)
+{
+	const uint8_t *data = seg->data;
+	ulong len;
+	int value_len;
+	int i;
+
+	for (i = first; i < seg->count; i += seg->step) {
+		len = seg->data_len - i * seg->segment_size;
+		if (len > seg->segment_size)
+			len = seg->segment_size;
+		if (calculate_hash(data + i * seg->segment_size, len,
+				   seg->algo, seg->list + i * FIT_MAX_HASH_LEN,
+				   &value_len))
+			return -1;
+	}
+
+	return 0;
+}
+
+#if !defined(USE_HOSTCC) && defined(CONFIG_JOBS)
+struct fit_segment_job {
+	struct job job;
+	struct fit_segments *seg;
+	int first;
+};
+
+static int fit_segment_job(void *arg)
+{
+	struct fit_segment_job *sjob = arg;
+
+	return fit_hash_segment_range(sjob->seg, sjob->first);
+}
+
+/* Share the segments out between this CPU and any idle ones */
+static int fit_hash_segments(struct fit_segments *seg)
+{
+	struct fit_segment_job sjobs[JOB_MAX_CPUS];
+	int i, ret;
+
+	seg->step = min(jobs_cpus() + 1, seg->count);
+	if (seg->step <= 1) {
+		seg->step = 1;
+		return fit_hash_segment_range(seg, 0);
+	}
+	for (i = 1; i < seg->step; i++) {
+		sjobs[i].seg = seg;
+		sjobs[i].first = i;
+		job_init(&sjobs[i].job, "fit segments", fit_segment_job,
+			 &sjobs[i]);
+		job_start(&sjobs[i].job);
+	}
+	ret = fit_hash_segment_range(seg, 0);
+	for (i = 1; i < seg->step; i++)
+		ret |= job_wait(&sjobs[i].job);
+
+	return ret;
+}
+#else
+static int fit_hash_segments(struct fit_segments *seg)
+{
+	seg->step = 1;
+
+	return fit_hash_segment_range(seg, 0);
+}
+#endif
+
+/**
+ * calculate_segment_hash - calculate a hash over segments of the input data
+ * @data: pointer to the input data
+ * @data_len: data length
+ * @segment_size: segment size in bytes, or 0 for a plain hash
+ * @algo: requested hash algorithm
+ * @value: pointer to the char, will hold hash value data (caller must
+ * allocate enough free space)
+ * value_len: length of the calculated hash
+ *
+ * calculate_segment_hash() splits the input data into segments of
+ * @segment_size bytes (the last one may be shorter), hashes each segment
+ * and then hashes the list of segment hashes. The segments do not depend on
+ * each other, so U-Boot hashes them on as many CPUs as it has running.
+ * With a @segment_size of 0 this is the same as calculate_hash().
+ *
+ * returns:
+ *     0, on success
+ *    -1, when algo is unsupported or memory is short
+ */
+int calculate_segment_hash(const void *data, int data_len, ulong segment_size,
+			   const char *algo, uint8_t *value, int *value_len)
+{
+	struct fit_segments seg;
+	int i, ret;
+
+	if (!segment_size)
+		return calculate_hash(data, data_len, algo, value, value_len);
+
+	/* Find the digest length, which is the same for every segment */
+	if (calculate_hash(data, 0, algo, value, value_len))
+		return -1;
+
+	seg.data = data;
+	seg.data_len = data_len;
+	seg.segment_size = segment_size;
+	seg.algo = algo;
+	seg.count = (data_len + segment_size - 1) / segment_size;
+	seg.list = malloc((seg.count ? seg.count : 1) * FIT_MAX_HASH_LEN);
+	if (!seg.list)
+		return -1;
+
+	ret = fit_hash_segments(&seg);
+	if (!ret) {
+		/* Pack the segment hashes together and hash those */
+		for (i = 1; i < seg.count; i++)
+			memmove(seg.list + i * *value_len,
+				seg.list + i * FIT_MAX_HASH_LEN, *value_len);
+		ret = calculate_hash(seg.list, seg.count * *value_len, algo,
+				     value, value_len);
+	}
+	free(seg.list);
+
+	return ret;
+}
+
+#if !defined(USE_HOSTCC) && defined(CONFIG_JOBS)
+/*
+ * Hashes worked out ahead of time on other CPUs, for example while the boot
+ * CPU checks a configuration's signature. fit_image_check_hash() picks them
+ * up by the data, length and algorithm they cover. Anything which changes
+ * image data must drop the hashes of that data first.
+ */
+#define FIT_HASH_AHEAD_MAX	8
+
+struct fit_hash_ahead {
+	struct job job;
+	int valid;		/* started and not yet collected */
+	const void *data;
+	size_t size;
+	const char *algo;
+	ulong segment_size;
+	uint8_t value[FIT_MAX_HASH_LEN];
+	int value_len;
+};
+
+static struct fit_hash_ahead hash_ahead[FIT_HASH_AHEAD_MAX];
+static int hash_ahead_count;
+
+static int fit_hash_ahead_job(void *arg)
+{
+	struct fit_hash_ahead *ahead = arg;
+
+	return calculate_segment_hash(ahead->data, ahead->size,
+				      ahead->segment_size, ahead->algo,
+				      ahead->value, &ahead->value_len);
+}
+
+/* Returns what the job returned; entries stay put as jobs point at them */
+static int fit_hash_ahead_remove(struct fit_hash_ahead *ahead)
+{
+	ahead->valid = 0;
+
+	return job_wait(&ahead->job);
+}
+
+/* Start hashing an image's data on other CPUs, as far as there is room */
+static void fit_hash_ahead_image(const void *fit, int image_noffset)
+{
+	struct fit_hash_ahead *ahead;
+	const void *data;
+	size_t size;
+	ulong segment_size;
+	char *algo;
+	int noffset, ignore;
+
+	if (!jobs_cpus() || fit_image_get_data(fit, image_noffset, &data,
+					       &size))
+		return;
+
+	fdt_for_each_subnode(fit, noffset, image_noffset) {
+		const char *name = fit_get_name(fit, noffset, NULL);
+
+		if (strncmp(name, FIT_HASH_NODENAME,
+			    strlen(FIT_HASH_NODENAME)))
+			continue;
+		if (hash_ahead_count == FIT_HASH_AHEAD_MAX)
+			return;
+		if (fit_image_hash_get_algo(fit, noffset, &algo) ||
+		    fit_image_hash_get_segment_size(fit, noffset,
+						    &segment_size))
+			continue;
+		if (IMAGE_ENABLE_IGNORE) {
+			fit_image_hash_get_ignore(fit, noffset, &ignore);
+			if (ignore)
+				continue;
+		}
+
+		ahead = &hash_ahead[hash_ahead_count++];
+		ahead->valid = 1;
+		ahead->data = data;
+		ahead->size = size;
+		ahead->algo = algo;
+		ahead->segment_size = segment_size;
+		job_init(&ahead->job, name, fit_hash_ahead_job, ahead);
+		job_start(&ahead->job);
+	}
+}
+
+/* Start hashing the images a configuration boots */
+static void fit_hash_ahead_config(const void *fit, int cfg_noffset)
+{
+	static const char * const props[] = {
+		FIT_KERNEL_PROP, FIT_RAMDISK_PROP, FIT_FDT_PROP,
+	};
+	int noffset, i;
+
+	fit_image_hash_flush();
+	for (i = 0; i < ARRAY_SIZE(props); i++) {
+		noffset = fit_conf_get_prop_node(fit, cfg_noffset, props[i]);
+		if (noffset >= 0)
+			fit_hash_ahead_image(fit, noffset);
+	}
+}
+
+/* Collect a hash worked out ahead, returning -ENOENT if there is none */
+static int fit_hash_ahead_get(const void *data, size_t size, const char *algo,
+			      ulong segment_size, uint8_t *value,
+			      int *value_len)
+{
+	struct fit_hash_ahead *ahead;
+	int ret;
+
+	for (ahead = hash_ahead; ahead != hash_ahead + hash_ahead_count;
+	     ahead++) {
+		if (!ahead->valid || ahead->data != data ||
+		    ahead->size != size ||
+		    ahead->segment_size != segment_size ||
+		    strcmp(ahead->algo, algo))
+			continue;
+		ret = fit_hash_ahead_remove(ahead);
+		if (ret)
+			return -ENOENT;
+		memcpy(value, ahead->value, ahead->value_len);
+		*value_len = ahead->value_len;
+
+		return 0;
+	}
+
+	return -ENOENT;
+}
+
+/* Drop hashes of data which overlaps the given range */
+static void fit_hash_ahead_drop(const void *start, size_t len)
+{
+	struct fit_hash_ahead *ahead;
+
+	for (ahead = hash_ahead; ahead != hash_ahead + hash_ahead_count;
+	     ahead++) {
+		if (ahead->valid &&
+		    (const char *)ahead->data < (const char *)start + len &&
+		    (const char *)ahead->data + ahead->size >
+		    (const char *)start)
+			fit_hash_ahead_remove(ahead);
+	}
+}
+
+void fit_image_hash_flush(void)
+{
+	struct fit_hash_ahead *ahead;
+
+	for (ahead = hash_ahead; ahead != hash_ahead + hash_ahead_count;
+	     ahead++) {
+		if (ahead->valid)
+			fit_hash_ahead_remove(ahead);
+	}
+	hash_ahead_count = 0;
+}
+#else
+static inline void fit_hash_ahead_image(const void *fit, int image_noffset)
+{
+}
+
+static inline void fit_hash_ahead_config(const void *fit, int cfg_noffset)
+{
+}
+
+static inline int fit_hash_ahead_get(const void *data, size_t size,
+				     const char *algo, ulong segment_size,
+				     uint8_t *value, int *value_len)
+{
+	return -ENOENT;
+}
+
+static inline void fit_hash_ahead_drop(const void *start, size_t len)
+{
+}
+#endif
+
 static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 				size_t size, char **err_msgp)
 {
@@ -933,6 +1280,7 @@ static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 	char *algo;
 	uint8_t *fit_value;
 	int fit_value_len;
+	ulong segment_size;
 	int ignore;
 
 	*err_msgp = NULL;
@@ -957,7 +1305,19 @@ static int fit_image_check_hash(const void *fit, int noffset, const void *data,
 		return -1;
 	}
 
-	if (calculate_hash(data, size, algo, value, &value_len)) {
+	if (fit_image_hash_get_segment_size(fit, noffset, &segment_size)) {
+		*err_msgp = "Can't get hash segment size property";
+		return -1;
+	}
+
+	/* Data which was hashed as it was read need not be gone over again */
+	if (!segment_size &&
+	    !hash_read_lookup(algo, data, size, value, &value_len)) {
+		debug("%s: hashed as it was read\n", __func__);
+	} else if (fit_hash_ahead_get(data, size, algo, segment_size, value,
+				      &value_len) &&
+		   calculate_segment_hash(data, size, segment_size, algo,
+					  value, &value_len)) {
 		*err_msgp = "Unsupported hash algorithm";
 		return -1;
 	}
@@ -1076,6 +1436,11 @@ int fit_all_image_verify(const void *fit)
 		return 0;
 	}
 
+	/* Let other CPUs work on the images while they are checked in turn */
+	fit_image_hash_flush();
+	fdt_for_each_subnode(fit, noffset, images_noffset)
+		fit_hash_ahead_image(fit, noffset);
+
 	/* Process all image subnodes, check hashes for each */
 	printf("## Checking hash(es) for FIT Image at %08lx ...\n",
 	       (ulong)fit);
@@ -1091,11 +1456,14 @@ int fit_all_image_verify(const void *fit)
 			printf("   Hash(es) for Image %u (%s): ", count++,
 			       fit_get_name(fit, noffset, NULL));
 
-			if (!fit_image_verify(fit, noffset))
+			if (!fit_image_verify(fit, noffset)) {
+				fit_image_hash_flush();
 				return 0;
+			}
 			printf("\n");
 		}
 	}
+	fit_image_hash_flush();
 	return 1;
 }
 
@@ -1589,6 +1957,8 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 		if (image_type == IH_TYPE_KERNEL) {
 			/* Remember (and possibly verify) this config */
 			images->fit_uname_cfg = fit_uname_config;
+			if (images->verify)
+				fit_hash_ahead_config(fit, cfg_noffset);
 			if (IMAGE_ENABLE_VERIFY && images->verify) {
 				puts("   Verifying Hash Integrity ... ");
 				if (fit_config_verify(fit, cfg_noffset)) {
@@ -1714,6 +2084,8 @@ int fit_image_load(bootm_headers_t *images, ulong addr,
 		       prop_name, data, load);
 
 		dst = map_sysmem(load, len);
+		fit_hash_ahead_drop(dst, len);
+		hash_read_drop(dst, len);
 		memmove(dst, buf, len);
 		data = load;
 	}
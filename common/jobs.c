@@ -0,0 +1,311 @@
+/*
+ * Running independent work on secondary CPUs
+ *
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <jobs.h>
+#include <malloc.h>
+#include <watchdog.h>
+#include <asm/io.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Time allowed for a secondary CPU to start or stop */
+#define JOB_CPU_TIMEOUT_MS	100
+
+static struct job_cpu *cpus;
+static int nr_cpus;		/* secondary CPUs in @cpus */
+static int jobs_active;		/* secondary CPUs may be running */
+
+__weak int arch_job_cpus(void)
+{
+	return 0;
+}
+
+__weak int arch_job_cpu_start(struct job_cpu *cpu)
+{
+	return -ENOSYS;
+}
+
+__weak void arch_job_cpu_stop(struct job_cpu *cpu)
+{
+}
+
+__weak int arch_job_cpu_wait_off(struct job_cpu *cpu)
+{
+	return 0;
+}
+
+__weak ulong arch_job_cpu_id(void)
+{
+	return 0;
+}
+
+__weak void arch_job_idle(void)
+{
+}
+
+__weak void arch_job_kick(void)
+{
+}
+
+/* Nothing here may be touched before relocation, when .bss is not set up */
+static int jobs_running(void)
+{
+	return (gd->flags & GD_FLG_RELOC) && jobs_active;
+}
+
+int job_cpu(void)
+{
+	ulong id;
+	int i;
+
+	if (!jobs_running())
+		return 0;
+	id = arch_job_cpu_id();
+	for (i = 0; i < nr_cpus; i++) {
+		if (cpus[i].running && cpus[i].id == id)
+			return cpus[i].index;
+	}
+
+	return 0;
+}
+
+/*
+ * Lamport's bakery algorithm: each CPU takes a ticket one higher than any it
+ * sees, and the lowest ticket goes first. It needs only ordered loads and
+ * stores, so it works on secondary CPUs which run with caches and the MMU
+ * off, where exclusive access instructions may not.
+ */
+void job_lock(struct job_lock *lock)
+{
+	unsigned int ticket = 0;
+	int me, i;
+
+	if (!jobs_running())
+		return;
+	me = job_cpu();
+	if (lock->owner == me + 1) {
+		lock->depth++;
+		return;
+	}
+
+	lock->choosing[me] = 1;
+	mb();
+	for (i = 0; i <= nr_cpus; i++) {
+		if (lock->number[i] > ticket)
+			ticket = lock->number[i];
+	}
+	lock->number[me] = ++ticket;
+	mb();
+	lock->choosing[me] = 0;
+	mb();
+
+	for (i = 0; i <= nr_cpus; i++) {
+		while (lock->choosing[i])
+			arch_job_idle();
+		while (lock->number[i] && (lock->number[i] < ticket ||
+		       (lock->number[i] == ticket && i < me)))
+			arch_job_idle();
+	}
+	mb();
+	lock->owner = me + 1;
+	lock->depth = 1;
+}
+
+void job_unlock(struct job_lock *lock)
+{
+	int me;
+
+	if (!jobs_running())
+		return;
+	me = job_cpu();
+	if (lock->owner != me + 1 || --lock->depth)
+		return;
+	lock->owner = 0;
+	mb();
+	lock->number[me] = 0;
+	mb();
+}
+
+void job_cpu_main(struct job_cpu *cpu)
+{
+	struct job *job;
+
+	cpu->running = 1;
+	mb();
+	arch_job_kick();
+
+	while (!cpu->stop) {
+		job = cpu->job;
+		if (!job) {
+			arch_job_idle();
+			continue;
+		}
+		job->cpu = cpu->index;
+		job->ret = job->func(job->arg);
+		mb();
+		job->state = JOB_DONE;
+		cpu->job = NULL;
+		mb();
+		arch_job_kick();
+	}
+
+	cpu->running = 0;
+	mb();
+	arch_job_kick();
+}
+
+/* Wait for @cond to become true, giving up after JOB_CPU_TIMEOUT_MS */
+#define job_wait_for(cond) ({ \
+	ulong __start = get_timer(0); \
+	int __ret = 0; \
+	\
+	while (!(cond)) { \
+		if (get_timer(__start) > JOB_CPU_TIMEOUT_MS) { \
+			__ret = -ETIMEDOUT; \
+			break; \
+		} \
+		arch_job_idle(); \
+	} \
+	__ret; \
+})
+
+int jobs_init(void)
+{
+	struct job_cpu *cpu;
+	int count, started = 0;
+
+	count = min(arch_job_cpus(), JOB_MAX_CPUS - 1);
+	if (count <= 0)
+		return 0;
+	cpus = calloc(count, sizeof(*cpus));
+	if (!cpus)
+		return -ENOMEM;
+	nr_cpus = count;
+	jobs_active = 1;
+
+	for (cpu = cpus; cpu != cpus + count; cpu++) {
+		cpu->index = cpu - cpus + 1;
+		if (arch_job_cpu_start(cpu)) {
+			debug("%s: CPU %d not started\n", __func__, cpu->index);
+			continue;
+		}
+		if (job_wait_for(cpu->running)) {
+			printf("Jobs: CPU %d did not start\n", cpu->index);
+			continue;
+		}
+		started++;
+	}
+	debug("%s: %d of %d CPUs running\n", __func__, started, count);
+
+	/*
+	 * A CPU which never came up may yet read @cpus, so that stays. If
+	 * none came up there is nothing to lock against.
+	 */
+	if (!started)
+		jobs_active = 0;
+
+	return 0;
+}
+
+void jobs_stop(void)
+{
+	struct job_cpu *cpu;
+
+	if (!jobs_running())
+		return;
+
+	for (cpu = cpus; cpu != cpus + nr_cpus; cpu++) {
+		while (cpu->job) {
+			WATCHDOG_RESET();
+			arch_job_idle();
+		}
+	}
+
+	for (cpu = cpus; cpu != cpus + nr_cpus; cpu++) {
+		if (!cpu->running)
+			continue;
+		cpu->stop = 1;
+		mb();
+		arch_job_kick();
+		if (job_wait_for(!cpu->running) ||
+		    arch_job_cpu_wait_off(cpu))
+			printf("Jobs: CPU %d did not stop\n", cpu->index);
+	}
+	jobs_active = 0;
+}
+
+int jobs_cpus(void)
+{
+	int i, count = 0;
+
+	if (!jobs_running())
+		return 0;
+	for (i = 0; i < nr_cpus; i++) {
+		if (cpus[i].running && !cpus[i].stop)
+			count++;
+	}
+
+	return count;
+}
+
+void job_init(struct job *job, const char *name, int (*func)(void *arg),
+	      void *arg)
+{
+	job->name = name;
+	job->func = func;
+	job->arg = arg;
+	job->state = JOB_IDLE;
+	job->ret = 0;
+	job->cpu = 0;
+}
+
+int job_start(struct job *job)
+{
+	struct job_cpu *cpu;
+
+	if (job->state == JOB_RUNNING)
+		return -EBUSY;
+	job->state = JOB_RUNNING;
+
+	/* Only the boot CPU hands out jobs; a job's own jobs run in place */
+	if (jobs_running() && !job_cpu()) {
+		for (cpu = cpus; cpu != cpus + nr_cpus; cpu++) {
+			if (!cpu->running || cpu->stop || cpu->job)
+				continue;
+			debug("%s: '%s' on CPU %d\n", __func__, job->name,
+			      cpu->index);
+			mb();
+			cpu->job = job;
+			mb();
+			arch_job_kick();
+			return 0;
+		}
+	}
+
+	job->cpu = job_cpu();
+	job->ret = job->func(job->arg);
+	job->state = JOB_DONE;
+
+	return 0;
+}
+
+int job_wait(struct job *job)
+{
+	if (job->state == JOB_IDLE)
+		return -ENOENT;
+	while (job->state == JOB_RUNNING) {
+		WATCHDOG_RESET();
+		arch_job_idle();
+	}
+	mb();
+	job->state = JOB_IDLE;
+
+	return job->ret;
+}
@@ -84,5 +84,7 @@ void main_loop(void)
 
 	autoboot_command(s);
 
+	/* Quiet boot is over, show the prompt */
+	console_set_quiet(0);
 	cli_loop();
 }
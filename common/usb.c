@@ -337,13 +337,16 @@ static int usb_parse_config(struct usb_device *dev,
 			unsigned char *buffer, int cfgno)
 {
 	struct usb_descriptor_header *head;
-	int index, ifno, epno, curr_if_num;
+	int index, ifno, epno, curr_if_num, curr_alt, curr_protocol, prev_type;
 	u16 ep_wMaxPacketSize;
 	struct usb_interface *if_desc = NULL;
 
 	ifno = -1;
 	epno = -1;
 	curr_if_num = -1;
+	curr_alt = 0;
+	curr_protocol = 0;
+	prev_type = USB_DT_CONFIG;
 
 	dev->configno = cfgno;
 	head = (struct usb_descriptor_header *) &buffer[0];
@@ -391,6 +394,8 @@ static int usb_parse_config(struct usb_device *dev,
 					USB_DT_INTERFACE_SIZE);
 				if_desc->no_of_ep = 0;
 				if_desc->num_altsetting = 1;
+				memset(if_desc->ep_pipe_id, '\0',
+				       sizeof(if_desc->ep_pipe_id));
 				curr_if_num =
 				     if_desc->desc.bInterfaceNumber;
 			} else {
@@ -400,6 +405,10 @@ static int usb_parse_config(struct usb_device *dev,
 					if_desc->num_altsetting++;
 				}
 			}
+			curr_alt = ((struct usb_interface_descriptor *)
+				    head)->bAlternateSetting;
+			curr_protocol = ((struct usb_interface_descriptor *)
+					 head)->bInterfaceProtocol;
 			break;
 		case USB_DT_ENDPOINT:
 			if (head->bLength != USB_DT_ENDPOINT_SIZE) {
@@ -427,6 +436,8 @@ static int usb_parse_config(struct usb_device *dev,
 			if_desc->no_of_ep++;
 			memcpy(&if_desc->ep_desc[epno], head,
 				USB_DT_ENDPOINT_SIZE);
+			if_desc->ep_altsetting[epno] = curr_alt;
+			if_desc->ep_protocol[epno] = curr_protocol;
 			ep_wMaxPacketSize = get_unaligned(&dev->config.\
 							if_desc[ifno].\
 							ep_desc[epno].\
@@ -457,6 +468,23 @@ static int usb_parse_config(struct usb_device *dev,
 			memcpy(&if_desc->ss_ep_comp_desc[epno], head,
 				USB_DT_SS_EP_COMP_SIZE);
 			break;
+		case USB_DT_PIPE_USAGE:
+			/*
+			 * USB Attached SCSI gives the use of each endpoint in
+			 * a Pipe Usage descriptor following it
+			 */
+			if (head->bLength != USB_DT_PIPE_USAGE_SIZE ||
+			    index + USB_DT_PIPE_USAGE_SIZE >
+			    dev->config.desc.wTotalLength ||
+			    ifno < 0 || epno < 0 ||
+			    (prev_type != USB_DT_ENDPOINT &&
+			     prev_type != USB_DT_SS_ENDPOINT_COMP)) {
+				debug("Ignoring Pipe Usage descriptor\n");
+				break;
+			}
+			if_desc = &dev->config.if_desc[ifno];
+			if_desc->ep_pipe_id[epno] = ((unsigned char *)head)[2];
+			break;
 		default:
 			if (head->bLength == 0)
 				return 1;
@@ -476,6 +504,7 @@ static int usb_parse_config(struct usb_device *dev,
 #endif
 			break;
 		}
+		prev_type = head->bDescriptorType;
 		index += head->bLength;
 		head = (struct usb_descriptor_header *)&buffer[index];
 	}
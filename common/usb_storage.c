@@ -33,10 +33,12 @@
 
 #include <common.h>
 #include <command.h>
+#include <div64.h>
 #include <inttypes.h>
 #include <asm/byteorder.h>
 #include <asm/processor.h>
 
+#include <hash.h>
 #include <part.h>
 #include <usb.h>
 
@@ -99,11 +101,63 @@ typedef struct {
 } umass_bbb_csw_t;
 #define UMASS_BBB_CSW_SIZE	13
 
+/*
+ * USB Attached SCSI
+ *
+ * We have a single command in flight, always with the same tag. On
+ * SuperSpeed the tag is also the bulk stream that carries its data and
+ * status.
+ */
+#define UAS_TAG			1
+
+/* Command IU */
+typedef struct {
+	__u8		bIUID;
+#	define UAS_IU_COMMAND		0x01
+#	define UAS_IU_SENSE		0x03
+#	define UAS_IU_RESPONSE		0x04
+#	define UAS_IU_READ_READY	0x06
+#	define UAS_IU_WRITE_READY	0x07
+	__u8		bReserved1;
+	__u16		wTag;			/* big-endian */
+	__u8		bTaskAttribute;
+#	define UAS_TASK_SIMPLE	0x0
+	__u8		bReserved5;
+	__u8		bAddCDBLength;
+	__u8		bReserved7;
+	__u8		LUN[8];
+	__u8		CDB[16];
+} umass_uas_cmd_iu_t;
+#define UMASS_UAS_CMD_IU_SIZE	32
+
+/* Sense IU. Read Ready and Write Ready IUs are its first four bytes. */
+typedef struct {
+	__u8		bIUID;
+	__u8		bReserved1;
+	__u16		wTag;			/* big-endian */
+	__u16		wStatusQualifier;
+	__u8		bStatus;
+#	define UAS_STATUS_GOOD	0x0
+	__u8		bReserved7[7];
+	__u16		wSenseLength;		/* big-endian */
+	__u8		SenseData[96];
+} umass_uas_sense_iu_t;
+#define UMASS_UAS_SENSE_IU_SIZE	112
+
 #define USB_MAX_STOR_DEV 5
 static int usb_max_devs; /* number of highest available usb device */
 
 static block_dev_desc_t usb_dev_desc[USB_MAX_STOR_DEV];
 
+/* Transfer statistics, reported by 'usb storage' */
+struct usb_stor_stats {
+	unsigned long long	bytes;		/* bytes transferred */
+	unsigned long		msecs;		/* time spent, in ms */
+};
+
+static struct usb_stor_stats usb_read_stats[USB_MAX_STOR_DEV];
+static struct usb_stor_stats usb_write_stats[USB_MAX_STOR_DEV];
+
 struct us_data;
 typedef int (*trans_cmnd)(ccb *cb, struct us_data *data);
 typedef int (*trans_reset)(struct us_data *data);
@@ -117,6 +171,8 @@ struct us_data {
 	unsigned char	ep_in;			/* in endpoint */
 	unsigned char	ep_out;			/* out ....... */
 	unsigned char	ep_int;			/* interrupt . */
+	unsigned char	ep_cmd;			/* UAS command pipe */
+	unsigned char	ep_status;		/* UAS status pipe */
 	unsigned char	subclass;		/* as in overview */
 	unsigned char	protocol;		/* .............. */
 	unsigned char	attention_done;		/* force attn on first cmd */
@@ -139,6 +195,14 @@ struct us_data {
  * limited to 65535 blocks.
  */
 #define USB_MAX_XFER_BLK	65535
+#elif defined(CONFIG_USB_XHCI)
+/*
+ * The xHCI driver queues each bulk transfer as a single TD on a transfer ring
+ * of one 64-TRB segment, and a TRB cannot cover more than 64 KiB. Keep the
+ * transfers well within that, whatever the block size.
+ */
+#define USB_MAX_XFER_BLK	65535
+#define USB_MAX_XFER_SIZE	(2 * 1024 * 1024)
 #else
 #define USB_MAX_XFER_BLK	20
 #endif
@@ -173,6 +237,37 @@ static void usb_show_progress(void)
 	debug(".");
 }
 
+/* Maximum number of blocks in a single READ(10)/WRITE(10) command */
+static unsigned short usb_stor_max_xfer_blk(block_dev_desc_t *dev_desc)
+{
+#ifdef USB_MAX_XFER_SIZE
+	if (dev_desc->blksz)
+		return min(USB_MAX_XFER_BLK,
+			   (int)(USB_MAX_XFER_SIZE / dev_desc->blksz));
+#endif
+	return USB_MAX_XFER_BLK;
+}
+
+static void usb_stor_account(struct usb_stor_stats *stats, int device,
+			     lbaint_t blkcnt, unsigned long start)
+{
+	stats->bytes += (unsigned long long)blkcnt * usb_dev_desc[device].blksz;
+	stats->msecs += get_timer(start);
+}
+
+static void usb_stor_show_stats(const char *name, struct usb_stor_stats *stats)
+{
+	unsigned long kib = stats->bytes >> 10;
+
+	if (!stats->bytes)
+		return;
+	printf("            %s: %lu KiB in %lu ms", name, kib, stats->msecs);
+	if (stats->msecs)
+		printf(" (%lu KiB/s)", (unsigned long)lldiv((u64)kib * 1000,
+							   stats->msecs));
+	printf("\n");
+}
+
 /*******************************************************************************
  * show info on storage devices; 'usb start/init' must be invoked earlier
  * as we only retrieve structures populated during devices initialization
@@ -185,6 +280,8 @@ int usb_stor_info(void)
 		for (i = 0; i < usb_max_devs; i++) {
 			printf("  Device %d: ", i);
 			dev_print(&usb_dev_desc[i]);
+			usb_stor_show_stats("Read", &usb_read_stats[i]);
+			usb_stor_show_stats("Written", &usb_write_stats[i]);
 		}
 		return 0;
 	}
@@ -197,6 +294,10 @@ static unsigned int usb_get_max_lun(struct us_data *us)
 {
 	int len;
 	ALLOC_CACHE_ALIGN_BUFFER(unsigned char, result, 1);
+
+	/* UAS has no Get Max LUN request, we only use LUN 0 */
+	if (us->protocol == US_PR_UAS)
+		return 0;
 	len = usb_control_msg(us->pusb_dev,
 			      usb_rcvctrlpipe(us->pusb_dev, 0),
 			      US_BBB_GET_MAX_LUN,
@@ -233,6 +334,8 @@ int usb_stor_scan(int mode)
 		usb_dev_desc[i].block_read = usb_stor_read;
 		usb_dev_desc[i].block_write = usb_stor_write;
 	}
+	memset(usb_read_stats, 0, sizeof(usb_read_stats));
+	memset(usb_write_stats, 0, sizeof(usb_write_stats));
 
 	usb_max_devs = 0;
 	for (i = 0; i < USB_MAX_DEVICE; i++) {
@@ -776,6 +879,127 @@ again:
 	return result;
 }
 
+static int usb_stor_UAS_reset(struct us_data *us)
+{
+	/*
+	 * UAS has no class specific reset. Clear any halt on the pipes, so
+	 * that the next command starts afresh.
+	 */
+	debug("UAS_reset\n");
+	usb_clear_halt(us->pusb_dev,
+		       usb_sndbulkpipe(us->pusb_dev, us->ep_cmd));
+	usb_clear_halt(us->pusb_dev,
+		       usb_rcvbulkpipe(us->pusb_dev, us->ep_status));
+	usb_clear_halt(us->pusb_dev, usb_rcvbulkpipe(us->pusb_dev, us->ep_in));
+	usb_clear_halt(us->pusb_dev, usb_sndbulkpipe(us->pusb_dev, us->ep_out));
+	return 0;
+}
+
+/* read an IU from the status pipe, returns its ID or -1 */
+static int usb_stor_UAS_status(struct us_data *us, umass_uas_sense_iu_t *iu)
+{
+	int result, actlen;
+
+	result = usb_bulk_msg(us->pusb_dev,
+			      usb_rcvbulkpipe(us->pusb_dev, us->ep_status),
+			      iu, UMASS_UAS_SENSE_IU_SIZE, &actlen,
+			      USB_CNTL_TIMEOUT * 5);
+	if (result < 0 || actlen < 4) {
+		debug("UAS: no status, status %ld\n", us->pusb_dev->status);
+		return -1;
+	}
+	if (be16_to_cpu(iu->wTag) != UAS_TAG) {
+		debug("UAS: !Tag\n");
+		return -1;
+	}
+	return iu->bIUID;
+}
+
+static int usb_stor_UAS_transport(ccb *srb, struct us_data *us)
+{
+	ALLOC_CACHE_ALIGN_BUFFER(umass_uas_cmd_iu_t, cmd, 1);
+	ALLOC_CACHE_ALIGN_BUFFER(umass_uas_sense_iu_t, iu, 1);
+	int result, dir_in, actlen, id, len;
+	unsigned int pipe;
+
+	dir_in = US_DIRECTION(srb->cmd[0]);
+	memset(srb->sense_buf, 0, sizeof(srb->sense_buf));
+
+	/* COMMAND phase */
+	memset(cmd, 0, UMASS_UAS_CMD_IU_SIZE);
+	cmd->bIUID = UAS_IU_COMMAND;
+	cmd->wTag = cpu_to_be16(UAS_TAG);
+	cmd->bTaskAttribute = UAS_TASK_SIMPLE;
+	cmd->LUN[1] = srb->lun;
+	memcpy(cmd->CDB, srb->cmd, min_t(int, srb->cmdlen, sizeof(cmd->CDB)));
+	result = usb_bulk_msg(us->pusb_dev,
+			      usb_sndbulkpipe(us->pusb_dev, us->ep_cmd),
+			      cmd, UMASS_UAS_CMD_IU_SIZE, &actlen,
+			      USB_CNTL_TIMEOUT * 5);
+	if (result < 0) {
+		debug("UAS: failed to send command, status %ld\n",
+		      us->pusb_dev->status);
+		usb_stor_UAS_reset(us);
+		return USB_STOR_TRANSPORT_FAILED;
+	}
+
+	/*
+	 * Without streams the device tells us on the status pipe when it is
+	 * ready for the data. If the command fails early it sends the Sense
+	 * IU instead, and there is no data phase.
+	 */
+	id = 0;
+	if (srb->datalen && !us->pusb_dev->bulk_streams) {
+		id = usb_stor_UAS_status(us, iu);
+		if (id != UAS_IU_SENSE &&
+		    id != (dir_in ? UAS_IU_READ_READY : UAS_IU_WRITE_READY)) {
+			debug("UAS: expected Ready IU, got %d\n", id);
+			usb_stor_UAS_reset(us);
+			return USB_STOR_TRANSPORT_FAILED;
+		}
+	}
+
+	/* DATA phase */
+	if (srb->datalen && id != UAS_IU_SENSE) {
+		if (dir_in)
+			pipe = usb_rcvbulkpipe(us->pusb_dev, us->ep_in);
+		else
+			pipe = usb_sndbulkpipe(us->pusb_dev, us->ep_out);
+		result = usb_bulk_msg(us->pusb_dev, pipe, srb->pdata,
+				      srb->datalen, &actlen,
+				      USB_CNTL_TIMEOUT * 5);
+		/* on a STALL the status still follows */
+		if ((result < 0) && (us->pusb_dev->status & USB_ST_STALLED)) {
+			debug("UAS: DATA:stall\n");
+			result = usb_clear_halt(us->pusb_dev, pipe);
+		}
+		if (result < 0) {
+			debug("UAS: data failed, status %ld\n",
+			      us->pusb_dev->status);
+			usb_stor_UAS_reset(us);
+			return USB_STOR_TRANSPORT_FAILED;
+		}
+	}
+
+	/* STATUS phase */
+	if (id != UAS_IU_SENSE)
+		id = usb_stor_UAS_status(us, iu);
+	if (id != UAS_IU_SENSE) {
+		/* a Response IU means the device rejected the command */
+		debug("UAS: expected Sense IU, got %d\n", id);
+		usb_stor_UAS_reset(us);
+		return USB_STOR_TRANSPORT_FAILED;
+	}
+	if (iu->bStatus == UAS_STATUS_GOOD)
+		return USB_STOR_TRANSPORT_GOOD;
+
+	/* the sense data came with the status, keep it for request sense */
+	len = min_t(int, be16_to_cpu(iu->wSenseLength), sizeof(srb->sense_buf));
+	memcpy(srb->sense_buf, iu->SenseData, len);
+	debug("UAS: status %#x\n", iu->bStatus);
+	return USB_STOR_TRANSPORT_FAILED;
+}
+
 static int usb_stor_CB_transport(ccb *srb, struct us_data *us)
 {
 	int result, status;
@@ -917,6 +1141,13 @@ static int usb_request_sense(ccb *srb, struct us_data *ss)
 {
 	char *ptr;
 
+	/* UAS devices return the sense data along with a failed status */
+	if (ss->protocol == US_PR_UAS) {
+		debug("Request Sense returned %02X %02X %02X\n",
+		      srb->sense_buf[2], srb->sense_buf[12],
+		      srb->sense_buf[13]);
+		return 0;
+	}
 	ptr = (char *)srb->pdata;
 	memset(&srb->cmd[0], 0, 12);
 	srb->cmd[0] = SCSI_REQ_SENSE;
@@ -1045,11 +1276,12 @@ unsigned long usb_stor_read(int device, lbaint_t blknr,
 {
 	lbaint_t start, blks;
 	uintptr_t buf_addr;
-	unsigned short smallblks;
+	unsigned short smallblks, max_blks;
 	struct usb_device *dev;
 	struct us_data *ss;
 	int retry, i;
 	ccb *srb = &usb_ccb;
+	unsigned long time_start;
 
 	if (blkcnt == 0)
 		return 0;
@@ -1072,20 +1304,22 @@ unsigned long usb_stor_read(int device, lbaint_t blknr,
 	buf_addr = (uintptr_t)buffer;
 	start = blknr;
 	blks = blkcnt;
+	max_blks = usb_stor_max_xfer_blk(&usb_dev_desc[device]);
 
 	debug("\nusb_read: dev %d startblk " LBAF ", blccnt " LBAF
 	      " buffer %" PRIxPTR "\n", device, start, blks, buf_addr);
 
+	time_start = get_timer(0);
 	do {
 		/* XXX need some comment here */
 		retry = 2;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (blks > USB_MAX_XFER_BLK)
-			smallblks = USB_MAX_XFER_BLK;
+		if (blks > max_blks)
+			smallblks = max_blks;
 		else
 			smallblks = (unsigned short) blks;
 retry_it:
-		if (smallblks == USB_MAX_XFER_BLK)
+		if (smallblks == max_blks)
 			usb_show_progress();
 		srb->datalen = usb_dev_desc[device].blksz * smallblks;
 		srb->pdata = (unsigned char *)buf_addr;
@@ -1094,21 +1328,28 @@ retry_it:
 			usb_request_sense(srb, ss);
 			if (retry--)
 				goto retry_it;
+			hash_read_drop((void *)buf_addr,
+				       usb_dev_desc[device].blksz * smallblks);
 			blkcnt -= blks;
 			break;
 		}
+		hash_read_data(srb->pdata, srb->datalen);
 		start += smallblks;
 		blks -= smallblks;
 		buf_addr += srb->datalen;
 	} while (blks != 0);
 	ss->flags &= ~USB_READY;
+	/* A failed transfer would skew the throughput, so leave it out */
+	if (!blks)
+		usb_stor_account(&usb_read_stats[device], device, blkcnt,
+				 time_start);
 
 	debug("usb_read: end startblk " LBAF
 	      ", blccnt %x buffer %" PRIxPTR "\n",
 	      start, smallblks, buf_addr);
 
 	usb_disable_asynch(0); /* asynch transfer allowed */
-	if (blkcnt >= USB_MAX_XFER_BLK)
+	if (blkcnt >= max_blks)
 		debug("\n");
 	return blkcnt;
 }
@@ -1118,11 +1359,12 @@ unsigned long usb_stor_write(int device, lbaint_t blknr,
 {
 	lbaint_t start, blks;
 	uintptr_t buf_addr;
-	unsigned short smallblks;
+	unsigned short smallblks, max_blks;
 	struct usb_device *dev;
 	struct us_data *ss;
 	int retry, i;
 	ccb *srb = &usb_ccb;
+	unsigned long time_start;
 
 	if (blkcnt == 0)
 		return 0;
@@ -1146,22 +1388,24 @@ unsigned long usb_stor_write(int device, lbaint_t blknr,
 	buf_addr = (uintptr_t)buffer;
 	start = blknr;
 	blks = blkcnt;
+	max_blks = usb_stor_max_xfer_blk(&usb_dev_desc[device]);
 
 	debug("\nusb_write: dev %d startblk " LBAF ", blccnt " LBAF
 	      " buffer %" PRIxPTR "\n", device, start, blks, buf_addr);
 
+	time_start = get_timer(0);
 	do {
 		/* If write fails retry for max retry count else
 		 * return with number of blocks written successfully.
 		 */
 		retry = 2;
 		srb->pdata = (unsigned char *)buf_addr;
-		if (blks > USB_MAX_XFER_BLK)
-			smallblks = USB_MAX_XFER_BLK;
+		if (blks > max_blks)
+			smallblks = max_blks;
 		else
 			smallblks = (unsigned short) blks;
 retry_it:
-		if (smallblks == USB_MAX_XFER_BLK)
+		if (smallblks == max_blks)
 			usb_show_progress();
 		srb->datalen = usb_dev_desc[device].blksz * smallblks;
 		srb->pdata = (unsigned char *)buf_addr;
@@ -1178,17 +1422,84 @@ retry_it:
 		buf_addr += srb->datalen;
 	} while (blks != 0);
 	ss->flags &= ~USB_READY;
+	/* A failed transfer would skew the throughput, so leave it out */
+	if (!blks)
+		usb_stor_account(&usb_write_stats[device], device, blkcnt,
+				 time_start);
 
 	debug("usb_write: end startblk " LBAF ", blccnt %x buffer %"
 	      PRIxPTR "\n", start, smallblks, buf_addr);
 
 	usb_disable_asynch(0); /* asynch transfer allowed */
-	if (blkcnt >= USB_MAX_XFER_BLK)
+	if (blkcnt >= max_blks)
 		debug("\n");
 	return blkcnt;
 
 }
 
+/*
+ * Look for an alternate setting with the four UAS pipes, and store them in
+ * ss. Returns the alternate setting, or -1 if there is none we can use.
+ */
+static int usb_stor_UAS_find(struct usb_device *dev,
+			     struct usb_interface *iface, struct us_data *ss)
+{
+	struct usb_endpoint_descriptor *ep_desc;
+	unsigned char ep[UAS_PIPE_DATA_OUT + 1];
+	int i, j, alt, id;
+
+	/* SuperSpeed UAS needs bulk streams from the host */
+	if (dev->speed == USB_SPEED_SUPER && !dev->bulk_streams)
+		return -1;
+
+	for (i = 0; i < iface->no_of_ep; i++) {
+		if (iface->ep_pipe_id[i] != UAS_PIPE_CMD)
+			continue;
+		alt = iface->ep_altsetting[i];
+		memset(ep, 0, sizeof(ep));
+		for (j = 0; j < iface->no_of_ep; j++) {
+			ep_desc = &iface->ep_desc[j];
+			id = iface->ep_pipe_id[j];
+			if (iface->ep_altsetting[j] != alt ||
+			    id < UAS_PIPE_CMD || id > UAS_PIPE_DATA_OUT ||
+			    (ep_desc->bmAttributes &
+			     USB_ENDPOINT_XFERTYPE_MASK) !=
+			    USB_ENDPOINT_XFER_BULK)
+				continue;
+			/* on SuperSpeed all but the command pipe use streams */
+			if (dev->speed == USB_SPEED_SUPER &&
+			    id != UAS_PIPE_CMD &&
+			    !(iface->ss_ep_comp_desc[j].bmAttributes & 0x1f))
+				continue;
+			ep[id] = ep_desc->bEndpointAddress &
+				 USB_ENDPOINT_NUMBER_MASK;
+		}
+		if (!ep[UAS_PIPE_CMD] || !ep[UAS_PIPE_STATUS] ||
+		    !ep[UAS_PIPE_DATA_IN] || !ep[UAS_PIPE_DATA_OUT])
+			continue;
+		ss->ep_cmd = ep[UAS_PIPE_CMD];
+		ss->ep_status = ep[UAS_PIPE_STATUS];
+		ss->ep_in = ep[UAS_PIPE_DATA_IN];
+		ss->ep_out = ep[UAS_PIPE_DATA_OUT];
+		debug("UAS: alt %d Cmd %d Status %d In %d Out %d\n", alt,
+		      ss->ep_cmd, ss->ep_status, ss->ep_in, ss->ep_out);
+		return alt;
+	}
+	return -1;
+}
+
+/* Returns an alternate setting of the given protocol, or -1 if none */
+static int usb_stor_alt_find(struct usb_interface *iface, int protocol)
+{
+	int i;
+
+	for (i = 0; i < iface->no_of_ep; i++) {
+		if (iface->ep_protocol[i] == protocol)
+			return iface->ep_altsetting[i];
+	}
+	return -1;
+}
+
 /* Probe to see if a new device is actually a Storage device */
 int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 		      struct us_data *ss)
@@ -1197,6 +1508,7 @@ int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 	int i;
 	struct usb_endpoint_descriptor *ep_desc;
 	unsigned int flags = 0;
+	int alt = 0;
 
 	int protocol = 0;
 	int subclass = 0;
@@ -1247,6 +1559,31 @@ int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 		ss->protocol = iface->desc.bInterfaceProtocol;
 	}
 
+	/*
+	 * We run UAS with one command in flight, which does no better than
+	 * Bulk-Only with large transfers. So UAS is only used by devices
+	 * whose default setting is UAS, and even they use a Bulk-Only
+	 * setting if they have one and UAS cannot be done.
+	 */
+	if (ss->protocol == US_PR_UAS) {
+		alt = usb_stor_UAS_find(dev, iface, ss);
+		if (alt >= 0) {
+			ss->subclass = US_SC_SCSI;
+		} else {
+			alt = usb_stor_alt_find(iface, US_PR_BULK);
+			if (alt >= 0) {
+				ss->protocol = US_PR_BULK;
+			} else if (dev->speed == USB_SPEED_SUPER &&
+				   !dev->bulk_streams) {
+				printf("USB Storage: UAS needs bulk streams, which this host does not provide\n");
+				return 0;
+			} else {
+				printf("USB Storage: UAS device without a usable set of pipes\n");
+				return 0;
+			}
+		}
+	}
+
 	/* set the handler pointers based on the protocol */
 	debug("Transport: ");
 	switch (ss->protocol) {
@@ -1266,6 +1603,11 @@ int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 		ss->transport = usb_stor_BBB_transport;
 		ss->transport_reset = usb_stor_BBB_reset;
 		break;
+	case US_PR_UAS:
+		debug("USB Attached SCSI\n");
+		ss->transport = usb_stor_UAS_transport;
+		ss->transport_reset = usb_stor_UAS_reset;
+		break;
 	default:
 		printf("USB Storage Transport unknown / not yet implemented\n");
 		return 0;
@@ -1275,9 +1617,12 @@ int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 	/*
 	 * We are expecting a minimum of 2 endpoints - in and out (bulk).
 	 * An optional interrupt is OK (necessary for CBI protocol).
-	 * We will ignore any others.
+	 * We will ignore any others, and those of other alternate settings.
+	 * UAS has found its pipes already.
 	 */
-	for (i = 0; i < iface->desc.bNumEndpoints; i++) {
+	for (i = 0; ss->protocol != US_PR_UAS && i < iface->no_of_ep; i++) {
+		if (iface->ep_altsetting[i] != alt)
+			continue;
 		ep_desc = &iface->ep_desc[i];
 		/* is it an BULK endpoint? */
 		if ((ep_desc->bmAttributes &
@@ -1303,7 +1648,7 @@ int usb_storage_probe(struct usb_device *dev, unsigned int ifnum,
 	      ss->ep_in, ss->ep_out, ss->ep_int);
 
 	/* Do some basic sanity checks, and bail if we find a problem */
-	if (usb_set_interface(dev, iface->desc.bInterfaceNumber, 0) ||
+	if (usb_set_interface(dev, iface->desc.bInterfaceNumber, alt) ||
 	    !ss->ep_in || !ss->ep_out ||
 	    (ss->protocol == US_PR_CBI && ss->ep_int == 0)) {
 		debug("Problems with device\n");
@@ -6,10 +6,12 @@
 
 #include <config.h>
 #include <common.h>
+#include <hash.h>
 #include <part.h>
 #include <os.h>
 #include <malloc.h>
 #include <sandboxblockdev.h>
+#include <trace.h>
 #include <asm/errno.h>
 
 static struct host_block_dev host_devices[CONFIG_HOST_MAX_DEVICES];
@@ -35,10 +37,14 @@ static unsigned long host_block_read(int dev, unsigned long start,
 		printf("ERROR: Invalid position\n");
 		return -1;
 	}
+	trace_event_start(TRACE_EVENT_BLK_READ);
 	ssize_t len = os_read(host_dev->fd, buffer,
 			      blkcnt * host_dev->blk_dev.blksz);
-	if (len >= 0)
+	trace_event_end(TRACE_EVENT_BLK_READ, len >= 0 ? len : 0);
+	if (len >= 0) {
+		hash_read_data(buffer, len);
 		return len / host_dev->blk_dev.blksz;
+	}
 	return -1;
 }
 
@@ -52,8 +58,10 @@ static unsigned long host_block_write(int dev, unsigned long start,
 		printf("ERROR: Invalid position\n");
 		return -1;
 	}
+	trace_event_start(TRACE_EVENT_BLK_WRITE);
 	ssize_t len = os_write(host_dev->fd, buffer, blkcnt *
 			       host_dev->blk_dev.blksz);
+	trace_event_end(TRACE_EVENT_BLK_WRITE, len >= 0 ? len : 0);
 	if (len >= 0)
 		return len / host_dev->blk_dev.blksz;
 	return -1;
@@ -27,6 +27,7 @@ DECLARE_GLOBAL_DATA_PTR;
 int device_bind(struct udevice *parent, struct driver *drv, const char *name,
 		void *platdata, int of_offset, struct udevice **devp)
 {
+	struct dm_timing_mark mark;
 	struct udevice *dev;
 	struct uclass *uc;
 	int ret = 0;
@@ -42,6 +43,7 @@ int device_bind(struct udevice *parent, struct driver *drv, const char *name,
 	dev = calloc(1, sizeof(struct udevice));
 	if (!dev)
 		return -ENOMEM;
+	dm_timing_start(&mark);
 
 	INIT_LIST_HEAD(&dev->sibling_node);
 	INIT_LIST_HEAD(&dev->child_head);
@@ -118,6 +120,7 @@ int device_bind(struct udevice *parent, struct driver *drv, const char *name,
 	if (parent)
 		dm_dbg("Bound device %s to %s\n", dev->name, parent->name);
 	*devp = dev;
+	dm_timing_end(drv, false, &mark);
 
 	return 0;
 
@@ -145,6 +148,7 @@ fail_alloc2:
 	}
 fail_alloc1:
 	free(dev);
+	dm_timing_end(drv, false, &mark);
 
 	return ret;
 }
@@ -166,6 +170,7 @@ int device_bind_by_name(struct udevice *parent, bool pre_reloc_only,
 
 int device_probe_child(struct udevice *dev, void *parent_priv)
 {
+	struct dm_timing_mark mark;
 	struct driver *drv;
 	int size = 0;
 	int ret;
@@ -179,6 +184,7 @@ int device_probe_child(struct udevice *dev, void *parent_priv)
 
 	drv = dev->driver;
 	assert(drv);
+	dm_timing_start(&mark);
 
 	/* Allocate private data if requested */
 	if (drv->priv_auto_alloc_size) {
@@ -225,7 +231,7 @@ int device_probe_child(struct udevice *dev, void *parent_priv)
 		ret = seq;
 		goto fail;
 	}
-	dev->seq = seq;
+	uclass_set_seq(dev, seq);
 
 	ret = uclass_pre_probe_child(dev);
 	if (ret)
@@ -256,6 +262,7 @@ int device_probe_child(struct udevice *dev, void *parent_priv)
 		dev->flags &= ~DM_FLAG_ACTIVATED;
 		goto fail_uclass;
 	}
+	dm_timing_end(drv, true, &mark);
 
 	return 0;
 fail_uclass:
@@ -264,8 +271,9 @@ fail_uclass:
 			__func__, dev->name);
 	}
 fail:
-	dev->seq = -1;
+	uclass_set_seq(dev, -1);
 	device_free(dev);
+	dm_timing_end(drv, true, &mark);
 
 	return ret;
 }
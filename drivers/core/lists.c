@@ -9,6 +9,7 @@
 
 #include <common.h>
 #include <errno.h>
+#include <malloc.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -18,13 +19,164 @@
 #include <fdtdec.h>
 #include <linux/compiler.h>
 
+DECLARE_GLOBAL_DATA_PTR;
+
+#ifndef CONFIG_SPL_BUILD
+/*
+ * After relocation the driver list is indexed by name and by compatible
+ * string, in hash tables built on first use. Before relocation there are
+ * only a few devices to bind, and the list is scanned.
+ */
+struct lists_compat {
+	const char *compatible;
+	struct driver *drv;
+};
+
+static struct lists_index {
+	unsigned int mask;		/* table size - 1 */
+	struct driver **names;
+	struct lists_compat *compats;
+} lists_index;
+
+static unsigned int lists_hash(const char *s)
+{
+	unsigned int hash = 2166136261u;
+
+	while (*s) {
+		hash ^= (unsigned char)*s++;
+		hash *= 16777619;
+	}
+
+	return hash;
+}
+
+static struct lists_index *lists_get_index(void)
+{
+	struct driver *drv = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	struct lists_index *idx = &lists_index;
+	const struct udevice_id *of_match;
+	struct driver *entry;
+	unsigned int size, i;
+	int count = n_ents;
+
+	if (!(gd->flags & GD_FLG_RELOC))
+		return NULL;
+	if (idx->names)
+		return idx;
+
+	for (entry = drv; entry != drv + n_ents; entry++) {
+		for (of_match = entry->of_match;
+		     of_match && of_match->compatible; of_match++)
+			count++;
+	}
+	for (size = 1; size < 2 * count; size <<= 1)
+		;
+	idx->names = calloc(size, sizeof(*idx->names));
+	idx->compats = calloc(size, sizeof(*idx->compats));
+	if (!idx->names || !idx->compats) {
+		free(idx->names);
+		free(idx->compats);
+		idx->names = NULL;
+		idx->compats = NULL;
+		return NULL;
+	}
+	idx->mask = size - 1;
+
+	/* Open addressing, in list order so that the first entry wins */
+	for (entry = drv; entry != drv + n_ents; entry++) {
+		i = lists_hash(entry->name) & idx->mask;
+		while (idx->names[i])
+			i = (i + 1) & idx->mask;
+		idx->names[i] = entry;
+
+		for (of_match = entry->of_match;
+		     of_match && of_match->compatible; of_match++) {
+			i = lists_hash(of_match->compatible) & idx->mask;
+			while (idx->compats[i].drv)
+				i = (i + 1) & idx->mask;
+			idx->compats[i].compatible = of_match->compatible;
+			idx->compats[i].drv = entry;
+		}
+	}
+
+	return idx;
+}
+
+static struct driver *lists_index_name(struct lists_index *idx,
+				       const char *name)
+{
+	unsigned int i;
+
+	for (i = lists_hash(name) & idx->mask; idx->names[i];
+	     i = (i + 1) & idx->mask) {
+		if (!strcmp(name, idx->names[i]->name))
+			return idx->names[i];
+	}
+
+	return NULL;
+}
+
+#ifdef CONFIG_OF_CONTROL
+/**
+ * lists_index_compatible() - Find the first driver for a device tree node
+ *
+ * @idx:	Driver index
+ * @blob:	Device tree pointer
+ * @offset:	Offset of node in device tree
+ * @first:	First driver in the list
+ * @end:	End of the driver list
+ * @return the first driver in the list which matches one of the node's
+ * compatible strings, @end if there is none, or @first if the node has no
+ * compatible strings to look up
+ */
+static struct driver *lists_index_compatible(struct lists_index *idx,
+					     const void *blob, int offset,
+					     struct driver *first,
+					     struct driver *end)
+{
+	struct driver *best = end;
+	const char *compat, *str_end;
+	unsigned int i;
+	int len;
+
+	compat = fdt_getprop(blob, offset, "compatible", &len);
+	if (!compat)
+		return first;
+
+	for (; len > 0; len -= str_end - compat + 1, compat = str_end + 1) {
+		str_end = memchr(compat, '\0', len);
+		if (!str_end)
+			break;
+		for (i = lists_hash(compat) & idx->mask; idx->compats[i].drv;
+		     i = (i + 1) & idx->mask) {
+			if (idx->compats[i].drv < best &&
+			    !strcmp(compat, idx->compats[i].compatible))
+				best = idx->compats[i].drv;
+		}
+	}
+
+	return best;
+}
+#endif
+#else
+static inline struct lists_index *lists_get_index(void)
+{
+	return NULL;
+}
+#endif
+
 struct driver *lists_driver_lookup_name(const char *name)
 {
 	struct driver *drv =
 		ll_entry_start(struct driver, driver);
 	const int n_ents = ll_entry_count(struct driver, driver);
+	struct lists_index *idx = lists_get_index();
 	struct driver *entry;
 
+	if (idx)
+		return lists_index_name(idx, name);
+
 	for (entry = drv; entry != drv + n_ents; entry++) {
 		if (!strcmp(name, entry->name))
 			return entry;
@@ -136,6 +288,7 @@ int lists_bind_fdt(struct udevice *parent, const void *blob, int offset,
 {
 	struct driver *driver = ll_entry_start(struct driver, driver);
 	const int n_ents = ll_entry_count(struct driver, driver);
+	struct lists_index *idx;
 	const struct udevice_id *id;
 	struct driver *entry;
 	struct udevice *dev;
@@ -147,7 +300,13 @@ int lists_bind_fdt(struct udevice *parent, const void *blob, int offset,
 	dm_dbg("bind node %s\n", fdt_get_name(blob, offset, NULL));
 	if (devp)
 		*devp = NULL;
-	for (entry = driver; entry != driver + n_ents; entry++) {
+	/* With an index, skip straight to the first matching driver */
+	idx = lists_get_index();
+	entry = driver;
+	if (idx)
+		entry = lists_index_compatible(idx, blob, offset, driver,
+					       driver + n_ents);
+	for (; entry != driver + n_ents; entry++) {
 		ret = driver_check_compatible(blob, offset, entry->of_match,
 					      &id);
 		name = fdt_get_name(blob, offset, NULL);
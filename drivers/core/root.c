@@ -105,6 +105,7 @@ int dm_init(void)
 		return -EINVAL;
 	}
 	INIT_LIST_HEAD(&DM_UCLASS_ROOT_NON_CONST);
+	memset(gd->uclass_index, '\0', sizeof(gd->uclass_index));
 
 #if defined(CONFIG_NEEDS_MANUAL_RELOC)
 	fix_drivers();
@@ -0,0 +1,70 @@
+/*
+ * Bind and probe times for each driver
+ *
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <dm/device.h>
+#include <dm/util.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/*
+ * One entry for each driver in the linker list, allocated after relocation.
+ * Times before relocation are not kept: the devices are bound again later.
+ */
+static struct dm_timing *timing;
+
+/* Time spent in nested binds and probes, so that each only counts its own */
+static ulong nested_us;
+
+struct dm_timing *dm_timing_get(struct driver *drv)
+{
+	struct driver *start = ll_entry_start(struct driver, driver);
+	const int count = ll_entry_count(struct driver, driver);
+
+	if (!(gd->flags & GD_FLG_RELOC))
+		return NULL;
+	if (drv < start || drv >= start + count)
+		return NULL;
+	if (!timing) {
+		timing = calloc(count, sizeof(*timing));
+		if (!timing)
+			return NULL;
+	}
+
+	return &timing[drv - start];
+}
+
+void dm_timing_start(struct dm_timing_mark *mark)
+{
+	if (!(gd->flags & GD_FLG_RELOC))
+		return;
+	mark->nested_us = nested_us;
+	nested_us = 0;
+	mark->start = timer_get_us();
+}
+
+void dm_timing_end(struct driver *drv, bool probe,
+		   struct dm_timing_mark *mark)
+{
+	struct dm_timing *t;
+	ulong elapsed;
+
+	if (!(gd->flags & GD_FLG_RELOC))
+		return;
+	elapsed = timer_get_us() - mark->start;
+	t = dm_timing_get(drv);
+	if (t && probe) {
+		t->probes++;
+		t->probe_us += elapsed - nested_us;
+	} else if (t) {
+		t->binds++;
+		t->bind_us += elapsed - nested_us;
+	}
+	nested_us = mark->nested_us + elapsed;
+}
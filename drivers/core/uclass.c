@@ -21,21 +21,10 @@ DECLARE_GLOBAL_DATA_PTR;
 
 struct uclass *uclass_find(enum uclass_id key)
 {
-	struct uclass *uc;
-
-	if (!gd->dm_root)
+	if (!gd->dm_root || key < 0 || key >= UCLASS_COUNT)
 		return NULL;
-	/*
-	 * TODO(sjg@chromium.org): Optimise this, perhaps moving the found
-	 * node to the start of the list, or creating a linear array mapping
-	 * id to node.
-	 */
-	list_for_each_entry(uc, &gd->uclass_root, sibling_node) {
-		if (uc->uc_drv->id == key)
-			return uc;
-	}
 
-	return NULL;
+	return gd->uclass_index[key];
 }
 
 /**
@@ -74,6 +63,7 @@ static int uclass_add(enum uclass_id id, struct uclass **ucp)
 	INIT_LIST_HEAD(&uc->sibling_node);
 	INIT_LIST_HEAD(&uc->dev_head);
 	list_add(&uc->sibling_node, &DM_UCLASS_ROOT_NON_CONST);
+	gd->uclass_index[id] = uc;
 
 	if (uc_drv->init) {
 		ret = uc_drv->init(uc);
@@ -90,6 +80,7 @@ fail:
 		uc->priv = NULL;
 	}
 	list_del(&uc->sibling_node);
+	gd->uclass_index[id] = NULL;
 fail_mem:
 	free(uc);
 
@@ -115,8 +106,11 @@ int uclass_destroy(struct uclass *uc)
 	if (uc_drv->destroy)
 		uc_drv->destroy(uc);
 	list_del(&uc->sibling_node);
+	if (gd->uclass_index[uc_drv->id] == uc)
+		gd->uclass_index[uc_drv->id] = NULL;
 	if (uc_drv->priv_auto_alloc_size)
 		free(uc->priv);
+	free(uc->seq_index);
 	free(uc);
 
 	return 0;
@@ -156,9 +150,84 @@ int uclass_find_device(enum uclass_id id, int index, struct udevice **devp)
 	return -ENODEV;
 }
 
+/**
+ * uclass_seq_entry() - Get the index entry for a sequence number
+ *
+ * The index is grown as needed. If it cannot be, it is dropped and the
+ * list of devices is searched from then on.
+ *
+ * @uc: uclass to check
+ * @seq: Sequence number (>= 0)
+ * @return the entry, or NULL if there is no index
+ */
+static struct uclass_seq *uclass_seq_entry(struct uclass *uc, int seq)
+{
+	struct uclass_seq *index;
+	int size;
+
+	if (uc->seq_index_size < 0)
+		return NULL;
+	if (seq < uc->seq_index_size)
+		return &uc->seq_index[seq];
+
+	size = max(seq + 1, 2 * uc->seq_index_size);
+	index = realloc(uc->seq_index, size * sizeof(*index));
+	if (!index) {
+		free(uc->seq_index);
+		uc->seq_index = NULL;
+		uc->seq_index_size = -1;
+		return NULL;
+	}
+	memset(index + uc->seq_index_size, '\0',
+	       (size - uc->seq_index_size) * sizeof(*index));
+	uc->seq_index = index;
+	uc->seq_index_size = size;
+
+	return &index[seq];
+}
+
+/* Remove a device which has left the uclass from the req_seq index */
+static void uclass_seq_drop_req(struct uclass *uc, struct udevice *dev)
+{
+	struct uclass_seq *entry;
+	struct udevice *other;
+
+	if (dev->req_seq < 0 || dev->req_seq >= uc->seq_index_size)
+		return;
+	entry = &uc->seq_index[dev->req_seq];
+	if (entry->req_dev != dev)
+		return;
+
+	/* Another device may have asked for the same sequence number */
+	entry->req_dev = NULL;
+	list_for_each_entry(other, &uc->dev_head, uclass_node) {
+		if (other->req_seq == dev->req_seq) {
+			entry->req_dev = other;
+			break;
+		}
+	}
+}
+
+void uclass_set_seq(struct udevice *dev, int seq)
+{
+	struct uclass *uc = dev->uclass;
+	struct uclass_seq *entry;
+
+	if (dev->seq >= 0 && dev->seq < uc->seq_index_size &&
+	    uc->seq_index[dev->seq].dev == dev)
+		uc->seq_index[dev->seq].dev = NULL;
+	dev->seq = seq;
+	if (seq >= 0) {
+		entry = uclass_seq_entry(uc, seq);
+		if (entry)
+			entry->dev = dev;
+	}
+}
+
 int uclass_find_device_by_seq(enum uclass_id id, int seq_or_req_seq,
 			      bool find_req_seq, struct udevice **devp)
 {
+	struct uclass_seq *entry;
 	struct uclass *uc;
 	struct udevice *dev;
 	int ret;
@@ -171,6 +240,16 @@ int uclass_find_device_by_seq(enum uclass_id id, int seq_or_req_seq,
 	if (ret)
 		return ret;
 
+	if (uc->seq_index_size >= 0) {
+		if (seq_or_req_seq < 0 || seq_or_req_seq >= uc->seq_index_size)
+			return -ENODEV;
+		entry = &uc->seq_index[seq_or_req_seq];
+		*devp = find_req_seq ? entry->req_dev : entry->dev;
+		debug("   - %s\n", *devp ? "found" : "not found");
+
+		return *devp ? 0 : -ENODEV;
+	}
+
 	list_for_each_entry(dev, &uc->dev_head, uclass_node) {
 		debug("   - %d %d\n", dev->req_seq, dev->seq);
 		if ((find_req_seq ? dev->req_seq : dev->seq) ==
@@ -320,6 +399,12 @@ int uclass_bind_device(struct udevice *dev)
 
 	uc = dev->uclass;
 	list_add_tail(&dev->uclass_node, &uc->dev_head);
+	if (dev->req_seq >= 0) {
+		struct uclass_seq *entry = uclass_seq_entry(uc, dev->req_seq);
+
+		if (entry && !entry->req_dev)
+			entry->req_dev = dev;
+	}
 
 	if (dev->parent) {
 		struct uclass_driver *uc_drv = dev->parent->uclass->uc_drv;
@@ -340,6 +425,7 @@ int uclass_bind_device(struct udevice *dev)
 err:
 	/* There is no need to undo the parent's post_bind call */
 	list_del(&dev->uclass_node);
+	uclass_seq_drop_req(uc, dev);
 
 	return ret;
 }
@@ -357,6 +443,9 @@ int uclass_unbind_device(struct udevice *dev)
 	}
 
 	list_del(&dev->uclass_node);
+	uclass_seq_drop_req(uc, dev);
+	uclass_set_seq(dev, -1);
+
 	return 0;
 }
 
@@ -431,7 +520,7 @@ int uclass_pre_remove_device(struct udevice *dev)
 		free(dev->uclass_priv);
 		dev->uclass_priv = NULL;
 	}
-	dev->seq = -1;
+	uclass_set_seq(dev, -1);
 
 	return 0;
 }
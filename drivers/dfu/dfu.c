@@ -77,6 +77,7 @@ int dfu_init_env_entities(char *interface, char *devstr)
 
 static unsigned char *dfu_buf;
 static unsigned long dfu_buf_size = CONFIG_SYS_DFU_DATA_BUF_SIZE;
+static int dfu_buf_count = CONFIG_SYS_DFU_DATA_BUF_COUNT;
 
 unsigned char *dfu_free_buf(void)
 {
@@ -90,6 +91,11 @@ unsigned long dfu_get_buf_size(void)
 	return dfu_buf_size;
 }
 
+int dfu_get_buf_count(void)
+{
+	return dfu_buf_count;
+}
+
 unsigned char *dfu_get_buf(struct dfu_entity *dfu)
 {
 	char *s;
@@ -107,14 +113,48 @@ unsigned char *dfu_get_buf(struct dfu_entity *dfu)
 	if (dfu->max_buf_size && dfu_buf_size > dfu->max_buf_size)
 		dfu_buf_size = dfu->max_buf_size;
 
-	dfu_buf = memalign(CONFIG_SYS_CACHELINE_SIZE, dfu_buf_size);
+	s = getenv("dfu_bufcnt");
+	if (s)
+		dfu_buf_count = (int)simple_strtol(s, NULL, 0);
+
+	if (!s || dfu_buf_count < 1)
+		dfu_buf_count = CONFIG_SYS_DFU_DATA_BUF_COUNT;
+
+	if (dfu_buf_count > DFU_MAX_BUF_COUNT)
+		dfu_buf_count = DFU_MAX_BUF_COUNT;
+
+	/* each slot must start on a cache line, it is a DMA target */
+	if (dfu_buf_count > 1)
+		dfu_buf_size = ALIGN(dfu_buf_size, CONFIG_SYS_CACHELINE_SIZE);
+
+	dfu_buf = memalign(CONFIG_SYS_CACHELINE_SIZE,
+			   dfu_buf_size * dfu_buf_count);
 	if (dfu_buf == NULL)
 		printf("%s: Could not memalign 0x%lx bytes\n",
-		       __func__, dfu_buf_size);
+		       __func__, dfu_buf_size * dfu_buf_count);
 
 	return dfu_buf;
 }
 
+static u8 *dfu_get_slot(int slot)
+{
+	return dfu_buf + slot * dfu_buf_size;
+}
+
+/*
+ * Return the location where dfu_write() will store its next chunk of data.
+ * Gadgets which receive straight into the DFU buffer use this to avoid a
+ * copy, as it moves to another slot when write-behind is enabled. The data
+ * must then be passed to dfu_write() in chunks of the same size.
+ */
+unsigned char *dfu_get_write_buf(struct dfu_entity *dfu)
+{
+	if (dfu->inited)
+		return dfu->i_buf;
+
+	return dfu_get_buf(dfu);
+}
+
 static char *dfu_get_hash_algo(void)
 {
 	char *s;
@@ -132,33 +172,91 @@ static char *dfu_get_hash_algo(void)
 	return NULL;
 }
 
+/* Write up to max bytes of the queued slots to the medium, oldest first */
+static int dfu_write_queued(struct dfu_entity *dfu, long max)
+{
+	long chunk, w_size;
+	int ret;
+
+	while (dfu->w_count && max > 0) {
+		chunk = min(max, dfu->w_len[dfu->w_slot]);
+
+		/*
+		 * Part of a slot is written in whole write units of the
+		 * medium, e.g. NAND erase blocks, the rest is written later
+		 */
+		if (chunk < dfu->w_len[dfu->w_slot]) {
+			if (!dfu->write_unit)
+				break;
+			chunk -= chunk % dfu->write_unit;
+			if (!chunk)
+				break;
+		}
+		w_size = chunk;
+
+		if (dfu_hash_algo)
+			dfu_hash_algo->hash_update(dfu_hash_algo, &dfu->crc,
+						   dfu->w_buf, w_size, 0);
+
+		ret = dfu->write_medium(dfu, dfu->offset, dfu->w_buf, &w_size);
+		if (ret) {
+			debug("%s: Write error!\n", __func__);
+			return ret;
+		}
+
+		/* update offset */
+		dfu->offset += w_size;
+
+		dfu->w_buf += chunk;
+		dfu->w_len[dfu->w_slot] -= chunk;
+		max -= chunk;
+
+		if (dfu->w_len[dfu->w_slot] == 0) {
+			dfu->w_slot = (dfu->w_slot + 1) % dfu_buf_count;
+			dfu->w_buf = dfu_get_slot(dfu->w_slot);
+			dfu->w_count--;
+
+			puts("#");
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Queue the filled part of the current slot for the medium and move on to
+ * the next slot. With a single buffer this writes the data immediately;
+ * with more, the write is deferred until no free slot is left, dfu_flush()
+ * is called or the gadget calls dfu_write_pending() while it is waiting for
+ * the host.
+ */
 static int dfu_write_buffer_drain(struct dfu_entity *dfu)
 {
 	long w_size;
-	int ret;
 
 	/* flush size? */
 	w_size = dfu->i_buf - dfu->i_buf_start;
 	if (w_size == 0)
 		return 0;
 
-	if (dfu_hash_algo)
-		dfu_hash_algo->hash_update(dfu_hash_algo, &dfu->crc,
-					   dfu->i_buf_start, w_size, 0);
-
-	ret = dfu->write_medium(dfu, dfu->offset, dfu->i_buf_start, &w_size);
-	if (ret)
-		debug("%s: Write error!\n", __func__);
+	if (!dfu->w_count) {
+		dfu->w_slot = dfu->i_slot;
+		dfu->w_buf = dfu->i_buf_start;
+	}
+	dfu->w_len[dfu->i_slot] = w_size;
+	dfu->w_count++;
 
-	/* point back */
+	/* point to the next slot */
+	dfu->i_slot = (dfu->i_slot + 1) % dfu_buf_count;
+	dfu->i_buf_start = dfu_get_slot(dfu->i_slot);
+	dfu->i_buf_end = dfu->i_buf_start + dfu_buf_size;
 	dfu->i_buf = dfu->i_buf_start;
 
-	/* update offset */
-	dfu->offset += w_size;
+	/* the next slot must be free before it can be filled */
+	if (dfu->w_count == dfu_buf_count)
+		return dfu_write_queued(dfu, dfu->w_len[dfu->w_slot]);
 
-	puts("#");
-
-	return ret;
+	return 0;
 }
 
 void dfu_write_transaction_cleanup(struct dfu_entity *dfu)
@@ -171,16 +269,45 @@ void dfu_write_transaction_cleanup(struct dfu_entity *dfu)
 	dfu->i_buf_start = dfu_buf;
 	dfu->i_buf_end = dfu_buf;
 	dfu->i_buf = dfu->i_buf_start;
+	dfu->i_slot = 0;
+	dfu->w_count = 0;
 	dfu->inited = 0;
 }
 
+/**
+ * dfu_write_pending() - write back part of the data queued by dfu_write()
+ *
+ * Gadgets call this after queueing a USB transfer, so that the medium is
+ * written while the host is sending the next chunk. Only whole multiples of
+ * the entity's write_unit are written from a slot until all of it can go;
+ * a write_unit of 0 means that only whole slots are written.
+ *
+ * On error the caller must cancel the transaction with
+ * dfu_write_transaction_cleanup() once the buffer is no longer in use.
+ *
+ * @dfu:	DFU entity
+ * @max:	maximum number of bytes to write
+ * @return 0 if OK, -ve on error
+ */
+int dfu_write_pending(struct dfu_entity *dfu, long max)
+{
+	if (!dfu->inited || !dfu->w_count)
+		return 0;
+
+	return dfu_write_queued(dfu, max);
+}
+
 int dfu_flush(struct dfu_entity *dfu, void *buf, int size, int blk_seq_num)
 {
 	int ret = 0;
 
 	ret = dfu_write_buffer_drain(dfu);
-	if (ret)
+	if (!ret)
+		ret = dfu_write_queued(dfu, LONG_MAX);
+	if (ret) {
+		dfu_write_transaction_cleanup(dfu);
 		return ret;
+	}
 
 	if (dfu->flush_medium)
 		ret = dfu->flush_medium(dfu);
@@ -198,9 +325,9 @@ int dfu_write(struct dfu_entity *dfu, void *buf, int size, int blk_seq_num)
 {
 	int ret;
 
-	debug("%s: name: %s buf: 0x%p size: 0x%x p_num: 0x%x offset: 0x%llx bufoffset: 0x%x\n",
+	debug("%s: name: %s buf: 0x%p size: 0x%x p_num: 0x%x offset: 0x%llx bufoffset: 0x%lx\n",
 	      __func__, dfu->name, buf, size, blk_seq_num, dfu->offset,
-	      dfu->i_buf - dfu->i_buf_start);
+	      (ulong)(dfu->i_buf - dfu->i_buf_start));
 
 	if (!dfu->inited) {
 		/* initial state */
@@ -213,6 +340,8 @@ int dfu_write(struct dfu_entity *dfu, void *buf, int size, int blk_seq_num)
 			return -ENOMEM;
 		dfu->i_buf_end = dfu_get_buf(dfu) + dfu_buf_size;
 		dfu->i_buf = dfu->i_buf_start;
+		dfu->i_slot = 0;
+		dfu->w_count = 0;
 
 		dfu->inited = 1;
 	}
@@ -257,7 +386,9 @@ int dfu_write(struct dfu_entity *dfu, void *buf, int size, int blk_seq_num)
 		return -1;
 	}
 
-	memcpy(dfu->i_buf, buf, size);
+	/* the gadget may have received straight into the buffer */
+	if (buf != dfu->i_buf)
+		memcpy(dfu->i_buf, buf, size);
 	dfu->i_buf += size;
 
 	/* if end or if buffer full flush */
@@ -413,6 +544,7 @@ static int dfu_fill_entity(struct dfu_entity *dfu, char *s, int alt,
 
 	dfu->alt = alt;
 	dfu->max_buf_size = 0;
+	dfu->write_unit = 1;
 	dfu->free_entity = NULL;
 
 	/* Specific for mmc device */
@@ -330,6 +330,7 @@ int dfu_fill_entity_mmc(struct dfu_entity *dfu, char *devstr, char *s)
 		dfu->data.mmc.lba_start		= second_arg;
 		dfu->data.mmc.lba_size		= third_arg;
 		dfu->data.mmc.lba_blk_size	= mmc->read_bl_len;
+		dfu->write_unit			= mmc->read_bl_len;
 
 		/*
 		 * Check for an extra entry at dfu_alt_info env variable
@@ -356,6 +357,7 @@ int dfu_fill_entity_mmc(struct dfu_entity *dfu, char *devstr, char *s)
 		dfu->data.mmc.lba_start		= partinfo.start;
 		dfu->data.mmc.lba_size		= partinfo.size;
 		dfu->data.mmc.lba_blk_size	= partinfo.blksz;
+		dfu->write_unit			= partinfo.blksz;
 	} else if (!strcmp(entity_type, "fat")) {
 		dfu->layout = DFU_FS_FAT;
 	} else if (!strcmp(entity_type, "ext4")) {
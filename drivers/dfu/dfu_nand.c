@@ -230,6 +230,13 @@ int dfu_fill_entity_nand(struct dfu_entity *dfu, char *devstr, char *s)
 	dfu->flush_medium = dfu_flush_medium_nand;
 	dfu->poll_timeout = dfu_polltimeout_nand;
 
+	/* each write erases the blocks it touches, only write whole ones */
+	if (nand_curr_device >= 0 &&
+	    nand_curr_device < CONFIG_SYS_MAX_NAND_DEVICE)
+		dfu->write_unit = nand_info[nand_curr_device].erasesize;
+	else
+		dfu->write_unit = 0;
+
 	/* initial state */
 	dfu->inited = 0;
 
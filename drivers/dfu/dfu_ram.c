@@ -13,6 +13,7 @@
 #include <malloc.h>
 #include <errno.h>
 #include <dfu.h>
+#include <hash.h>
 
 static int dfu_transfer_medium_ram(enum dfu_op op, struct dfu_entity *dfu,
 				   u64 offset, void *buf, long *len)
@@ -22,15 +23,17 @@ static int dfu_transfer_medium_ram(enum dfu_op op, struct dfu_entity *dfu,
 		return  -EINVAL;
 	}
 
-	if (offset > dfu->data.ram.size) {
+	if (offset + *len > dfu->data.ram.size) {
 		error("request exceeds allowed area\n");
 		return -EINVAL;
 	}
 
-	if (op == DFU_OP_WRITE)
+	if (op == DFU_OP_WRITE) {
+		hash_read_drop(dfu->data.ram.start + offset, *len);
 		memcpy(dfu->data.ram.start + offset, buf, *len);
-	else
+	} else {
 		memcpy(buf, dfu->data.ram.start + offset, *len);
+	}
 
 	return 0;
 }
@@ -11,9 +11,11 @@
 #include <common.h>
 #include <command.h>
 #include <errno.h>
+#include <hash.h>
 #include <mmc.h>
 #include <part.h>
 #include <malloc.h>
+#include <trace.h>
 #include <linux/list.h>
 #include <div64.h>
 #include "mmc_private.h"
@@ -251,15 +253,22 @@ static ulong mmc_bread(int dev_num, lbaint_t start, lbaint_t blkcnt, void *dst)
 	if (mmc_set_blocklen(mmc, mmc->read_bl_len))
 		return 0;
 
+	trace_event_start(TRACE_EVENT_BLK_READ);
 	do {
 		cur = (blocks_todo > mmc->cfg->b_max) ?
 			mmc->cfg->b_max : blocks_todo;
-		if(mmc_read_blocks(mmc, dst, start, cur) != cur)
+		if(mmc_read_blocks(mmc, dst, start, cur) != cur) {
+			trace_event_end(TRACE_EVENT_BLK_READ,
+					(blkcnt - blocks_todo) *
+					mmc->read_bl_len);
 			return 0;
+		}
+		hash_read_data(dst, cur * mmc->read_bl_len);
 		blocks_todo -= cur;
 		start += cur;
 		dst += cur * mmc->read_bl_len;
 	} while (blocks_todo > 0);
+	trace_event_end(TRACE_EVENT_BLK_READ, blkcnt * mmc->read_bl_len);
 
 	return blkcnt;
 }
@@ -285,51 +294,59 @@ static int mmc_go_idle(struct mmc *mmc)
 	return 0;
 }
 
-static int sd_send_op_cond(struct mmc *mmc)
+static int sd_send_op_cond_iter(struct mmc *mmc, struct mmc_cmd *cmd)
 {
-	int timeout = 1000;
 	int err;
-	struct mmc_cmd cmd;
 
-	do {
-		cmd.cmdidx = MMC_CMD_APP_CMD;
-		cmd.resp_type = MMC_RSP_R1;
-		cmd.cmdarg = 0;
+	cmd->cmdidx = MMC_CMD_APP_CMD;
+	cmd->resp_type = MMC_RSP_R1;
+	cmd->cmdarg = 0;
 
-		err = mmc_send_cmd(mmc, &cmd, NULL);
+	err = mmc_send_cmd(mmc, cmd, NULL);
 
-		if (err)
-			return err;
+	if (err)
+		return err;
 
-		cmd.cmdidx = SD_CMD_APP_SEND_OP_COND;
-		cmd.resp_type = MMC_RSP_R3;
+	cmd->cmdidx = SD_CMD_APP_SEND_OP_COND;
+	cmd->resp_type = MMC_RSP_R3;
 
-		/*
-		 * Most cards do not answer if some reserved bits
-		 * in the ocr are set. However, Some controller
-		 * can set bit 7 (reserved for low voltages), but
-		 * how to manage low voltages SD card is not yet
-		 * specified.
-		 */
-		cmd.cmdarg = mmc_host_is_spi(mmc) ? 0 :
-			(mmc->cfg->voltages & 0xff8000);
+	/*
+	 * Most cards do not answer if some reserved bits
+	 * in the ocr are set. However, Some controller
+	 * can set bit 7 (reserved for low voltages), but
+	 * how to manage low voltages SD card is not yet
+	 * specified.
+	 */
+	cmd->cmdarg = mmc_host_is_spi(mmc) ? 0 :
+		(mmc->cfg->voltages & 0xff8000);
 
-		if (mmc->version == SD_VERSION_2)
-			cmd.cmdarg |= OCR_HCS;
+	if (mmc->version == SD_VERSION_2)
+		cmd->cmdarg |= OCR_HCS;
 
-		err = mmc_send_cmd(mmc, &cmd, NULL);
+	err = mmc_send_cmd(mmc, cmd, NULL);
+	if (err)
+		return err;
+	mmc->op_cond_response = cmd->response[0];
+	return 0;
+}
 
-		if (err)
-			return err;
+static int sd_complete_op_cond(struct mmc *mmc)
+{
+	struct mmc_cmd cmd;
+	int timeout = 1000;
+	uint start;
+	int err;
 
+	mmc->op_cond_pending = 0;
+	start = get_timer(0);
+	while (!(mmc->op_cond_response & OCR_BUSY)) {
+		if (get_timer(start) > timeout)
+			return UNUSABLE_ERR;
 		udelay(1000);
-	} while ((!(cmd.response[0] & OCR_BUSY)) && timeout--);
-
-	if (timeout <= 0)
-		return UNUSABLE_ERR;
-
-	if (mmc->version != SD_VERSION_2)
-		mmc->version = SD_VERSION_1_0;
+		err = sd_send_op_cond_iter(mmc, &cmd);
+		if (err)
+			return err;
+	}
 
 	if (mmc_host_is_spi(mmc)) { /* read OCR for spi */
 		cmd.cmdidx = MMC_CMD_SPI_READ_OCR;
@@ -342,7 +359,8 @@ static int sd_send_op_cond(struct mmc *mmc)
 			return err;
 	}
 
-	mmc->ocr = cmd.response[0];
+	mmc->ocr = mmc_host_is_spi(mmc) ? cmd.response[0] :
+		mmc->op_cond_response;
 
 	mmc->high_capacity = ((mmc->ocr & OCR_HCS) == OCR_HCS);
 	mmc->rca = 0;
@@ -350,6 +368,25 @@ static int sd_send_op_cond(struct mmc *mmc)
 	return 0;
 }
 
+static int sd_send_op_cond(struct mmc *mmc)
+{
+	struct mmc_cmd cmd;
+	int err;
+
+	err = sd_send_op_cond_iter(mmc, &cmd);
+	if (err)
+		return err;
+
+	/* The card answered, so it is SD; leave it to finish powering up */
+	if (mmc->version != SD_VERSION_2)
+		mmc->version = SD_VERSION_1_0;
+	mmc->op_cond_pending = 1;
+	if (!(mmc->op_cond_response & OCR_BUSY))
+		return IN_PROGRESS;
+
+	return sd_complete_op_cond(mmc);
+}
+
 /* We pass in the cmd since otherwise the init seems to fail */
 static int mmc_send_op_cond_iter(struct mmc *mmc, struct mmc_cmd *cmd,
 		int use_arg)
@@ -383,6 +420,9 @@ static int mmc_send_op_cond(struct mmc *mmc)
 	/* Some cards seem to need this */
 	mmc_go_idle(mmc);
 
+	/* Not SD after all, whatever mmc_send_if_cond() found */
+	mmc->version = MMC_VERSION_UNKNOWN;
+
  	/* Asking to the card its capabilities */
 	mmc->op_cond_pending = 1;
 	for (i = 0; i < 2; i++) {
@@ -1627,7 +1667,8 @@ int mmc_start_init(struct mmc *mmc)
 		}
 	}
 
-	if (err == IN_PROGRESS)
+	/* Either way, mmc_complete_init() carries on from here */
+	if (!err || err == IN_PROGRESS)
 		mmc->init_in_progress = 1;
 
 	return err;
@@ -1638,7 +1679,8 @@ static int mmc_complete_init(struct mmc *mmc)
 	int err = 0;
 
 	if (mmc->op_cond_pending)
-		err = mmc_complete_op_cond(mmc);
+		err = IS_SD(mmc) ? sd_complete_op_cond(mmc) :
+			mmc_complete_op_cond(mmc);
 
 	if (!err)
 		err = mmc_startup(mmc);
@@ -1650,7 +1692,7 @@ static int mmc_complete_init(struct mmc *mmc)
 	return err;
 }
 
-int mmc_init(struct mmc *mmc)
+static int mmc_init_card(struct mmc *mmc)
 {
 	int err = IN_PROGRESS;
 	unsigned start;
@@ -1669,6 +1711,27 @@ int mmc_init(struct mmc *mmc)
 	return err;
 }
 
+static int mmc_finish_init(void *arg)
+{
+	struct mmc *mmc = arg;
+
+#ifdef CONFIG_JOBS
+	/* The card may be being set up on another CPU */
+	job_wait(&mmc->init_job);
+#endif
+
+	return mmc_init_card(mmc);
+}
+
+int mmc_init(struct mmc *mmc)
+{
+	/* The first use finishes, and times, what do_preinit() started */
+	if (deferred_pending(&mmc->init_defer))
+		return deferred_complete(&mmc->init_defer);
+
+	return mmc_finish_init(mmc);
+}
+
 int mmc_set_dsr(struct mmc *mmc, u16 val)
 {
 	mmc->dsr = val;
@@ -1731,16 +1794,42 @@ void mmc_set_preinit(struct mmc *mmc, int preinit)
 	mmc->preinit = preinit;
 }
 
+#ifdef CONFIG_JOBS
+static int mmc_init_job(void *arg)
+{
+	return mmc_init_card(arg);
+}
+#endif
+
 static void do_preinit(void)
 {
 	struct mmc *m;
 	struct list_head *entry;
+	int err;
 
 	list_for_each(entry, &mmc_devices) {
 		m = list_entry(entry, struct mmc, link);
 
-		if (m->preinit)
-			mmc_start_init(m);
+		if (!m->preinit)
+			continue;
+#ifdef CONFIG_JOBS
+		/*
+		 * With other CPUs to do the waiting, the card can be set up
+		 * on one of them. mmc_init() waits for the result.
+		 */
+		if (jobs_cpus()) {
+			job_init(&m->init_job, m->cfg->name, mmc_init_job, m);
+			job_start(&m->init_job);
+			deferred_start(&m->init_defer, m->cfg->name,
+				       mmc_finish_init, m);
+			continue;
+		}
+#endif
+		/* Leave the card powering up; mmc_init() waits for it */
+		err = mmc_start_init(m);
+		if (!err || err == IN_PROGRESS)
+			deferred_start(&m->init_defer, m->cfg->name,
+				       mmc_finish_init, m);
 	}
 }
 
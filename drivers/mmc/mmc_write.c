@@ -10,6 +10,7 @@
 #include <config.h>
 #include <common.h>
 #include <part.h>
+#include <trace.h>
 #include "mmc_private.h"
 
 static ulong mmc_erase_t(struct mmc *mmc, ulong start, lbaint_t blkcnt)
@@ -166,15 +167,21 @@ ulong mmc_bwrite(int dev_num, lbaint_t start, lbaint_t blkcnt, const void *src)
 	if (mmc_set_blocklen(mmc, mmc->write_bl_len))
 		return 0;
 
+	trace_event_start(TRACE_EVENT_BLK_WRITE);
 	do {
 		cur = (blocks_todo > mmc->cfg->b_max) ?
 			mmc->cfg->b_max : blocks_todo;
-		if (mmc_write_blocks(mmc, start, cur, src) != cur)
+		if (mmc_write_blocks(mmc, start, cur, src) != cur) {
+			trace_event_end(TRACE_EVENT_BLK_WRITE,
+					(blkcnt - blocks_todo) *
+					mmc->write_bl_len);
 			return 0;
+		}
 		blocks_todo -= cur;
 		start += cur;
 		src += cur * mmc->write_bl_len;
 	} while (blocks_todo > 0);
+	trace_event_end(TRACE_EVENT_BLK_WRITE, blkcnt * mmc->write_bl_len);
 
 	return blkcnt;
 }
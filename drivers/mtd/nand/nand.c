@@ -118,3 +118,15 @@ void nand_init(void)
 	board_nand_select_device(nand_info[nand_curr_device].priv, nand_curr_device);
 #endif
 }
+
+#ifdef CONFIG_NAND_BBT_ENV
+/* Called by env_relocate(), see nand_bbt_env_sync() */
+void nand_env_ready(void)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_SYS_MAX_NAND_DEVICE; i++)
+		if (nand_info[i].name)
+			nand_bbt_env_sync(&nand_info[i]);
+}
+#endif
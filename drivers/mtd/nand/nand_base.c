@@ -779,6 +779,7 @@ static void nand_command_lp(struct mtd_info *mtd, unsigned int command,
 {
 	register struct nand_chip *chip = mtd->priv;
 	uint32_t rst_sts_cnt = CONFIG_SYS_NAND_RESET_CNT;
+	unsigned int confirm = NAND_CMD_READSTART;
 
 	/* Emulate NAND_CMD_READOOB */
 	if (command == NAND_CMD_READOOB) {
@@ -786,6 +787,12 @@ static void nand_command_lp(struct mtd_info *mtd, unsigned int command,
 		command = NAND_CMD_READ0;
 	}
 
+	/* A multi-plane read is a READ0 confirmed with 32h */
+	if (command == NAND_CMD_READMULTI) {
+		confirm = NAND_CMD_READMULTI;
+		command = NAND_CMD_READ0;
+	}
+
 	/* Command latch cycle */
 	chip->cmd_ctrl(mtd, command, NAND_NCE | NAND_CLE | NAND_CTRL_CHANGE);
 
@@ -842,6 +849,7 @@ static void nand_command_lp(struct mtd_info *mtd, unsigned int command,
 		return;
 
 	case NAND_CMD_RNDOUT:
+	case NAND_CMD_RNDOUTENH:
 		/* No ready / busy check necessary */
 		chip->cmd_ctrl(mtd, NAND_CMD_RNDOUTSTART,
 			       NAND_NCE | NAND_CLE | NAND_CTRL_CHANGE);
@@ -850,7 +858,7 @@ static void nand_command_lp(struct mtd_info *mtd, unsigned int command,
 		return;
 
 	case NAND_CMD_READ0:
-		chip->cmd_ctrl(mtd, NAND_CMD_READSTART,
+		chip->cmd_ctrl(mtd, confirm,
 			       NAND_NCE | NAND_CLE | NAND_CTRL_CHANGE);
 		chip->cmd_ctrl(mtd, NAND_CMD_NONE,
 			       NAND_NCE | NAND_CTRL_CHANGE);
@@ -1618,6 +1626,86 @@ static int nand_setup_read_retry(struct mtd_info *mtd, int retry_mode)
 	return chip->setup_read_retry(mtd, retry_mode);
 }
 
+/**
+ * nand_read_cmd - [INTERN] Load a page into the data register
+ * @mtd: MTD device structure
+ * @page: page number to read
+ * @cache_page: page the chip is already fetching with a cache read, or -1
+ * @more: the next page is read too
+ *
+ * Chips with NAND_CACHE_READ keep reading the next page of a block while
+ * the current one is transferred: READ CACHE SEQUENTIAL (31h) moves the
+ * fetched page to the cache register and starts the next fetch, READ
+ * CACHE END (3Fh) moves the last one without starting another.
+ * Returns the page being fetched into the array, or -1 if none.
+ */
+static int nand_read_cmd(struct mtd_info *mtd, int page, int cache_page,
+			 bool more)
+{
+	struct nand_chip *chip = mtd->priv;
+	int ppb_mask = (1 << (chip->phys_erase_shift - chip->page_shift)) - 1;
+
+	if (page != cache_page) {
+		if (cache_page != -1)
+			chip->cmdfunc(mtd, NAND_CMD_READCACHEEND, -1, -1);
+		chip->cmdfunc(mtd, NAND_CMD_READ0, 0x00, page);
+		cache_page = -1;
+	}
+
+	if (!NAND_HAS_CACHE_READ(chip))
+		return -1;
+
+	/* Sequences do not cross block boundaries */
+	if (more && ((page + 1) & ppb_mask)) {
+		chip->cmdfunc(mtd, NAND_CMD_READCACHESEQ, -1, -1);
+		return page + 1;
+	}
+
+	if (cache_page != -1)
+		chip->cmdfunc(mtd, NAND_CMD_READCACHEEND, -1, -1);
+
+	return -1;
+}
+
+/**
+ * nand_read_multi_plane - [INTERN] Read a block from each plane at once
+ * @mtd: MTD device structure
+ * @page: first page of the block in plane 0
+ * @buf: buffer for chip->planes consecutive blocks
+ *
+ * The same page of each plane is loaded with a single array access, then
+ * the data registers are transferred one after the other with CHANGE READ
+ * COLUMN ENHANCED (06h-E0h). Returns the maximum number of bitflips.
+ */
+static int nand_read_multi_plane(struct mtd_info *mtd, int page, uint8_t *buf)
+{
+	struct nand_chip *chip = mtd->priv;
+	int ppb = 1 << (chip->phys_erase_shift - chip->page_shift);
+	unsigned int max_bitflips = 0;
+	int i, plane, ret;
+
+	for (i = 0; i < ppb; i++) {
+		WATCHDOG_RESET();
+		for (plane = 0; plane < chip->planes; plane++)
+			chip->cmdfunc(mtd, plane < chip->planes - 1 ?
+				      NAND_CMD_READMULTI : NAND_CMD_READ0,
+				      0x00, page + plane * ppb + i);
+
+		for (plane = 0; plane < chip->planes; plane++) {
+			chip->cmdfunc(mtd, NAND_CMD_RNDOUTENH, 0x00,
+				      page + plane * ppb + i);
+			ret = chip->ecc.read_page(mtd, chip,
+					buf + (plane * ppb + i) * mtd->writesize,
+					0, page + plane * ppb + i);
+			if (ret < 0)
+				return ret;
+			max_bitflips = max_t(unsigned int, max_bitflips, ret);
+		}
+	}
+
+	return max_bitflips;
+}
+
 /**
  * nand_do_read_ops - [INTERN] Read data with ECC
  * @mtd: MTD device structure
@@ -1641,6 +1729,9 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 	unsigned int max_bitflips = 0;
 	int retry_mode = 0;
 	bool ecc_fail = false;
+	int cache_page = -1;
+	uint32_t group = mtd->erasesize * chip->planes;
+	int group_pages = group >> chip->page_shift;
 
 	chipnr = (int)(from >> chip->chip_shift);
 	chip->select_chip(mtd, chipnr);
@@ -1658,6 +1749,33 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 		unsigned int ecc_failures = mtd->ecc_stats.failed;
 
 		WATCHDOG_RESET();
+
+		/* Read whole blocks of all planes at once when possible */
+		if (NAND_HAS_MULTI_PLANE_READ(chip) && !oob && !col &&
+		    ops->mode != MTD_OPS_RAW && chip->read_retries <= 1 &&
+		    cache_page == -1 && readlen >= group &&
+		    !(page & (group_pages - 1))) {
+			ret = nand_read_multi_plane(mtd, page, buf);
+			if (ret < 0)
+				break;
+			max_bitflips = max_t(unsigned int, max_bitflips, ret);
+			if (mtd->ecc_stats.failed - ecc_failures)
+				ecc_fail = true;
+
+			buf += group;
+			readlen -= group;
+			if (!readlen)
+				break;
+			realpage += group_pages;
+			page = realpage & chip->pagemask;
+			if (!page) {
+				chipnr++;
+				chip->select_chip(mtd, -1);
+				chip->select_chip(mtd, chipnr);
+			}
+			continue;
+		}
+
 		bytes = min(mtd->writesize - col, readlen);
 		aligned = (bytes == mtd->writesize);
 
@@ -1666,7 +1784,8 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 			bufpoi = aligned ? buf : chip->buffers->databuf;
 
 read_retry:
-			chip->cmdfunc(mtd, NAND_CMD_READ0, 0x00, page);
+			cache_page = nand_read_cmd(mtd, page, cache_page,
+						   readlen > bytes);
 
 			/*
 			 * Now read the page into the buffer.  Absent an error,
@@ -1735,6 +1854,12 @@ read_retry:
 
 					/* Reset failures; retry */
 					mtd->ecc_stats.failed = ecc_failures;
+					if (cache_page != -1) {
+						chip->cmdfunc(mtd,
+							NAND_CMD_READCACHEEND,
+							-1, -1);
+						cache_page = -1;
+					}
 					goto read_retry;
 				} else {
 					/* No more retry modes; real failure */
@@ -1776,6 +1901,8 @@ read_retry:
 			chip->select_chip(mtd, chipnr);
 		}
 	}
+	if (cache_page != -1)
+		chip->cmdfunc(mtd, NAND_CMD_READCACHEEND, -1, -1);
 	chip->select_chip(mtd, -1);
 
 	ops->retlen = ops->len - (size_t) readlen;
@@ -3324,6 +3451,16 @@ static int nand_flash_detect_onfi(struct mtd_info *mtd, struct nand_chip *chip,
 	if (p->jedec_id == NAND_MFR_MICRON)
 		nand_onfi_detect_micron(chip, p);
 
+	if (le16_to_cpu(p->opt_cmd) & ONFI_OPT_CMD_READ_CACHE)
+		chip->options |= NAND_CACHE_READ;
+
+	/* Multi-plane reads need 06h-E0h to pick the plane to transfer */
+	if (p->interleaved_bits && p->interleaved_bits < 4 &&
+	    (le16_to_cpu(p->opt_cmd) & ONFI_OPT_CMD_RNDOUT_ENH)) {
+		chip->options |= NAND_MULTI_PLANE_READ;
+		chip->planes = 1 << p->interleaved_bits;
+	}
+
 	return 1;
 }
 #else
@@ -4219,6 +4356,16 @@ int nand_scan_tail(struct mtd_info *mtd)
 	if ((ecc->mode == NAND_ECC_SOFT) && (chip->page_shift > 9))
 		chip->options |= NAND_SUBPAGE_READ;
 
+	/*
+	 * Cache and multi-plane reads are only sequenced by the default large
+	 * page command function, and need the page data to come out in order.
+	 */
+	if (chip->cmdfunc != nand_command_lp ||
+	    ecc->mode == NAND_ECC_HW_OOB_FIRST)
+		chip->options &= ~(NAND_CACHE_READ | NAND_MULTI_PLANE_READ);
+	if (!(chip->options & NAND_MULTI_PLANE_READ))
+		chip->planes = 1;
+
 	/* Fill in remaining MTD driver data */
 	mtd->type = nand_is_slc(chip) ? MTD_NANDFLASH : MTD_MLCNANDFLASH;
 	mtd->flags = (chip->options & NAND_ROM) ? MTD_CAP_ROM :
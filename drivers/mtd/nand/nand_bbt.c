@@ -75,6 +75,7 @@
 #include <common.h>
 #include <malloc.h>
 #include <linux/compat.h>
+#include <nand.h>
 
  #include <linux/mtd/mtd.h>
  #include <linux/mtd/bbm.h>
@@ -456,6 +457,29 @@ static int scan_block_fast(struct mtd_info *mtd, struct nand_bbt_descr *bd,
 	return 0;
 }
 
+/*
+ * Read only the bad block marker bytes instead of the whole OOB area, as
+ * nand_block_bad() does. Returns 1 if the block is bad.
+ */
+static int scan_block_bbm(struct mtd_info *mtd, struct nand_bbt_descr *bd,
+			  loff_t offs, int numpages)
+{
+	struct nand_chip *this = mtd->priv;
+	int page = (int)(offs >> this->page_shift) & this->pagemask;
+	int i, j, bad = 0;
+
+	this->select_chip(mtd, (int)(offs >> this->chip_shift));
+	for (j = 0; j < numpages && !bad; j++, page++) {
+		this->cmdfunc(mtd, NAND_CMD_READOOB, bd->offs, page);
+		for (i = 0; i < bd->len; i++)
+			if (this->read_byte(mtd) != bd->pattern[i])
+				bad = 1;
+	}
+	this->select_chip(mtd, -1);
+
+	return bad;
+}
+
 /**
  * create_bbt - [GENERIC] Create a bad block table by scanning the device
  * @mtd: MTD device structure
@@ -474,9 +498,17 @@ static int create_bbt(struct mtd_info *mtd, uint8_t *buf,
 	int i, numblocks, numpages;
 	int startblock;
 	loff_t from;
+	bool bbm_only;
 
 	pr_info("Scanning device for bad blocks\n");
 
+	/*
+	 * The generated pattern is the marker nand_block_bad() checks, which
+	 * can be read on its own on 8 bit chips.
+	 */
+	bbm_only = (bd->options & NAND_BBT_DYNAMICSTRUCT) &&
+		   !(this->options & NAND_BUSWIDTH_16);
+
 	if (bd->options & NAND_BBT_SCAN2NDPAGE)
 		numpages = 2;
 	else
@@ -506,7 +538,10 @@ static int create_bbt(struct mtd_info *mtd, uint8_t *buf,
 
 		BUG_ON(bd->options & NAND_BBT_NO_OOB);
 
-		ret = scan_block_fast(mtd, bd, from, buf, numpages);
+		if (bbm_only)
+			ret = scan_block_bbm(mtd, bd, from, numpages);
+		else
+			ret = scan_block_fast(mtd, bd, from, buf, numpages);
 		if (ret < 0)
 			return ret;
 
@@ -836,6 +871,153 @@ static int write_bbt(struct mtd_info *mtd, uint8_t *buf,
 	return res;
 }
 
+#ifdef CONFIG_NAND_BBT_ENV
+/*
+ * The memory based table is kept in the environment variable "<mtd name>bbt"
+ * as "<erase size>:<blocks>:<bad block>,<bad block>,..." in hex, so that a
+ * saved environment spares the scan at the next start.
+ *
+ * A chip holding the environment is scanned while the environment is being
+ * loaded, before the variable can be read or set. nand_bbt_env_sync() then
+ * stores the scanned table once the environment is ready.
+ *
+ * The environment is never saved from here: this code runs in the middle of
+ * NAND operations, and saving may write to the same device. 'nand markbad'
+ * saves it once it has finished.
+ */
+DECLARE_GLOBAL_DATA_PTR;
+
+static void bbt_env_name(struct mtd_info *mtd, char *name, size_t len)
+{
+	snprintf(name, len, "%sbbt", mtd->name);
+}
+
+/* Parse the variable, marking the bad blocks if @mark is set */
+static int bbt_env_parse(struct mtd_info *mtd, const char *p, int mark)
+{
+	struct nand_chip *this = mtd->priv;
+	int numblocks = mtd->size >> this->bbt_erase_shift;
+	char *end;
+	unsigned long block;
+
+	if (simple_strtoul(p, &end, 16) != mtd->erasesize || *end != ':')
+		return -EINVAL;
+	if (simple_strtoul(end + 1, &end, 16) != numblocks || *end != ':')
+		return -EINVAL;
+
+	for (p = end + 1; *p; p = end + 1) {
+		block = simple_strtoul(p, &end, 16);
+		if (end == p || block >= numblocks || (*end && *end != ','))
+			return -EINVAL;
+		if (mark) {
+			bbt_mark_entry(this, block, BBT_BLOCK_FACTORY_BAD);
+			mtd->ecc_stats.badblocks++;
+		}
+		if (!*end)
+			break;
+	}
+
+	return 0;
+}
+
+static int bbt_from_env(struct mtd_info *mtd)
+{
+	char name[32];
+	char *p;
+
+	if (!(gd->flags & GD_FLG_ENV_READY))
+		return 0;
+
+	bbt_env_name(mtd, name, sizeof(name));
+	p = getenv(name);
+	if (!p)
+		return 0;
+	if (bbt_env_parse(mtd, p, 0)) {
+		printf("Ignoring '%s' for another geometry\n", name);
+		return 0;
+	}
+	bbt_env_parse(mtd, p, 1);
+	pr_info("Bad block table from environment '%s'\n", name);
+
+	return 1;
+}
+
+/* Store the table in the variable */
+static void bbt_to_env(struct mtd_info *mtd)
+{
+	struct nand_chip *this = mtd->priv;
+	int numblocks = mtd->size >> this->bbt_erase_shift;
+	char name[32];
+	char *buf, *p, *old;
+	int block, bad = 0;
+
+	if (!(gd->flags & GD_FLG_ENV_READY))
+		return;
+
+	for (block = 0; block < numblocks; block++)
+		if (bbt_get_entry(this, block) != BBT_BLOCK_GOOD)
+			bad++;
+
+	p = buf = malloc(32 + 9 * bad);
+	if (!buf)
+		return;
+
+	p += sprintf(p, "%x:%x:", mtd->erasesize, numblocks);
+	for (block = 0; block < numblocks; block++) {
+		if (bbt_get_entry(this, block) != BBT_BLOCK_GOOD)
+			p += sprintf(p, "%s%x", p[-1] == ':' ? "" : ",",
+				     block);
+	}
+
+	bbt_env_name(mtd, name, sizeof(name));
+	old = getenv(name);
+	if (!old || strcmp(old, buf))
+		setenv(name, buf);
+	free(buf);
+}
+
+/**
+ * nand_bbt_env_sync - store a table scanned before the environment was ready
+ * @mtd: MTD device structure
+ *
+ * Called once the environment is loaded. A saved copy that differs from the
+ * scan is replaced in memory only; it is written by the next saveenv.
+ */
+void nand_bbt_env_sync(struct mtd_info *mtd)
+{
+	struct nand_chip *this = mtd->priv;
+
+	if (!this->bbt || (this->bbt_options & NAND_BBT_USE_FLASH))
+		return;
+
+	bbt_to_env(mtd);
+}
+
+/**
+ * nand_bbt_env_clear - forget the bad block table saved in the environment
+ * @mtd: MTD device structure
+ *
+ * Used when the bad block markers are erased, so that the next access scans
+ * the device again.
+ */
+void nand_bbt_env_clear(struct mtd_info *mtd)
+{
+	char name[32];
+
+	bbt_env_name(mtd, name, sizeof(name));
+	setenv(name, NULL);
+}
+#else
+static inline int bbt_from_env(struct mtd_info *mtd)
+{
+	return 0;
+}
+
+static inline void bbt_to_env(struct mtd_info *mtd)
+{
+}
+#endif
+
 /**
  * nand_memory_bbt - [GENERIC] create a memory based bad block table
  * @mtd: MTD device structure
@@ -847,8 +1029,16 @@ static int write_bbt(struct mtd_info *mtd, uint8_t *buf,
 static inline int nand_memory_bbt(struct mtd_info *mtd, struct nand_bbt_descr *bd)
 {
 	struct nand_chip *this = mtd->priv;
+	int res;
 
-	return create_bbt(mtd, this->buffers->databuf, bd, -1);
+	if (bbt_from_env(mtd))
+		return 0;
+
+	res = create_bbt(mtd, this->buffers->databuf, bd, -1);
+	if (!res)
+		bbt_to_env(mtd);
+
+	return res;
 }
 
 /**
@@ -1375,6 +1565,8 @@ int nand_markbad_bbt(struct mtd_info *mtd, loff_t offs)
 	/* Update flash-based bad block table */
 	if (this->bbt_options & NAND_BBT_USE_FLASH)
 		ret = nand_update_bbt(mtd, offs);
+	else
+		bbt_to_env(mtd);
 
 	return ret;
 }
@@ -18,6 +18,12 @@ static struct nand_chip nand_chip;
 					CONFIG_SYS_NAND_ECCSIZE)
 #define ECCTOTAL	(ECCSTEPS * CONFIG_SYS_NAND_ECCBYTES)
 
+#if defined(CONFIG_SPL_NAND_CACHE_READ) && \
+	((CONFIG_SYS_NAND_PAGE_SIZE <= 512) || \
+	 defined(CONFIG_SYS_NAND_HW_ECC_OOBFIRST))
+#error "CONFIG_SPL_NAND_CACHE_READ needs a large page, data first layout"
+#endif
+
 
 #if (CONFIG_SYS_NAND_PAGE_SIZE <= 512)
 /*
@@ -110,6 +116,49 @@ static int nand_command(int block, int page, uint32_t offs,
 
 	return 0;
 }
+
+#ifdef CONFIG_SPL_NAND_CACHE_READ
+/* Page the chip is fetching with READ CACHE SEQUENTIAL, or -1 */
+static int cache_next = -1;
+
+static void nand_cache_command(u8 cmd)
+{
+	struct nand_chip *this = mtd.priv;
+
+	while (!this->dev_ready(&mtd))
+		;
+
+	this->cmd_ctrl(&mtd, cmd, NAND_CTRL_CLE | NAND_CTRL_CHANGE);
+	this->cmd_ctrl(&mtd, NAND_CMD_NONE, NAND_NCE | NAND_CTRL_CHANGE);
+
+	while (!this->dev_ready(&mtd))
+		;
+}
+
+/*
+ * Load a page into the cache register, fetching the next page of the block
+ * while this one is transferred. Sequences end at the last page of a block.
+ */
+static void nand_cache_read(int block, int page)
+{
+	int page_addr = page + block * CONFIG_SYS_NAND_PAGE_COUNT;
+
+	if (page_addr != cache_next) {
+		if (cache_next != -1)
+			nand_cache_command(NAND_CMD_READCACHEEND);
+		nand_command(block, page, 0, NAND_CMD_READ0);
+		cache_next = -1;
+	}
+
+	if (page < CONFIG_SYS_NAND_PAGE_COUNT - 1) {
+		nand_cache_command(NAND_CMD_READCACHESEQ);
+		cache_next = page_addr + 1;
+	} else if (cache_next != -1) {
+		nand_cache_command(NAND_CMD_READCACHEEND);
+		cache_next = -1;
+	}
+}
+#endif
 #endif
 
 static int nand_is_bad_block(int block)
@@ -177,7 +226,11 @@ static int nand_read_page(int block, int page, void *dst)
 	int eccsteps = ECCSTEPS;
 	uint8_t *p = dst;
 
+#ifdef CONFIG_SPL_NAND_CACHE_READ
+	nand_cache_read(block, page);
+#else
 	nand_command(block, page, 0, NAND_CMD_READ0);
+#endif
 
 	for (i = 0; eccsteps; eccsteps--, i += eccbytes, p += eccsize) {
 		if (this->ecc.mode != NAND_ECC_SOFT)
@@ -92,6 +92,7 @@ int nand_erase_opts(nand_info_t *meminfo, const nand_erase_options_t *opts)
 		}
 		chip->bbt = NULL;
 		chip->options &= ~NAND_BBT_SCANNED;
+		nand_bbt_env_clear(meminfo);
 	}
 
 	for (erased_length = 0;
@@ -544,6 +545,113 @@ int nand_verify(nand_info_t *nand, loff_t ofs, size_t len, u_char *buf)
 
 
 
+static int is_all_ff(const u_char *buf, size_t len)
+{
+	while (len--) {
+		if (*buf++ != 0xff)
+			return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * nand_update_block:
+ *
+ * Write part of an eraseblock, first checking what it already holds.
+ * The whole block, including OOB, is read back in one go. If the data is
+ * already there nothing is done. Otherwise the block is erased, unless
+ * it already is, and the pages which are not all 0xFF are programmed,
+ * keeping the data and OOB of the pages outside the range. Pages in the
+ * range get fresh OOB, as with nand_write(). A block which cannot be
+ * read is only rewritten if the range covers all of it.
+ *
+ * @param nand		NAND device
+ * @param offset	offset in flash, within a good block
+ * @param len		length to write, not crossing the block end
+ * @param buf		buffer to read from
+ * @param blockbuf	scratch buffer for a block's data and OOB
+ * @param flags		WITH_WR_VERIFY to verify data that is written
+ * @param stats		statistics to update
+ * @return		0 in case of success
+ */
+static int nand_update_block(nand_info_t *nand, loff_t offset, size_t len,
+			     const u_char *buf, u_char *blockbuf, int flags,
+			     struct nand_update_stats *stats)
+{
+	loff_t block = offset & ~((loff_t)nand->erasesize - 1);
+	size_t block_offset = offset - block;
+	u_char *oobbuf = blockbuf + nand->erasesize;
+	struct mtd_oob_ops ops = {
+		.mode = MTD_OPS_PLACE_OOB,
+		.len = nand->erasesize,
+		.datbuf = blockbuf,
+		.ooblen = nand->erasesize / nand->writesize * nand->oobsize,
+		.oobbuf = oobbuf,
+	};
+	size_t pos, run = 0, start = 0, first, last;
+	int rval, erased;
+
+	rval = mtd_read_oob(nand, block, &ops);
+	if (rval && rval != -EUCLEAN) {
+		/* Nothing outside the range can be trusted */
+		if (len != nand->erasesize) {
+			printf("Cannot read block 0x%08llx to update it: %d\n",
+			       block, rval);
+			return rval;
+		}
+		erased = 0;
+	} else if (!memcmp(blockbuf + block_offset, buf, len)) {
+		stats->unchanged += len;
+		return 0;
+	} else {
+		erased = is_all_ff(blockbuf, ops.len) &&
+			 is_all_ff(oobbuf, ops.ooblen);
+	}
+
+	/* The pages being written get fresh OOB, the others keep theirs */
+	memcpy(blockbuf + block_offset, buf, len);
+	first = block_offset / nand->writesize;
+	last = (block_offset + len - 1) / nand->writesize;
+	memset(oobbuf + first * nand->oobsize, 0xff,
+	       (last - first + 1) * nand->oobsize);
+	if (!erased) {
+		rval = nand_erase(nand, block, nand->erasesize);
+		if (rval)
+			return rval;
+		stats->erased += nand->erasesize;
+	}
+
+	for (pos = 0; pos <= nand->erasesize; pos += nand->writesize) {
+		if (pos < nand->erasesize &&
+		    (!is_all_ff(blockbuf + pos, nand->writesize) ||
+		     !is_all_ff(oobbuf + pos / nand->writesize * nand->oobsize,
+				nand->oobsize))) {
+			if (!run)
+				start = pos;
+			run += nand->writesize;
+			continue;
+		}
+		if (!run)
+			continue;
+		/* ECC bytes in the OOB are replaced as the pages are written */
+		ops.len = run;
+		ops.datbuf = blockbuf + start;
+		ops.ooblen = run / nand->writesize * nand->oobsize;
+		ops.oobbuf = oobbuf + start / nand->writesize * nand->oobsize;
+		rval = mtd_write_oob(nand, block + start, &ops);
+		if (rval)
+			return rval;
+		stats->programmed += run;
+		run = 0;
+	}
+
+	if (flags & WITH_WR_VERIFY)
+		return nand_verify(nand, offset, len, (u_char *)buf);
+
+	return 0;
+}
+
 /**
  * nand_write_skip_bad:
  *
@@ -570,13 +678,35 @@ int nand_verify(nand_info_t *nand, loff_t ofs, size_t len, u_char *buf)
  */
 int nand_write_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
 		size_t *actual, loff_t lim, u_char *buffer, int flags)
+{
+	struct nand_update_stats stats;
+
+	return nand_update_skip_bad(nand, offset, length, actual, lim, buffer,
+				    flags, &stats);
+}
+
+/**
+ * nand_update_skip_bad:
+ *
+ * Same as nand_write_skip_bad(), but also return what was done to the
+ * flash when flags include WITH_UPDATE.
+ *
+ * @param stats		set to the bytes found unchanged, erased and
+ *			programmed; only meaningful with WITH_UPDATE
+ * @return		0 in case of success
+ */
+int nand_update_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
+			 size_t *actual, loff_t lim, u_char *buffer, int flags,
+			 struct nand_update_stats *stats)
 {
 	int rval = 0, blocksize;
 	size_t left_to_write = *length;
 	size_t used_for_write = 0;
 	u_char *p_buffer = buffer;
+	u_char *blockbuf = NULL;
 	int need_skip;
 
+	memset(stats, 0, sizeof(*stats));
 	if (actual)
 		*actual = 0;
 
@@ -616,7 +746,7 @@ int nand_write_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
 		return -EFBIG;
 	}
 
-	if (!need_skip && !(flags & WITH_DROP_FFS)) {
+	if (!need_skip && !(flags & (WITH_DROP_FFS | WITH_UPDATE))) {
 		rval = nand_write(nand, offset, length, buffer);
 
 		if ((flags & WITH_WR_VERIFY) && !rval)
@@ -631,6 +761,15 @@ int nand_write_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
 		return rval;
 	}
 
+	if (flags & WITH_UPDATE) {
+		blockbuf = malloc(nand->erasesize + nand->erasesize /
+				  nand->writesize * nand->oobsize);
+		if (!blockbuf) {
+			*length = 0;
+			return -ENOMEM;
+		}
+	}
+
 	while (left_to_write > 0) {
 		size_t block_offset = offset & (nand->erasesize - 1);
 		size_t write_size, truncated_write_size;
@@ -649,19 +788,25 @@ int nand_write_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
 		else
 			write_size = blocksize - block_offset;
 
-		truncated_write_size = write_size;
+		if (flags & WITH_UPDATE) {
+			rval = nand_update_block(nand, offset, write_size,
+						 p_buffer, blockbuf, flags,
+						 stats);
+		} else {
+			truncated_write_size = write_size;
 #ifdef CONFIG_CMD_NAND_TRIMFFS
-		if (flags & WITH_DROP_FFS)
-			truncated_write_size = drop_ffs(nand, p_buffer,
-					&write_size);
+			if (flags & WITH_DROP_FFS)
+				truncated_write_size = drop_ffs(nand, p_buffer,
+						&write_size);
 #endif
 
-		rval = nand_write(nand, offset, &truncated_write_size,
-				p_buffer);
+			rval = nand_write(nand, offset, &truncated_write_size,
+					p_buffer);
 
-		if ((flags & WITH_WR_VERIFY) && !rval)
-			rval = nand_verify(nand, offset,
-				truncated_write_size, p_buffer);
+			if ((flags & WITH_WR_VERIFY) && !rval)
+				rval = nand_verify(nand, offset,
+					truncated_write_size, p_buffer);
+		}
 
 		offset += write_size;
 		p_buffer += write_size;
@@ -670,12 +815,15 @@ int nand_write_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
 			printf("NAND write to offset %llx failed %d\n",
 				offset, rval);
 			*length -= left_to_write;
+			free(blockbuf);
 			return rval;
 		}
 
 		left_to_write -= write_size;
 	}
 
+	free(blockbuf);
+
 	return 0;
 }
 
@@ -0,0 +1,726 @@
+/*
+ * File-backed NAND flash simulator for sandbox
+ *
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ *
+ * The chip is driven through cmd_ctrl() at the command/address latch level,
+ * so all of nand_base.c (command sequencing, ECC, bad block handling) runs
+ * as it does on real hardware. Each page and its OOB area are stored back
+ * to back in a host file, which is created filled with 0xff if needed.
+ *
+ * It is connected with --nand <file>[:<option>=<value>...], options being:
+ *	size	chip size in MiB (default 128)
+ *	page	page size in bytes (default 2048)
+ *	oob	OOB size in bytes (default 64)
+ *	ppb	pages per block (default 64)
+ *	bad	bad blocks, separated by commas; these are marked in the OOB
+ *		and fail to program or erase
+ *	tr	page read time in us (default 0)
+ *	tprog	page program time in us (default 0)
+ *	terase	block erase time in us (default 0)
+ *	tbyte	bus transfer time per byte in ns (default 0)
+ *	bitflip	flip bits in one of this many page reads (default 0: never)
+ *	flips	number of bits flipped in the same ECC step (default 1)
+ *	onfi	1 to identify through an ONFI parameter page announcing READ
+ *		CACHE SEQUENTIAL / END (31h/3Fh) instead of the ID table
+ *	planes	planes read together with 32h and 06h-E0h (default 1), needs
+ *		onfi=1
+ *
+ * In ONFI mode the next page of a cache read is fetched while the current
+ * one is transferred, and the pages of a multi-plane read share a single
+ * array access, so tr and tbyte show what these commands save. Command
+ * sequences such chips would reject are reported as "NAND sim:" errors.
+ */
+
+#include <common.h>
+#include <errno.h>
+#include <malloc.h>
+#include <nand.h>
+#include <os.h>
+#include <asm/getopt.h>
+#include <asm/state.h>
+
+#define SIM_MAX_BAD		32
+#define SIM_MAX_PLANES		4
+
+/* Timing and fault model, see the file header */
+struct sim_model {
+	unsigned long t_read;		/* us */
+	unsigned long t_prog;		/* us */
+	unsigned long t_erase;		/* us */
+	unsigned long t_byte;		/* ns */
+	unsigned int bitflip;		/* one in this many page reads */
+	unsigned int flips;		/* bits per bit-flip event */
+};
+
+struct sandbox_nand {
+	struct nand_chip chip;
+	struct nand_flash_dev id[2];
+	struct sim_model model;
+	int fd;
+
+	unsigned int page_size;		/* data bytes per page */
+	unsigned int oob_size;
+	unsigned int ppb;		/* pages per block */
+	unsigned int pages;
+	unsigned int raw_size;		/* page_size + oob_size */
+	int bad[SIM_MAX_BAD];
+	int bad_count;
+	int onfi;
+	unsigned int planes;
+
+	/* bus state */
+	u8 cmd;				/* last command latched */
+	u8 addr[5];
+	int addr_count;
+	int addr_done;			/* address of @cmd decoded */
+	int row;
+	int col;
+	int status;
+	u8 *reg;			/* selected page register */
+	u8 *regs;			/* one page register per plane */
+	int reg_row[SIM_MAX_PLANES];	/* page held by each register */
+	unsigned long busy_until;	/* timer_get_us() */
+	int cache_row;			/* page fetched by a cache read, or -1 */
+	unsigned long array_until;	/* end of that fetch */
+	int multi_row[SIM_MAX_PLANES];	/* pages queued by 32h, or -1 */
+	unsigned int reads;		/* page reads, for bit-flips */
+	u32 seed;
+	struct nand_onfi_params onfi_params;
+};
+
+static struct sandbox_nand sim;
+
+static const u8 sim_id[] = { 0x2c, 0xdc, 0x90, 0x95, 0x56 };
+
+/* Spin for the bus transfer time of @bytes */
+static void sim_transfer(unsigned long bytes)
+{
+	unsigned long us = bytes * sim.model.t_byte / 1000;
+	unsigned long start = timer_get_us();
+
+	while (us && timer_get_us() - start < us)
+		;
+}
+
+static void sim_busy(unsigned long us)
+{
+	sim.busy_until = timer_get_us() + us;
+}
+
+static int sim_is_ready(void)
+{
+	return timer_get_us() >= sim.busy_until;
+}
+
+static int sim_plane(int row)
+{
+	return (row / sim.ppb) & (sim.planes - 1);
+}
+
+/* Use the page register of @plane, which is about to hold @row */
+static void sim_select(int plane, int row)
+{
+	sim.reg = sim.regs + plane * sim.raw_size;
+	sim.reg_row[plane] = row;
+}
+
+static int sim_is_bad(int block)
+{
+	int i;
+
+	for (i = 0; i < sim.bad_count; i++)
+		if (sim.bad[i] == block)
+			return 1;
+
+	return 0;
+}
+
+static int sim_io(int page, void *buf, int write)
+{
+	off_t pos = (off_t)page * sim.raw_size;
+	ssize_t ret;
+
+	if (os_lseek(sim.fd, pos, OS_SEEK_SET) != pos)
+		return -EIO;
+	if (write)
+		ret = os_write(sim.fd, buf, sim.raw_size);
+	else
+		ret = os_read(sim.fd, buf, sim.raw_size);
+
+	return ret == sim.raw_size ? 0 : -EIO;
+}
+
+static u32 sim_random(void)
+{
+	sim.seed = sim.seed * 1103515245 + 12345;
+	return sim.seed >> 8;
+}
+
+static void sim_read_page(void)
+{
+	unsigned int step, bit, i;
+
+	if (sim.row >= sim.pages || sim_io(sim.row, sim.reg, 0)) {
+		memset(sim.reg, 0, sim.raw_size);
+		return;
+	}
+
+	sim.reads++;
+	if (!sim.model.bitflip || sim.reads % sim.model.bitflip)
+		return;
+
+	/* flip bits within one 256-byte ECC step of the data area */
+	step = (sim_random() % (sim.page_size / 256)) * 256;
+	for (i = 0; i < sim.model.flips; i++) {
+		bit = sim_random() % (256 * 8);
+		sim.reg[step + bit / 8] ^= 1 << (bit % 8);
+	}
+}
+
+static int sim_program_page(void)
+{
+	u8 *old;
+	int i, ret;
+
+	if (sim.row >= sim.pages || sim_is_bad(sim.row / sim.ppb))
+		return -EIO;
+
+	old = malloc(sim.raw_size);
+	if (!old)
+		return -ENOMEM;
+
+	/* programming can only clear bits */
+	ret = sim_io(sim.row, old, 0);
+	if (!ret) {
+		for (i = 0; i < sim.raw_size; i++)
+			old[i] &= sim.reg[i];
+		ret = sim_io(sim.row, old, 1);
+	}
+	free(old);
+
+	return ret;
+}
+
+static int sim_erase_block(void)
+{
+	int block = sim.row / sim.ppb;
+	int page, ret = 0;
+
+	if (sim.row >= sim.pages || sim_is_bad(block))
+		return -EIO;
+
+	sim_select(0, -1);
+	memset(sim.reg, 0xff, sim.raw_size);
+	for (page = 0; page < sim.ppb && !ret; page++)
+		ret = sim_io(block * sim.ppb + page, sim.reg, 1);
+
+	return ret;
+}
+
+/* Decode the address cycles latched for the current command */
+static void sim_decode_addr(void)
+{
+	if (sim.addr_done)
+		return;
+	sim.addr_done = 1;
+
+	switch (sim.cmd) {
+	case NAND_CMD_READ0:
+	case NAND_CMD_SEQIN:
+		sim.col = sim.addr[0] | sim.addr[1] << 8;
+		sim.row = sim.addr[2] | sim.addr[3] << 8 | sim.addr[4] << 16;
+		break;
+	case NAND_CMD_RNDOUTENH:
+		sim.col = sim.addr[0] | sim.addr[1] << 8;
+		sim.row = sim.addr[2] | sim.addr[3] << 8 | sim.addr[4] << 16;
+		if (sim.reg_row[sim_plane(sim.row)] != sim.row)
+			printf("NAND sim: 06h for page %#x which was not read\n",
+			       sim.row);
+		sim.reg = sim.regs + sim_plane(sim.row) * sim.raw_size;
+		break;
+	case NAND_CMD_RNDOUT:
+	case NAND_CMD_RNDIN:
+		sim.col = sim.addr[0] | sim.addr[1] << 8;
+		break;
+	case NAND_CMD_ERASE1:
+		sim.row = sim.addr[0] | sim.addr[1] << 8 | sim.addr[2] << 16;
+		break;
+	case NAND_CMD_READID:
+	case NAND_CMD_PARAM:
+		sim.col = sim.addr[0];
+		break;
+	}
+}
+
+/* Load the pages queued by 32h and the current one with one array access */
+static void sim_read_planes(void)
+{
+	int row = sim.row;
+	int plane;
+
+	for (plane = 0; plane < sim.planes; plane++) {
+		if (sim.multi_row[plane] == -1)
+			continue;
+		if (plane == sim_plane(row) ||
+		    sim.multi_row[plane] % sim.ppb != row % sim.ppb)
+			printf("NAND sim: multi-plane read of pages %#x and %#x\n",
+			       sim.multi_row[plane], row);
+		sim.row = sim.multi_row[plane];
+		sim_select(plane, sim.row);
+		sim_read_page();
+		sim.multi_row[plane] = -1;
+	}
+
+	sim.row = row;
+	sim_select(sim_plane(row), row);
+	sim_read_page();
+}
+
+/* Wait for the page being fetched, then move it to the cache register */
+static void sim_read_cache(u8 cmd)
+{
+	unsigned long now = timer_get_us();
+
+	if (sim.cache_row == -1) {
+		if (cmd == NAND_CMD_READCACHEEND ||
+		    sim.reg_row[sim_plane(sim.row)] != sim.row) {
+			printf("NAND sim: %02xh without a page read\n", cmd);
+			return;
+		}
+		/* the page read by 30h goes straight to the cache */
+		sim.cache_row = sim.row + 1;
+		sim.array_until = now + sim.model.t_read;
+		sim.col = 0;
+		return;
+	}
+
+	sim.busy_until = max(now, sim.array_until);
+	sim.row = sim.cache_row;
+	sim_select(sim_plane(sim.row), sim.row);
+	sim_read_page();
+	sim.col = 0;
+
+	if (cmd == NAND_CMD_READCACHESEQ) {
+		sim.cache_row++;
+		sim.array_until = sim.busy_until + sim.model.t_read;
+	} else {
+		sim.cache_row = -1;
+	}
+}
+
+static void sim_command(u8 cmd)
+{
+	int ret;
+
+	sim_decode_addr();
+
+	if (!sim_is_ready() && cmd != NAND_CMD_STATUS &&
+	    cmd != NAND_CMD_RESET && cmd != NAND_CMD_READCACHESEQ &&
+	    cmd != NAND_CMD_READCACHEEND)
+		printf("NAND sim: command %02xh while busy\n", cmd);
+	if (sim.cache_row != -1 &&
+	    (cmd == NAND_CMD_READ0 || cmd == NAND_CMD_SEQIN ||
+	     cmd == NAND_CMD_ERASE1)) {
+		printf("NAND sim: command %02xh during a cache read\n", cmd);
+		sim.cache_row = -1;
+	}
+
+	switch (cmd) {
+	case NAND_CMD_READSTART:
+		sim_read_planes();
+		sim_busy(sim.model.t_read);
+		break;
+	case NAND_CMD_READMULTI:
+		if (sim.planes < 2 || sim.cmd != NAND_CMD_READ0) {
+			printf("NAND sim: unexpected 32h\n");
+			break;
+		}
+		sim.multi_row[sim_plane(sim.row)] = sim.row;
+		break;
+	case NAND_CMD_READCACHESEQ:
+	case NAND_CMD_READCACHEEND:
+		if (!sim.onfi) {
+			printf("NAND sim: unexpected %02xh\n", cmd);
+			break;
+		}
+		sim_read_cache(cmd);
+		break;
+	case NAND_CMD_RNDOUTSTART:
+		break;
+	case NAND_CMD_SEQIN:
+		sim_select(0, -1);
+		memset(sim.reg, 0xff, sim.raw_size);
+		break;
+	case NAND_CMD_PAGEPROG:
+	case NAND_CMD_CACHEDPROG:
+		ret = sim_program_page();
+		sim.status = ret ? NAND_STATUS_FAIL : 0;
+		sim_busy(sim.model.t_prog);
+		break;
+	case NAND_CMD_ERASE2:
+		ret = sim_erase_block();
+		sim.status = ret ? NAND_STATUS_FAIL : 0;
+		sim_busy(sim.model.t_erase);
+		break;
+	case NAND_CMD_RESET:
+		sim.status = 0;
+		sim.busy_until = 0;
+		sim.cache_row = -1;
+		break;
+	}
+
+	/* keep the command whose data phase follows */
+	if (cmd != NAND_CMD_READSTART && cmd != NAND_CMD_RNDOUTSTART &&
+	    cmd != NAND_CMD_PAGEPROG && cmd != NAND_CMD_CACHEDPROG &&
+	    cmd != NAND_CMD_ERASE2 && cmd != NAND_CMD_READCACHESEQ &&
+	    cmd != NAND_CMD_READCACHEEND && cmd != NAND_CMD_READMULTI) {
+		sim.cmd = cmd;
+		sim.addr_count = 0;
+		sim.addr_done = 0;
+		memset(sim.addr, 0, sizeof(sim.addr));
+	}
+}
+
+static void sandbox_nand_cmd_ctrl(struct mtd_info *mtd, int dat,
+				  unsigned int ctrl)
+{
+	if (dat == NAND_CMD_NONE)
+		return;
+
+	if (ctrl & NAND_CLE) {
+		sim_command(dat);
+	} else if (ctrl & NAND_ALE) {
+		if (sim.addr_count < sizeof(sim.addr))
+			sim.addr[sim.addr_count++] = dat;
+		sim.addr_done = 0;
+	}
+}
+
+static int sandbox_nand_dev_ready(struct mtd_info *mtd)
+{
+	return sim_is_ready();
+}
+
+static uint8_t sandbox_nand_read_byte(struct mtd_info *mtd)
+{
+	u8 val = 0;
+
+	sim_decode_addr();
+
+	switch (sim.cmd) {
+	case NAND_CMD_STATUS:
+		val = sim.status | NAND_STATUS_WP;
+		if (sandbox_nand_dev_ready(mtd))
+			val |= NAND_STATUS_READY | NAND_STATUS_TRUE_READY;
+		return val;
+	case NAND_CMD_READID:
+		/* anything else, e.g. the JEDEC signature, reads as zero */
+		if (sim.col < sizeof(sim_id))
+			val = sim_id[sim.col];
+		else if (sim.onfi && sim.col >= 0x20 && sim.col < 0x24)
+			val = "ONFI"[sim.col - 0x20];
+		sim.col++;
+		return val;
+	case NAND_CMD_PARAM:
+		/* the parameter page is repeated three times */
+		if (sim.onfi && sim.col < 3 * sizeof(sim.onfi_params))
+			val = ((u8 *)&sim.onfi_params)[sim.col %
+						sizeof(sim.onfi_params)];
+		sim.col++;
+		return val;
+	}
+
+	if (sim.col < sim.raw_size)
+		val = sim.reg[sim.col++];
+	sim_transfer(1);
+
+	return val;
+}
+
+static void sandbox_nand_read_buf(struct mtd_info *mtd, uint8_t *buf, int len)
+{
+	int avail;
+
+	sim_decode_addr();
+	avail = min(len, (int)(sim.raw_size - sim.col));
+	if (avail > 0) {
+		memcpy(buf, sim.reg + sim.col, avail);
+		sim.col += avail;
+	} else {
+		avail = 0;
+	}
+	memset(buf + avail, 0xff, len - avail);
+	sim_transfer(len);
+}
+
+static void sandbox_nand_write_buf(struct mtd_info *mtd, const uint8_t *buf,
+				   int len)
+{
+	int avail;
+
+	sim_decode_addr();
+	avail = min(len, (int)(sim.raw_size - sim.col));
+	if (avail > 0) {
+		memcpy(sim.reg + sim.col, buf, avail);
+		sim.col += avail;
+	}
+	sim_transfer(len);
+}
+
+static void sandbox_nand_select_chip(struct mtd_info *mtd, int chipnr)
+{
+}
+
+static u16 sim_crc16(u16 crc, const u8 *p, size_t len)
+{
+	int i;
+
+	while (len--) {
+		crc ^= *p++ << 8;
+		for (i = 0; i < 8; i++)
+			crc = (crc << 1) ^ ((crc & 0x8000) ? 0x8005 : 0);
+	}
+
+	return crc;
+}
+
+/* Describe the chip in an ONFI 2.0 parameter page */
+static void sim_init_onfi(void)
+{
+	struct nand_onfi_params *p = &sim.onfi_params;
+	u16 opt_cmd = ONFI_OPT_CMD_READ_CACHE;
+
+	if (sim.planes > 1)
+		opt_cmd |= ONFI_OPT_CMD_RNDOUT_ENH;
+
+	memset(p, 0, sizeof(*p));
+	memcpy(p->sig, "ONFI", 4);
+	p->revision = cpu_to_le16(1 << 2);
+	p->opt_cmd = cpu_to_le16(opt_cmd);
+	memset(p->manufacturer, ' ', sizeof(p->manufacturer));
+	memcpy(p->manufacturer, "SANDBOX", 7);
+	memset(p->model, ' ', sizeof(p->model));
+	memcpy(p->model, "sandbox ONFI NAND", 17);
+	p->byte_per_page = cpu_to_le32(sim.page_size);
+	p->spare_bytes_per_page = cpu_to_le16(sim.oob_size);
+	p->pages_per_block = cpu_to_le32(sim.ppb);
+	p->blocks_per_lun = cpu_to_le32(sim.pages / sim.ppb);
+	p->lun_count = 1;
+	p->addr_cycles = 0x23;
+	p->bits_per_cell = 1;
+	p->programs_per_page = 4;
+	p->ecc_bits = 1;
+	p->interleaved_bits = ffs(sim.planes) - 1;
+	p->t_r = cpu_to_le16(sim.model.t_read);
+	p->t_prog = cpu_to_le16(sim.model.t_prog);
+	p->t_bers = cpu_to_le16(sim.model.t_erase);
+	p->crc = cpu_to_le16(sim_crc16(ONFI_CRC_BASE, (u8 *)p, 254));
+}
+
+/* Make the backing file the right size and mark the bad blocks */
+static int sim_prepare_file(void)
+{
+	off_t size = (off_t)sim.pages * sim.raw_size;
+	off_t end;
+	int i, page;
+
+	end = os_lseek(sim.fd, 0, OS_SEEK_END);
+	if (end < 0)
+		return -EIO;
+	end -= end % sim.raw_size;
+
+	memset(sim.reg, 0xff, sim.raw_size);
+	for (page = end / sim.raw_size; page < sim.pages; page++) {
+		if (sim_io(page, sim.reg, 1))
+			return -EIO;
+	}
+
+	for (i = 0; i < sim.bad_count; i++) {
+		page = sim.bad[i] * sim.ppb;
+		if (page >= sim.pages || sim_io(page, sim.reg, 0))
+			continue;
+		sim.reg[sim.page_size] = 0;
+		sim_io(page, sim.reg, 1);
+	}
+	debug("%s: %lld bytes\n", __func__, (long long)size);
+
+	return 0;
+}
+
+static int sim_parse_spec(char *spec, char **fname)
+{
+	unsigned long size = 128;
+	char *opt, *val;
+
+	sim.page_size = 2048;
+	sim.oob_size = 64;
+	sim.ppb = 64;
+	sim.planes = 1;
+	sim.model.flips = 1;
+
+	*fname = strsep(&spec, ":");
+	while ((opt = strsep(&spec, ":"))) {
+		val = strchr(opt, '=');
+		if (!val)
+			return -EINVAL;
+		*val++ = '\0';
+
+		if (!strcmp(opt, "size")) {
+			size = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "page")) {
+			sim.page_size = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "oob")) {
+			sim.oob_size = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "ppb")) {
+			sim.ppb = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "bad")) {
+			while (*val && sim.bad_count < SIM_MAX_BAD) {
+				sim.bad[sim.bad_count++] =
+					simple_strtoul(val, &val, 0);
+				if (*val != ',')
+					break;
+				val++;
+			}
+		} else if (!strcmp(opt, "tr")) {
+			sim.model.t_read = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "tprog")) {
+			sim.model.t_prog = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "terase")) {
+			sim.model.t_erase = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "tbyte")) {
+			sim.model.t_byte = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "bitflip")) {
+			sim.model.bitflip = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "flips")) {
+			sim.model.flips = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "onfi")) {
+			sim.onfi = simple_strtoul(val, NULL, 0);
+		} else if (!strcmp(opt, "planes")) {
+			sim.planes = simple_strtoul(val, NULL, 0);
+		} else {
+			printf("NAND: unknown option '%s'\n", opt);
+			return -EINVAL;
+		}
+	}
+
+	/* the soft ECC layouts need 3 bytes per 256 in 3/8 of the OOB */
+	if (!sim.page_size || sim.page_size % 512 || !sim.ppb || !size ||
+	    (sim.oob_size != 16 && sim.oob_size != 64 &&
+	     sim.oob_size != 128) ||
+	    sim.page_size / 256 * 3 > sim.oob_size * 3 / 8) {
+		printf("NAND: bad geometry\n");
+		return -EINVAL;
+	}
+	sim.raw_size = sim.page_size + sim.oob_size;
+	sim.pages = (size << 20) / sim.page_size;
+
+	if (sim.planes > SIM_MAX_PLANES || !is_power_of_2(sim.planes) ||
+	    (sim.planes > 1 && !sim.onfi) ||
+	    sim.pages % (sim.ppb * sim.planes)) {
+		printf("NAND: bad plane count\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int sandbox_nand_init(struct mtd_info *mtd, const char *spec)
+{
+	struct nand_chip *chip = &sim.chip;
+	struct nand_flash_dev *id = &sim.id[0];
+	char *fname, *buf;
+	int i, ret;
+
+	buf = strdup(spec);
+	if (!buf)
+		return -ENOMEM;
+	ret = sim_parse_spec(buf, &fname);
+	if (ret)
+		goto err;
+
+	ret = -ENOMEM;
+	sim.regs = malloc(sim.raw_size * sim.planes);
+	if (!sim.regs)
+		goto err;
+	sim.reg = sim.regs;
+	sim.cache_row = -1;
+	for (i = 0; i < SIM_MAX_PLANES; i++) {
+		sim.reg_row[i] = -1;
+		sim.multi_row[i] = -1;
+	}
+
+	ret = -EIO;
+	sim.fd = os_open(fname, OS_O_RDWR | OS_O_CREAT);
+	if (sim.fd < 0) {
+		printf("NAND: cannot open '%s'\n", fname);
+		goto err;
+	}
+	ret = sim_prepare_file();
+	if (ret)
+		goto err;
+
+	/* with an empty ID table nand_base reads the parameter page */
+	if (sim.onfi) {
+		sim_init_onfi();
+	} else {
+		memcpy(id->id, sim_id, sizeof(sim_id));
+		id->name = "sandbox NAND";
+		id->id_len = sizeof(sim_id);
+		id->pagesize = sim.page_size;
+		id->oobsize = sim.oob_size;
+		id->erasesize = sim.page_size * sim.ppb;
+		id->chipsize = ((u64)sim.pages * sim.page_size) >> 20;
+	}
+
+	chip->cmd_ctrl = sandbox_nand_cmd_ctrl;
+	chip->dev_ready = sandbox_nand_dev_ready;
+	chip->read_byte = sandbox_nand_read_byte;
+	chip->read_buf = sandbox_nand_read_buf;
+	chip->write_buf = sandbox_nand_write_buf;
+	chip->select_chip = sandbox_nand_select_chip;
+	chip->ecc.mode = NAND_ECC_SOFT;
+	chip->chip_delay = 0;
+	mtd->priv = chip;
+
+	ret = nand_scan_ident(mtd, 1, sim.id);
+	if (!ret)
+		ret = nand_scan_tail(mtd);
+	if (ret)
+		goto err;
+
+	free(buf);
+	return nand_register(0);
+
+err:
+	if (sim.fd >= 0)
+		os_close(sim.fd);
+	sim.fd = -1;
+	free(buf);
+	free(sim.regs);
+	return ret;
+}
+
+void board_nand_init(void)
+{
+	struct sandbox_state *state = state_get_current();
+
+	sim.fd = -1;
+	sim.seed = 1;
+	if (!state->nand_spec)
+		return;
+
+	if (sandbox_nand_init(&nand_info[0], state->nand_spec))
+		printf("NAND: sandbox simulator init failed\n");
+}
+
+static int sandbox_cmdline_cb_nand(struct sandbox_state *state,
+				   const char *arg)
+{
+	state->nand_spec = arg;
+	return 0;
+}
+SANDBOX_CMDLINE_OPT(nand, 1,
+	"connect a NAND flash: <file>[:size=<MiB>:page=<n>:oob=<n>:...]");
@@ -513,6 +513,36 @@ static int sandbox_sf_xfer(struct udevice *dev, unsigned int bitlen,
 	return pos == bytes ? 0 : -EIO;
 }
 
+/* Copy a whole read straight from the backing file, as a DMA engine would */
+static int sandbox_sf_read_flash(struct udevice *dev,
+				 struct spi_flash_read_message *msg)
+{
+	struct sandbox_spi_flash *sbsf = dev_get_priv(dev);
+	uint off;
+	int ret;
+
+	if ((msg->read_opcode != CMD_READ_ARRAY_FAST &&
+	     msg->read_opcode != CMD_READ_ARRAY_SLOW) ||
+	    msg->addr_width != SF_ADDR_LEN)
+		return -ENOSYS;
+
+	off = msg->from & ((1 << (8 * SF_ADDR_LEN)) - 1);
+	debug("sandbox_sf: read_flash: off:%06x len:%zu\n", off, msg->len);
+	if (os_lseek(sbsf->fd, off, OS_SEEK_SET) < 0) {
+		puts("sandbox_sf: os_lseek() failed");
+		return -EIO;
+	}
+	ret = os_read(sbsf->fd, msg->buf, msg->len);
+	if (ret < 0) {
+		puts("sandbox_sf: os_read() failed\n");
+		return -EIO;
+	}
+	/* Past the end of the backing file reads as erased flash */
+	memset(msg->buf + ret, 0xff, msg->len - ret);
+
+	return 0;
+}
+
 int sandbox_sf_ofdata_to_platdata(struct udevice *dev)
 {
 	struct sandbox_spi_flash_plat_data *pdata = dev_get_platdata(dev);
@@ -532,6 +562,7 @@ int sandbox_sf_ofdata_to_platdata(struct udevice *dev)
 
 static const struct dm_spi_emul_ops sandbox_sf_emul_ops = {
 	.xfer          = sandbox_sf_xfer,
+	.read_flash    = sandbox_sf_read_flash,
 };
 
 #ifdef CONFIG_SPI_FLASH
@@ -360,11 +360,42 @@ int spi_flash_read_common(struct spi_flash *flash, const u8 *cmd,
 	return ret;
 }
 
+/*
+ * Let the controller read a whole chunk itself, with DMA or a direct-read
+ * window. Returns -ENOSYS if it cannot, in which case the caller should
+ * fall back to spi_flash_read_common().
+ */
+static int spi_flash_read_bulk(struct spi_flash *flash, u32 addr,
+			       void *data, size_t len)
+{
+	struct spi_flash_read_message msg = {
+		.buf		= data,
+		.from		= addr,
+		.len		= len,
+		.read_opcode	= flash->read_cmd,
+		.addr_width	= SPI_FLASH_3B_ADDR_LEN,
+		.dummy_bytes	= flash->dummy_byte,
+	};
+	int ret;
+
+	ret = spi_claim_bus(flash->spi);
+	if (ret) {
+		debug("SF: unable to claim SPI bus\n");
+		return ret;
+	}
+
+	ret = spi_read_flash(flash->spi, &msg);
+	spi_release_bus(flash->spi);
+
+	return ret;
+}
+
 int spi_flash_cmd_read_ops(struct spi_flash *flash, u32 offset,
 		size_t len, void *data)
 {
 	u8 *cmd, cmdsz;
 	u32 remain_len, read_len, read_addr;
+	bool bulk = true;
 	int bank_sel = 0;
 	int ret = -1;
 
@@ -409,9 +440,16 @@ int spi_flash_cmd_read_ops(struct spi_flash *flash, u32 offset,
 		else
 			read_len = remain_len;
 
-		spi_flash_addr(read_addr, cmd);
-
-		ret = spi_flash_read_common(flash, cmd, cmdsz, data, read_len);
+		ret = -ENOSYS;
+		if (bulk)
+			ret = spi_flash_read_bulk(flash, read_addr, data,
+						  read_len);
+		if (ret == -ENOSYS) {
+			bulk = false;
+			spi_flash_addr(read_addr, cmd);
+			ret = spi_flash_read_common(flash, cmd, cmdsz, data,
+						    read_len);
+		}
 		if (ret < 0) {
 			debug("SF: read failed\n");
 			break;
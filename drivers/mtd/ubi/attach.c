@@ -80,9 +80,8 @@
 #include <linux/err.h>
 #endif
 
-#include <linux/math64.h>
-
 #include <ubi_uboot.h>
+#include <linux/math64.h>
 #include "ubi.h"
 
 static int self_check_ai(struct ubi_device *ubi, struct ubi_attach_info *ai);
@@ -796,6 +795,218 @@ out_unlock:
 	return err;
 }
 
+/*
+ * Batched scanning: when the EC and VID headers share a minimal I/O unit,
+ * the headers of a run of PEBs are read first, in one read per PEB, and the
+ * volume RB-trees are built from a sorted array of the used PEBs once the
+ * whole device has been scanned. PEBs whose headers could not be read
+ * cleanly in the batch are re-read the usual way, so the outcome is the same
+ * as with PEB-by-PEB scanning.
+ *
+ * The headers of different PEBs are an eraseblock apart, so a run cannot be
+ * fetched with fewer reads than PEBs. Without sub-pages the VID header has a
+ * page of its own and batching saves no read at all; only the tree build is
+ * deferred then.
+ */
+enum {
+	BATCH_UNREAD = 0,	/* nothing buffered, use the normal path */
+	BATCH_BAD,		/* bad PEB */
+	BATCH_HDRS,		/* EC and VID headers buffered */
+};
+
+/* A used PEB whose insertion into the volume RB-tree is deferred */
+struct scan_leb {
+	struct ubi_vid_hdr vid_hdr;
+	int pnum;
+	int ec;
+	int bitflips;
+};
+
+static struct {
+	int start;		/* first PEB of the current run */
+	int count;		/* number of PEBs in the current run */
+	int hdr_len;		/* bytes read per PEB */
+	u8 *buf;		/* header data, hdr_len bytes per PEB */
+	u8 state[CONFIG_MTD_UBI_ATTACH_BATCH + 1];
+	struct scan_leb *lebs;	/* deferred used PEBs */
+	int leb_count;
+	unsigned long read_us, scan_us, build_us;
+} batch;
+
+static int batch_state(int pnum)
+{
+	if (!batch.buf || pnum < batch.start ||
+	    pnum >= batch.start + batch.count)
+		return BATCH_UNREAD;
+
+	return batch.state[pnum - batch.start];
+}
+
+static void *batch_hdrs(int pnum)
+{
+	return batch.buf + (pnum - batch.start) * batch.hdr_len;
+}
+
+/**
+ * batch_init - set up batched scanning.
+ * @ubi: UBI device description object
+ * @start: first PEB to be scanned
+ *
+ * Batching is an optimisation only, so if memory is short this just leaves
+ * it disabled.
+ */
+static void batch_init(struct ubi_device *ubi, int start)
+{
+	memset(&batch, 0, sizeof(batch));
+	batch.start = start;
+	if (CONFIG_MTD_UBI_ATTACH_BATCH <= 0)
+		return;
+
+	batch.lebs = vmalloc((ubi->peb_count - start) *
+			     sizeof(struct scan_leb));
+	if (!batch.lebs)
+		return;
+
+	/*
+	 * Read both headers at once only if that does not cost an extra page
+	 * for empty PEBs, which have no VID header to read. Otherwise reading
+	 * ahead would just cost a copy.
+	 */
+	batch.hdr_len = ubi->vid_hdr_aloffset + ubi->vid_hdr_alsize;
+	if (ubi->min_io_size > 1 && batch.hdr_len > ubi->min_io_size)
+		return;
+
+	batch.buf = vmalloc(CONFIG_MTD_UBI_ATTACH_BATCH * batch.hdr_len);
+}
+
+static void batch_free(void)
+{
+	vfree(batch.buf);
+	vfree(batch.lebs);
+	batch.buf = NULL;
+	batch.lebs = NULL;
+}
+
+/**
+ * batch_read - read the headers of a run of PEBs.
+ * @ubi: UBI device description object
+ * @start: first PEB of the run
+ * @count: number of PEBs in the run
+ */
+static void batch_read(struct ubi_device *ubi, int start, int count)
+{
+	unsigned long t = timer_get_us();
+	int i, err;
+
+	batch.start = start;
+	batch.count = count;
+	for (i = 0; i < count; i++) {
+		batch.state[i] = BATCH_UNREAD;
+
+		err = ubi_io_is_bad(ubi, start + i);
+		if (err) {
+			/* errors are reported again by scan_peb() */
+			if (err > 0)
+				batch.state[i] = BATCH_BAD;
+			continue;
+		}
+
+		err = ubi_io_read(ubi, batch_hdrs(start + i), start + i, 0,
+				  batch.hdr_len);
+		if (err)
+			continue;
+
+		batch.state[i] = BATCH_HDRS;
+	}
+	batch.read_us += timer_get_us() - t;
+}
+
+static int scan_read_ec_hdr(struct ubi_device *ubi, int pnum)
+{
+	if (batch_state(pnum) < BATCH_HDRS)
+		return ubi_io_read_ec_hdr(ubi, pnum, ech, 0);
+
+	memcpy(ech, batch_hdrs(pnum), UBI_EC_HDR_SIZE);
+	return ubi_io_check_ec_hdr(ubi, pnum, ech, 0, 0);
+}
+
+static int scan_read_vid_hdr(struct ubi_device *ubi, int pnum)
+{
+	if (batch_state(pnum) < BATCH_HDRS)
+		return ubi_io_read_vid_hdr(ubi, pnum, vidh, 0);
+
+	memcpy(vidh, batch_hdrs(pnum) + ubi->vid_hdr_offset,
+	       UBI_VID_HDR_SIZE);
+	return ubi_io_check_vid_hdr(ubi, pnum, vidh, 0, 0);
+}
+
+static int scan_add_to_av(struct ubi_device *ubi, struct ubi_attach_info *ai,
+			  int pnum, int ec, int bitflips)
+{
+	struct scan_leb *leb;
+
+	if (!batch.lebs)
+		return ubi_add_to_av(ubi, ai, pnum, ec, vidh, bitflips);
+
+	leb = &batch.lebs[batch.leb_count++];
+	memcpy(&leb->vid_hdr, vidh, sizeof(leb->vid_hdr));
+	leb->pnum = pnum;
+	leb->ec = ec;
+	leb->bitflips = bitflips;
+
+	return 0;
+}
+
+static int cmp_scan_leb(const void *a, const void *b)
+{
+	const struct ubi_vid_hdr *va = &((const struct scan_leb *)a)->vid_hdr;
+	const struct ubi_vid_hdr *vb = &((const struct scan_leb *)b)->vid_hdr;
+	u32 ia = be32_to_cpu(va->vol_id), ib = be32_to_cpu(vb->vol_id);
+	unsigned long long sa, sb;
+
+	if (ia != ib)
+		return ia < ib ? -1 : 1;
+
+	ia = be32_to_cpu(va->lnum);
+	ib = be32_to_cpu(vb->lnum);
+	if (ia != ib)
+		return ia < ib ? -1 : 1;
+
+	sa = be64_to_cpu(va->sqnum);
+	sb = be64_to_cpu(vb->sqnum);
+	if (sa != sb)
+		return sa < sb ? -1 : 1;
+
+	return 0;
+}
+
+/**
+ * batch_build - add the deferred used PEBs to the volume RB-trees.
+ * @ubi: UBI device description object
+ * @ai: attaching information
+ *
+ * Sorting by volume, LEB and sequence number keeps each volume's lookups and
+ * insertions together and makes copies of the same LEB meet back to back.
+ */
+static int batch_build(struct ubi_device *ubi, struct ubi_attach_info *ai)
+{
+	unsigned long t = timer_get_us();
+	struct scan_leb *leb;
+	int i, err = 0;
+
+	qsort(batch.lebs, batch.leb_count, sizeof(struct scan_leb),
+	      cmp_scan_leb);
+
+	for (i = 0; i < batch.leb_count && !err; i++) {
+		leb = &batch.lebs[i];
+		err = ubi_add_to_av(ubi, ai, leb->pnum, leb->ec, &leb->vid_hdr,
+				    leb->bitflips);
+	}
+	batch.build_us += timer_get_us() - t;
+
+	return err;
+}
+
 /**
  * scan_peb - scan and process UBI headers of a PEB.
  * @ubi: UBI device description object
@@ -818,7 +1029,10 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	dbg_bld("scan PEB %d", pnum);
 
 	/* Skip bad physical eraseblocks */
-	err = ubi_io_is_bad(ubi, pnum);
+	if (batch_state(pnum) == BATCH_BAD)
+		err = 1;
+	else
+		err = ubi_io_is_bad(ubi, pnum);
 	if (err < 0)
 		return err;
 	else if (err) {
@@ -826,7 +1040,7 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		return 0;
 	}
 
-	err = ubi_io_read_ec_hdr(ubi, pnum, ech, 0);
+	err = scan_read_ec_hdr(ubi, pnum);
 	if (err < 0)
 		return err;
 	switch (err) {
@@ -908,7 +1122,7 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 
 	/* OK, we've done with the EC header, let's look at the VID header */
 
-	err = ubi_io_read_vid_hdr(ubi, pnum, vidh, 0);
+	err = scan_read_vid_hdr(ubi, pnum);
 	if (err < 0)
 		return err;
 	switch (err) {
@@ -1029,7 +1243,7 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (ec_err)
 		ubi_warn("valid VID header but corrupted EC header at PEB %d",
 			 pnum);
-	err = ubi_add_to_av(ubi, ai, pnum, ec, vidh, bitflips);
+	err = scan_add_to_av(ubi, ai, pnum, ec, bitflips);
 	if (err)
 		return err;
 
@@ -1224,6 +1438,8 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	struct rb_node *rb1, *rb2;
 	struct ubi_ainf_volume *av;
 	struct ubi_ainf_peb *aeb;
+	unsigned long t;
+	unsigned long total = timer_get_us();
 
 	err = -ENOMEM;
 
@@ -1235,15 +1451,30 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (!vidh)
 		goto out_ech;
 
+	batch_init(ubi, start);
+
 	for (pnum = start; pnum < ubi->peb_count; pnum++) {
 		cond_resched();
 
+		if (batch.buf && pnum == batch.start + batch.count)
+			batch_read(ubi, pnum,
+				   min(CONFIG_MTD_UBI_ATTACH_BATCH,
+				       ubi->peb_count - pnum));
+
+		t = timer_get_us();
 		dbg_gen("process PEB %d", pnum);
 		err = scan_peb(ubi, ai, pnum, NULL, NULL);
+		batch.scan_us += timer_get_us() - t;
 		if (err < 0)
 			goto out_vidh;
 	}
 
+	if (batch.lebs) {
+		err = batch_build(ubi, ai);
+		if (err)
+			goto out_vidh;
+	}
+
 	ubi_msg("scanning is finished");
 
 	/* Calculate mean erase counter */
@@ -1281,12 +1512,19 @@ static int scan_all(struct ubi_device *ubi, struct ubi_attach_info *ai,
 	if (err)
 		goto out_vidh;
 
+	ubi->attach_read_us = batch.read_us;
+	ubi->attach_scan_us = batch.scan_us;
+	ubi->attach_build_us = batch.build_us;
+	ubi->attach_us = timer_get_us() - total;
+
+	batch_free();
 	ubi_free_vid_hdr(ubi, vidh);
 	kfree(ech);
 
 	return 0;
 
 out_vidh:
+	batch_free();
 	ubi_free_vid_hdr(ubi, vidh);
 out_ech:
 	kfree(ech);
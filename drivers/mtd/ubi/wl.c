@@ -849,9 +849,12 @@ static void __schedule_ubi_work(struct ubi_device *ubi, struct ubi_work *wrk)
 #else
 	/*
 	 * U-Boot special: We have no bgt_thread in U-Boot!
-	 * So just call do_work() here directly.
+	 * So just call do_work() here directly. Works scheduled while
+	 * attaching, e.g. scrubbing, must wait until the device is set up
+	 * and are run by ubi_do_worker().
 	 */
-	do_work(ubi);
+	if (ubi->thread_enabled)
+		do_work(ubi);
 #endif
 	spin_unlock(&ubi->wl_lock);
 }
@@ -1795,6 +1798,22 @@ static void tree_destroy(struct rb_root *root)
 	}
 }
 
+#ifdef __UBOOT__
+/**
+ * ubi_do_worker - do all pending works.
+ * @ubi: UBI device description object
+ *
+ * U-Boot special: this stands in for the background thread once the device
+ * is attached, and stops at the first work that fails.
+ */
+void ubi_do_worker(struct ubi_device *ubi)
+{
+	while (!list_empty(&ubi->works) && !ubi->ro_mode)
+		if (do_work(ubi))
+			break;
+}
+#endif
+
 /**
  * ubi_thread - UBI background thread.
  * @u: the UBI device description object pointer
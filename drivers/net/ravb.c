@@ -17,6 +17,7 @@
 #include <miiphy.h>
 #include <asm/errno.h>
 #include <asm/io.h>
+#include <asm/unaligned.h>
 
 #include "ravb.h"
 
@@ -104,6 +105,16 @@ int ravb_recv(struct eth_device *dev)
 			len = desc->ds;
 			packet = (u8 *)(uintptr_t)desc->dptr;
 			ravb_invalidate_dcache((uintptr_t)packet, len);
+#ifdef CONFIG_UDP_CHECKSUM
+			/*
+			 * The E-MAC appends the one's complement sum of the
+			 * frame data following the Ethernet header
+			 */
+			if (len >= sizeof(u16)) {
+				len -= sizeof(u16);
+				dev->rx_csum = get_unaligned_le16(packet + len);
+			}
+#endif
 			NetReceive(packet, len);
 		}
 
@@ -366,6 +377,13 @@ static int ravb_phy_config(struct ravb_dev *eth)
 	return ret;
 }
 
+static int ravb_phy_startup(void *arg)
+{
+	struct ravb_dev *eth = arg;
+
+	return phy_startup(eth->phydev);
+}
+
 /* Set Mac address */
 static int ravb_write_hwaddr(struct eth_device *dev)
 {
@@ -436,6 +454,7 @@ static int ravb_config(struct ravb_dev *eth, bd_t *bd)
 {
 	int ret = 0;
 	struct phy_device *phy;
+	u32 ecmr = ECMR_CHG_DM | ECMR_RE | ECMR_TE;
 
 	/* Configure AVB-DMAC register */
 	ravb_dmac_init(eth);
@@ -443,19 +462,22 @@ static int ravb_config(struct ravb_dev *eth, bd_t *bd)
 	/* Configure E-MAC registers */
 	ravb_mac_init(eth);
 
-	/* Configure phy */
-	ret = ravb_phy_config(eth);
-	if (ret) {
-		printf(CARDNAME ": Fail to connect phy\n");
-		goto err_phy_cfg;
+	/* Configure phy, unless ravb_initialize() has already done so */
+	if (deferred_pending(&eth->phy_defer)) {
+		ret = deferred_complete(&eth->phy_defer);
+	} else {
+		ret = ravb_phy_config(eth);
+		if (ret) {
+			printf(CARDNAME ": Fail to connect phy\n");
+			goto err_phy_cfg;
+		}
+		ret = phy_startup(eth->phydev);
 	}
-	phy = eth->phydev;
-
-	ret = phy_startup(phy);
 	if (ret) {
 		printf(CARDNAME ": phy startup failure\n");
 		return ret;
 	}
+	phy = eth->phydev;
 
 	/* Set the transfer speed */
 	if (phy->speed == 100) {
@@ -469,12 +491,15 @@ static int ravb_config(struct ravb_dev *eth, bd_t *bd)
 	/* Check if full duplex mode is supported by the phy */
 	if (phy->duplex) {
 		printf("Full\n");
-		ravb_write(eth, ECMR_CHG_DM | ECMR_RE | ECMR_TE | ECMR_DM,
-			   ECMR);
+		ecmr |= ECMR_DM;
 	} else {
 		printf("Half\n");
-		ravb_write(eth, ECMR_CHG_DM | ECMR_RE | ECMR_TE, ECMR);
 	}
+#ifdef CONFIG_UDP_CHECKSUM
+	/* Let the E-MAC sum received frames for UDP checksum verification */
+	ecmr |= ECMR_RCSC;
+#endif
+	ravb_write(eth, ecmr, ECMR);
 
 	phy_write(phy, 0x02, 0x04, 0x0070);
 	phy_write(phy, 0x02, 0x06, 0x0000);
@@ -566,6 +591,9 @@ int ravb_initialize(bd_t *bd)
 	dev->send = ravb_send;
 	dev->recv = ravb_recv;
 	dev->write_hwaddr = ravb_write_hwaddr;
+#ifdef CONFIG_UDP_CHECKSUM
+	dev->features = ETH_FEATURE_RX_CSUM;
+#endif
 	eth->dev = dev;
 
 	sprintf(dev->name, CARDNAME);
@@ -576,6 +604,14 @@ int ravb_initialize(bd_t *bd)
 	bb_miiphy_buses[dev->index].priv = eth;
 	miiphy_register(dev->name, bb_miiphy_read, bb_miiphy_write);
 
+	/*
+	 * Start autonegotiation now rather than at first use, which then
+	 * only has to wait for whatever is left of it
+	 */
+	if (IS_ENABLED(CONFIG_DEFERRED_INIT) && !ravb_phy_config(eth))
+		deferred_start(&eth->phy_defer, dev->name, ravb_phy_startup,
+			       eth);
+
 	return ret;
 
 err:
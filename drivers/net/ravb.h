@@ -7,6 +7,7 @@
  * SPDX-License-Identifier:	GPL-2.0+
  */
 
+#include <deferred.h>
 #include <netdev.h>
 #include <asm/types.h>
 
@@ -137,6 +138,7 @@ struct ravb_dev {
 	u8 phy_addr;
 	struct eth_device *dev;
 	struct phy_device *phydev;
+	struct deferred phy_defer;	/* autonegotiation started at init */
 };
 
 /* from linux/drivers/net/ethernet/renesas/ravb.h */
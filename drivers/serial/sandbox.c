@@ -36,10 +36,13 @@ static unsigned int serial_buf_read;
 
 struct sandbox_serial_platdata {
 	int colour;	/* Text colour to use for output, -1 for none */
+	int tx_fifo;	/* Size of the modelled Tx FIFO, 0 for none */
 };
 
 struct sandbox_serial_priv {
 	bool start_of_line;
+	unsigned int tx_count;	/* Characters in the modelled Tx FIFO */
+	unsigned long tx_time;	/* Time (us) the first of them started */
 };
 
 /**
@@ -82,11 +85,46 @@ static int sandbox_serial_remove(struct udevice *dev)
 	return 0;
 }
 
+/**
+ * tx_fifo_full() - Model the Tx FIFO of a UART at the current baud rate
+ *
+ * Characters leave the FIFO at one per 10 bit times (8N1).
+ *
+ * @priv: Serial port private data
+ * @size: FIFO size in characters
+ * @return true if the FIFO is full, else false
+ */
+static bool tx_fifo_full(struct sandbox_serial_priv *priv, int size)
+{
+	unsigned long now = timer_get_us();
+	unsigned long char_us, sent;
+
+	if (!gd->baudrate)
+		return false;
+	char_us = 10000000 / gd->baudrate;
+	sent = char_us ? (now - priv->tx_time) / char_us : priv->tx_count;
+	if (sent >= priv->tx_count) {
+		priv->tx_count = 0;
+		priv->tx_time = now;
+	} else {
+		priv->tx_count -= sent;
+		priv->tx_time += sent * char_us;
+	}
+
+	return priv->tx_count >= size;
+}
+
 static int sandbox_serial_putc(struct udevice *dev, const char ch)
 {
 	struct sandbox_serial_priv *priv = dev_get_priv(dev);
 	struct sandbox_serial_platdata *plat = dev->platdata;
 
+	if (plat->tx_fifo) {
+		if (tx_fifo_full(priv, plat->tx_fifo))
+			return -EAGAIN;
+		priv->tx_count++;
+	}
+
 	if (priv->start_of_line && plat->colour != -1) {
 		priv->start_of_line = false;
 		output_ansi_colour(plat->colour);
@@ -151,6 +189,8 @@ static int sandbox_serial_ofdata_to_platdata(struct udevice *dev)
 	int i;
 
 	plat->colour = -1;
+	plat->tx_fifo = fdtdec_get_int(gd->fdt_blob, dev->of_offset,
+				       "sandbox,tx-fifo", 0);
 	colour = fdt_getprop(gd->fdt_blob, dev->of_offset,
 			     "sandbox,text-colour", NULL);
 	if (colour) {
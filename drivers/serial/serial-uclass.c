@@ -137,6 +137,13 @@ void serial_putc(char ch)
 	_serial_putc(gd->cur_serial_dev, ch);
 }
 
+int serial_try_putc(const char ch)
+{
+	struct dm_serial_ops *ops = serial_get_ops(gd->cur_serial_dev);
+
+	return ops->putc(gd->cur_serial_dev, ch);
+}
+
 void serial_puts(const char *str)
 {
 	_serial_puts(gd->cur_serial_dev, str);
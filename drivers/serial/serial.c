@@ -483,6 +483,25 @@ void serial_putc(const char c)
 	get_current()->putc(c);
 }
 
+/**
+ * serial_try_putc() - Output character only if the port can take it now
+ * @c:	Single character to be output from the serial port.
+ *
+ * Unlike serial_putc(), this function never waits and sends the character
+ * as it is, without adding a carriage return to a newline. It returns 0
+ * if the character was sent, -EAGAIN if the transmitter is busy, or
+ * -ENOSYS if the driver of the selected port cannot tell.
+ */
+int serial_try_putc(const char c)
+{
+	struct serial_device *dev = get_current();
+
+	if (!dev->try_putc)
+		return -ENOSYS;
+
+	return dev->try_putc(c);
+}
+
 /**
  * serial_puts() - Output string via currently selected serial port
  * @s:	Zero-terminated string to be output from the serial port.
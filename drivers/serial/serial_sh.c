@@ -25,6 +25,11 @@ static int scif_rxfill(struct uart_port *port)
 {
 	return sci_in(port, SCRFDR) & 0xff;
 }
+
+static int scif_txroom(struct uart_port *port)
+{
+	return SCIF_TXROOM_MAX - (sci_in(port, SCTFDR) & 0xff);
+}
 #elif defined(CONFIG_CPU_SH7763)
 static int scif_rxfill(struct uart_port *port)
 {
@@ -37,6 +42,18 @@ static int scif_rxfill(struct uart_port *port)
 		return sci_in(port, SCFDR) & SCIF2_RFDC_MASK;
 	}
 }
+
+static int scif_txroom(struct uart_port *port)
+{
+	if ((port->mapbase == 0xffe00000) ||
+	    (port->mapbase == 0xffe08000)) {
+		/* SCIF0/1*/
+		return SCIF_TXROOM_MAX - (sci_in(port, SCTFDR) & 0xff);
+	} else {
+		/* SCIF2 */
+		return SCIF2_TXROOM_MAX - (sci_in(port, SCFDR) >> 8);
+	}
+}
 #elif defined(CONFIG_ARCH_SH7372)
 static int scif_rxfill(struct uart_port *port)
 {
@@ -45,11 +62,24 @@ static int scif_rxfill(struct uart_port *port)
 	else
 		return sci_in(port, SCRFDR);
 }
+
+static int scif_txroom(struct uart_port *port)
+{
+	if (port->type == PORT_SCIFA)
+		return SCIF_TXROOM_MAX - (sci_in(port, SCFDR) >> 8);
+	else
+		return SCIF_TXROOM_MAX - sci_in(port, SCTFDR);
+}
 #else
 static int scif_rxfill(struct uart_port *port)
 {
 	return sci_in(port, SCFDR) & SCIF_RFDC_MASK;
 }
+
+static int scif_txroom(struct uart_port *port)
+{
+	return SCIF_TXROOM_MAX - (sci_in(port, SCFDR) >> 8);
+}
 #endif
 
 static void sh_serial_init_generic(struct uart_port *port)
@@ -281,6 +311,20 @@ static void sh_serial_putc(const char c)
 	}
 }
 
+static int sh_serial_try_putc(const char c)
+{
+	struct uart_port *port = &sh_sci;
+
+	/* Any room in the Tx fifo? It need not be empty */
+	if (scif_txroom(port) <= 0)
+		return -EAGAIN;
+
+	sci_out(port, SCxTDR, c);
+	sci_out(port, SCxSR, sci_in(port, SCxSR) & ~SCxSR_TEND(port));
+
+	return 0;
+}
+
 static int sh_serial_tstc(void)
 {
 	struct uart_port *port = &sh_sci;
@@ -309,6 +353,7 @@ static struct serial_device sh_serial_drv = {
 	.setbrg	= sh_serial_setbrg,
 	.putc	= sh_serial_putc,
 	.puts	= default_serial_puts,
+	.try_putc = sh_serial_try_putc,
 	.getc	= sh_serial_getc,
 	.tstc	= sh_serial_tstc,
 };
@@ -16,6 +16,7 @@
 #include <os.h>
 
 #include <asm/errno.h>
+#include <asm/getopt.h>
 #include <asm/spi.h>
 #include <asm/state.h>
 #include <dm/device-internal.h>
@@ -49,27 +50,14 @@ __weak int sandbox_spi_get_emul(struct sandbox_state *state,
 	return -ENOENT;
 }
 
-static int sandbox_spi_xfer(struct udevice *slave, unsigned int bitlen,
-			    const void *dout, void *din, unsigned long flags)
+/* Find and probe the emulator attached to a slave's chip select */
+static int sandbox_spi_find_emul(struct udevice *slave, struct udevice **emulp)
 {
 	struct udevice *bus = slave->parent;
 	struct sandbox_state *state = state_get_current();
-	struct dm_spi_emul_ops *ops;
 	struct udevice *emul;
-	uint bytes = bitlen / 8, i;
-	int ret;
-	u8 *tx = (void *)dout, *rx = din;
 	uint busnum, cs;
-
-	if (bitlen == 0)
-		return 0;
-
-	/* we can only do 8 bit transfers */
-	if (bitlen % 8) {
-		printf("sandbox_spi: xfer: invalid bitlen size %u; needs to be 8bit\n",
-		       bitlen);
-		return -EINVAL;
-	}
+	int ret;
 
 	busnum = bus->seq;
 	cs = spi_chip_select(slave);
@@ -86,6 +74,33 @@ static int sandbox_spi_xfer(struct udevice *slave, unsigned int bitlen,
 		return -ENOENT;
 	}
 	ret = device_probe(emul);
+	if (ret)
+		return ret;
+	*emulp = emul;
+
+	return 0;
+}
+
+static int sandbox_spi_xfer(struct udevice *slave, unsigned int bitlen,
+			    const void *dout, void *din, unsigned long flags)
+{
+	struct dm_spi_emul_ops *ops;
+	struct udevice *emul;
+	uint bytes = bitlen / 8, i;
+	int ret;
+	u8 *tx = (void *)dout, *rx = din;
+
+	if (bitlen == 0)
+		return 0;
+
+	/* we can only do 8 bit transfers */
+	if (bitlen % 8) {
+		printf("sandbox_spi: xfer: invalid bitlen size %u; needs to be 8bit\n",
+		       bitlen);
+		return -EINVAL;
+	}
+
+	ret = sandbox_spi_find_emul(slave, &emul);
 	if (ret)
 		return ret;
 
@@ -124,6 +139,33 @@ static int sandbox_spi_xfer(struct udevice *slave, unsigned int bitlen,
 	return ret;
 }
 
+/*
+ * Act like a controller with a DMA engine: the emulator copies the data
+ * straight into the buffer. This can be disabled with --spi_pio to compare
+ * against the xfer() path.
+ */
+static int sandbox_spi_read_flash(struct udevice *slave,
+				  struct spi_flash_read_message *msg)
+{
+	struct sandbox_state *state = state_get_current();
+	struct dm_spi_emul_ops *ops;
+	struct udevice *emul;
+	int ret;
+
+	if (state->spi_pio)
+		return -ENOSYS;
+
+	ret = sandbox_spi_find_emul(slave, &emul);
+	if (ret)
+		return ret;
+
+	ops = spi_emul_get_ops(emul);
+	if (!ops->read_flash)
+		return -ENOSYS;
+
+	return ops->read_flash(emul, msg);
+}
+
 static int sandbox_spi_set_speed(struct udevice *bus, uint speed)
 {
 	return 0;
@@ -149,6 +191,7 @@ static const struct dm_spi_ops sandbox_spi_ops = {
 	.set_speed	= sandbox_spi_set_speed,
 	.set_mode	= sandbox_spi_set_mode,
 	.cs_info	= sandbox_cs_info,
+	.read_flash	= sandbox_spi_read_flash,
 };
 
 static const struct udevice_id sandbox_spi_ids[] = {
@@ -156,6 +199,14 @@ static const struct udevice_id sandbox_spi_ids[] = {
 	{ }
 };
 
+static int sandbox_cmdline_cb_spi_pio(struct sandbox_state *state,
+				      const char *arg)
+{
+	state->spi_pio = true;
+	return 0;
+}
+SANDBOX_CMDLINE_OPT(spi_pio, 0, "Read SPI flash with xfer(), not read_flash()");
+
 U_BOOT_DRIVER(spi_sandbox) = {
 	.name	= "spi_sandbox",
 	.id	= UCLASS_SPI,
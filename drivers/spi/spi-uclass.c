@@ -92,6 +92,22 @@ int spi_xfer(struct spi_slave *slave, unsigned int bitlen,
 	return spi_get_ops(bus)->xfer(dev, bitlen, dout, din, flags);
 }
 
+int spi_read_flash(struct spi_slave *slave, struct spi_flash_read_message *msg)
+{
+	struct udevice *dev = slave->dev;
+	struct udevice *bus = dev->parent;
+	struct dm_spi_ops *ops;
+
+	if (bus->uclass->uc_drv->id != UCLASS_SPI)
+		return -EOPNOTSUPP;
+
+	ops = spi_get_ops(bus);
+	if (!ops->read_flash)
+		return -ENOSYS;
+
+	return ops->read_flash(dev, msg);
+}
+
 int spi_post_bind(struct udevice *dev)
 {
 	/* Scan the bus for devices */
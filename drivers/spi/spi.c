@@ -5,6 +5,7 @@
  */
 
 #include <common.h>
+#include <errno.h>
 #include <fdtdec.h>
 #include <malloc.h>
 #include <spi.h>
@@ -21,6 +22,13 @@ int spi_set_wordlen(struct spi_slave *slave, unsigned int wordlen)
 	return 0;
 }
 
+/* Controllers which can read a SPI flash with DMA override this */
+__weak int spi_read_flash(struct spi_slave *slave,
+			  struct spi_flash_read_message *msg)
+{
+	return -ENOSYS;
+}
+
 void *spi_do_alloc_slave(int offset, int size, unsigned int bus,
 			 unsigned int cs)
 {
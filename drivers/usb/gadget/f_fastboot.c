@@ -13,6 +13,7 @@
 #include <config.h>
 #include <common.h>
 #include <errno.h>
+#include <hash.h>
 #include <malloc.h>
 #include <linux/usb/ch9.h>
 #include <linux/usb/gadget.h>
@@ -23,6 +24,9 @@
 #ifdef CONFIG_FASTBOOT_FLASH_MMC_DEV
 #include <fb_mmc.h>
 #endif
+#ifdef CONFIG_FASTBOOT_FLASH_DELTA
+#include <fb_delta.h>
+#endif
 
 #define FASTBOOT_VERSION		"0.4"
 
@@ -372,6 +376,14 @@ static void cb_getvar(struct usb_ep *ep, struct usb_request *req)
 			strncat(response, s, chars_left);
 		else
 			strcpy(response, "FAILValue not set");
+#ifdef CONFIG_FASTBOOT_FLASH_DELTA
+	} else if (!strcmp_l1("delta-map:", cmd)) {
+		unsigned int first = simple_strtoul(cmd + 10, NULL, 16);
+
+		if (fb_delta_map(first, response + strlen(response),
+				 chars_left + 1))
+			strcpy(response, "FAILno delta map");
+#endif
 	} else {
 		error("unknown variable: %s\n", cmd);
 		strcpy(response, "FAILVariable not implemented");
@@ -414,6 +426,8 @@ static void rx_handler_dl_image(struct usb_ep *ep, struct usb_request *req)
 	if (buffer_size < transfer_size)
 		transfer_size = buffer_size;
 
+	hash_read_drop((void *)CONFIG_USB_FASTBOOT_BUF_ADDR + download_bytes,
+		       transfer_size);
 	memcpy((void *)CONFIG_USB_FASTBOOT_BUF_ADDR + download_bytes,
 	       buffer, transfer_size);
 
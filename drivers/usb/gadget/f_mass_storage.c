@@ -708,13 +708,14 @@ static int do_read(struct fsg_common *common)
 	unsigned int		amount;
 	unsigned int		partial_page;
 	ssize_t			nread;
+	ulong			start;
 
 	/* Get the starting Logical Block Address and check that it's
 	 * not too big */
 	if (common->cmnd[0] == SC_READ_6)
 		lba = get_unaligned_be24(&common->cmnd[1]);
 	else {
-		lba = get_unaligned_be32(&common->cmnd[2]);
+		lba = ums_cdb_lba(common->cmnd);
 
 		/* We allow DPO (Disable Page Out = don't save data in the
 		 * cache) and FUA (Force Unit Access = don't read from the
@@ -746,6 +747,8 @@ static int do_read(struct fsg_common *common)
 		 * If this means reading 0 then we were asked to read past
 		 *	the end of file. */
 		amount = min(amount_left, FSG_BUFLEN);
+		amount = min_t(loff_t, amount,
+			       curlun->file_length - file_offset);
 		partial_page = file_offset & (PAGE_CACHE_SIZE - 1);
 		if (partial_page > 0)
 			amount = min(amount, (unsigned int) PAGE_CACHE_SIZE -
@@ -770,13 +773,25 @@ static int do_read(struct fsg_common *common)
 			break;
 		}
 
+		/*
+		 * Let the UDC make progress on the buffers already queued.
+		 * The read below is synchronous, so only a UDC which moves
+		 * queued requests by itself (DMA) keeps sending during it;
+		 * with one which moves data only from
+		 * usb_gadget_handle_interrupts() nothing overlaps.
+		 */
+		usb_gadget_handle_interrupts();
+
 		/* Perform the read */
+		start = get_timer(0);
 		rc = ums->read_sector(ums,
 				      file_offset / SECTOR_SIZE,
 				      amount / SECTOR_SIZE,
 				      (char __user *)bh->buf);
+		ums->read_time += get_timer(start);
 		if (!rc)
 			return -EIO;
+		ums->read_bytes += rc * SECTOR_SIZE;
 
 		nread = rc * SECTOR_SIZE;
 
@@ -836,6 +851,7 @@ static int do_write(struct fsg_common *common)
 	unsigned int		partial_page;
 	ssize_t			nwritten;
 	int			rc;
+	ulong			start;
 
 	if (curlun->ro) {
 		curlun->sense_data = SS_WRITE_PROTECTED;
@@ -847,7 +863,7 @@ static int do_write(struct fsg_common *common)
 	if (common->cmnd[0] == SC_WRITE_6)
 		lba = get_unaligned_be24(&common->cmnd[1]);
 	else {
-		lba = get_unaligned_be32(&common->cmnd[2]);
+		lba = ums_cdb_lba(common->cmnd);
 
 		/* We allow DPO (Disable Page Out = don't save data in the
 		 * cache) and FUA (Force Unit Access = write directly to the
@@ -885,6 +901,8 @@ static int do_write(struct fsg_common *common)
 			 *	to write past the end of file.
 			 * Finally, round down to a block boundary. */
 			amount = min(amount_left_to_req, FSG_BUFLEN);
+			amount = min_t(loff_t, amount,
+				       curlun->file_length - usb_offset);
 			partial_page = usb_offset & (PAGE_CACHE_SIZE - 1);
 			if (partial_page > 0)
 				amount = min(amount,
@@ -944,13 +962,23 @@ static int do_write(struct fsg_common *common)
 
 			amount = bh->outreq->actual;
 
+			/*
+			 * Keep the other OUT requests going. As with reads,
+			 * they only proceed during the write if the UDC
+			 * does DMA.
+			 */
+			usb_gadget_handle_interrupts();
+
 			/* Perform the write */
+			start = get_timer(0);
 			rc = ums->write_sector(ums,
 					       file_offset / SECTOR_SIZE,
 					       amount / SECTOR_SIZE,
 					       (char __user *)bh->buf);
+			ums->write_time += get_timer(start);
 			if (!rc)
 				return -EIO;
+			ums->write_bytes += rc * SECTOR_SIZE;
 			nwritten = rc * SECTOR_SIZE;
 
 			VLDBG(curlun, "file write %u @ %llu -> %d\n", amount,
@@ -973,7 +1001,7 @@ static int do_write(struct fsg_common *common)
 
 			/* If an error occurred, report it and its position */
 			if (nwritten < amount) {
-				printf("nwritten:%d amount:%d\n", nwritten,
+				printf("nwritten:%zd amount:%u\n", nwritten,
 				       amount);
 				curlun->sense_data = SS_WRITE_ERROR;
 				curlun->info_valid = 1;
@@ -1896,6 +1924,16 @@ static int do_scsi_command(struct fsg_common *common)
 			reply = do_read(common);
 		break;
 
+	case SC_READ_16:
+		common->data_size_from_cmnd =
+				ums_cdb16_blocks(common->cmnd) << 9;
+		reply = check_command(common, 16, DATA_DIR_TO_HOST,
+				      (1<<1) | (0xff<<2) | (0xf<<10), 1,
+				      "READ(16)");
+		if (reply == 0)
+			reply = do_read(common);
+		break;
+
 	case SC_READ_CAPACITY:
 		common->data_size_from_cmnd = 8;
 		reply = check_command(common, 10, DATA_DIR_TO_HOST,
@@ -2014,6 +2052,16 @@ static int do_scsi_command(struct fsg_common *common)
 			reply = do_write(common);
 		break;
 
+	case SC_WRITE_16:
+		common->data_size_from_cmnd =
+				ums_cdb16_blocks(common->cmnd) << 9;
+		reply = check_command(common, 16, DATA_DIR_FROM_HOST,
+				      (1<<1) | (0xff<<2) | (0xf<<10), 1,
+				      "WRITE(16)");
+		if (reply == 0)
+			reply = do_write(common);
+		break;
+
 	/* Some mandatory commands that we recognize but don't implement.
 	 * They don't mean much in this setting.  It's left as an exercise
 	 * for anyone interested to implement RESERVE and RELEASE in terms
@@ -30,7 +30,7 @@
 
 static void thor_tx_data(unsigned char *data, int len);
 static void thor_set_dma(void *addr, int len);
-static int thor_rx_data(void);
+static int thor_rx_data(struct dfu_entity *dfu);
 
 static struct f_thor *thor_func;
 static inline struct f_thor *func_to_thor(struct usb_function *f)
@@ -143,7 +143,7 @@ static long long int download_head(unsigned long long total,
 {
 	long long int rcv_cnt = 0, left_to_rcv, ret_rcv;
 	struct dfu_entity *dfu_entity = dfu_get_entity(alt_setting_num);
-	void *transfer_buffer = dfu_get_buf(dfu_entity);
+	void *transfer_buffer = dfu_get_write_buf(dfu_entity);
 	void *buf = transfer_buffer;
 	int usb_pkt_cnt = 0, ret;
 
@@ -151,13 +151,14 @@ static long long int download_head(unsigned long long total,
 	 * Files smaller than THOR_STORE_UNIT_SIZE (now 32 MiB) are stored on
 	 * the medium.
 	 * The packet response is sent on the purpose after successful data
-	 * chunk write. There is a room for improvement when asynchronous write
-	 * is performed.
+	 * chunk write. With more than one DFU buffer ("dfu_bufcnt") the data
+	 * is received straight into the next buffer and the previous one is
+	 * written out while each packet is in flight.
 	 */
 	while (total - rcv_cnt >= packet_size) {
 		thor_set_dma(buf, packet_size);
 		buf += packet_size;
-		ret_rcv = thor_rx_data();
+		ret_rcv = thor_rx_data(dfu_entity);
 		if (ret_rcv < 0)
 			return ret_rcv;
 		rcv_cnt += ret_rcv;
@@ -173,6 +174,7 @@ static long long int download_head(unsigned long long total,
 				      ret, *cnt);
 				return ret;
 			}
+			transfer_buffer = dfu_get_write_buf(dfu_entity);
 			buf = transfer_buffer;
 		}
 		send_data_rsp(0, ++usb_pkt_cnt);
@@ -191,7 +193,7 @@ static long long int download_head(unsigned long long total,
 
 	if (left_to_rcv) {
 		thor_set_dma(buf, packet_size);
-		ret_rcv = thor_rx_data();
+		ret_rcv = thor_rx_data(dfu_entity);
 		if (ret_rcv < 0)
 			return ret_rcv;
 		rcv_cnt += ret_rcv;
@@ -217,7 +219,7 @@ static int download_tail(long long int left, int cnt)
 		return -ENOENT;
 	}
 
-	transfer_buffer = dfu_get_buf(dfu_entity);
+	transfer_buffer = dfu_get_write_buf(dfu_entity);
 	if (!transfer_buffer) {
 		error("Transfer buffer not allocated!");
 		return -ENXIO;
@@ -522,10 +524,14 @@ static struct usb_request *alloc_ep_req(struct usb_ep *ep, unsigned length)
 	return req;
 }
 
-static int thor_rx_data(void)
+/*
+ * Receive dev->out_req->length bytes. If a DFU entity is given, its queued
+ * data is written to the medium while the transfer is in progress.
+ */
+static int thor_rx_data(struct dfu_entity *dfu)
 {
 	struct thor_dev *dev = thor_func->dev;
-	int data_to_rx, tmp, status;
+	int data_to_rx, tmp, status, ret = 0;
 
 	data_to_rx = dev->out_req->length;
 	tmp = data_to_rx;
@@ -542,6 +548,9 @@ static int thor_rx_data(void)
 			return -EAGAIN;
 		}
 
+		if (dfu && !ret)
+			ret = dfu_write_pending(dfu, data_to_rx);
+
 		while (!dev->rxdata) {
 			usb_gadget_handle_interrupts();
 			if (ctrlc())
@@ -551,6 +560,12 @@ static int thor_rx_data(void)
 		data_to_rx -= dev->out_req->actual;
 	} while (data_to_rx);
 
+	if (ret) {
+		error("DFU write failed [%d]", ret);
+		dfu_write_transaction_cleanup(dfu);
+		return ret;
+	}
+
 	return tmp;
 }
 
@@ -698,7 +713,7 @@ int thor_init(void)
 
 	thor_set_dma(thor_rx_data_buf, strlen("THOR"));
 	/* detect the download request from Host PC */
-	if (thor_rx_data() < 0) {
+	if (thor_rx_data(NULL) < 0) {
 		printf("%s: Data not received!\n", __func__);
 		return -1;
 	}
@@ -724,7 +739,7 @@ int thor_handle(void)
 	/* receive the data from Host PC */
 	while (1) {
 		thor_set_dma(thor_rx_data_buf, sizeof(struct rqt_box));
-		ret = thor_rx_data();
+		ret = thor_rx_data(NULL);
 
 		if (ret > 0) {
 			ret = process_data();
@@ -230,6 +230,7 @@ struct interrupt_data {
 #define SC_READ_6			0x08
 #define SC_READ_10			0x28
 #define SC_READ_12			0xa8
+#define SC_READ_16			0x88
 #define SC_READ_CAPACITY		0x25
 #define SC_READ_FORMAT_CAPACITIES	0x23
 #define SC_READ_HEADER			0x44
@@ -245,6 +246,7 @@ struct interrupt_data {
 #define SC_WRITE_6			0x0a
 #define SC_WRITE_10			0x2a
 #define SC_WRITE_12			0xaa
+#define SC_WRITE_16			0x8a
 
 /* SCSI Sense Key/Additional Sense Code/ASC Qualifier values */
 #define SS_NO_SENSE				0
@@ -305,11 +307,24 @@ static struct fsg_lun *fsg_lun_from_dev(struct device *dev)
 #define EP0_BUFSIZE	256
 #define DELAYED_STATUS	(EP0_BUFSIZE + 999)	/* An impossibly large value */
 
-/* Number of buffers we will use.  2 is enough for double-buffering */
+/*
+ * Number of buffers we will use.  2 is enough for double-buffering, more
+ * let media accesses run further ahead of (or behind) the USB transfers.
+ * Media accesses are synchronous, so this only helps with a UDC driver
+ * which moves queued requests by DMA while they run.
+ */
+#ifdef CONFIG_USB_GADGET_STORAGE_NUM_BUFFERS
+#define FSG_NUM_BUFFERS	CONFIG_USB_GADGET_STORAGE_NUM_BUFFERS
+#else
 #define FSG_NUM_BUFFERS	2
+#endif
 
-/* Default size of buffer length. */
+/* Size of each buffer, i.e. the largest single media access */
+#ifdef CONFIG_USB_GADGET_STORAGE_BUFLEN
+#define FSG_BUFLEN	((u32)CONFIG_USB_GADGET_STORAGE_BUFLEN)
+#else
 #define FSG_BUFLEN	((u32)16384)
+#endif
 
 /* Maximal number of LUNs supported in mass storage function */
 #define FSG_MAX_LUNS	8
@@ -287,6 +287,39 @@ static void ehci_update_endpt2_dev_n_port(struct usb_device *dev,
 				     QH_ENDPT2_HUBADDR(ttdev->parent->devnum));
 }
 
+/*
+ * qTDs set aside for asynchronous transfers when the controller starts:
+ * enough for a mass-storage transfer of 65535 blocks of 512 bytes into an
+ * unaligned buffer (see the qTD count in ehci_submit_async()).
+ */
+#define EHCI_ASYNC_TDS	(2 + 2 + 65535 * 512 / \
+			 ((QT_BUFFER_CNT - 1) * EHCI_PAGE_SIZE))
+
+/*
+ * Get an array of at least @count qTDs for an asynchronous transfer. The
+ * array is kept with the controller, set up for the largest storage
+ * transfer when it starts and only reallocated if a larger one comes
+ * along, so that back-to-back bulk transfers do not go through the heap.
+ *
+ * Only one transfer is queued at a time: the whole data stage of a
+ * request is chained onto its QH, but the USB core waits for each request
+ * to complete, and Bulk-Only storage allows a single command in flight.
+ */
+static struct qTD *ehci_alloc_qtds(struct ehci_ctrl *ctrl, int count)
+{
+	if (count > ctrl->async_td_count) {
+		free(ctrl->async_tds);
+		ctrl->async_td_count = 0;
+		ctrl->async_tds = memalign(USB_DMA_MINALIGN,
+					   count * sizeof(struct qTD));
+		if (ctrl->async_tds == NULL)
+			return NULL;
+		ctrl->async_td_count = count;
+	}
+
+	return ctrl->async_tds;
+}
+
 static int
 ehci_submit_async(struct usb_device *dev, unsigned long pipe, void *buffer,
 		   int length, struct devrequest *req)
@@ -373,7 +406,7 @@ ehci_submit_async(struct usb_device *dev, unsigned long pipe, void *buffer,
 #if CONFIG_SYS_MALLOC_LEN <= 64 + 128 * 1024
 #warning CONFIG_SYS_MALLOC_LEN may be too small for EHCI
 #endif
-	qtd = memalign(USB_DMA_MINALIGN, qtd_count * sizeof(struct qTD));
+	qtd = ehci_alloc_qtds(ctrl, qtd_count);
 	if (qtd == NULL) {
 		printf("unable to allocate TDs\n");
 		return -1;
@@ -555,7 +588,11 @@ ehci_submit_async(struct usb_device *dev, unsigned long pipe, void *buffer,
 		goto fail;
 	}
 
-	/* Wait for TDs to be processed. */
+	/*
+	 * Wait for TDs to be processed. Only the last qTD is looked at, so
+	 * there is no need to invalidate the whole list on every poll, which
+	 * for large bulk transfers is a considerable amount of memory.
+	 */
 	ts = get_timer(0);
 	vtd = &qtd[qtd_counter - 1];
 	timeout = USB_TIMEOUT_MS(pipe);
@@ -565,8 +602,10 @@ ehci_submit_async(struct usb_device *dev, unsigned long pipe, void *buffer,
 			ALIGN_END_ADDR(struct QH, &ctrl->qh_list, 1));
 		invalidate_dcache_range((unsigned long)qh,
 			ALIGN_END_ADDR(struct QH, qh, 1));
-		invalidate_dcache_range((unsigned long)qtd,
-			ALIGN_END_ADDR(struct qTD, qtd, qtd_count));
+		invalidate_dcache_range(
+			(unsigned long)vtd & ~(USB_DMA_MINALIGN - 1),
+			ALIGN((unsigned long)vtd + sizeof(struct qTD),
+			      USB_DMA_MINALIGN));
 
 		token = hc32_to_cpu(vtd->qt_token);
 		if (!(QT_TOKEN_GET_STATUS(token) & QT_TOKEN_STATUS_ACTIVE))
@@ -641,11 +680,9 @@ ehci_submit_async(struct usb_device *dev, unsigned long pipe, void *buffer,
 #endif
 	}
 
-	free(qtd);
 	return (dev->status != USB_ST_NOT_PROC) ? 0 : -1;
 
 fail:
-	free(qtd);
 	return -1;
 }
 
@@ -1010,6 +1047,9 @@ int usb_lowlevel_init(int index, enum usb_init_type init, void **controller)
 
 	if (!ehcic[index].periodic_list)
 		return -ENOMEM;
+
+	/* Not fatal, ehci_submit_async() tries again for what it needs */
+	ehci_alloc_qtds(&ehcic[index], EHCI_ASYNC_TDS);
 	for (i = 0; i < 1024; i++) {
 		ehcic[index].periodic_list[i] = cpu_to_hc32((unsigned long)periodic
 						| QH_LINK_TYPE_QH);
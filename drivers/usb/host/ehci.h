@@ -248,6 +248,8 @@ struct ehci_ctrl {
 	uint32_t *periodic_list;
 	int periodic_schedules;
 	int ntds;
+	struct qTD *async_tds;	/* qTDs for ehci_submit_async(), see there */
+	int async_td_count;
 };
 
 /* Low level init functions */
@@ -94,6 +94,20 @@ static void xhci_ring_free(struct xhci_ring *ring)
 	free(ring);
 }
 
+/**
+ * frees the ring and stream context array of an endpoint, if it has them
+ *
+ * @param virt_ep	endpoint to clear
+ * @return none
+ */
+void xhci_virt_ep_free(struct xhci_virt_ep *virt_ep)
+{
+	if (virt_ep->ring)
+		xhci_ring_free(virt_ep->ring);
+	free(virt_ep->stream_ctx);
+	memset(virt_ep, '\0', sizeof(*virt_ep));
+}
+
 /**
  * frees the "xhci_container_ctx" pointer passed
  *
@@ -130,8 +144,7 @@ static void xhci_free_virt_devices(struct xhci_ctrl *ctrl)
 		ctrl->dcbaa->dev_context_ptrs[slot_id] = 0;
 
 		for (i = 0; i < 31; ++i)
-			if (virt_dev->eps[i].ring)
-				xhci_ring_free(virt_dev->eps[i].ring);
+			xhci_virt_ep_free(&virt_dev->eps[i]);
 
 		if (virt_dev->in_ctx)
 			xhci_free_container_ctx(virt_dev->in_ctx);
@@ -318,6 +331,30 @@ struct xhci_ring *xhci_ring_alloc(unsigned int num_segs, bool link_trbs)
 	return ring;
 }
 
+/**
+ * Allocates a stream context array in which stream XHCI_STREAM_ID uses
+ * the ring passed
+ *
+ * @param ring	transfer ring for the stream
+ * @return pointer to the stream context array, NULL if out of memory
+ */
+struct xhci_stream_ctx *xhci_stream_ctx_alloc(struct xhci_ring *ring)
+{
+	struct xhci_stream_ctx *stream_ctx;
+	unsigned int size = XHCI_STREAM_CTX_NUM * sizeof(*stream_ctx);
+	u64 trb_64;
+
+	stream_ctx = xhci_malloc(size);
+	if (!stream_ctx)
+		return NULL;
+	trb_64 = (uintptr_t)ring->enqueue;
+	stream_ctx[XHCI_STREAM_ID].stream_ring = cpu_to_le64(trb_64 |
+			SCT_FOR_CTX(SCT_PRI_TR) | ring->cycle_state);
+	xhci_flush_cache((uint32_t)stream_ctx, size);
+
+	return stream_ctx;
+}
+
 /**
  * Allocates the Container context
  *
@@ -269,8 +269,8 @@ static int prepare_ring(struct xhci_ctrl *ctrl, struct xhci_ring *ep_ring,
  * @param cmd		Command type to enqueue
  * @return none
  */
-void xhci_queue_command(struct xhci_ctrl *ctrl, u8 *ptr, u32 slot_id,
-			u32 ep_index, trb_type cmd)
+static void queue_command(struct xhci_ctrl *ctrl, u8 *ptr, u32 slot_id,
+			  u32 ep_index, u32 stream_id, trb_type cmd)
 {
 	u32 fields[4];
 	u64 val_64 = (uintptr_t)ptr;
@@ -279,7 +279,7 @@ void xhci_queue_command(struct xhci_ctrl *ctrl, u8 *ptr, u32 slot_id,
 
 	fields[0] = lower_32_bits(val_64);
 	fields[1] = upper_32_bits(val_64);
-	fields[2] = 0;
+	fields[2] = STREAM_ID_FOR_TRB(stream_id);
 	fields[3] = TRB_TYPE(cmd) | EP_ID_FOR_TRB(ep_index) |
 		    SLOT_ID_FOR_TRB(slot_id) | ctrl->cmd_ring->cycle_state;
 
@@ -289,6 +289,22 @@ void xhci_queue_command(struct xhci_ctrl *ctrl, u8 *ptr, u32 slot_id,
 	xhci_writel(&ctrl->dba->doorbell[0], DB_VALUE_HOST);
 }
 
+void xhci_queue_command(struct xhci_ctrl *ctrl, u8 *ptr, u32 slot_id,
+			u32 ep_index, trb_type cmd)
+{
+	queue_command(ctrl, ptr, slot_id, ep_index, 0, cmd);
+}
+
+/* The stream to use on an endpoint, or 0 if it does not have streams */
+static u32 ep_stream_id(struct usb_device *udev, int ep_index)
+{
+	struct xhci_ctrl *ctrl = udev->controller;
+	struct xhci_virt_ep *virt_ep;
+
+	virt_ep = &ctrl->devs[udev->slot_id]->eps[ep_index];
+	return (virt_ep->ep_state & EP_HAS_STREAMS) ? XHCI_STREAM_ID : 0;
+}
+
 /**
  * The TD size is the number of bytes remaining in the TD (including this TRB),
  * right shifted by 10.
@@ -368,7 +384,7 @@ static void giveback_first_trb(struct usb_device *udev, int ep_index,
 
 	/* Ringing EP doorbell here */
 	xhci_writel(&ctrl->dba->doorbell[udev->slot_id],
-				DB_VALUE(ep_index, 0));
+		    DB_VALUE(ep_index, ep_stream_id(udev, ep_index)));
 
 	return;
 }
@@ -479,6 +495,8 @@ static void abort_td(struct usb_device *udev, int ep_index)
 {
 	struct xhci_ctrl *ctrl = udev->controller;
 	struct xhci_ring *ring =  ctrl->devs[udev->slot_id]->eps[ep_index].ring;
+	u32 stream_id = ep_stream_id(udev, ep_index);
+	uintptr_t deq;
 	union xhci_trb *event;
 	u32 field;
 
@@ -498,8 +516,12 @@ static void abort_td(struct usb_device *udev, int ep_index)
 		event->event_cmd.status)) != COMP_SUCCESS);
 	xhci_acknowledge_event(ctrl);
 
-	xhci_queue_command(ctrl, (void *)((uintptr_t)ring->enqueue |
-		ring->cycle_state), udev->slot_id, ep_index, TRB_SET_DEQ);
+	/* A stream's dequeue pointer also gives the stream context type */
+	deq = (uintptr_t)ring->enqueue | ring->cycle_state;
+	if (stream_id)
+		deq |= SCT_FOR_CTX(SCT_PRI_TR);
+	queue_command(ctrl, (void *)deq, udev->slot_id, ep_index, stream_id,
+		      TRB_SET_DEQ);
 	event = xhci_wait_for_event(ctrl, TRB_COMPLETION);
 	BUG_ON(TRB_TO_SLOT_ID(le32_to_cpu(event->event_cmd.flags))
 		!= udev->slot_id || GET_COMP_CODE(le32_to_cpu(
@@ -281,12 +281,15 @@ static int xhci_configure_endpoints(struct usb_device *udev, bool ctx_change)
 }
 
 /**
- * Configure the endpoint, programming the device contexts.
+ * Configure the endpoints of an alternate setting of the first interface,
+ * programming the device contexts. The endpoints of the setting used
+ * before are dropped.
  *
  * @param udev	pointer to the USB device structure
+ * @param alt	alternate setting whose endpoints are configured
  * @return returns the status of the xhci_configure_endpoints
  */
-static int xhci_set_configuration(struct usb_device *udev)
+static int xhci_set_configuration(struct usb_device *udev, int alt)
 {
 	struct xhci_container_ctx *in_ctx;
 	struct xhci_container_ctx *out_ctx;
@@ -304,10 +307,17 @@ static int xhci_set_configuration(struct usb_device *udev)
 	u64 trb_64 = 0;
 	int slot_id = udev->slot_id;
 	struct xhci_virt_device *virt_dev = ctrl->devs[slot_id];
+	struct xhci_virt_ep old_eps[ARRAY_SIZE(virt_dev->eps)];
+	struct xhci_virt_ep *virt_ep;
 	struct usb_interface *ifdesc;
+	int max_psa;
+	int ret;
 
 	out_ctx = virt_dev->out_ctx;
 	in_ctx = virt_dev->in_ctx;
+	max_psa = HCC_MAX_PSA(xhci_readl(&ctrl->hccr->cr_hccparams));
+	udev->bulk_streams = udev->speed == USB_SPEED_SUPER &&
+			     max_psa >= XHCI_STREAM_CTX_NUM;
 
 	num_of_ep = udev->config.if_desc[0].no_of_ep;
 	ifdesc = &udev->config.if_desc[0];
@@ -317,8 +327,26 @@ static int xhci_set_configuration(struct usb_device *udev)
 	ctrl_ctx->add_flags = 0;
 	ctrl_ctx->drop_flags = 0;
 
-	/* EP_FLAG gives values 1 & 4 for EP1OUT and EP2IN */
+	/*
+	 * Drop the endpoints set up before. Their rings are only freed once
+	 * the controller has let go of them.
+	 */
+	for (ep_index = 1; ep_index < ARRAY_SIZE(virt_dev->eps); ep_index++) {
+		virt_ep = &virt_dev->eps[ep_index];
+		old_eps[ep_index] = *virt_ep;
+		if (!virt_ep->ring)
+			continue;
+		ctrl_ctx->drop_flags |= cpu_to_le32(1 << (ep_index + 1));
+		memset(virt_ep, '\0', sizeof(*virt_ep));
+	}
+
+	/*
+	 * EP_FLAG gives values 1 & 4 for EP1OUT and EP2IN. The endpoints of
+	 * all alternate settings are listed, only add those of this one.
+	 */
 	for (cur_ep = 0; cur_ep < num_of_ep; cur_ep++) {
+		if (ifdesc->ep_altsetting[cur_ep] != alt)
+			continue;
 		ep_flag = xhci_get_ep_index(&ifdesc->ep_desc[cur_ep]);
 		ctrl_ctx->add_flags |= cpu_to_le32(1 << (ep_flag + 1));
 		if (max_ep_flag < ep_flag)
@@ -339,16 +367,21 @@ static int xhci_set_configuration(struct usb_device *udev)
 	for (cur_ep = 0; cur_ep < num_of_ep; cur_ep++) {
 		struct usb_endpoint_descriptor *endpt_desc = NULL;
 
+		if (ifdesc->ep_altsetting[cur_ep] != alt)
+			continue;
 		endpt_desc = &ifdesc->ep_desc[cur_ep];
 		trb_64 = 0;
 
 		ep_index = xhci_get_ep_index(endpt_desc);
 		ep_ctx[ep_index] = xhci_get_ep_ctx(ctrl, in_ctx, ep_index);
+		virt_ep = &virt_dev->eps[ep_index];
 
 		/* Allocate the ep rings */
-		virt_dev->eps[ep_index].ring = xhci_ring_alloc(1, true);
-		if (!virt_dev->eps[ep_index].ring)
-			return -ENOMEM;
+		virt_ep->ring = xhci_ring_alloc(1, true);
+		if (!virt_ep->ring) {
+			ret = -ENOMEM;
+			goto err;
+		}
 
 		/*NOTE: ep_desc[0] actually represents EP1 and so on */
 		dir = (((endpt_desc->bEndpointAddress) & (0x80)) >> 7);
@@ -363,13 +396,52 @@ static int xhci_set_configuration(struct usb_device *udev)
 			cpu_to_le32(((0 & MAX_BURST_MASK) << MAX_BURST_SHIFT) |
 			((3 & ERROR_COUNT_MASK) << ERROR_COUNT_SHIFT));
 
-		trb_64 = (uintptr_t)
-				virt_dev->eps[ep_index].ring->enqueue;
+		trb_64 = (uintptr_t)virt_ep->ring->enqueue;
 		ep_ctx[ep_index]->deq = cpu_to_le64(trb_64 |
-				virt_dev->eps[ep_index].ring->cycle_state);
+				virt_ep->ring->cycle_state);
+
+		/*
+		 * USB Attached SCSI pipes on SuperSpeed are addressed by
+		 * stream. Give them a stream array with one stream, whose
+		 * ring is the one just allocated.
+		 */
+		ep_ctx[ep_index]->ep_info &=
+			cpu_to_le32(~(EP_MAXPSTREAMS_MASK | EP_HAS_LSA));
+		if (udev->bulk_streams &&
+		    (ep_type == BULK_IN_EP || ep_type == BULK_OUT_EP) &&
+		    ifdesc->ep_pipe_id[cur_ep] &&
+		    (ifdesc->ss_ep_comp_desc[cur_ep].bmAttributes & 0x1f)) {
+			virt_ep->stream_ctx =
+				xhci_stream_ctx_alloc(virt_ep->ring);
+			if (!virt_ep->stream_ctx) {
+				ret = -ENOMEM;
+				goto err;
+			}
+			virt_ep->ep_state |= EP_HAS_STREAMS;
+			ep_ctx[ep_index]->ep_info |= cpu_to_le32(
+				EP_MAXPSTREAMS(XHCI_MAX_PSTREAMS) | EP_HAS_LSA);
+			ep_ctx[ep_index]->deq =
+				cpu_to_le64((uintptr_t)virt_ep->stream_ctx);
+		}
 	}
 
-	return xhci_configure_endpoints(udev, false);
+	ret = xhci_configure_endpoints(udev, false);
+	if (ret)
+		goto err;
+
+	for (ep_index = 1; ep_index < ARRAY_SIZE(virt_dev->eps); ep_index++)
+		xhci_virt_ep_free(&old_eps[ep_index]);
+
+	return 0;
+
+err:
+	/* Keep the endpoints as they were, the controller still has them */
+	for (ep_index = 1; ep_index < ARRAY_SIZE(virt_dev->eps); ep_index++) {
+		xhci_virt_ep_free(&virt_dev->eps[ep_index]);
+		virt_dev->eps[ep_index] = old_eps[ep_index];
+	}
+
+	return ret;
 }
 
 /**
@@ -919,7 +991,19 @@ submit_control_msg(struct usb_device *udev, unsigned long pipe, void *buffer,
 		return xhci_address_device(udev);
 
 	if (setup->request == USB_REQ_SET_CONFIGURATION) {
-		ret = xhci_set_configuration(udev);
+		ret = xhci_set_configuration(udev, 0);
+		if (ret) {
+			puts("Failed to configure xHCI endpoint\n");
+			return ret;
+		}
+	}
+
+	/* Switching the first interface to another setting swaps endpoints */
+	if (setup->requesttype == USB_RECIP_INTERFACE &&
+	    setup->request == USB_REQ_SET_INTERFACE &&
+	    le16_to_cpu(setup->index) ==
+	    udev->config.if_desc[0].desc.bInterfaceNumber) {
+		ret = xhci_set_configuration(udev, le16_to_cpu(setup->value));
 		if (ret) {
 			puts("Failed to configure xHCI endpoint\n");
 			return ret;
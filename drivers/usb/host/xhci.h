@@ -628,6 +628,32 @@ struct xhci_ep_ctx {
 /* Endpoint is set up with a Linear Stream Array (vs. Secondary Stream Array) */
 #define	EP_HAS_LSA			(1 << 15)
 
+/*
+ * Bulk streams are only used by USB Attached SCSI, which we drive with one
+ * command at a time, so endpoints get the smallest primary stream array and
+ * use a single stream in it.
+ */
+#define XHCI_MAX_PSTREAMS		1
+#define XHCI_STREAM_CTX_NUM		(1 << (XHCI_MAX_PSTREAMS + 1))
+#define XHCI_STREAM_ID			1
+
+/**
+ * struct xhci_stream_ctx
+ * @stream_ring:	64-bit stream ring address, cycle state, and stream type
+ *
+ * Stream Context - section 6.2.4.1
+ */
+struct xhci_stream_ctx {
+	__le64	stream_ring;
+	/* offset 0x8 - 0xf reserved for HC internal use */
+	__le32	reserved[2];
+};
+
+/* Stream Context Types - bits 3:1 of the stream ring address */
+#define SCT_FOR_CTX(p)		(((p) & 0x7) << 1)
+/* Primary stream array, the stream ring is a transfer ring */
+#define SCT_PRI_TR		1
+
 /* ep_info2 bitmasks */
 /*
  * Force Event - generate transfer events for all TRBs for this endpoint
@@ -1055,6 +1081,8 @@ struct xhci_erst {
 
 struct xhci_virt_ep {
 	struct xhci_ring		*ring;
+	/* Stream context array, if EP_HAS_STREAMS is set in ep_state */
+	struct xhci_stream_ctx		*stream_ctx;
 	unsigned int			ep_state;
 #define SET_DEQ_PENDING		(1 << 0)
 #define EP_HALTED		(1 << 1)	/* For stall handling */
@@ -1246,6 +1274,8 @@ void xhci_flush_cache(uint32_t addr, u32 type_len);
 void xhci_inval_cache(uint32_t addr, u32 type_len);
 void xhci_cleanup(struct xhci_ctrl *ctrl);
 struct xhci_ring *xhci_ring_alloc(unsigned int num_segs, bool link_trbs);
+struct xhci_stream_ctx *xhci_stream_ctx_alloc(struct xhci_ring *ring);
+void xhci_virt_ep_free(struct xhci_virt_ep *virt_ep);
 int xhci_alloc_virt_device(struct usb_device *udev);
 int xhci_mem_init(struct xhci_ctrl *ctrl, struct xhci_hccr *hccr,
 		  struct xhci_hcor *hcor);
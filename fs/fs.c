@@ -21,6 +21,7 @@
 #include <ext4fs.h>
 #include <fat.h>
 #include <fs.h>
+#include <hash.h>
 #include <sandboxfs.h>
 #include <asm/io.h>
 #include <div64.h>
@@ -296,6 +297,7 @@ int fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 	 * means read the whole file.
 	 */
 	buf = map_sysmem(addr, len);
+	hash_read_start(getenv("loadhash"), buf);
 	ret = info->read(filename, buf, offset, len, actread);
 	unmap_sysmem(buf);
 
@@ -304,6 +306,8 @@ int fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 		printf("** Unable to read file %s **\n", filename);
 		ret = -1;
 	}
+	if (ret || hash_read_finish(*actread))
+		hash_read_stop();
 	fs_close();
 
 	return ret;
@@ -401,8 +405,11 @@ int do_load(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 	time = get_timer(0);
 	ret = fs_read(filename, addr, pos, bytes, &len_read);
 	time = get_timer(time);
-	if (ret < 0)
+	if (ret < 0) {
+		/* Do not leave the digest of an earlier load behind */
+		hash_read_setenv("loadsum", NULL, 0);
 		return 1;
+	}
 
 	printf("%llu bytes read in %lu ms", len_read, time);
 	if (time > 0) {
@@ -413,6 +420,7 @@ int do_load(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 	puts("\n");
 
 	setenv_hex("filesize", len_read);
+	hash_read_setenv("loadsum", map_sysmem(addr, len_read), len_read);
 
 	return 0;
 }
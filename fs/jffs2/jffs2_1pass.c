@@ -168,45 +168,116 @@ static struct part_info *current_part;
 #endif
 #define NAND_CACHE_SIZE (NAND_CACHE_PAGES*NAND_PAGE_SIZE)
 
-static u8* nand_cache = NULL;
-static u32 nand_cache_off = (u32)-1;
+/*
+ * Dirents and data nodes of a file are spread over the partition, so a
+ * few windows are kept and the least recently used one is refilled.
+ * Only a window continuing the previous one is filled completely, an
+ * isolated node header just needs its flash page.
+ */
+#ifndef NAND_CACHE_WINDOWS
+#define NAND_CACHE_WINDOWS 4
+#endif
+
+static struct nand_cache_window {
+	u8 *buf;
+	u32 off;
+	u32 len;
+	u32 used;
+} nand_cache[NAND_CACHE_WINDOWS];
+static u32 nand_cache_clock;
+static u32 nand_cache_next;	/* end of the last window read */
+
+/* Drop the cached data, the flash may have been written since last time */
+static void nand_cache_invalidate(void)
+{
+	int i;
+
+	for (i = 0; i < NAND_CACHE_WINDOWS; i++)
+		nand_cache[i].off = (u32)-1;
+	nand_cache_next = (u32)-1;
+}
+
+static struct nand_cache_window *nand_cache_get(u32 off)
+{
+	struct mtdids *id = current_part->dev->id;
+	struct nand_cache_window *win = &nand_cache[0];
+	u32 page = nand_info[id->num].writesize;
+	size_t retlen;
+	int i;
+
+	for (i = 0; i < NAND_CACHE_WINDOWS; i++) {
+		if (nand_cache[i].buf && nand_cache[i].off != (u32)-1 &&
+		    off >= nand_cache[i].off &&
+		    off < nand_cache[i].off + nand_cache[i].len) {
+			win = &nand_cache[i];
+			win->used = ++nand_cache_clock;
+			return win;
+		}
+		if (nand_cache[i].used < win->used)
+			win = &nand_cache[i];
+	}
+
+	if (!win->buf) {
+		/* This memory never gets freed but 'cause
+		   it's a bootloader, nobody cares */
+		win->buf = malloc(NAND_CACHE_SIZE);
+		if (!win->buf) {
+			printf("read_nand_cached: can't alloc cache size %d bytes\n",
+			       NAND_CACHE_SIZE);
+			return NULL;
+		}
+	}
+
+	win->off = off & NAND_PAGE_MASK;
+	win->len = NAND_CACHE_SIZE;
+	if (win->off != nand_cache_next && page < NAND_CACHE_SIZE)
+		win->len = ALIGN(win->off + 1, max_t(u32, page, NAND_PAGE_SIZE)) -
+			   win->off;
+	win->used = ++nand_cache_clock;
+	nand_cache_next = win->off + win->len;
+
+	retlen = win->len;
+	if (nand_read(&nand_info[id->num], win->off, &retlen, win->buf) != 0 ||
+	    retlen != win->len) {
+		printf("read_nand_cached: error reading nand off %#x size %d bytes\n",
+		       win->off, win->len);
+		win->off = (u32)-1;
+		return NULL;
+	}
+
+	return win;
+}
 
 static int read_nand_cached(u32 off, u32 size, u_char *buf)
 {
 	struct mtdids *id = current_part->dev->id;
+	struct nand_cache_window *win;
 	u32 bytes_read = 0;
 	size_t retlen;
 	int cpy_bytes;
 
+	/* Large reads gain nothing from the cache, read them directly */
+	if (size >= NAND_CACHE_SIZE) {
+		retlen = size;
+		if (nand_read(&nand_info[id->num], off, &retlen, buf) != 0 ||
+		    retlen != size) {
+			printf("read_nand_cached: error reading nand off %#x size %d bytes\n",
+			       off, size);
+			return -1;
+		}
+		return size;
+	}
+
 	while (bytes_read < size) {
-		if ((off + bytes_read < nand_cache_off) ||
-		    (off + bytes_read >= nand_cache_off+NAND_CACHE_SIZE)) {
-			nand_cache_off = (off + bytes_read) & NAND_PAGE_MASK;
-			if (!nand_cache) {
-				/* This memory never gets freed but 'cause
-				   it's a bootloader, nobody cares */
-				nand_cache = malloc(NAND_CACHE_SIZE);
-				if (!nand_cache) {
-					printf("read_nand_cached: can't alloc cache size %d bytes\n",
-					       NAND_CACHE_SIZE);
-					return -1;
-				}
-			}
+		win = nand_cache_get(off + bytes_read);
+		if (!win)
+			return -1;
 
-			retlen = NAND_CACHE_SIZE;
-			if (nand_read(&nand_info[id->num], nand_cache_off,
-						&retlen, nand_cache) != 0 ||
-					retlen != NAND_CACHE_SIZE) {
-				printf("read_nand_cached: error reading nand off %#x size %d bytes\n",
-						nand_cache_off, NAND_CACHE_SIZE);
-				return -1;
-			}
-		}
-		cpy_bytes = nand_cache_off + NAND_CACHE_SIZE - (off + bytes_read);
+		cpy_bytes = win->off + win->len - (off + bytes_read);
 		if (cpy_bytes > size - bytes_read)
 			cpy_bytes = size - bytes_read;
 		memcpy(buf + bytes_read,
-		       nand_cache + off + bytes_read - nand_cache_off,
+		       win->buf + off + bytes_read - win->off,
 		       cpy_bytes);
 		bytes_read += cpy_bytes;
 	}
@@ -470,6 +541,38 @@ static inline void put_fl_mem(void *buf, void *ext_buf)
 	}
 }
 
+/* Forget the cached flash contents, it may have been written since */
+static inline void flush_fl_mem(void)
+{
+#if defined(CONFIG_JFFS2_NAND) && defined(CONFIG_CMD_NAND)
+	nand_cache_invalidate();
+#endif
+#if defined(CONFIG_CMD_ONENAND)
+	onenand_cache_off = (u32)-1;
+#endif
+}
+
+/*
+ * Smallest unit the flash is written in. Nodes appended after a partially
+ * written NAND page start on the next page.
+ */
+static inline u32 fl_write_size(void)
+{
+	struct mtdids *id = current_part->dev->id;
+
+	switch (id->type) {
+#if defined(CONFIG_JFFS2_NAND) && defined(CONFIG_CMD_NAND)
+	case MTD_DEV_TYPE_NAND:
+		return nand_info[id->num].writesize;
+#endif
+#if defined(CONFIG_CMD_ONENAND)
+	case MTD_DEV_TYPE_ONENAND:
+		return onenand_mtd.writesize;
+#endif
+	}
+	return 4;
+}
+
 /* Compression names */
 static char *compr_names[] = {
 	"NONE",
@@ -542,7 +645,7 @@ add_node(struct b_list *list)
 }
 
 static struct b_node *
-insert_node(struct b_list *list, u32 offset)
+insert_node(struct b_list *list, const struct b_node *node)
 {
 	struct b_node *new;
 #ifdef CONFIG_SYS_JFFS2_SORT_FRAGMENTS
@@ -553,7 +656,7 @@ insert_node(struct b_list *list, u32 offset)
 		putstr("add_node failed!\r\n");
 		return NULL;
 	}
-	new->offset = offset;
+	*new = *node;
 
 #ifdef CONFIG_SYS_JFFS2_SORT_FRAGMENTS
 	if (list->listTail != NULL && list->listCompare(new, list->listTail))
@@ -598,14 +701,7 @@ insert_node(struct b_list *list, u32 offset)
  */
 static int compare_inodes(struct b_node *new, struct b_node *old)
 {
-	struct jffs2_raw_inode ojNew;
-	struct jffs2_raw_inode ojOld;
-	struct jffs2_raw_inode *jNew =
-		(struct jffs2_raw_inode *)get_fl_mem(new->offset, sizeof(ojNew), &ojNew);
-	struct jffs2_raw_inode *jOld =
-		(struct jffs2_raw_inode *)get_fl_mem(old->offset, sizeof(ojOld), &ojOld);
-
-	return jNew->version > jOld->version;
+	return new->version > old->version;
 }
 
 /* Sort directory entries so all entries in the same directory
@@ -615,38 +711,39 @@ static int compare_inodes(struct b_node *new, struct b_node *old)
  */
 static int compare_dirents(struct b_node *new, struct b_node *old)
 {
-	struct jffs2_raw_dirent ojNew;
-	struct jffs2_raw_dirent ojOld;
-	struct jffs2_raw_dirent *jNew =
-		(struct jffs2_raw_dirent *)get_fl_mem(new->offset, sizeof(ojNew), &ojNew);
-	struct jffs2_raw_dirent *jOld =
-		(struct jffs2_raw_dirent *)get_fl_mem(old->offset, sizeof(ojOld), &ojOld);
+	struct jffs2_raw_dirent *jNew;
+	struct jffs2_raw_dirent *jOld;
 	int cmp;
 
 	/* ascending sort by pino */
-	if (jNew->pino != jOld->pino)
-		return jNew->pino > jOld->pino;
+	if (new->pino != old->pino)
+		return new->pino > old->pino;
 
 	/* pino is the same, so use ascending sort by nsize, so
 	 * we don't do strncmp unless we really must.
 	 */
-	if (jNew->nsize != jOld->nsize)
-		return jNew->nsize > jOld->nsize;
+	if (new->nsize != old->nsize)
+		return new->nsize > old->nsize;
 
 	/* length is also the same, so use ascending sort by name
 	 */
-	cmp = strncmp((char *)jNew->name, (char *)jOld->name, jNew->nsize);
+	jNew = (struct jffs2_raw_dirent *)get_node_mem(new->offset, NULL);
+	jOld = (struct jffs2_raw_dirent *)get_node_mem(old->offset, NULL);
+	cmp = jNew && jOld ?
+		strncmp((char *)jNew->name, (char *)jOld->name, new->nsize) : 0;
+	put_fl_mem(jNew, NULL);
+	put_fl_mem(jOld, NULL);
 	if (cmp != 0)
 		return cmp > 0;
 
 	/* we have duplicate names in this directory, so use ascending
 	 * sort by version
 	 */
-	if (jNew->version > jOld->version) {
-		/* since jNew is newer, we know jOld is not valid, so
+	if (new->version > old->version) {
+		/* since new is newer, we know old is not valid, so
 		 * mark it with inode 0 and it will not be used
 		 */
-		jOld->ino = 0;
+		old->ino = 0;
 		return 1;
 	}
 
@@ -654,6 +751,100 @@ static int compare_dirents(struct b_node *new, struct b_node *old)
 }
 #endif
 
+static u16
+jffs2_name_hash(const u8 *name, int len)
+{
+	u32 hash = 0;
+
+	while (len--)
+		hash = hash * 31 + *name++;
+
+	return hash ^ (hash >> 16);
+}
+
+static inline u32
+dir_bucket(u32 pino, u16 name_hash)
+{
+	return (pino * 31 + name_hash) & (JFFS2_HASH_SIZE - 1);
+}
+
+static inline u32
+frag_bucket(u32 ino)
+{
+	return ino & (JFFS2_HASH_SIZE - 1);
+}
+
+static struct b_node *
+insert_inode(struct b_lists *pL, u32 offset, u32 ino, u32 version)
+{
+	struct b_node node;
+
+	memset(&node, 0, sizeof(node));
+	node.offset = offset;
+	node.ino = ino;
+	node.version = version;
+
+	return insert_node(&pL->frag, &node);
+}
+
+static struct b_node *
+insert_dirent(struct b_lists *pL, u32 offset, u32 pino, u32 ino, u32 version,
+	      const u8 *name, u8 nsize, u8 type)
+{
+	struct b_node node;
+
+	memset(&node, 0, sizeof(node));
+	node.offset = offset;
+	node.ino = ino;
+	node.pino = pino;
+	node.version = version;
+	node.name_hash = jffs2_name_hash(name, nsize);
+	node.nsize = nsize;
+	node.type = type;
+
+	return insert_node(&pL->dir, &node);
+}
+
+/*
+ * Chain the nodes of the final lists into hash buckets, keeping list
+ * order within a bucket so newer fragments still overwrite older ones.
+ */
+static void
+build_hashes(struct b_lists *pL)
+{
+	struct b_node *b, *prev, *next;
+	u32 i;
+
+	memset(pL->dir_hash, 0, sizeof(pL->dir_hash));
+	memset(pL->frag_hash, 0, sizeof(pL->frag_hash));
+
+	for (b = pL->dir.listHead; b; b = b->next) {
+		i = dir_bucket(b->pino, b->name_hash);
+		b->hash_next = pL->dir_hash[i];
+		pL->dir_hash[i] = b;
+	}
+	for (b = pL->frag.listHead; b; b = b->next) {
+		i = frag_bucket(b->ino);
+		b->hash_next = pL->frag_hash[i];
+		pL->frag_hash[i] = b;
+	}
+
+	/* the buckets were built backwards */
+	for (i = 0; i < JFFS2_HASH_SIZE; i++) {
+		for (prev = NULL, b = pL->dir_hash[i]; b; prev = b, b = next) {
+			next = b->hash_next;
+			b->hash_next = prev;
+		}
+		pL->dir_hash[i] = prev;
+
+		for (prev = NULL, b = pL->frag_hash[i]; b; prev = b, b = next) {
+			next = b->hash_next;
+			b->hash_next = prev;
+		}
+		pL->frag_hash[i] = prev;
+	}
+}
+
 void
 jffs2_free_cache(struct part_info *part)
 {
@@ -663,8 +854,10 @@ jffs2_free_cache(struct part_info *part)
 		pL = (struct b_lists *)part->jffs2_priv;
 		free_nodes(&pL->frag);
 		free_nodes(&pL->dir);
+		free(pL->sectors);
 		free(pL->readbuf);
 		free(pL);
+		part->jffs2_priv = NULL;
 	}
 }
 
@@ -707,21 +900,21 @@ jffs2_1pass_read_inode(struct b_lists *pL, u32 inode, char *dest)
 	 * This shouldn't cause trouble when loading kernel images, so
 	 * we will live with it.
 	 */
-	for (b = pL->frag.listHead; b != NULL; b = b->next) {
+	for (b = pL->frag_hash[frag_bucket(inode)]; b; b = b->hash_next) {
+		if (inode != b->ino || b->version < latestVersion)
+			continue;
 		jNode = (struct jffs2_raw_inode *) get_fl_mem(b->offset,
 			sizeof(struct jffs2_raw_inode), pL->readbuf);
-		if ((inode == jNode->ino)) {
-			/* get actual file length from the newest node */
-			if (jNode->version >= latestVersion) {
-				totalSize = jNode->isize;
-				latestVersion = jNode->version;
-			}
-		}
+		/* get actual file length from the newest node */
+		totalSize = jNode->isize;
+		latestVersion = jNode->version;
 		put_fl_mem(jNode, pL->readbuf);
 	}
 #endif
 
-	for (b = pL->frag.listHead; b != NULL; b = b->next) {
+	for (b = pL->frag_hash[frag_bucket(inode)]; b; b = b->hash_next) {
+		if (inode != b->ino)
+			continue;
 		jNode = (struct jffs2_raw_inode *) get_node_mem(b->offset,
 								pL->readbuf);
 		if (inode == jNode->ino) {
@@ -819,25 +1012,27 @@ jffs2_1pass_find_inode(struct b_lists * pL, const char *name, u32 pino)
 	struct b_node *b;
 	struct jffs2_raw_dirent *jDir;
 	int len;
+	u16 hash;
 	u32 counter;
 	u32 version = 0;
 	u32 inode = 0;
 
 	/* name is assumed slash free */
 	len = strlen(name);
+	hash = jffs2_name_hash((const u8 *)name, len);
 
 	counter = 0;
 	/* we need to search all and return the inode with the highest version */
-	for(b = pL->dir.listHead; b; b = b->next, counter++) {
+	for (b = pL->dir_hash[dir_bucket(pino, hash)]; b;
+	     b = b->hash_next, counter++) {
+		if (pino != b->pino || len != b->nsize || hash != b->name_hash ||
+		    !b->ino || b->version < version)	/* ino 0 for unlink */
+			continue;
 		jDir = (struct jffs2_raw_dirent *) get_node_mem(b->offset,
 								pL->readbuf);
 		if ((pino == jDir->pino) && (len == jDir->nsize) &&
 		    (jDir->ino) &&	/* 0 for unlink */
 		    (!strncmp((char *)jDir->name, name, len))) {	/* a match */
-			if (jDir->version < version) {
-				put_fl_mem(jDir, pL->readbuf);
-				continue;
-			}
 
 			if (jDir->version == version && inode != 0) {
 				/* I'm pretty sure this isn't legal */
@@ -951,31 +1146,27 @@ jffs2_1pass_list_inodes(struct b_lists * pL, u32 pino)
 	struct jffs2_raw_dirent *jDir;
 
 	for (b = pL->dir.listHead; b; b = b->next) {
+		if (pino != b->pino || !b->ino)	/* ino=0 -> unlink */
+			continue;
 		jDir = (struct jffs2_raw_dirent *) get_node_mem(b->offset,
 								pL->readbuf);
 		if ((pino == jDir->pino) && (jDir->ino)) { /* ino=0 -> unlink */
-			u32 i_version = 0;
-			struct jffs2_raw_inode ojNode;
-			struct jffs2_raw_inode *jNode, *i = NULL;
-			struct b_node *b2 = pL->frag.listHead;
-
-			while (b2) {
-				jNode = (struct jffs2_raw_inode *)
-					get_fl_mem(b2->offset, sizeof(ojNode), &ojNode);
-				if (jNode->ino == jDir->ino && jNode->version >= i_version) {
-					i_version = jNode->version;
-					if (i)
-						put_fl_mem(i, NULL);
-
-					if (jDir->type == DT_LNK)
-						i = get_node_mem(b2->offset,
-								 NULL);
-					else
-						i = get_fl_mem(b2->offset,
-							       sizeof(*i),
-							       NULL);
-				}
-				b2 = b2->next;
+			struct jffs2_raw_inode *i = NULL;
+			struct b_node *b2, *newest = NULL;
+
+			for (b2 = pL->frag_hash[frag_bucket(b->ino)]; b2;
+			     b2 = b2->hash_next) {
+				if (b2->ino == b->ino &&
+				    (!newest || b2->version >= newest->version))
+					newest = b2;
+			}
+
+			if (newest) {
+				if (jDir->type == DT_LNK)
+					i = get_node_mem(newest->offset, NULL);
+				else
+					i = get_fl_mem(newest->offset,
+						       sizeof(*i), NULL);
 			}
 
 			dump_inode(pL, jDir, i);
@@ -1059,36 +1250,36 @@ jffs2_1pass_resolve_inode(struct b_lists * pL, u32 ino)
 
 	/* we need to search all and return the inode with the highest version */
 	for(b = pL->dir.listHead; b; b = b->next) {
-		jDir = (struct jffs2_raw_dirent *) get_node_mem(b->offset,
-								pL->readbuf);
-		if (ino == jDir->ino) {
-			if (jDir->version < version) {
-				put_fl_mem(jDir, pL->readbuf);
-				continue;
-			}
-
-			if (jDir->version == version && jDirFoundType) {
-				/* I'm pretty sure this isn't legal */
-				putstr(" ** ERROR ** ");
-				putnstr(jDir->name, jDir->nsize);
-				putLabeledWord(" has dup version (resolve) = ",
-					version);
-			}
+		if (ino != b->ino || b->version < version)
+			continue;
 
-			jDirFoundType = jDir->type;
-			jDirFoundIno = jDir->ino;
-			jDirFoundPino = jDir->pino;
-			version = jDir->version;
+		if (b->version == version && jDirFoundType) {
+			/* I'm pretty sure this isn't legal */
+			jDir = (struct jffs2_raw_dirent *)
+				get_node_mem(b->offset, pL->readbuf);
+			putstr(" ** ERROR ** ");
+			putnstr(jDir->name, jDir->nsize);
+			putLabeledWord(" has dup version (resolve) = ",
+				version);
+			put_fl_mem(jDir, pL->readbuf);
 		}
-		put_fl_mem(jDir, pL->readbuf);
+
+		jDirFoundType = b->type;
+		jDirFoundIno = b->ino;
+		jDirFoundPino = b->pino;
+		version = b->version;
 	}
 	/* now we found the right entry again. (shoulda returned inode*) */
 	if (jDirFoundType != DT_LNK)
 		return jDirFoundIno;
 
 	/* it's a soft link so we follow it again. */
-	b2 = pL->frag.listHead;
+	b2 = pL->frag_hash[frag_bucket(jDirFoundIno)];
 	while (b2) {
+		if (b2->ino != jDirFoundIno) {
+			b2 = b2->hash_next;
+			continue;
+		}
 		jNode = (struct jffs2_raw_inode *) get_node_mem(b2->offset,
 								pL->readbuf);
 		if (jNode->ino == jDirFoundIno) {
@@ -1105,7 +1296,7 @@ jffs2_1pass_resolve_inode(struct b_lists * pL, u32 ino)
 			put_fl_mem(jNode, pL->readbuf);
 			break;
 		}
-		b2 = b2->next;
+		b2 = b2->hash_next;
 		put_fl_mem(jNode, pL->readbuf);
 	}
 	/* ok so the name of the new file to find is in tmp */
@@ -1169,10 +1360,11 @@ jffs2_1pass_search_list_inodes(struct b_lists * pL, const char *fname, u32 pino)
 unsigned char
 jffs2_1pass_rescan_needed(struct part_info *part)
 {
-	struct b_node *b;
 	struct jffs2_unknown_node onode;
 	struct jffs2_unknown_node *node;
 	struct b_lists *pL = (struct b_lists *)part->jffs2_priv;
+	u32 tail;
+	u32 i;
 
 	if (part->jffs2_priv == 0){
 		DEBUGF ("rescan: First time in use\n");
@@ -1185,17 +1377,35 @@ jffs2_1pass_rescan_needed(struct part_info *part)
 		return 1;
 	}
 
-	/* but suppose someone reflashed a partition at the same offset... */
-	b = pL->dir.listHead;
-	while (b) {
-		node = (struct jffs2_unknown_node *) get_fl_mem(b->offset,
-			sizeof(onode), &onode);
-		if (node->nodetype != JFFS2_NODETYPE_DIRENT) {
-			DEBUGF ("rescan: fs changed beneath me? (%lx)\n",
-					(unsigned long) b->offset);
+	/* but suppose someone reflashed a partition at the same offset,
+	 * or wrote to it: check that the last node of each sector is
+	 * still there and nothing was written after it.
+	 */
+	for (i = 0; i < pL->nr_sectors; i++) {
+		struct b_sector *sect = &pL->sectors[i];
+		u32 sector_ofs = (u32)part->offset + i * part->sector_size;
+		u32 end = sector_ofs;
+
+		if (sect->offset != (u32)-1) {
+			node = (struct jffs2_unknown_node *)
+				get_fl_mem(sect->offset, sizeof(onode), &onode);
+			if (node->magic != JFFS2_MAGIC_BITMASK ||
+			    node->hdr_crc != sect->hdr_crc) {
+				DEBUGF ("rescan: fs changed beneath me? (%lx)\n",
+						(unsigned long) sect->offset);
+				return 1;
+			}
+			end = ALIGN(sect->offset + node->totlen,
+				    fl_write_size());
+		}
+		if (end + sizeof(tail) > sector_ofs + part->sector_size)
+			continue;
+		get_fl_mem(end, sizeof(tail), &tail);
+		if (tail != sect->tail) {
+			DEBUGF ("rescan: fs written at %lx\n",
+					(unsigned long) end);
 			return 1;
 		}
-		b = b->next;
 	}
 	return 0;
 }
@@ -1248,11 +1458,15 @@ static int jffs2_sum_process_sum_data(struct part_info *part, uint32_t offset,
 					if (pass) {
 						spi = sp;
 
-						ret = insert_node(&pL->frag,
+						ret = insert_inode(pL,
 							(u32)part->offset +
 							offset +
 							sum_get_unaligned32(
-								&spi->offset));
+								&spi->offset),
+							sum_get_unaligned32(
+								&spi->inode),
+							sum_get_unaligned32(
+								&spi->version));
 						if (ret == NULL)
 							return -1;
 					}
@@ -1265,11 +1479,19 @@ static int jffs2_sum_process_sum_data(struct part_info *part, uint32_t offset,
 					struct jffs2_sum_dirent_flash *spd;
 					spd = sp;
 					if (pass) {
-						ret = insert_node(&pL->dir,
+						ret = insert_dirent(pL,
 							(u32) part->offset +
 							offset +
 							sum_get_unaligned32(
-								&spd->offset));
+								&spd->offset),
+							sum_get_unaligned32(
+								&spd->pino),
+							sum_get_unaligned32(
+								&spd->ino),
+							sum_get_unaligned32(
+								&spd->version),
+							spd->name, spd->nsize,
+							spd->type);
 						if (ret == NULL)
 							return -1;
 					}
@@ -1439,6 +1661,7 @@ jffs2_1pass_build_lists(struct part_info * part)
 {
 	struct b_lists *pL;
 	struct jffs2_unknown_node *node;
+	struct b_sector *sect;
 	u32 nr_sectors;
 	u32 i;
 	u32 counter4 = 0;
@@ -1457,6 +1680,13 @@ jffs2_1pass_build_lists(struct part_info * part)
 	/* if we are building a list we need to refresh the cache. */
 	jffs_init_1pass_list(part);
 	pL = (struct b_lists *)part->jffs2_priv;
+	pL->sectors = malloc(nr_sectors * sizeof(*pL->sectors));
+	if (!pL->sectors) {
+		putstr("Can't get memory for sector list!\n");
+		jffs2_free_cache(part);
+		return 0;
+	}
+	pL->nr_sectors = nr_sectors;
 	buf = malloc(buf_size);
 	puts ("Scanning JFFS2 FS:   ");
 
@@ -1466,6 +1696,7 @@ jffs2_1pass_build_lists(struct part_info * part)
 		uint32_t buf_ofs = sector_ofs;
 		uint32_t buf_len;
 		uint32_t ofs, prevofs;
+		uint32_t end = sector_ofs;
 #ifdef CONFIG_JFFS2_SUMMARY
 		struct jffs2_sum_marker *sm;
 		void *sumptr = NULL;
@@ -1475,6 +1706,10 @@ jffs2_1pass_build_lists(struct part_info * part)
 
 		WATCHDOG_RESET();
 
+		sect = &pL->sectors[i];
+		sect->offset = (u32)-1;
+		sect->tail = 0xffffffff;
+
 #ifdef CONFIG_JFFS2_SUMMARY
 		buf_len = sizeof(*sm);
 
@@ -1516,6 +1751,12 @@ jffs2_1pass_build_lists(struct part_info * part)
 		if (sumptr) {
 			ret = jffs2_sum_scan_sumnode(part, sector_ofs, sumptr,
 					sumlen, pL);
+			if (ret > 0) {
+				sect->offset = (u32)part->offset + sector_ofs +
+					part->sector_size - sumlen;
+				sect->hdr_crc = ((struct jffs2_raw_summary *)
+						 sumptr)->hdr_crc;
+			}
 
 			if (buf_size && sumlen > buf_size)
 				free(sumptr);
@@ -1622,6 +1863,9 @@ jffs2_1pass_build_lists(struct part_info * part)
 				counter4++;
 				continue;
 			}
+			sect->offset = (u32)part->offset + ofs;
+			sect->hdr_crc = node->hdr_crc;
+			end = ofs + node->totlen;
 			/* if its a fragment add it */
 			switch (node->nodetype) {
 			case JFFS2_NODETYPE_INODE:
@@ -1635,8 +1879,11 @@ jffs2_1pass_build_lists(struct part_info * part)
 				if (!inode_crc((struct jffs2_raw_inode *) node))
 				       break;
 
-				if (insert_node(&pL->frag, (u32) part->offset +
-						ofs) == NULL) {
+				if (insert_inode(pL, (u32) part->offset + ofs,
+						((struct jffs2_raw_inode *)
+						 node)->ino,
+						((struct jffs2_raw_inode *)
+						 node)->version) == NULL) {
 					free(buf);
 					jffs2_free_cache(part);
 					return 0;
@@ -1665,8 +1912,19 @@ jffs2_1pass_build_lists(struct part_info * part)
 					break;
 				if (! (counterN%100))
 					puts ("\b\b.  ");
-				if (insert_node(&pL->dir, (u32) part->offset +
-						ofs) == NULL) {
+				if (insert_dirent(pL, (u32) part->offset + ofs,
+						((struct jffs2_raw_dirent *)
+						 node)->pino,
+						((struct jffs2_raw_dirent *)
+						 node)->ino,
+						((struct jffs2_raw_dirent *)
+						 node)->version,
+						((struct jffs2_raw_dirent *)
+						 node)->name,
+						((struct jffs2_raw_dirent *)
+						 node)->nsize,
+						((struct jffs2_raw_dirent *)
+						 node)->type) == NULL) {
 					free(buf);
 					jffs2_free_cache(part);
 					return 0;
@@ -1699,9 +1957,16 @@ jffs2_1pass_build_lists(struct part_info * part)
 			ofs += ((node->totlen + 3) & ~3);
 			counterF++;
 		}
+
+		/* remember what follows the last node, see rescan_needed */
+		end = ALIGN(end, fl_write_size());
+		if (end + sizeof(sect->tail) <= sector_ofs + part->sector_size)
+			get_fl_mem((u32)part->offset + end,
+				   sizeof(sect->tail), &sect->tail);
 	}
 
 	free(buf);
+	build_hashes(pL);
 	putstr("\b\b done.\r\n");		/* close off the dots */
 
 	/* We don't care if malloc failed - then each read operation will
@@ -1769,6 +2034,7 @@ jffs2_get_list(struct part_info * part, const char *who)
 {
 	/* copy requested part_info struct pointer to global location */
 	current_part = part;
+	flush_fl_mem();
 
 	if (jffs2_1pass_rescan_needed(part)) {
 		if (!jffs2_1pass_build_lists(part)) {
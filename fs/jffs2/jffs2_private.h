@@ -4,9 +4,20 @@
 #include <jffs2/jffs2.h>
 
 
+/*
+ * The header fields needed for lookups are kept with each node, so that
+ * finding a file only reads the candidate nodes from flash.
+ */
 struct b_node {
 	u32 offset;
 	struct b_node *next;
+	struct b_node *hash_next;	/* next node in the same hash bucket */
+	u32 ino;			/* inode number, 0 for an unlinked dirent */
+	u32 pino;			/* dirents: parent inode */
+	u32 version;
+	u16 name_hash;			/* dirents: see jffs2_name_hash() */
+	u8 nsize;			/* dirents: name length */
+	u8 type;			/* dirents: DT_xxx */
 	enum { CRC_UNKNOWN = 0, CRC_OK, CRC_BAD } datacrc;
 };
 
@@ -22,9 +33,27 @@ struct b_list {
 	struct mem_block *listMemBase;
 };
 
+/* Must be a power of 2 */
+#define JFFS2_HASH_SIZE	256
+
+/*
+ * Last node found in a sector by the scan, used to notice that the flash
+ * was written since. For a sector without nodes, offset is (u32)-1 and
+ * tail holds the first word of the sector.
+ */
+struct b_sector {
+	u32 offset;
+	u32 hdr_crc;
+	u32 tail;			/* first word that may be written next */
+};
+
 struct b_lists {
 	struct b_list dir;
 	struct b_list frag;
+	struct b_node *dir_hash[JFFS2_HASH_SIZE];	/* by pino and name */
+	struct b_node *frag_hash[JFFS2_HASH_SIZE];	/* by ino */
+	struct b_sector *sectors;
+	u32 nr_sectors;
 	void *readbuf;
 };
 
@@ -6,6 +6,7 @@
 
 #include <common.h>
 #include <fs.h>
+#include <hash.h>
 #include <os.h>
 
 int sandbox_fs_set_blk_dev(block_dev_desc_t *rbdd, disk_partition_t *info)
@@ -45,6 +46,7 @@ int sandbox_fs_read_at(const char *filename, loff_t pos, void *buffer,
 	} else {
 		ret = 0;
 		*actread = size;
+		hash_read_data(buffer, size);
 	}
 
 	return ret;
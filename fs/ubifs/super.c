@@ -2272,6 +2272,12 @@ static int ubifs_fill_super(struct super_block *sb, void *data, int silent)
 		goto out_bdi;
 
 	sb->s_bdi = &c->bdi;
+#else
+	/*
+	 * Files are only ever read whole, so read their data nodes in bulk,
+	 * one flash read and one index lookup for many blocks.
+	 */
+	c->bulk_read = 1;
 #endif
 	sb->s_fs_info = c;
 	sb->s_magic = UBIFS_SUPER_MAGIC;
@@ -26,6 +26,7 @@
 #include "ubifs.h"
 #include <u-boot/zlib.h>
 
+#include <asm/io.h>
 #include <linux/err.h>
 #include <linux/lzo.h>
 
@@ -133,6 +134,7 @@ static inline int crypto_comp_decompress(struct crypto_comp *tfm,
 				u8 *dst, unsigned int *dlen)
 {
 	struct ubifs_compressor *compr = ubifs_compressors[tfm->compressor];
+	size_t len = *dlen;
 	int err;
 
 	if (compr->compr_type == UBIFS_COMPR_NONE) {
@@ -141,7 +143,9 @@ static inline int crypto_comp_decompress(struct crypto_comp *tfm,
 		return 0;
 	}
 
-	err = compr->decompress(src, slen, dst, (size_t *)dlen);
+	/* @dlen bounds the output, the decompressors take a size_t */
+	err = compr->decompress(src, slen, dst, &len);
+	*dlen = len;
 	if (err)
 		ubifs_err("cannot decompress %d bytes, compressor %s, "
 			  "error %d", slen, compr->name, err);
@@ -627,34 +631,40 @@ static inline void *kmap(struct page *page)
 	return page->addr;
 }
 
-static int read_block(struct inode *inode, void *addr, unsigned int block,
-		      struct ubifs_data_node *dn)
+/*
+ * Uncompress data node @dn of @block to @addr, storing at most @len bytes.
+ * The data goes straight to @addr unless the block is longer than @len.
+ */
+static int read_data_node(struct ubifs_info *c, struct inode *inode,
+			  struct ubifs_data_node *dn, unsigned int block,
+			  void *addr, int len)
 {
-	struct ubifs_info *c = inode->i_sb->s_fs_info;
-	int err, len, out_len;
-	union ubifs_key key;
+	int err, size, out_len;
 	unsigned int dlen;
-
-	data_key_init(c, &key, inode->i_ino, block);
-	err = ubifs_tnc_lookup(c, &key, dn);
-	if (err) {
-		if (err == -ENOENT)
-			/* Not found, so it must be a hole */
-			memset(addr, 0, UBIFS_BLOCK_SIZE);
-		return err;
-	}
+	void *out = addr;
 
 	ubifs_assert(le64_to_cpu(dn->ch.sqnum) > ubifs_inode(inode)->creat_sqnum);
 
-	len = le32_to_cpu(dn->size);
-	if (len <= 0 || len > UBIFS_BLOCK_SIZE)
+	size = le32_to_cpu(dn->size);
+	if (size <= 0 || size > UBIFS_BLOCK_SIZE)
 		goto dump;
 
+	len = min(len, UBIFS_BLOCK_SIZE);
+	if (size > len) {
+		out = malloc(UBIFS_BLOCK_SIZE);
+		if (!out)
+			return -ENOMEM;
+	}
+
 	dlen = le32_to_cpu(dn->ch.len) - UBIFS_DATA_NODE_SZ;
-	out_len = UBIFS_BLOCK_SIZE;
-	err = ubifs_decompress(&dn->data, dlen, addr, &out_len,
+	out_len = out == addr ? len : UBIFS_BLOCK_SIZE;
+	err = ubifs_decompress(&dn->data, dlen, out, &out_len,
 			       le16_to_cpu(dn->compr_type));
-	if (err || len != out_len)
+	if (out != addr) {
+		memcpy(addr, out, len);
+		free(out);
+	}
+	if (err || size != out_len)
 		goto dump;
 
 	/*
@@ -662,8 +672,8 @@ static int read_block(struct inode *inode, void *addr, unsigned int block,
 	 * not the last in the file (e.g., as a result of making a hole and
 	 * appending data). Ensure that the remainder is zeroed out.
 	 */
-	if (len < UBIFS_BLOCK_SIZE)
-		memset(addr + len, 0, UBIFS_BLOCK_SIZE - len);
+	if (size < len)
+		memset(addr + size, 0, len - size);
 
 	return 0;
 
@@ -674,6 +684,75 @@ dump:
 	return -EINVAL;
 }
 
+static int read_block(struct inode *inode, void *addr, unsigned int block,
+		      struct ubifs_data_node *dn)
+{
+	struct ubifs_info *c = inode->i_sb->s_fs_info;
+	int err;
+	union ubifs_key key;
+
+	data_key_init(c, &key, inode->i_ino, block);
+	err = ubifs_tnc_lookup(c, &key, dn);
+	if (err) {
+		if (err == -ENOENT)
+			/* Not found, so it must be a hole */
+			memset(addr, 0, UBIFS_BLOCK_SIZE);
+		return err;
+	}
+
+	return read_data_node(c, inode, dn, block, addr, UBIFS_BLOCK_SIZE);
+}
+
+/*
+ * Read the blocks from @block on whose data nodes follow each other in one
+ * LEB with a single flash read, storing at most @len bytes to @addr. This
+ * takes one index lookup per bulk instead of one per block. Returns the
+ * number of bytes stored or a negative error code.
+ */
+static int read_bulk(struct ubifs_info *c, struct inode *inode, void *addr,
+		     unsigned int block, int len)
+{
+	struct bu_info *bu = &c->bu;
+	struct ubifs_zbranch *zbr = bu->zbranch;
+	void *buf = bu->buf;
+	int err, n, done = 0;
+
+	data_key_init(c, &bu->key, inode->i_ino, block);
+	bu->buf_len = c->max_bu_buf_len;
+	err = ubifs_tnc_get_bu_keys(c, bu);
+	if (err)
+		return err;
+
+	if (!bu->cnt) {
+		/* No data nodes left, the rest of the file is a hole */
+		memset(addr, 0, len);
+		return len;
+	}
+
+	err = ubifs_tnc_bulk_read(c, bu);
+	if (err)
+		return err;
+
+	while (zbr < bu->zbranch + bu->cnt && done < len) {
+		n = min(len - done, UBIFS_BLOCK_SIZE);
+		if (key_block(c, &zbr->key) == block) {
+			err = read_data_node(c, inode, buf, block,
+					     addr + done, n);
+			if (err)
+				return err;
+			buf += ALIGN(zbr->len, 8);
+			zbr++;
+		} else {
+			/* Not found, so it must be a hole */
+			memset(addr + done, 0, n);
+		}
+		done += n;
+		block++;
+	}
+
+	return done;
+}
+
 static int do_readpage(struct ubifs_info *c, struct inode *inode,
 		       struct page *page, int last_block_size)
 {
@@ -785,12 +864,30 @@ error:
 	return err;
 }
 
+/* Read the first @size bytes of @inode to @buf, bulk by bulk */
+static int load_bulk(struct ubifs_info *c, struct inode *inode, void *buf,
+		     u32 size)
+{
+	u32 offs;
+	int ret;
+
+	for (offs = 0; offs < size; offs += ret) {
+		ret = read_bulk(c, inode, buf + offs,
+				offs >> UBIFS_BLOCK_SHIFT, size - offs);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
 int ubifs_load(char *filename, u32 addr, u32 size)
 {
 	struct ubifs_info *c = ubifs_sb->s_fs_info;
 	unsigned long inum;
 	struct inode *inode;
 	struct page page;
+	void *buf;
 	int err = 0;
 	int i;
 	int count;
@@ -826,9 +923,15 @@ int ubifs_load(char *filename, u32 addr, u32 size)
 	printf("Loading file '%s' to addr 0x%08x with size %d (0x%08x)...\n",
 	       filename, addr, size, size);
 
-	page.addr = (void *)addr;
+	buf = map_sysmem(addr, size);
+	page.addr = buf;
 	page.index = 0;
 	page.inode = inode;
+	/* Without a bulk-read buffer, read the file page by page */
+	if (c->bu.buf) {
+		err = load_bulk(c, inode, buf, size);
+		count = 0;
+	}
 	for (i = 0; i < count; i++) {
 		/*
 		 * Make sure to not read beyond the requested size
@@ -850,6 +953,7 @@ int ubifs_load(char *filename, u32 addr, u32 size)
 		setenv_hex("filesize", size);
 		printf("Done\n");
 	}
+	unmap_sysmem(buf);
 
 	ubifs_iput(inode);
 
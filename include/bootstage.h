@@ -326,6 +326,20 @@ int bootstage_stash(void *base, int size);
  */
 int bootstage_unstash(void *base, int size);
 
+/**
+ * Dump the boot stages into a buffer, for use with the call trace
+ *
+ * The buffer holds a struct trace_output_hdr followed by a struct
+ * trace_output_mark for each boot stage. Mark times are converted to
+ * timer_get_us(), the timer used for the call trace.
+ *
+ * @param buff		Buffer in which to place data, or NULL to count size
+ * @param buff_size	Size of buffer
+ * @param needed	Returns number of bytes used / needed
+ * @return 0 if ok, -1 on error (buffer exhausted)
+ */
+int bootstage_list_marks(void *buff, int buff_size, unsigned *needed);
+
 #else
 static inline ulong bootstage_add_record(enum bootstage_id id,
 		const char *name, int flags, ulong mark)
@@ -386,6 +400,13 @@ static inline int bootstage_unstash(void *base, int size)
 {
 	return 0;	/* Pretend to succeed */
 }
+
+static inline int bootstage_list_marks(void *buff, int buff_size,
+				       unsigned *needed)
+{
+	*needed = 0;
+	return 0;	/* No marks to list */
+}
 #endif /* CONFIG_BOOTSTAGE */
 
 /* Helper macro for adding a bootstage to a line of code */
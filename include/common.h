@@ -580,6 +580,7 @@ int	serial_init   (void);
 void	serial_setbrg (void);
 void	serial_putc   (const char);
 void	serial_putc_raw(const char);
+int	serial_try_putc(const char);
 void	serial_puts   (const char *);
 int	serial_getc   (void);
 int	serial_tstc   (void);
@@ -769,6 +770,17 @@ int	had_ctrlc (void);	/* have we had a Control-C since last clear? */
 void	clear_ctrlc (void);	/* clear the Control-C condition */
 int	disable_ctrlc (int);	/* 1 to disable, 0 to enable Control-C detect */
 int confirm_yesno(void);        /*  1 if input is "y", "Y", "yes" or "YES" */
+#if defined(CONFIG_CONSOLE_TX_BUFFER) && !defined(CONFIG_SPL_BUILD)
+void	console_flush(void);	/* Wait until buffered output has been sent */
+void	console_flush_fatal(void);	/* Same, also output kept by quiet */
+void	console_set_quiet(int quiet);	/* Only record output when set */
+int	console_get_quiet(void);
+void	console_show_log(void);	/* Print the recorded output */
+#else
+static inline void console_flush(void) {}
+static inline void console_flush_fatal(void) {}
+static inline void console_set_quiet(int quiet) {}
+#endif
 /*
  * STDIO based functions (can always be used)
  */
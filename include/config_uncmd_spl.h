@@ -22,6 +22,8 @@
 #undef CONFIG_CMD_TFTPSRV
 #undef CONFIG_OF_CONTROL
 
+#undef CONFIG_OF_LIBFDT_INDEX
+
 #ifndef CONFIG_SPL_DM
 #undef CONFIG_DM_SERIAL
 #undef CONFIG_DM_GPIO
@@ -32,6 +34,12 @@
 #undef CONFIG_DM_WARN
 #undef CONFIG_DM_DEVICE_REMOVE
 #undef CONFIG_DM_STDIO
+#undef CONFIG_DM_TIMING
+
+#undef CONFIG_JOBS
+#undef CONFIG_DEFERRED_INIT
+#undef CONFIG_HASH_ON_READ
+#undef CONFIG_NAND_BBT_ENV
 
 #endif /* CONFIG_SPL_BUILD */
 #endif /* __CONFIG_UNCMD_SPL_H__ */
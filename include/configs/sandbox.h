@@ -53,6 +53,30 @@
 #define CONFIG_SANDBOX_GPIO
 #define CONFIG_SANDBOX_GPIO_COUNT	128
 
+/* File-backed NAND simulator, see drivers/mtd/nand/sandbox_nand.c */
+#define CONFIG_NAND_SANDBOX
+#define CONFIG_CMD_NAND
+#define CONFIG_SYS_NAND_SELF_INIT
+#define CONFIG_SYS_NAND_ONFI_DETECTION
+#define CONFIG_NAND_BBT_ENV
+#define CONFIG_SYS_MAX_NAND_DEVICE	1
+#define CONFIG_MTD_DEVICE
+#define CONFIG_MTD_PARTITIONS
+#define CONFIG_CMD_MTDPARTS
+#define MTDIDS_DEFAULT			"nand0=nand0"
+#define MTDPARTS_DEFAULT		"mtdparts=nand0:-(ubi)"
+#define CONFIG_RBTREE
+#define CONFIG_CMD_UBI
+#define CONFIG_CMD_UBIFS
+#define CONFIG_LZO
+#define CONFIG_BCH
+#define CONFIG_CMD_TIME
+
+/* DFU back-end only (there is no UDC), to test buffering with RAM */
+#define CONFIG_DFU_FUNCTION
+#define CONFIG_DFU_RAM
+#define CONFIG_SYS_CACHELINE_SIZE	64
+
 #define CONFIG_CMD_GPT
 #define CONFIG_PARTITION_UUIDS
 #define CONFIG_EFI_PARTITION
@@ -120,6 +144,7 @@
 #define CONFIG_SYS_BAUDRATE_TABLE	{4800, 9600, 19200, 38400, 57600,\
 					115200}
 #define CONFIG_SANDBOX_SERIAL
+#define CONFIG_CONSOLE_TX_BUFFER
 
 #define CONFIG_SYS_NO_FLASH
 
@@ -135,6 +160,9 @@
 #define CONFIG_SHA1
 #define CONFIG_SHA256
 
+/* Chunk digests for fastboot delta flashing, tested with ut_fb_delta */
+#define CONFIG_FASTBOOT_FLASH_DELTA
+
 #define CONFIG_TPM_TIS_SANDBOX
 
 #define CONFIG_CMD_SANDBOX
@@ -0,0 +1,123 @@
+/*
+ * Deferred completion of slow hardware operations
+ *
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __DEFERRED_H
+#define __DEFERRED_H
+
+#include <errno.h>
+#include <linux/list.h>
+
+/*
+ * Much of bringing up hardware is waiting: for a card to leave its busy
+ * state, for a PHY to finish autonegotiation. A driver can start such an
+ * operation during init, register it here with a function which finishes
+ * it, and call deferred_complete() when the hardware is first needed. By
+ * then the wait is usually over, having run alongside the rest of init.
+ *
+ * Each operation records when it was started, when it was first needed and
+ * how long that first use had to wait, and deferred_report() lists them.
+ */
+
+enum deferred_state {
+	DEFERRED_IDLE,		/* never started */
+	DEFERRED_PENDING,	/* started, not yet completed */
+	DEFERRED_DONE,		/* completed, @ret holds the result */
+};
+
+/**
+ * struct deferred - An operation started now and completed at first use
+ *
+ * This must be zeroed before deferred_start() is first called on it.
+ *
+ * @name:	Name of the operation, for the report
+ * @complete:	Function which waits for and finishes the operation
+ * @arg:	Argument to pass to @complete
+ * @state:	enum deferred_state
+ * @ret:	Value returned by @complete
+ * @start_us:	Time the operation was started
+ * @used_us:	Time it was first needed, 0 if not yet
+ * @wait_us:	Time spent in @complete
+ * @sibling_node:	Node in the list of operations
+ */
+struct deferred {
+	const char *name;
+	int (*complete)(void *arg);
+	void *arg;
+	int state;
+	int ret;
+	ulong start_us;
+	ulong used_us;
+	ulong wait_us;
+	struct list_head sibling_node;
+};
+
+#ifdef CONFIG_DEFERRED_INIT
+/**
+ * deferred_start() - Record that an operation has been started
+ *
+ * The caller has already kicked off the operation; @complete must wait for
+ * it and finish it. An operation which is started again is reset.
+ *
+ * @op:		Operation to record
+ * @name:	Name of the operation, for the report
+ * @complete:	Function to finish the operation, returning 0 or -ve error
+ * @arg:	Argument to pass to @complete
+ */
+void deferred_start(struct deferred *op, const char *name,
+		    int (*complete)(void *arg), void *arg);
+
+/**
+ * deferred_pending() - Check whether an operation still needs completing
+ *
+ * @op:		Operation to check
+ * @return 1 if it was started and not yet completed, else 0
+ */
+int deferred_pending(struct deferred *op);
+
+/**
+ * deferred_complete() - Finish an operation at its first use
+ *
+ * The first call runs the operation's @complete function and times it.
+ * Later calls return the same result without running it again.
+ *
+ * @op:		Operation to finish
+ * @return value returned by @complete, or -ENOENT if @op was never started
+ */
+int deferred_complete(struct deferred *op);
+
+/**
+ * deferred_report() - Show how much waiting the operations hid
+ *
+ * For each operation this shows the time between its start and its first
+ * use, during which it ran alongside other work, and how long that use
+ * still had to wait. An operation which was already finished when first
+ * used may have taken less than the time shown.
+ */
+void deferred_report(void);
+#else
+static inline void deferred_start(struct deferred *op, const char *name,
+				  int (*complete)(void *arg), void *arg)
+{
+}
+
+static inline int deferred_pending(struct deferred *op)
+{
+	return 0;
+}
+
+static inline int deferred_complete(struct deferred *op)
+{
+	return -ENOENT;
+}
+
+static inline void deferred_report(void)
+{
+}
+#endif
+
+#endif
@@ -85,6 +85,10 @@ struct sf_internal_data {
 #ifndef CONFIG_SYS_DFU_DATA_BUF_SIZE
 #define CONFIG_SYS_DFU_DATA_BUF_SIZE		(1024*1024*8)	/* 8 MiB */
 #endif
+#ifndef CONFIG_SYS_DFU_DATA_BUF_COUNT
+#define CONFIG_SYS_DFU_DATA_BUF_COUNT		1
+#endif
+#define DFU_MAX_BUF_COUNT		4
 #ifndef CONFIG_SYS_DFU_MAX_FILE_SIZE
 #define CONFIG_SYS_DFU_MAX_FILE_SIZE CONFIG_SYS_DFU_DATA_BUF_SIZE
 #endif
@@ -102,6 +106,7 @@ struct dfu_entity {
 	enum dfu_device_type    dev_type;
 	enum dfu_layout         layout;
 	unsigned long           max_buf_size;
+	unsigned long           write_unit;	/* see dfu_write_pending() */
 
 	union {
 		struct mmc_internal_data mmc;
@@ -137,6 +142,13 @@ struct dfu_entity {
 
 	u32 bad_skip;	/* for nand use */
 
+	/* write-behind state, see dfu_write_pending() */
+	int i_slot;			/* buffer slot being filled */
+	int w_slot;			/* oldest slot queued for the medium */
+	int w_count;			/* number of slots queued */
+	u8 *w_buf;			/* next byte to write from w_slot */
+	long w_len[DFU_MAX_BUF_COUNT];	/* bytes left to write per slot */
+
 	unsigned int inited:1;
 };
 
@@ -157,11 +169,15 @@ int dfu_init_env_entities(char *interface, char *devstr);
 unsigned char *dfu_get_buf(struct dfu_entity *dfu);
 unsigned char *dfu_free_buf(void);
 unsigned long dfu_get_buf_size(void);
+int dfu_get_buf_count(void);
+unsigned char *dfu_get_write_buf(struct dfu_entity *dfu);
 bool dfu_usb_get_reset(void);
 
 int dfu_read(struct dfu_entity *de, void *buf, int size, int blk_seq_num);
 int dfu_write(struct dfu_entity *de, void *buf, int size, int blk_seq_num);
 int dfu_flush(struct dfu_entity *de, void *buf, int size, int blk_seq_num);
+int dfu_write_pending(struct dfu_entity *de, long max);
+void dfu_write_transaction_cleanup(struct dfu_entity *de);
 /* Device specific */
 #ifdef CONFIG_DFU_MMC
 extern int dfu_fill_entity_mmc(struct dfu_entity *dfu, char *devstr, char *s);
@@ -43,6 +43,16 @@ int uclass_bind_device(struct udevice *dev);
  */
 int uclass_unbind_device(struct udevice *dev);
 
+/**
+ * uclass_set_seq() - Set the sequence number of a device
+ *
+ * This also keeps the uclass's index of sequence numbers up to date.
+ *
+ * @dev:	Pointer to the device
+ * @seq:	Sequence number, or -1 for none
+ */
+void uclass_set_seq(struct udevice *dev, int seq);
+
 /**
  * uclass_pre_probe_child() - Deal with a child that is about to be probed
  *
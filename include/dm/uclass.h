@@ -30,16 +30,32 @@
  * @dev_head: List of devices in this uclass (devices are attached to their
  * uclass when their bind method is called)
  * @sibling_node: Next uclass in the linked list of uclasses
+ * @seq_index: Devices by sequence number (see uclass_find_device_by_seq())
+ * @seq_index_size: Number of entries in @seq_index, or -1 if there is no
+ * index and the list of devices must be searched instead
  */
 struct uclass {
 	void *priv;
 	struct uclass_driver *uc_drv;
 	struct list_head dev_head;
 	struct list_head sibling_node;
+	struct uclass_seq *seq_index;
+	int seq_index_size;
 };
 
 struct udevice;
 
+/**
+ * struct uclass_seq - Devices of a uclass with one sequence number
+ *
+ * @dev: Active device with this seq, or NULL
+ * @req_dev: First device bound with this req_seq, or NULL
+ */
+struct uclass_seq {
+	struct udevice *dev;
+	struct udevice *req_dev;
+};
+
 /* Members of this uclass sequence themselves with aliases */
 #define DM_UC_FLAG_SEQ_ALIAS			(1 << 0)
 
@@ -23,6 +23,74 @@ static inline void dm_dbg(const char *fmt, ...)
 }
 #endif
 
+/**
+ * struct dm_timing - Bind and probe times of one driver
+ *
+ * Each time covers the driver's own work only: binding or probing another
+ * device from within bind() or probe() counts for that device's driver.
+ *
+ * @binds: Number of devices bound
+ * @probes: Number of devices probed
+ * @bind_us: Total time binding, in microseconds
+ * @probe_us: Total time probing, in microseconds
+ */
+struct dm_timing {
+	uint binds;
+	uint probes;
+	ulong bind_us;
+	ulong probe_us;
+};
+
+struct dm_timing_mark {
+	ulong start;
+	ulong nested_us;
+};
+
+struct driver;
+
+#ifdef CONFIG_DM_TIMING
+/**
+ * dm_timing_get() - Get the times recorded for a driver
+ *
+ * Times are only recorded after relocation.
+ *
+ * @drv:	Driver to check
+ * @return times for the driver, or NULL if none can be recorded
+ */
+struct dm_timing *dm_timing_get(struct driver *drv);
+
+/**
+ * dm_timing_start() - Start timing a bind or probe
+ *
+ * @mark:	Returns the state needed by dm_timing_end()
+ */
+void dm_timing_start(struct dm_timing_mark *mark);
+
+/**
+ * dm_timing_end() - Record the time since dm_timing_start()
+ *
+ * @drv:	Driver which was bound or probed
+ * @probe:	true for a probe, false for a bind
+ * @mark:	State from dm_timing_start()
+ */
+void dm_timing_end(struct driver *drv, bool probe,
+		   struct dm_timing_mark *mark);
+#else
+static inline struct dm_timing *dm_timing_get(struct driver *drv)
+{
+	return NULL;
+}
+
+static inline void dm_timing_start(struct dm_timing_mark *mark)
+{
+}
+
+static inline void dm_timing_end(struct driver *drv, bool probe,
+				 struct dm_timing_mark *mark)
+{
+}
+#endif
+
 struct list_head;
 
 /**
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef _FB_DELTA_H_
+#define _FB_DELTA_H_
+
+#include <part.h>
+
+/*
+ * Delta flashing: the host flashes a manifest holding the SHA-256 digest of
+ * each chunk of the new image, reads back which chunks differ from the
+ * partition with "getvar:delta-map:<first chunk>", then flashes only those
+ * chunks, grouped in runs behind a header giving the first chunk. Both are
+ * recognised by their magic, as sparse images are.
+ */
+#define FB_DELTA_MANIFEST_MAGIC	0x544c4446	/* "FDLT" */
+#define FB_DELTA_CHUNKS_MAGIC	0x4b434446	/* "FDCK" */
+#define FB_DELTA_DIGEST_SIZE	32		/* SHA-256 */
+
+struct fb_delta_header {
+	__le32	magic;
+	__le32	chunk_size;	/* bytes, a multiple of the block size */
+	__le32	chunk_count;	/* chunks in the image, or that follow */
+	__le32	first;		/* index of the first chunk that follows */
+	__le64	image_size;	/* bytes, a multiple of the block size */
+};
+
+/*
+ * A manifest is followed by chunk_count digests, a chunk run by the data of
+ * chunk_count chunks. The last chunk of the image is short if image_size is
+ * not a multiple of chunk_size.
+ */
+
+static inline int is_delta_manifest(void *buf)
+{
+	struct fb_delta_header *hdr = buf;
+
+	return le32_to_cpu(hdr->magic) == FB_DELTA_MANIFEST_MAGIC;
+}
+
+static inline int is_delta_chunks(void *buf)
+{
+	struct fb_delta_header *hdr = buf;
+
+	return le32_to_cpu(hdr->magic) == FB_DELTA_CHUNKS_MAGIC;
+}
+
+/**
+ * fb_delta_check() - Find the chunks of a partition that differ from an image
+ *
+ * The digests are kept until the next manifest, for fb_delta_map() and to
+ * check the chunks given to fb_delta_write().
+ *
+ * @dev_desc:	Block device
+ * @info:	Partition to compare
+ * @manifest:	Manifest, struct fb_delta_header followed by the digests
+ * @size:	Size of the manifest in bytes
+ * @buf:	Buffer for reading the partition, may be @manifest
+ * @buf_size:	Size of @buf, at least one chunk
+ * @return number of chunks which differ, -ve on error
+ */
+int fb_delta_check(block_dev_desc_t *dev_desc, disk_partition_t *info,
+		   void *manifest, unsigned int size, void *buf,
+		   unsigned int buf_size);
+
+/**
+ * fb_delta_write() - Write a run of chunks checked against the manifest
+ *
+ * @dev_desc:	Block device
+ * @info:	Partition given to fb_delta_check()
+ * @data:	struct fb_delta_header followed by the chunk data
+ * @size:	Size of @data in bytes
+ * @return 0 if ok, -ENOENT without a manifest for @info, -EBADMSG if a
+ * digest does not match, other -ve value on error
+ */
+int fb_delta_write(block_dev_desc_t *dev_desc, disk_partition_t *info,
+		   void *data, unsigned int size);
+
+/**
+ * fb_delta_map() - Describe which chunks differ, as hex digits
+ *
+ * Each digit covers four chunks, the most significant bit being the first.
+ *
+ * @first:	First chunk, a multiple of 4
+ * @str:	Output string
+ * @len:	Size of @str including the terminating '\0'
+ * @return 0 if ok, -ENOENT without a manifest, -EINVAL for a bad @first
+ */
+int fb_delta_map(unsigned int first, char *str, size_t len);
+
+#endif
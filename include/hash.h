@@ -6,6 +6,8 @@
 #ifndef _HASH_H
 #define _HASH_H
 
+#include <errno.h>
+
 /*
  * Maximum digest size for all algorithms we support. Having this value
  * avoids a malloc() or C99 local declaration in common/cmd_hash.c.
@@ -158,4 +160,122 @@ int hash_lookup_algo(const char *algo_name, struct hash_algo **algop);
 int hash_progressive_lookup_algo(const char *algo_name,
 				 struct hash_algo **algop);
 
+/*
+ * Hashing data as it is read. While a read is hashed, storage drivers pass
+ * each chunk to hash_read_data() as it lands in memory. A chunk which
+ * carries on from the data hashed so far is hashed at once, while it is
+ * still in the cache; anything else is picked up from memory when the read
+ * finishes. The digest of the last read is kept, so that checking the same
+ * data afterwards need not go over it again. If the data is a device tree,
+ * such as a FIT image, the values of its larger properties get digests of
+ * their own too, for checking the images in it.
+ *
+ * Reads through hash_read_data() over that data make the digests stale.
+ * Anything else which writes to memory given by the user, such as the
+ * memory, load and flash read commands, must call hash_read_drop() for
+ * the memory it changes, or hash_read_stop() if that is not known.
+ */
+#if defined(CONFIG_HASH_ON_READ) && !defined(USE_HOSTCC)
+/**
+ * hash_read_start() - Start hashing a read
+ *
+ * Any read being hashed is stopped and the last digest is forgotten.
+ *
+ * @algo_name:	Hash algorithm to use, NULL to hash nothing
+ * @buf:	Buffer the data is being read into
+ * @return 0 if ok, -EPROTONOSUPPORT for an unknown algorithm, or -ENOMEM
+ */
+int hash_read_start(const char *algo_name, void *buf);
+
+/**
+ * hash_read_data() - Note a chunk of data read into memory
+ *
+ * This is called by storage drivers for every read, hashed or not.
+ *
+ * @buf:	Where the chunk was put
+ * @len:	Length of the chunk in bytes
+ */
+void hash_read_data(const void *buf, ulong len);
+
+/**
+ * hash_read_finish() - Finish hashing a read and keep the digest
+ *
+ * @len:	Number of bytes read into the buffer
+ * @return 0 if ok, -ENOENT if no read was being hashed, -EIO on error
+ */
+int hash_read_finish(ulong len);
+
+/**
+ * hash_read_stop() - Stop hashing and forget the last digest
+ */
+void hash_read_stop(void);
+
+/**
+ * hash_read_drop() - Forget the digests which cover changed memory
+ *
+ * @buf:	Start of the memory which changed
+ * @len:	Length of the memory in bytes
+ */
+void hash_read_drop(const void *buf, ulong len);
+
+/**
+ * hash_read_lookup() - Get the digest of data hashed as it was read
+ *
+ * @algo_name:	Hash algorithm wanted
+ * @data:	Start of the data
+ * @len:	Length of the data in bytes
+ * @output:	Place to put the digest, in the same form as hash_block()
+ * @output_size: If not NULL, returns the number of bytes in the digest
+ * @return 0 if ok, -ENOENT if neither the last read nor a large property in
+ * it was exactly this data, hashed with this algorithm
+ */
+int hash_read_lookup(const char *algo_name, const void *data, ulong len,
+		     uint8_t *output, int *output_size);
+
+/**
+ * hash_read_setenv() - Put the digest of a read in an environment variable
+ *
+ * The variable is deleted if the data was not hashed as it was read.
+ *
+ * @varname:	Variable to set
+ * @data:	Start of the data
+ * @len:	Length of the data in bytes
+ */
+void hash_read_setenv(const char *varname, const void *data, ulong len);
+#else
+static inline int hash_read_start(const char *algo_name, void *buf)
+{
+	return 0;
+}
+
+static inline void hash_read_data(const void *buf, ulong len)
+{
+}
+
+static inline int hash_read_finish(ulong len)
+{
+	return -ENOENT;
+}
+
+static inline void hash_read_stop(void)
+{
+}
+
+static inline void hash_read_drop(const void *buf, ulong len)
+{
+}
+
+static inline int hash_read_lookup(const char *algo_name, const void *data,
+				   ulong len, uint8_t *output,
+				   int *output_size)
+{
+	return -ENOENT;
+}
+
+static inline void hash_read_setenv(const char *varname, const void *data,
+				    ulong len)
+{
+}
+#endif
+
 #endif
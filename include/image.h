@@ -724,6 +724,7 @@ int bootz_setup(ulong image, ulong *start, ulong *end);
 #define FIT_ALGO_PROP		"algo"
 #define FIT_VALUE_PROP		"value"
 #define FIT_IGNORE_PROP		"uboot-ignore"
+#define FIT_SEGMENT_SIZE_PROP	"segment-size"
 #define FIT_SIG_NODENAME	"signature"
 
 /* image node */
@@ -810,6 +811,8 @@ int fit_image_get_data(const void *fit, int noffset,
 int fit_image_hash_get_algo(const void *fit, int noffset, char **algo);
 int fit_image_hash_get_value(const void *fit, int noffset, uint8_t **value,
 				int *value_len);
+int fit_image_hash_get_segment_size(const void *fit, int noffset,
+				    ulong *segment_size);
 
 int fit_set_timestamp(void *fit, int noffset, time_t timestamp);
 
@@ -868,6 +871,23 @@ int fit_check_ramdisk(const void *fit, int os_noffset,
 
 int calculate_hash(const void *data, int data_len, const char *algo,
 			uint8_t *value, int *value_len);
+int calculate_segment_hash(const void *data, int data_len, ulong segment_size,
+			   const char *algo, uint8_t *value, int *value_len);
+
+/**
+ * fit_image_hash_flush() - Drop image hashes worked out ahead of time
+ *
+ * While checking a configuration, U-Boot may hash its images on other CPUs
+ * before they are verified. This waits for those hashes and forgets them,
+ * which must be done before the images' data can change.
+ */
+#if !defined(USE_HOSTCC) && defined(CONFIG_JOBS)
+void fit_image_hash_flush(void);
+#else
+static inline void fit_image_hash_flush(void)
+{
+}
+#endif
 
 /*
  * At present we only support signing on the host, and verification on the
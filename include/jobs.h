@@ -0,0 +1,238 @@
+/*
+ * Running independent work on secondary CPUs
+ *
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __JOBS_H
+#define __JOBS_H
+
+/*
+ * U-Boot runs on one CPU. A job is a function which can be handed to one of
+ * the others while the boot CPU gets on with something else, such as the
+ * wait for an MMC card to come out of reset. When there are no other CPUs,
+ * or they are all busy, the job is run straight away by the caller, so code
+ * using jobs works the same either way, only more slowly.
+ *
+ * A job must only use hardware and memory which nothing else touches until
+ * job_wait() returns. It may call malloc() and printf(), which take a lock
+ * while secondary CPUs are running, but little else in U-Boot is safe to
+ * call from two CPUs at once.
+ */
+
+/* Highest number of CPUs, including the boot CPU */
+#define JOB_MAX_CPUS	8
+
+enum job_state {
+	JOB_IDLE,		/* not started, or done and waited for */
+	JOB_RUNNING,
+	JOB_DONE,
+};
+
+struct job {
+	const char *name;
+	int (*func)(void *arg);
+	void *arg;
+	volatile int state;	/* enum job_state */
+	int ret;		/* value returned by @func */
+	int cpu;		/* CPU the job ran on, 0 for the boot CPU */
+};
+
+/* A lock which works without exclusive access instructions or caches */
+struct job_lock {
+	volatile unsigned char choosing[JOB_MAX_CPUS];
+	volatile unsigned int number[JOB_MAX_CPUS];
+	int owner;		/* CPU holding the lock plus one, 0 if free */
+	int depth;		/* times the owner has taken it */
+};
+
+/**
+ * struct job_cpu - A secondary CPU which runs jobs
+ *
+ * @index:	CPU number, from 1
+ * @id:		Architecture's identity for the CPU, see arch_job_cpu_id()
+ * @job:	Job to run, set by the boot CPU and cleared when it is done
+ * @stop:	Set by jobs_stop() to ask the CPU to stop
+ * @running:	Set by the CPU while it is taking jobs
+ * @priv:	Architecture's private data
+ */
+struct job_cpu {
+	int index;
+	ulong id;
+	struct job *volatile job;
+	volatile int stop;
+	volatile int running;
+	void *priv;
+};
+
+#ifdef CONFIG_JOBS
+/**
+ * jobs_init() - Start the secondary CPUs
+ *
+ * This is called after relocation. CPUs which do not start are left out.
+ *
+ * @return 0 if OK, -ve on error
+ */
+int jobs_init(void);
+
+/**
+ * jobs_stop() - Wait for running jobs and stop the secondary CPUs
+ *
+ * This is called before handing over to an operating system or a 'go'
+ * application, which may start the CPUs itself, before the data cache is
+ * turned on and before a reset. Jobs started after this run on the boot
+ * CPU.
+ */
+void jobs_stop(void);
+
+/**
+ * jobs_cpus() - Get the number of secondary CPUs taking jobs
+ *
+ * @return number of CPUs, 0 if every job runs on the boot CPU
+ */
+int jobs_cpus(void);
+
+/**
+ * job_init() - Set up a job
+ *
+ * @job:	Job to set up
+ * @name:	Name of the job, for messages
+ * @func:	Function to run, whose return value job_wait() returns
+ * @arg:	Argument to pass to @func
+ */
+void job_init(struct job *job, const char *name, int (*func)(void *arg),
+	      void *arg);
+
+/**
+ * job_start() - Start a job
+ *
+ * The job goes to an idle secondary CPU. If there is none, it is run
+ * before this function returns.
+ *
+ * @job:	Job to start, set up with job_init()
+ * @return 0 if OK, -EBUSY if the job is already running
+ */
+int job_start(struct job *job);
+
+/**
+ * job_wait() - Wait for a job to finish
+ *
+ * @job:	Job to wait for
+ * @return value returned by the job's function, or -ENOENT if the job was
+ * not started
+ */
+int job_wait(struct job *job);
+
+/**
+ * job_cpu() - Get the number of the CPU running the caller
+ *
+ * @return 0 on the boot CPU, else the index of the secondary CPU
+ */
+int job_cpu(void);
+
+/**
+ * job_lock() - Take a lock shared with jobs on other CPUs
+ *
+ * This does nothing while there are no secondary CPUs running. A CPU may
+ * take a lock it already holds.
+ *
+ * @lock:	Lock to take
+ */
+void job_lock(struct job_lock *lock);
+
+/**
+ * job_unlock() - Release a lock taken with job_lock()
+ *
+ * @lock:	Lock to release
+ */
+void job_unlock(struct job_lock *lock);
+
+/**
+ * job_cpu_main() - Take jobs until asked to stop
+ *
+ * A secondary CPU started by arch_job_cpu_start() calls this on its own
+ * stack. When it returns, the CPU should stop.
+ *
+ * @cpu:	CPU which is running
+ */
+void job_cpu_main(struct job_cpu *cpu);
+
+/* Interface to the architecture */
+
+/**
+ * arch_job_cpus() - Get the number of secondary CPUs which can be started
+ *
+ * @return number of CPUs, at most JOB_MAX_CPUS - 1
+ */
+int arch_job_cpus(void);
+
+/**
+ * arch_job_cpu_start() - Start a secondary CPU
+ *
+ * The CPU must call job_cpu_main() and then arch_job_cpu_stop(). On return
+ * @cpu->id must be set.
+ *
+ * @cpu:	CPU to start, with @cpu->index set
+ * @return 0 if OK, -ve if the CPU cannot be started
+ */
+int arch_job_cpu_start(struct job_cpu *cpu);
+
+/**
+ * arch_job_cpu_stop() - Stop the secondary CPU which calls this
+ *
+ * @cpu:	CPU which is stopping
+ */
+void arch_job_cpu_stop(struct job_cpu *cpu);
+
+/**
+ * arch_job_cpu_wait_off() - Wait for a secondary CPU to stop
+ *
+ * @cpu:	CPU which has left job_cpu_main()
+ * @return 0 if OK, -ETIMEDOUT if it did not stop
+ */
+int arch_job_cpu_wait_off(struct job_cpu *cpu);
+
+/**
+ * arch_job_cpu_id() - Get the identity of the CPU running the caller
+ *
+ * @return value for comparing with struct job_cpu's @id
+ */
+ulong arch_job_cpu_id(void);
+
+/* Wait a little for another CPU, which calls arch_job_kick() when done */
+void arch_job_idle(void);
+
+/* Wake CPUs waiting in arch_job_idle() */
+void arch_job_kick(void);
+#else
+static inline int jobs_init(void)
+{
+	return 0;
+}
+
+static inline void jobs_stop(void)
+{
+}
+
+static inline int jobs_cpus(void)
+{
+	return 0;
+}
+
+static inline int job_cpu(void)
+{
+	return 0;
+}
+
+static inline void job_lock(struct job_lock *lock)
+{
+}
+
+static inline void job_unlock(struct job_lock *lock)
+{
+}
+#endif
+
+#endif
@@ -1710,4 +1710,23 @@ int fdt_find_regions(const void *fdt, char * const inc[], int inc_count,
 		     struct fdt_region region[], int max_regions,
 		     char *path, int path_len, int add_string_tab);
 
+/**
+ * fdt_index_build() - Index a device tree for faster lookups
+ *
+ * After this, fdt_subnode_offset(), fdt_path_offset(),
+ * fdt_node_offset_by_phandle() and fdt_node_offset_by_compatible() use an
+ * index for @fdt instead of scanning it, until the tree is changed by
+ * libfdt or the index is freed. Only one tree is indexed at a time.
+ *
+ * @fdt:	Device tree to index
+ * @return 0 if ok, -FDT_ERR_NOSPACE if out of memory, or another
+ * -FDT_ERR_... value for a bad tree
+ */
+int fdt_index_build(const void *fdt);
+
+/**
+ * fdt_index_free() - Free the index, so that lookups scan the tree again
+ */
+void fdt_index_free(void);
+
 #endif /* _LIBFDT_H */
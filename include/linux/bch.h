@@ -45,6 +45,7 @@
  * @cache:      log-based polynomial representation buffer
  * @elp:        error locator polynomial
  * @poly_2t:    temporary polynomials of degree 2t
+ * @syn_tab:    packed syndromes of each ecc nibble value, NULL if too large
  */
 struct bch_control {
 	unsigned int    m;
@@ -63,6 +64,7 @@ struct bch_control {
 	int            *cache;
 	struct gf_poly *elp;
 	struct gf_poly *poly_2t[4];
+	unsigned long  *syn_tab;
 };
 
 struct bch_control *init_bch(int m, int t, unsigned int prim_poly);
@@ -113,6 +113,12 @@ extern int nand_unlock(struct mtd_info *mtd, loff_t ofs, uint64_t len);
 #define NAND_CMD_RNDOUTSTART	0xE0
 #define NAND_CMD_CACHEDPROG	0x15
 
+/* Extended commands for ONFI cache and multi-plane reads */
+#define NAND_CMD_READCACHESEQ	0x31
+#define NAND_CMD_READCACHEEND	0x3f
+#define NAND_CMD_READMULTI	0x32	/* READ0 for all but the last plane */
+#define NAND_CMD_RNDOUTENH	0x06	/* change read column enhanced */
+
 /* Extended commands for AG-AND device */
 /*
  * Note: the command for NAND_CMD_DEPLETE1 is really 0x00 but
@@ -198,12 +204,20 @@ typedef enum {
 /* Device supports subpage reads */
 #define NAND_SUBPAGE_READ	0x00001000
 
+/* Device supports READ CACHE SEQUENTIAL / READ CACHE END */
+#define NAND_CACHE_READ		0x00002000
+
+/* Device can read the same page of a block in each plane at once */
+#define NAND_MULTI_PLANE_READ	0x00004000
+
 /* Options valid for Samsung large page devices */
 #define NAND_SAMSUNG_LP_OPTIONS NAND_CACHEPRG
 
 /* Macros to identify the above */
 #define NAND_HAS_CACHEPROG(chip) ((chip->options & NAND_CACHEPRG))
 #define NAND_HAS_SUBPAGE_READ(chip) ((chip->options & NAND_SUBPAGE_READ))
+#define NAND_HAS_CACHE_READ(chip) ((chip->options & NAND_CACHE_READ))
+#define NAND_HAS_MULTI_PLANE_READ(chip) ((chip->options & NAND_MULTI_PLANE_READ))
 
 /* Non chip related options */
 /* This option skips the bbt scan during initialization. */
@@ -259,8 +273,10 @@ struct nand_chip;
 /* ONFI subfeature parameters length */
 #define ONFI_SUBFEATURE_PARAM_LEN	4
 
-/* ONFI optional commands SET/GET FEATURES supported? */
+/* ONFI optional commands supported? */
+#define ONFI_OPT_CMD_READ_CACHE		(1 << 1)
 #define ONFI_OPT_CMD_SET_GET_FEATURES	(1 << 2)
+#define ONFI_OPT_CMD_RNDOUT_ENH		(1 << 6)
 
 struct nand_onfi_params {
 	/* rev info and features block */
@@ -651,6 +667,8 @@ struct nand_buffers {
  * @jedec_params:	[INTERN] holds the JEDEC parameter page when JEDEC is
  *			supported, 0 otherwise.
  * @read_retries:	[INTERN] the number of read retry modes supported
+ * @planes:		[INTERN] the number of planes read together when
+ *			NAND_MULTI_PLANE_READ is set
  * @onfi_set_features:	[REPLACEABLE] set the features for ONFI nand
  * @onfi_get_features:	[REPLACEABLE] get the features for ONFI nand
  * @bbt:		[INTERN] bad block table pointer
@@ -729,6 +747,7 @@ struct nand_chip {
 	struct nand_jedec_params jedec_params;
  
 	int read_retries;
+	int planes;
 
 	flstate_t state;
 
@@ -10,6 +10,8 @@
 #ifndef _MMC_H_
 #define _MMC_H_
 
+#include <deferred.h>
+#include <jobs.h>
 #include <linux/list.h>
 #include <linux/compiler.h>
 #include <part.h>
@@ -358,6 +360,10 @@ struct mmc {
 	char preinit;		/* start init as early as possible */
 	uint op_cond_response;	/* the response byte from the last op_cond */
 	int ddr_mode;
+#ifdef CONFIG_JOBS
+	struct job init_job;	/* init started by mmc_initialize() */
+#endif
+	struct deferred init_defer;	/* completed by the first mmc_init() */
 };
 
 struct mmc_hwpart_conf {
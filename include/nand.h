@@ -106,11 +106,31 @@ int nand_read_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
 
 #define WITH_DROP_FFS	(1 << 0) /* drop trailing all-0xff pages */
 #define WITH_WR_VERIFY	(1 << 1) /* verify data was written correctly */
+#define WITH_UPDATE	(1 << 2) /* erase/program only blocks that differ */
 
 int nand_write_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
 			size_t *actual, loff_t lim, u_char *buffer, int flags);
+
+/* Statistics gathered by nand_update_skip_bad() with WITH_UPDATE */
+struct nand_update_stats {
+	size_t unchanged;	/* bytes already holding the right data */
+	size_t erased;		/* bytes erased */
+	size_t programmed;	/* bytes programmed */
+};
+
+int nand_update_skip_bad(nand_info_t *nand, loff_t offset, size_t *length,
+			 size_t *actual, loff_t lim, u_char *buffer, int flags,
+			 struct nand_update_stats *stats);
 int nand_erase_opts(nand_info_t *meminfo, const nand_erase_options_t *opts);
 int nand_torture(nand_info_t *nand, loff_t offset);
+#ifdef CONFIG_NAND_BBT_ENV
+void nand_bbt_env_clear(nand_info_t *nand);
+void nand_bbt_env_sync(nand_info_t *nand);
+void nand_env_ready(void);
+#else
+static inline void nand_bbt_env_clear(nand_info_t *nand) {}
+static inline void nand_env_ready(void) {}
+#endif
 int nand_verify_page_oob(nand_info_t *nand, struct mtd_oob_ops *ops,
 			loff_t ofs);
 int nand_verify(nand_info_t *nand, loff_t ofs, size_t len, u_char *buf);
@@ -94,9 +94,18 @@ struct eth_device {
 	int  (*write_hwaddr) (struct eth_device *);
 	struct eth_device *next;
 	int index;
+	u32 features;		/* ETH_FEATURE_... flags */
+	/*
+	 * One's complement sum of the IP datagram in the packet being passed
+	 * to NetReceive(), valid if ETH_FEATURE_RX_CSUM is set
+	 */
+	u16 rx_csum;
 	void *priv;
 };
 
+/* The driver computes the checksum of received IP datagrams in rx_csum */
+#define ETH_FEATURE_RX_CSUM	(1 << 0)
+
 extern int eth_initialize(bd_t *bis);	/* Initialize network subsystem */
 extern int eth_register(struct eth_device* dev);/* Register network device */
 extern int eth_unregister(struct eth_device *dev);/* Remove network device */
@@ -493,6 +502,20 @@ extern void net_set_udp_header(uchar *pkt, IPaddr_t dest, int dport,
  */
 unsigned compute_ip_checksum(const void *addr, unsigned nbytes);
 
+/**
+ * ip_checksum_partial() - Add data to a running one's complement sum
+ *
+ * This can be called repeatedly to checksum data which is not contiguous,
+ * e.g. a UDP pseudo header followed by the UDP datagram. All but the last
+ * block must have an even length.
+ *
+ * @addr:	Address of data to add
+ * @nbytes:	Number of bytes to add
+ * @sum:	Sum returned by the previous call, or 0 to start
+ * @return updated sum, folded to 16 bits but not inverted
+ */
+unsigned ip_checksum_partial(const void *addr, unsigned nbytes, unsigned sum);
+
 /**
  * add_ip_checksums() - add two IP checksums
  *
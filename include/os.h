@@ -161,6 +161,32 @@ void os_usleep(unsigned long usec);
  */
 uint64_t os_get_nsec(void);
 
+/**
+ * Start a host thread
+ *
+ * \param func	Function for the thread to run
+ * \param arg	Argument to pass to func
+ * \param idp	Returns the identity of the thread, as os_thread_self()
+ *		gives it
+ * \return 0 if OK, -1 on error
+ */
+int os_thread_start(void (*func)(void *arg), void *arg, ulong *idp);
+
+/**
+ * Wait for a thread started by os_thread_start() to finish
+ *
+ * \param id	Identity of the thread
+ * \return 0 if OK, -1 on error
+ */
+int os_thread_join(ulong id);
+
+/**
+ * Get the identity of the calling thread
+ *
+ * \return thread identity
+ */
+ulong os_thread_self(void);
+
 /**
  * Parse arguments and update sandbox state.
  *
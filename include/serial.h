@@ -14,6 +14,8 @@ struct serial_device {
 	int	(*tstc)(void);
 	void	(*putc)(const char c);
 	void	(*puts)(const char *s);
+	/* Send a character without waiting, -EAGAIN if busy (optional) */
+	int	(*try_putc)(const char c);
 #if CONFIG_POST & CONFIG_SYS_POST_UART
 	void	(*loop)(int);
 #endif
@@ -130,6 +130,29 @@ struct spi_slave {
 	u8 flags;
 };
 
+/**
+ * struct spi_flash_read_message - a complete read from a SPI flash
+ *
+ * This describes a flash read in terms of the command the controller
+ * must send, so that controllers with a DMA engine or a direct-read
+ * window can perform it without the data passing through spi_xfer().
+ *
+ * @buf:		Buffer to fill with the data read
+ * @from:		Flash address, sent as @addr_width bytes
+ * @len:		Number of bytes to read
+ * @read_opcode:	Read command to send
+ * @addr_width:		Number of address bytes to send after the command
+ * @dummy_bytes:	Number of dummy bytes to send before the data
+ */
+struct spi_flash_read_message {
+	void *buf;
+	u32 from;
+	size_t len;
+	u8 read_opcode;
+	u8 addr_width;
+	u8 dummy_bytes;
+};
+
 /**
  * Initialization, must be called once on start up.
  *
@@ -268,6 +291,19 @@ int spi_set_wordlen(struct spi_slave *slave, unsigned int wordlen);
 int  spi_xfer(struct spi_slave *slave, unsigned int bitlen, const void *dout,
 		void *din, unsigned long flags);
 
+/**
+ * spi_read_flash() - Read from a SPI flash in a single operation
+ *
+ * This hands a whole flash read to the controller, which may use DMA or
+ * a memory-mapped window to carry it out. The bus must be claimed.
+ *
+ * @slave:	The SPI slave to read from
+ * @msg:	Description of the read
+ * @return 0 if OK, -ENOSYS if the controller cannot perform this read (use
+ *	   spi_xfer() instead), other -ve value on error
+ */
+int spi_read_flash(struct spi_slave *slave, struct spi_flash_read_message *msg);
+
 /**
  * Determine if a SPI chipselect is valid.
  * This function is provided by the board if the low-level SPI driver
@@ -477,6 +513,21 @@ struct dm_spi_ops {
 	 *	   is invalid, other -ve value on error
 	 */
 	int (*cs_info)(struct udevice *bus, uint cs, struct spi_cs_info *info);
+
+	/**
+	 * Read from a SPI flash in a single operation (optional)
+	 *
+	 * Controllers which can read a flash with DMA or through a
+	 * memory-mapped window should implement this, so that reads do not
+	 * need to pass through xfer().
+	 *
+	 * @dev:	The slave device to read from
+	 * @msg:	Description of the read
+	 * @return 0 if OK, -ENOSYS to have the caller use xfer() instead,
+	 *	   other -ve value on error
+	 */
+	int (*read_flash)(struct udevice *dev,
+			  struct spi_flash_read_message *msg);
 };
 
 struct dm_spi_emul_ops {
@@ -506,6 +557,18 @@ struct dm_spi_emul_ops {
 	 */
 	int (*xfer)(struct udevice *slave, unsigned int bitlen,
 		    const void *dout, void *din, unsigned long flags);
+
+	/**
+	 * Read from the emulated flash in a single operation (optional)
+	 *
+	 * This backs the read_flash() operation of the emulated SPI bus.
+	 *
+	 * @slave:	The emulated SPI slave
+	 * @msg:	Description of the read
+	 * @return 0 if OK, -ENOSYS if not supported, other -ve on error
+	 */
+	int (*read_flash)(struct udevice *slave,
+			  struct spi_flash_read_message *msg);
 };
 
 /**
@@ -29,6 +29,7 @@ enum {
 enum trace_chunk_type {
 	TRACE_CHUNK_FUNCS,
 	TRACE_CHUNK_CALLS,
+	TRACE_CHUNK_MARKS,
 };
 
 /* A trace record for a function, as written to the profile output file */
@@ -37,6 +38,25 @@ struct trace_output_func {
 	uint32_t call_count;		/* Number of times called */
 };
 
+enum {
+	TRACE_MARK_NAME_LEN	= 32,	/* longer bootstage names are cut */
+};
+
+/* Flags for trace_output_mark */
+enum trace_mark_flags {
+	TRACE_MARKF_ACCUM	= 1 << 0,	/* time_us is a total time */
+};
+
+/*
+ * A bootstage record, as written to the profile output file. The time is
+ * on the same timer as the call trace, so the two can be lined up.
+ */
+struct trace_output_mark {
+	uint32_t time_us;		/* Time of mark, or total time */
+	uint32_t flags;			/* enum trace_mark_flags */
+	char name[TRACE_MARK_NAME_LEN];	/* Name, nul-terminated */
+};
+
 /* A header at the start of the trace output buffer */
 struct trace_output_hdr {
 	enum trace_chunk_type type;	/* Record type */
@@ -65,12 +85,27 @@ enum ftrace_flags {
 	FUNCF_EXIT		= 0UL << 30,
 	FUNCF_ENTRY		= 1UL << 30,
 	FUNCF_TEXTBASE		= 2UL << 30,
+	FUNCF_EVENT		= 3UL << 30,
 
 	FUNCF_TIMESTAMP_MASK	= 0x3fffffff,
 };
 
 #define TRACE_CALL_TYPE(call)	((call)->flags & 0xc0000000UL)
 
+/*
+ * Spans of I/O recorded along with the function calls. In a FUNCF_EVENT
+ * record, func holds the event, with TRACE_EVENT_END set at the end of the
+ * span, and caller holds the number of bytes transferred.
+ */
+enum trace_event {
+	TRACE_EVENT_BLK_READ,		/* Reading from a block device */
+	TRACE_EVENT_BLK_WRITE,		/* Writing to a block device */
+	TRACE_EVENT_NET,		/* Loading a file over the network */
+
+	TRACE_EVENT_COUNT,
+	TRACE_EVENT_END		= 1 << 16,
+};
+
 /* Information about a single function entry/exit */
 struct trace_call {
 	uint32_t func;		/* Function offset */
@@ -80,6 +115,41 @@ struct trace_call {
 
 int trace_list_calls(void *buff, int buff_size, unsigned int *needed);
 
+/**
+ * Set how deep in the call stack functions are traced
+ *
+ * Calls nested more deeply than this are counted but not recorded, which
+ * keeps the overhead and the size of the trace down.
+ *
+ * @param depth_limit	Maximum call depth to record
+ */
+void trace_set_depth_limit(int depth_limit);
+
+#ifdef CONFIG_TRACE
+/**
+ * Record the start of a span of I/O in the call trace
+ *
+ * @param event		Type of I/O (enum trace_event)
+ */
+void trace_event_start(enum trace_event event);
+
+/**
+ * Record the end of a span of I/O in the call trace
+ *
+ * @param event		Type of I/O (enum trace_event)
+ * @param bytes		Number of bytes transferred
+ */
+void trace_event_end(enum trace_event event, ulong bytes);
+#else
+static inline void trace_event_start(enum trace_event event)
+{
+}
+
+static inline void trace_event_end(enum trace_event event, ulong bytes)
+{
+}
+#endif
+
 /**
  * Turn function tracing on and off
  *
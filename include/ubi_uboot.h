@@ -39,6 +39,9 @@
 #define CONFIG_MTD_UBI_WL_THRESHOLD	4096
 #endif
 #define CONFIG_MTD_UBI_BEB_RESERVE	1
+#if !defined(CONFIG_MTD_UBI_ATTACH_BATCH)
+#define CONFIG_MTD_UBI_ATTACH_BATCH	32
+#endif
 
 /* debug options (Linux: drivers/mtd/ubi/Kconfig.debug) */
 #undef CONFIG_MTD_UBI_DEBUG
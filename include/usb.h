@@ -67,6 +67,15 @@ struct usb_interface {
 	 * Revision 1.0 June 6th 2011
 	 */
 	struct usb_ss_ep_comp_descriptor ss_ep_comp_desc[USB_MAXENDPOINTS];
+	/*
+	 * Endpoints of all alternate settings are listed above; this gives
+	 * the setting each one belongs to
+	 */
+	unsigned char ep_altsetting[USB_MAXENDPOINTS];
+	/* and the bInterfaceProtocol of that setting */
+	unsigned char ep_protocol[USB_MAXENDPOINTS];
+	/* USB Attached SCSI pipe of each endpoint, from its Pipe Usage desc. */
+	unsigned char ep_pipe_id[USB_MAXENDPOINTS];
 } __attribute__ ((packed));
 
 /* Configuration information.. */
@@ -104,6 +113,7 @@ struct usb_device {
 	int epmaxpacketout[16];		/* OUTput endpoint specific maximums */
 
 	int configno;			/* selected config number */
+	int bulk_streams;		/* host can do bulk streams (for UAS) */
 	/* Device Descriptor */
 	struct usb_device_descriptor descriptor
 		__attribute__((aligned(ARCH_DMA_MINALIGN)));
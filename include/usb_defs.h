@@ -46,6 +46,13 @@
 #define US_PR_CB               1		/* Control/Bulk w/o interrupt */
 #define US_PR_CBI              0		/* Control/Bulk/Interrupt */
 #define US_PR_BULK             0x50		/* bulk only */
+#define US_PR_UAS              0x62		/* USB Attached SCSI */
+
+/* USB Attached SCSI pipe IDs, from the Pipe Usage descriptors */
+#define UAS_PIPE_CMD           1
+#define UAS_PIPE_STATUS        2
+#define UAS_PIPE_DATA_IN       3
+#define UAS_PIPE_DATA_OUT      4
 
 /* USB types */
 #define USB_TYPE_STANDARD   (0x00 << 5)
@@ -102,6 +109,7 @@
 #define USB_DT_ENDPOINT_AUDIO_SIZE  9	/* Audio extension */
 #define USB_DT_HUB_NONVAR_SIZE  7
 #define USB_DT_HID_SIZE         9
+#define USB_DT_PIPE_USAGE_SIZE  4	/* USB Attached SCSI */
 
 /* Endpoints */
 #define USB_ENDPOINT_NUMBER_MASK  0x0f	/* in bEndpointAddress */
@@ -10,6 +10,7 @@
 
 #define SECTOR_SIZE		0x200
 #include <part.h>
+#include <asm/unaligned.h>
 #include <linux/usb/composite.h>
 
 /* Wait at maximum 60 seconds for cable connection */
@@ -24,10 +25,43 @@ struct ums {
 	unsigned int num_sectors;
 	const char *name;
 	block_dev_desc_t *block_dev;
+	/* Statistics, updated by the mass storage function */
+	u64 read_bytes;
+	u64 write_bytes;
+	ulong read_time;		/* ms spent in read_sector() */
+	ulong write_time;		/* ms spent in write_sector() */
 };
 
 extern struct ums *ums;
 
+/* READ(16) and WRITE(16) are in SCSI opcode group 4, 16-byte commands */
+static inline int ums_cdb_is_16(const u8 *cmnd)
+{
+	return (cmnd[0] >> 5) == 4;
+}
+
+/*
+ * Get the LBA of a 10, 12 or 16 byte READ/WRITE command. We never expose
+ * more than 2^32 blocks (2 TiB), so a 64-bit LBA with any of the upper 32
+ * bits set is returned as ~0, which is always out of range.
+ */
+static inline u32 ums_cdb_lba(const u8 *cmnd)
+{
+	if (ums_cdb_is_16(cmnd)) {
+		if (get_unaligned_be32(&cmnd[2]))
+			return ~0;
+		return get_unaligned_be32(&cmnd[6]);
+	}
+
+	return get_unaligned_be32(&cmnd[2]);
+}
+
+/* Get the transfer length, in blocks, of a 16-byte READ/WRITE command */
+static inline u32 ums_cdb16_blocks(const u8 *cmnd)
+{
+	return get_unaligned_be32(&cmnd[10]);
+}
+
 int fsg_init(struct ums *);
 void fsg_cleanup(void);
 int fsg_main_thread(void *);
@@ -50,6 +50,13 @@
  * b. Error locator polynomial computation using Berlekamp-Massey algorithm
  * c. Error locator root finding (by far the most expensive step)
  *
+ * A codeword without errors is detected as soon as the received and computed
+ * ecc are compared, before any of these steps.
+ *
+ * Syndromes are computed 4 ecc bits at a time, using lookup tables of the
+ * syndromes of each nibble. Several 16-bit syndromes are packed in each
+ * machine word, so that they are added up a word at a time.
+ *
  * In this implementation, step c is not performed using the usual Chien search.
  * Instead, an alternative approach described in [1] is used. It consists in
  * factoring the error locator polynomial using the Berlekamp Trace algorithm
@@ -85,6 +92,13 @@
 #define BCH_ECC_WORDS(_p)      DIV_ROUND_UP(GF_M(_p)*GF_T(_p), 32)
 #define BCH_ECC_BYTES(_p)      DIV_ROUND_UP(GF_M(_p)*GF_T(_p), 8)
 
+/* nibble syndrome tables, only built if they fit in this many bytes */
+#define BCH_SYN_TAB_MAX        (64*1024)
+
+/* 16-bit syndromes packed in a word of the nibble syndrome tables */
+#define BCH_SYN_PER_LONG       (BITS_PER_LONG/16)
+#define BCH_SYN_LONGS(_p)      DIV_ROUND_UP(GF_T(_p), BCH_SYN_PER_LONG)
+
 #ifndef dbg
 #define dbg(_fmt, args...)     do {} while (0)
 #endif
@@ -347,18 +361,43 @@ static void compute_syndromes(struct bch_control *bch, uint32_t *ecc,
 		ecc[s/32] &= ~((1u << (32-m))-1);
 	memset(syn, 0, 2*t*sizeof(*syn));
 
-	/* compute v(a^j) for j=1 .. 2t-1 */
-	do {
-		poly = *ecc++;
-		s -= 32;
-		while (poly) {
-			i = deg(poly);
-			for (j = 0; j < 2*t; j += 2)
-				syn[j] ^= a_pow(bch, (j+1)*(i+s));
+	if (bch->syn_tab) {
+		/* add up the odd syndromes of each nonzero ecc nibble */
+		const int l = BCH_SYN_LONGS(bch);
+		const unsigned long *wtab = bch->syn_tab, *tab;
+		unsigned long acc[l];
+
+		memset(acc, 0, sizeof(acc));
+		do {
+			poly = *ecc++;
+			s -= 32;
+			for (i = 0; poly; i++, poly >>= 4) {
+				if (!(poly & 0xf))
+					continue;
+				tab = wtab + (i*16+(poly & 0xf))*l;
+				for (j = 0; j < l; j++)
+					acc[j] ^= tab[j];
+			}
+			wtab += 8*16*l;
+		} while (s > 0);
 
-			poly ^= (1 << i);
-		}
-	} while (s > 0);
+		for (j = 0; j < t; j++)
+			syn[2*j] = (acc[j/BCH_SYN_PER_LONG] >>
+				    (16*(j%BCH_SYN_PER_LONG))) & 0xffff;
+	} else {
+		/* compute v(a^j) for j=1 .. 2t-1 */
+		do {
+			poly = *ecc++;
+			s -= 32;
+			while (poly) {
+				i = deg(poly);
+				for (j = 0; j < 2*t; j += 2)
+					syn[j] ^= a_pow(bch, (j+1)*(i+s));
+
+				poly ^= (1 << i);
+			}
+		} while (s > 0);
+	}
 
 	/* v(a^(2j)) = v(a^j)^2 */
 	for (j = 0; j < t; j++)
@@ -995,6 +1034,11 @@ int decode_bch(struct bch_control *bch, const uint8_t *data, unsigned int len,
 
 	/* if caller does not provide syndromes, compute them */
 	if (!syn) {
+		/* fast path: identical received and calculated ecc bytes */
+		if (recv_ecc && calc_ecc &&
+		    !memcmp(recv_ecc, calc_ecc, BCH_ECC_BYTES(bch)))
+			return 0;
+
 		if (!calc_ecc) {
 			/* compute received data ecc into an internal buffer */
 			if (!data || !recv_ecc)
@@ -1008,16 +1052,22 @@ int decode_bch(struct bch_control *bch, const uint8_t *data, unsigned int len,
 		if (recv_ecc) {
 			load_ecc8(bch, bch->ecc_buf2, recv_ecc);
 			/* XOR received and calculated ecc */
-			for (i = 0, sum = 0; i < (int)ecc_words; i++) {
+			for (i = 0; i < (int)ecc_words; i++)
 				bch->ecc_buf[i] ^= bch->ecc_buf2[i];
-				sum |= bch->ecc_buf[i];
-			}
-			if (!sum)
-				/* no error found */
-				return 0;
 		}
+		for (i = 0, sum = 0; i < (int)ecc_words; i++)
+			sum |= bch->ecc_buf[i];
+		if (!sum)
+			/* no error found */
+			return 0;
+
 		compute_syndromes(bch, bch->ecc_buf, bch->syn);
 		syn = bch->syn;
+	} else {
+		for (i = 0, sum = 0; i < 2*(int)GF_T(bch); i++)
+			sum |= syn[i];
+		if (!sum)
+			return 0;
 	}
 
 	err = compute_error_locator_polynomial(bch, syn);
@@ -1103,6 +1153,40 @@ static void build_mod8_tables(struct bch_control *bch, const uint32_t *g)
 	}
 }
 
+/*
+ * compute the odd syndromes of each value of each ecc nibble, as ecc words
+ * are laid out by compute_syndromes()
+ */
+static void build_syn_tables(struct bch_control *bch)
+{
+	const unsigned int t = GF_T(bch);
+	const int l = BCH_SYN_LONGS(bch);
+	const int words = DIV_ROUND_UP(bch->ecc_bits, 32);
+	int k, b, v, e, j, s = bch->ecc_bits;
+	unsigned long *tab, *low;
+	unsigned int syn;
+
+	for (k = 0; k < words; k++) {
+		s -= 32;
+		for (b = 0; b < 8; b++) {
+			tab = bch->syn_tab + (k*8+b)*16*l;
+			memset(tab, 0, 16*l*sizeof(*tab));
+			for (v = 1; v < 16; v++) {
+				/* add the lowest bit set to the rest of v */
+				low = tab + (v & (v-1))*l;
+				e = 4*b+ffs(v)-1+s;
+				for (j = 0; j < l; j++)
+					tab[v*l+j] = low[j];
+				for (j = 0; (j < t) && (e >= 0); j++) {
+					syn = a_pow(bch, (2*j+1)*e);
+					tab[v*l+j/BCH_SYN_PER_LONG] ^= (unsigned long)
+						syn << (16*(j%BCH_SYN_PER_LONG));
+				}
+			}
+		}
+	}
+}
+
 /*
  * build a base for factoring degree 2 polynomials
  */
@@ -1246,6 +1330,7 @@ struct bch_control *init_bch(int m, int t, unsigned int prim_poly)
 {
 	int err = 0;
 	unsigned int i, words;
+	size_t size;
 	uint32_t *genpoly;
 	struct bch_control *bch = NULL;
 
@@ -1324,6 +1409,14 @@ struct bch_control *init_bch(int m, int t, unsigned int prim_poly)
 	if (err)
 		goto fail;
 
+	/* syndrome tables are optional, bit-serial syndromes are used without */
+	size = DIV_ROUND_UP(bch->ecc_bits, 32)*8*16*BCH_SYN_LONGS(bch)*
+		sizeof(*bch->syn_tab);
+	if (size <= BCH_SYN_TAB_MAX)
+		bch->syn_tab = kmalloc(size, GFP_KERNEL);
+	if (bch->syn_tab)
+		build_syn_tables(bch);
+
 	return bch;
 
 fail:
@@ -1349,6 +1442,7 @@ void free_bch(struct bch_control *bch)
 		kfree(bch->syn);
 		kfree(bch->cache);
 		kfree(bch->elp);
+		kfree(bch->syn_tab);
 
 		for (i = 0; i < ARRAY_SIZE(bch->poly_2t); i++)
 			kfree(bch->poly_2t[i]);
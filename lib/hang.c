@@ -25,6 +25,7 @@ void hang(void)
 		defined(CONFIG_SPL_SERIAL_SUPPORT))
 	puts("### ERROR ### Please RESET the board ###\n");
 #endif
+	console_flush_fatal();
 	bootstage_error(BOOTSTAGE_ID_NEED_RESET);
 	for (;;)
 		;
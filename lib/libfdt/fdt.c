@@ -204,6 +204,7 @@ int fdt_move(const void *fdt, void *buf, int bufsize)
 	if (fdt_totalsize(fdt) > bufsize)
 		return -FDT_ERR_NOSPACE;
 
+	_fdt_index_drop(buf);
 	memmove(buf, fdt, fdt_totalsize(fdt));
 	return 0;
 }
@@ -0,0 +1,315 @@
+/*
+ * Lookup index for a device tree which is only read
+ *
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ *
+ * fdt_subnode_offset_namelen(), fdt_node_offset_by_phandle() and
+ * fdt_node_offset_by_compatible() scan the structure block on each call.
+ * Once fdt_index_build() has been called for a tree, they use the index
+ * instead: a hash table of the nodes by parent and name, and tables of
+ * the phandles and compatible strings sorted for binary search. Every
+ * result is checked against the tree itself. Functions which change the
+ * tree drop its index.
+ */
+
+#include <common.h>
+#include <malloc.h>
+#include <libfdt.h>
+
+#include "libfdt_internal.h"
+
+#define FDT_INDEX_MAX_DEPTH	32
+
+struct fdt_index_node {
+	int offset;
+	int parent;	/* index of the parent node, -1 for the root */
+	int next;	/* next node in the same hash chain, or -1 */
+};
+
+struct fdt_index_entry {
+	uint32_t key;	/* phandle, or hash of a compatible string */
+	int offset;
+};
+
+static struct fdt_index {
+	const void *fdt;
+	uint32_t size_dt_struct;
+	int node_count;
+	struct fdt_index_node *nodes;
+	int *chains;
+	unsigned int chain_mask;
+	int phandle_count;
+	struct fdt_index_entry *phandles;
+	int compat_count;
+	struct fdt_index_entry *compats;
+} idx;
+
+/* FNV-1a */
+static uint32_t hash_bytes(uint32_t hash, const char *s, int len)
+{
+	while (len--) {
+		hash ^= (unsigned char)*s++;
+		hash *= 16777619;
+	}
+
+	return hash;
+}
+
+/* Hash a node name without its unit address, with the parent node */
+static uint32_t hash_name(int parent, const char *name, int namelen)
+{
+	const char *at = memchr(name, '@', namelen);
+
+	if (at)
+		namelen = at - name;
+
+	return hash_bytes(2166136261u ^ parent, name, namelen);
+}
+
+static uint32_t hash_string(const char *s)
+{
+	return hash_bytes(2166136261u, s, strlen(s));
+}
+
+static int entry_cmp(const void *a, const void *b)
+{
+	const struct fdt_index_entry *ea = a, *eb = b;
+
+	if (ea->key != eb->key)
+		return ea->key < eb->key ? -1 : 1;
+
+	return ea->offset - eb->offset;
+}
+
+/* First entry not before (@key, @offset) */
+static int entry_lower_bound(const struct fdt_index_entry *table, int count,
+			     uint32_t key, int offset)
+{
+	int lo = 0, hi = count;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+
+		if (table[mid].key < key ||
+		    (table[mid].key == key && table[mid].offset < offset))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+static int find_node(int offset)
+{
+	int lo = 0, hi = idx.node_count - 1;
+
+	while (lo <= hi) {
+		int mid = (lo + hi) / 2;
+
+		if (idx.nodes[mid].offset == offset)
+			return mid;
+		if (idx.nodes[mid].offset < offset)
+			lo = mid + 1;
+		else
+			hi = mid - 1;
+	}
+
+	return -1;
+}
+
+static int index_valid(const void *fdt)
+{
+	return fdt == idx.fdt && fdt_size_dt_struct(fdt) == idx.size_dt_struct;
+}
+
+void fdt_index_free(void)
+{
+	free(idx.nodes);
+	free(idx.chains);
+	free(idx.phandles);
+	free(idx.compats);
+	memset(&idx, '\0', sizeof(idx));
+}
+
+static int index_nodes(const void *fdt, int fill)
+{
+	int parents[FDT_INDEX_MAX_DEPTH];
+	const char *compat, *end;
+	int offset, depth = 0;
+	int count = 0, phandles = 0, compats = 0;
+	uint32_t phandle;
+	int len;
+
+	for (offset = 0; offset >= 0 && depth >= 0;
+	     offset = fdt_next_node(fdt, offset, &depth)) {
+		if (depth >= FDT_INDEX_MAX_DEPTH)
+			return -FDT_ERR_BADSTRUCTURE;
+		parents[depth] = count;
+
+		phandle = fdt_get_phandle(fdt, offset);
+		if (phandle) {
+			if (fill) {
+				idx.phandles[phandles].key = phandle;
+				idx.phandles[phandles].offset = offset;
+			}
+			phandles++;
+		}
+
+		compat = fdt_getprop(fdt, offset, "compatible", &len);
+		end = compat ? compat + len : NULL;
+		for (; compat && compat < end; compat += strlen(compat) + 1) {
+			if (fill) {
+				idx.compats[compats].key = hash_string(compat);
+				idx.compats[compats].offset = offset;
+			}
+			compats++;
+		}
+
+		if (fill) {
+			idx.nodes[count].offset = offset;
+			idx.nodes[count].parent = depth ? parents[depth - 1] :
+						  -1;
+			idx.nodes[count].next = -1;
+		}
+		count++;
+	}
+	if (offset < 0 && offset != -FDT_ERR_NOTFOUND)
+		return offset;
+
+	idx.node_count = count;
+	idx.phandle_count = phandles;
+	idx.compat_count = compats;
+
+	return 0;
+}
+
+int fdt_index_build(const void *fdt)
+{
+	const char *name;
+	unsigned int size;
+	uint32_t hash;
+	int i, len, ret;
+
+	fdt_index_free();
+	ret = fdt_check_header(fdt);
+	if (!ret)
+		ret = index_nodes(fdt, 0);
+	if (ret)
+		return ret;
+
+	for (size = 1; size < 2 * idx.node_count; size <<= 1)
+		;
+	idx.chain_mask = size - 1;
+	idx.nodes = malloc(idx.node_count * sizeof(*idx.nodes));
+	idx.chains = malloc(size * sizeof(*idx.chains));
+	idx.phandles = malloc(idx.phandle_count * sizeof(*idx.phandles) + 1);
+	idx.compats = malloc(idx.compat_count * sizeof(*idx.compats) + 1);
+	if (!idx.nodes || !idx.chains || !idx.phandles || !idx.compats) {
+		fdt_index_free();
+		return -FDT_ERR_NOSPACE;
+	}
+	index_nodes(fdt, 1);
+
+	/* Chain the nodes in tree order, as the scan would find them */
+	memset(idx.chains, 0xff, size * sizeof(*idx.chains));
+	for (i = idx.node_count - 1; i > 0; i--) {
+		name = fdt_get_name(fdt, idx.nodes[i].offset, &len);
+		hash = hash_name(idx.nodes[i].parent, name, len);
+		idx.nodes[i].next = idx.chains[hash & idx.chain_mask];
+		idx.chains[hash & idx.chain_mask] = i;
+	}
+
+	qsort(idx.phandles, idx.phandle_count, sizeof(*idx.phandles),
+	      entry_cmp);
+	qsort(idx.compats, idx.compat_count, sizeof(*idx.compats), entry_cmp);
+	idx.size_dt_struct = fdt_size_dt_struct(fdt);
+	idx.fdt = fdt;
+
+	return 0;
+}
+
+void _fdt_index_drop(const void *fdt)
+{
+	if (fdt == idx.fdt)
+		fdt_index_free();
+}
+
+int _fdt_index_subnode(const void *fdt, int parentoffset, const char *name,
+		       int namelen, int *offsetp)
+{
+	const char *node_name;
+	int parent, i, len;
+	uint32_t hash;
+
+	if (!index_valid(fdt))
+		return 0;
+	parent = find_node(parentoffset);
+	if (parent < 0)
+		return 0;
+
+	hash = hash_name(parent, name, namelen);
+	for (i = idx.chains[hash & idx.chain_mask]; i >= 0;
+	     i = idx.nodes[i].next) {
+		if (idx.nodes[i].parent != parent)
+			continue;
+		node_name = fdt_get_name(fdt, idx.nodes[i].offset, &len);
+		if (len < namelen || memcmp(node_name, name, namelen))
+			continue;
+		/* "name" also matches "name@address" */
+		if (node_name[namelen] == '\0' ||
+		    (node_name[namelen] == '@' &&
+		     !memchr(name, '@', namelen))) {
+			*offsetp = idx.nodes[i].offset;
+			return 1;
+		}
+	}
+	*offsetp = -FDT_ERR_NOTFOUND;
+
+	return 1;
+}
+
+int _fdt_index_phandle(const void *fdt, uint32_t phandle, int *offsetp)
+{
+	int i;
+
+	if (!index_valid(fdt))
+		return 0;
+
+	i = entry_lower_bound(idx.phandles, idx.phandle_count, phandle, 0);
+	if (i < idx.phandle_count && idx.phandles[i].key == phandle &&
+	    fdt_get_phandle(fdt, idx.phandles[i].offset) == phandle)
+		*offsetp = idx.phandles[i].offset;
+	else
+		*offsetp = -FDT_ERR_NOTFOUND;
+
+	return 1;
+}
+
+int _fdt_index_compatible(const void *fdt, int startoffset,
+			  const char *compatible, int *offsetp)
+{
+	uint32_t hash;
+	int i;
+
+	if (!index_valid(fdt))
+		return 0;
+	if (startoffset >= 0 && find_node(startoffset) < 0)
+		return 0;
+
+	hash = hash_string(compatible);
+	for (i = entry_lower_bound(idx.compats, idx.compat_count, hash,
+				   startoffset + 1);
+	     i < idx.compat_count && idx.compats[i].key == hash; i++) {
+		if (!fdt_node_check_compatible(fdt, idx.compats[i].offset,
+					       compatible)) {
+			*offsetp = idx.compats[i].offset;
+			return 1;
+		}
+	}
+	*offsetp = -FDT_ERR_NOTFOUND;
+
+	return 1;
+}
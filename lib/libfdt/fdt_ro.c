@@ -95,6 +95,9 @@ int fdt_subnode_offset_namelen(const void *fdt, int offset,
 
 	FDT_CHECK_HEADER(fdt);
 
+	if (_fdt_index_subnode(fdt, offset, name, namelen, &depth))
+		return depth;
+
 	for (depth = 0;
 	     (offset >= 0) && (depth >= 0);
 	     offset = fdt_next_node(fdt, offset, &depth))
@@ -458,6 +461,9 @@ int fdt_node_offset_by_phandle(const void *fdt, uint32_t phandle)
 
 	FDT_CHECK_HEADER(fdt);
 
+	if (_fdt_index_phandle(fdt, phandle, &offset))
+		return offset;
+
 	/* FIXME: The algorithm here is pretty horrible: we
 	 * potentially scan each property of a node in
 	 * fdt_get_phandle(), then if that didn't find what
@@ -589,6 +595,9 @@ int fdt_node_offset_by_compatible(const void *fdt, int startoffset,
 
 	FDT_CHECK_HEADER(fdt);
 
+	if (_fdt_index_compatible(fdt, startoffset, compatible, &offset))
+		return offset;
+
 	/* FIXME: The algorithm here is pretty horrible: we scan each
 	 * property of a node in fdt_node_check_compatible(), then if
 	 * that didn't find what we want, we scan over them again
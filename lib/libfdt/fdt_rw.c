@@ -30,6 +30,8 @@ static int _fdt_rw_check_header(void *fdt)
 {
 	FDT_CHECK_HEADER(fdt);
 
+	_fdt_index_drop(fdt);
+
 	if (fdt_version(fdt) < 17)
 		return -FDT_ERR_BADVERSION;
 	if (_fdt_blocks_misordered(fdt, sizeof(struct fdt_reserve_entry),
@@ -382,6 +384,7 @@ int fdt_open_into(const void *fdt, void *buf, int bufsize)
 	char *tmp;
 
 	FDT_CHECK_HEADER(fdt);
+	_fdt_index_drop(buf);
 
 	mem_rsv_size = (fdt_num_mem_rsv(fdt)+1)
 		* sizeof(struct fdt_reserve_entry);
@@ -27,6 +27,7 @@ int fdt_setprop_inplace(void *fdt, int nodeoffset, const char *name,
 	if (proplen != len)
 		return -FDT_ERR_NOSPACE;
 
+	_fdt_index_drop(fdt);
 	memcpy(propval, val, len);
 	return 0;
 }
@@ -48,6 +49,7 @@ int fdt_nop_property(void *fdt, int nodeoffset, const char *name)
 	if (! prop)
 		return len;
 
+	_fdt_index_drop(fdt);
 	_fdt_nop_region(prop, len + sizeof(*prop));
 
 	return 0;
@@ -71,6 +73,7 @@ int fdt_nop_node(void *fdt, int nodeoffset)
 	if (endoffset < 0)
 		return endoffset;
 
+	_fdt_index_drop(fdt);
 	_fdt_nop_region(fdt_offset_ptr_w(fdt, nodeoffset, 0),
 			endoffset - nodeoffset);
 	return 0;
@@ -47,4 +47,36 @@ static inline struct fdt_reserve_entry *_fdt_mem_rsv_w(void *fdt, int n)
 
 #define FDT_SW_MAGIC		(~FDT_MAGIC)
 
+/*
+ * Lookups through the index of fdt_index_build(). They return 1 with the
+ * result in *offsetp, or 0 if the tree has no index and must be scanned.
+ */
+#if defined(CONFIG_OF_LIBFDT_INDEX) && !defined(CONFIG_SPL_BUILD) && \
+	!defined(USE_HOSTCC)
+int _fdt_index_subnode(const void *fdt, int parentoffset, const char *name,
+		       int namelen, int *offsetp);
+int _fdt_index_phandle(const void *fdt, uint32_t phandle, int *offsetp);
+int _fdt_index_compatible(const void *fdt, int startoffset,
+			  const char *compatible, int *offsetp);
+void _fdt_index_drop(const void *fdt);
+#else
+static inline int _fdt_index_subnode(const void *fdt, int parentoffset,
+				     const char *name, int namelen,
+				     int *offsetp)
+{
+	return 0;
+}
+static inline int _fdt_index_phandle(const void *fdt, uint32_t phandle,
+				     int *offsetp)
+{
+	return 0;
+}
+static inline int _fdt_index_compatible(const void *fdt, int startoffset,
+					const char *compatible, int *offsetp)
+{
+	return 0;
+}
+static inline void _fdt_index_drop(const void *fdt) {}
+#endif
+
 #endif /* _LIBFDT_INTERNAL_H */
@@ -163,7 +163,34 @@ static int num_public_exponent_bits(const struct rsa_public_key *key,
 static int is_public_exponent_bit_set(const struct rsa_public_key *key,
 		int pos)
 {
-	return key->exponent & (1ULL << pos);
+	return (key->exponent >> pos) & 1;
+}
+
+/**
+ * check_public_exponent() - Check that the public exponent can be used
+ *
+ * @key:	RSA key
+ * @num_bits:	Returns the number of public exponent bits
+ * @return 0 if ok, -EINVAL if the exponent is too short or even
+ */
+static int check_public_exponent(const struct rsa_public_key *key,
+		int *num_bits)
+{
+	if (0 != num_public_exponent_bits(key, num_bits))
+		return -EINVAL;
+
+	if (*num_bits < 2) {
+		debug("Public exponent is too short (%d bits, minimum 2)\n",
+		      *num_bits);
+		return -EINVAL;
+	}
+
+	if (!is_public_exponent_bit_set(key, 0)) {
+		debug("LSB of RSA public exponent must be set.\n");
+		return -EINVAL;
+	}
+
+	return 0;
 }
 
 /**
@@ -193,19 +220,8 @@ static int pow_mod(const struct rsa_public_key *key, uint32_t *inout)
 	for (i = 0, ptr = inout + key->len - 1; i < key->len; i++, ptr--)
 		val[i] = get_unaligned_be32(ptr);
 
-	if (0 != num_public_exponent_bits(key, &k))
-		return -EINVAL;
-
-	if (k < 2) {
-		debug("Public exponent is too short (%d bits, minimum 2)\n",
-		      k);
-		return -EINVAL;
-	}
-
-	if (!is_public_exponent_bit_set(key, 0)) {
-		debug("LSB of RSA public exponent must be set.\n");
+	if (check_public_exponent(key, &k))
 		return -EINVAL;
-	}
 
 	/* the bit at e[k-1] is 1 by definition, so start with: C := M */
 	montgomery_mul(key, acc, val, key->rr); /* acc = a * RR / R mod n */
@@ -239,6 +255,265 @@ static int pow_mod(const struct rsa_public_key *key, uint32_t *inout)
 	return 0;
 }
 
+#ifdef __SIZEOF_INT128__
+/*
+ * On 64-bit builds the arithmetic is done in 64-bit words, with a quarter
+ * of the multiplies needed with 32-bit words. Exponents other than 65537
+ * are worked through a few bits at a time, using a table of odd powers.
+ */
+#define RSA_MAX_KEY_WORDS64	(RSA_MAX_KEY_BITS / 64)
+#define RSA_WINDOW_BITS		3
+
+typedef unsigned __int128 uint128_t;
+
+/**
+ * struct rsa_key64 - RSA public key in 64-bit words
+ *
+ * @len:	Length of modulus[] in number of uint64_t
+ * @n0inv:	-1 / modulus[0] mod 2^64
+ * @modulus:	modulus as little endian array
+ * @exponent:	public exponent
+ */
+struct rsa_key64 {
+	uint len;
+	uint64_t n0inv;
+	uint64_t modulus[RSA_MAX_KEY_WORDS64];
+	uint64_t exponent;
+};
+
+/**
+ * subtract_modulus64() - subtract modulus from the given value
+ *
+ * @key:	Key containing modulus to subtract
+ * @num:	Number to subtract modulus from, as little endian word array
+ */
+static void subtract_modulus64(const struct rsa_key64 *key, uint64_t num[])
+{
+	uint64_t borrow = 0, diff;
+	uint i;
+
+	for (i = 0; i < key->len; i++) {
+		diff = num[i] - key->modulus[i] - borrow;
+		borrow = num[i] < key->modulus[i] ||
+			 (num[i] == key->modulus[i] && borrow);
+		num[i] = diff;
+	}
+}
+
+/**
+ * greater_equal_modulus64() - check if a value is >= modulus
+ *
+ * @key:	Key containing modulus to check
+ * @num:	Number to check against modulus, as little endian word array
+ * @return 0 if num < modulus, 1 if num >= modulus
+ */
+static int greater_equal_modulus64(const struct rsa_key64 *key,
+				   uint64_t num[])
+{
+	int i;
+
+	for (i = (int)key->len - 1; i >= 0; i--) {
+		if (num[i] < key->modulus[i])
+			return 0;
+		if (num[i] > key->modulus[i])
+			return 1;
+	}
+
+	return 1;  /* equal */
+}
+
+/**
+ * montgomery_mul_add_step64() - Perform montgomery multiply-add step
+ *
+ * Operation: montgomery result[] += a * b[] / n0inv % modulus
+ *
+ * @key:	RSA key
+ * @result:	Place to put result, as little endian word array
+ * @a:		Multiplier
+ * @b:		Multiplicand, as little endian word array
+ */
+static void montgomery_mul_add_step64(const struct rsa_key64 *key,
+		uint64_t result[], const uint64_t a, const uint64_t b[])
+{
+	uint128_t acc_a, acc_b;
+	uint64_t d0;
+	uint i;
+
+	acc_a = (uint128_t)a * b[0] + result[0];
+	d0 = (uint64_t)acc_a * key->n0inv;
+	acc_b = (uint128_t)d0 * key->modulus[0] + (uint64_t)acc_a;
+	for (i = 1; i < key->len; i++) {
+		acc_a = (acc_a >> 64) + (uint128_t)a * b[i] + result[i];
+		acc_b = (acc_b >> 64) + (uint128_t)d0 * key->modulus[i] +
+				(uint64_t)acc_a;
+		result[i - 1] = (uint64_t)acc_b;
+	}
+
+	acc_a = (acc_a >> 64) + (acc_b >> 64);
+
+	result[i - 1] = (uint64_t)acc_a;
+
+	if (acc_a >> 64)
+		subtract_modulus64(key, result);
+}
+
+/**
+ * montgomery_mul64() - Perform montgomery mutitply
+ *
+ * Operation: montgomery result[] = a[] * b[] / n0inv % modulus
+ *
+ * @key:	RSA key
+ * @result:	Place to put result, as little endian word array
+ * @a:		Multiplier, as little endian word array
+ * @b:		Multiplicand, as little endian word array
+ */
+static void montgomery_mul64(const struct rsa_key64 *key,
+		uint64_t result[], const uint64_t a[], const uint64_t b[])
+{
+	uint i;
+
+	for (i = 0; i < key->len; ++i)
+		result[i] = 0;
+	for (i = 0; i < key->len; ++i)
+		montgomery_mul_add_step64(key, result, a[i], b);
+}
+
+/**
+ * pow_mod_window64() - Raise a value to the public exponent, in windows
+ *
+ * Operation: acc[] = a_scaled[] ^ exponent / R^(exponent - 1) % modulus
+ *
+ * Runs of up to RSA_WINDOW_BITS bits of the exponent ending in a 1 are
+ * handled with a single multiply by an odd power of the value.
+ *
+ * @key:	RSA key
+ * @acc:	Place to put result, as little endian word array
+ * @a_scaled:	Value in montgomery form, as little endian word array
+ * @k:		Number of bits in the exponent
+ */
+static void pow_mod_window64(const struct rsa_key64 *key, uint64_t acc[],
+			     const uint64_t a_scaled[], int k)
+{
+	uint64_t powers[1 << (RSA_WINDOW_BITS - 1)][RSA_MAX_KEY_WORDS64];
+	uint64_t tmp[RSA_MAX_KEY_WORDS64];
+	int window = k > 23 ? RSA_WINDOW_BITS : 1;
+	int i, j, low, first = 1;
+	uint val;
+
+	/* powers[i] = a ^ (2 * i + 1) */
+	memcpy(powers[0], a_scaled, key->len * sizeof(uint64_t));
+	if (window > 1) {
+		montgomery_mul64(key, tmp, a_scaled, a_scaled);
+		for (i = 1; i < 1 << (window - 1); i++)
+			montgomery_mul64(key, powers[i], powers[i - 1], tmp);
+	}
+
+	for (i = k - 1; i >= 0; i = low - 1) {
+		if (!(key->exponent & (1ULL << i))) {
+			montgomery_mul64(key, tmp, acc, acc);
+			memcpy(acc, tmp, key->len * sizeof(uint64_t));
+			low = i;
+			continue;
+		}
+
+		/* Take the longest run of bits from i down that ends in a 1 */
+		low = i - window + 1;
+		if (low < 0)
+			low = 0;
+		while (!(key->exponent & (1ULL << low)))
+			low++;
+		val = (key->exponent >> low) & ((1 << (i - low + 1)) - 1);
+
+		if (first) {
+			memcpy(acc, powers[val >> 1],
+			       key->len * sizeof(uint64_t));
+			first = 0;
+			continue;
+		}
+		for (j = low; j <= i; j++) {
+			montgomery_mul64(key, tmp, acc, acc);
+			memcpy(acc, tmp, key->len * sizeof(uint64_t));
+		}
+		montgomery_mul64(key, tmp, acc, powers[val >> 1]);
+		memcpy(acc, tmp, key->len * sizeof(uint64_t));
+	}
+}
+
+/**
+ * pow_mod64() - in-place public exponentiation in 64-bit words
+ *
+ * @key:	RSA key, whose length must be a whole number of 64-bit words
+ * @inout:	Big-endian word array containing value and result
+ */
+static int pow_mod64(const struct rsa_public_key *key, uint32_t *inout)
+{
+	uint64_t val[RSA_MAX_KEY_WORDS64], acc[RSA_MAX_KEY_WORDS64];
+	uint64_t tmp[RSA_MAX_KEY_WORDS64], rr[RSA_MAX_KEY_WORDS64];
+	uint64_t a_scaled[RSA_MAX_KEY_WORDS64];
+	struct rsa_key64 key64;
+	uint64_t inv;
+	uint32_t *ptr;
+	uint i;
+	int j, k;
+
+	if (check_public_exponent(key, &k))
+		return -EINVAL;
+
+	key64.len = key->len / 2;
+	key64.exponent = key->exponent;
+	for (i = 0; i < key64.len; i++) {
+		key64.modulus[i] = key->modulus[2 * i] |
+			(uint64_t)key->modulus[2 * i + 1] << 32;
+		rr[i] = key->rr[2 * i] | (uint64_t)key->rr[2 * i + 1] << 32;
+	}
+
+	/*
+	 * -n0inv is 1 / modulus mod 2^32; one Newton step takes that to
+	 * 1 / modulus mod 2^64
+	 */
+	inv = (uint32_t)-key->n0inv;
+	inv *= 2 - (key->modulus[0] | (uint64_t)key->modulus[1] << 32) * inv;
+	key64.n0inv = -inv;
+
+	/* Convert from big endian byte array to little endian word array. */
+	for (i = 0, ptr = inout + key->len - 2; i < key64.len; i++, ptr -= 2)
+		val[i] = (uint64_t)get_unaligned_be32(ptr) << 32 |
+			get_unaligned_be32(&ptr[1]);
+
+	/* a_scaled = a * RR / R mod n */
+	montgomery_mul64(&key64, a_scaled, val, rr);
+
+	if (key64.exponent == RSA_DEFAULT_PUBEXP) {
+		/* acc = a ^ 65536 * R mod n, from 16 squares */
+		memcpy(acc, a_scaled, key64.len * sizeof(acc[0]));
+		for (j = 0; j < 16; j++) {
+			montgomery_mul64(&key64, tmp, acc, acc);
+			memcpy(acc, tmp, key64.len * sizeof(acc[0]));
+		}
+		/* acc = a ^ 65537 mod n, out of montgomery form */
+		montgomery_mul64(&key64, acc, tmp, val);
+	} else {
+		pow_mod_window64(&key64, tmp, a_scaled, k);
+		/* multiply by one to take the result out of montgomery form */
+		memset(val, '\0', key64.len * sizeof(val[0]));
+		val[0] = 1;
+		montgomery_mul64(&key64, acc, tmp, val);
+	}
+
+	/* Make sure result < mod; result is at most 1x mod too large. */
+	if (greater_equal_modulus64(&key64, acc))
+		subtract_modulus64(&key64, acc);
+
+	/* Convert to bigendian byte array */
+	for (i = key64.len - 1, ptr = inout; (int)i >= 0; i--, ptr += 2) {
+		put_unaligned_be32(acc[i] >> 32, ptr);
+		put_unaligned_be32((uint32_t)acc[i], &ptr[1]);
+	}
+
+	return 0;
+}
+#endif
+
 static void rsa_convert_big_endian(uint32_t *dst, const uint32_t *src, int len)
 {
 	int i;
@@ -293,7 +568,12 @@ int rsa_mod_exp_sw(const uint8_t *sig, uint32_t sig_len,
 
 	memcpy(buf, sig, sig_len);
 
-	ret = pow_mod(&key, buf);
+#ifdef __SIZEOF_INT128__
+	if (!(key.len & 1))
+		ret = pow_mod64(&key, buf);
+	else
+#endif
+		ret = pow_mod(&key, buf);
 	if (ret)
 		return ret;
 
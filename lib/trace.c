@@ -85,6 +85,38 @@ static void __attribute__((no_instrument_function)) add_textbase(void)
 	hdr->ftrace_count++;
 }
 
+/*
+ * I/O events are recorded whatever the call depth, since they are few and
+ * are what the timeline is mostly wanted for
+ */
+static void __attribute__((no_instrument_function)) add_event(uint32_t event,
+				ulong bytes)
+{
+	if (hdr->ftrace_count < hdr->ftrace_size) {
+		struct trace_call *rec = &hdr->ftrace[hdr->ftrace_count];
+
+		rec->func = event;
+		rec->caller = bytes;
+		rec->flags = FUNCF_EVENT |
+			(timer_get_us() & FUNCF_TIMESTAMP_MASK);
+	}
+	hdr->ftrace_count++;
+}
+
+void __attribute__((no_instrument_function)) trace_event_start(
+		enum trace_event event)
+{
+	if (trace_enabled)
+		add_event(event, 0);
+}
+
+void __attribute__((no_instrument_function)) trace_event_end(
+		enum trace_event event, ulong bytes)
+{
+	if (trace_enabled)
+		add_event(event | TRACE_EVENT_END, bytes);
+}
+
 /**
  * This is called on every function entry
  *
@@ -126,8 +158,9 @@ void __attribute__((no_instrument_function)) __cyg_profile_func_exit(
 		void *func_ptr, void *caller)
 {
 	if (trace_enabled) {
-		add_ftrace(func_ptr, caller, FUNCF_EXIT);
+		/* Check the depth the entry was recorded at, so they pair up */
 		hdr->depth--;
+		add_ftrace(func_ptr, caller, FUNCF_EXIT);
 	}
 }
 
@@ -210,9 +243,11 @@ int trace_list_calls(void *buff, int buff_size, unsigned *needed)
 			struct trace_call *call = &hdr->ftrace[rec];
 			struct trace_call *out = ptr;
 
-			out->func = call->func * FUNC_SITE_SIZE;
-			out->caller = call->caller * FUNC_SITE_SIZE;
-			out->flags = call->flags;
+			*out = *call;
+			if (TRACE_CALL_TYPE(call) != FUNCF_EVENT) {
+				out->func = call->func * FUNC_SITE_SIZE;
+				out->caller = call->caller * FUNC_SITE_SIZE;
+			}
 			upto++;
 		}
 		ptr += sizeof(struct trace_call);
@@ -269,6 +304,11 @@ void __attribute__((no_instrument_function)) trace_set_enabled(int enabled)
 	trace_enabled = enabled != 0;
 }
 
+void trace_set_depth_limit(int depth_limit)
+{
+	hdr->depth_limit = depth_limit;
+}
+
 /**
  * Init the tracing system ready for used, and enable it
  *
@@ -849,6 +849,7 @@ void panic(const char *fmt, ...)
 	vprintf(fmt, args);
 	putc('\n');
 	va_end(args);
+	console_flush_fatal();
 #if defined(CONFIG_PANIC_HANG)
 	hang();
 #else
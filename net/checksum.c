@@ -11,29 +11,83 @@
 #include <common.h>
 #include <net.h>
 
-unsigned compute_ip_checksum(const void *vptr, unsigned nbytes)
+/*
+ * Sum 16-bit words one at a time. This is only used for buffers which are
+ * not 16-bit aligned, where the word-wide loop below cannot be used.
+ */
+static u64 ip_checksum_add16(const u16 *ptr, unsigned nbytes, u64 sum)
 {
-	int sum, oddbyte;
-	const unsigned short *ptr = vptr;
-
-	sum = 0;
 	while (nbytes > 1) {
 		sum += *ptr++;
 		nbytes -= 2;
 	}
 	if (nbytes == 1) {
-		oddbyte = 0;
+		u16 oddbyte = 0;
+
 		((u8 *)&oddbyte)[0] = *(u8 *)ptr;
-		((u8 *)&oddbyte)[1] = 0;
 		sum += oddbyte;
 	}
-	sum = (sum >> 16) + (sum & 0xffff);
-	sum += (sum >> 16);
-	sum = ~sum & 0xffff;
 
 	return sum;
 }
 
+/*
+ * Sum 32-bit words into a 64-bit accumulator. The one's complement sum is
+ * independent of the word size used to compute it, so carries only need to
+ * be folded back once at the end instead of on every 16-bit addition.
+ */
+static u64 ip_checksum_add32(const void *vptr, unsigned nbytes, u64 sum)
+{
+	const u16 *ptr16 = vptr;
+	const u32 *ptr32;
+
+	if ((uintptr_t)ptr16 & 1)
+		return ip_checksum_add16(ptr16, nbytes, sum);
+
+	/* Get to a 32-bit boundary */
+	if (((uintptr_t)ptr16 & 2) && nbytes > 1) {
+		sum += *ptr16++;
+		nbytes -= 2;
+	}
+
+	ptr32 = (const u32 *)ptr16;
+	while (nbytes >= 16) {
+		sum += ptr32[0];
+		sum += ptr32[1];
+		sum += ptr32[2];
+		sum += ptr32[3];
+		ptr32 += 4;
+		nbytes -= 16;
+	}
+	while (nbytes >= 4) {
+		sum += *ptr32++;
+		nbytes -= 4;
+	}
+
+	return ip_checksum_add16((const u16 *)ptr32, nbytes, sum);
+}
+
+static unsigned ip_checksum_fold(u64 sum)
+{
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffffffff) + (sum >> 32);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return sum;
+}
+
+unsigned ip_checksum_partial(const void *vptr, unsigned nbytes, unsigned sum)
+{
+	return ip_checksum_fold(ip_checksum_add32(vptr, nbytes, sum));
+}
+
+unsigned compute_ip_checksum(const void *vptr, unsigned nbytes)
+{
+	return ~ip_checksum_partial(vptr, nbytes, 0) & 0xffff;
+}
+
 unsigned add_ip_checksums(unsigned offset, unsigned sum, unsigned new)
 {
 	unsigned long checksum;
@@ -84,6 +84,7 @@
 #include <common.h>
 #include <command.h>
 #include <environment.h>
+#include <hash.h>
 #include <net.h>
 #if defined(CONFIG_STATUS_LED)
 #include <miiphy.h>
@@ -332,6 +333,9 @@ int NetLoop(enum proto_t protocol)
 	NetTryCount = 1;
 	debug_cond(DEBUG_INT_STATE, "--- NetLoop Entry\n");
 
+	/* Loads over the network are not hashed as they arrive */
+	hash_read_stop();
+
 	bootstage_mark_name(BOOTSTAGE_ID_ETH_START, "eth_start");
 	net_init();
 	if (eth_is_on_demand_init() || protocol != NETCONS) {
@@ -949,6 +953,45 @@ static void receive_icmp(struct ip_udp_hdr *ip, int len,
 	}
 }
 
+#ifdef CONFIG_UDP_CHECKSUM
+/**
+ * udp_checksum_ok() - Check the checksum of a received UDP datagram
+ *
+ * If the driver supplied the sum of the whole IP datagram we only need to
+ * add the pseudo header: the IP header has already been checked and sums
+ * to (negative) zero, so it does not affect the result.
+ *
+ * @ip:		IP packet containing the UDP datagram
+ * @hw_csum:	true if @csum holds the driver-computed sum of the datagram
+ * @csum:	Sum of the IP datagram from the driver
+ * @return true if the checksum matches, false if not
+ */
+static int udp_checksum_ok(struct ip_udp_hdr *ip, int hw_csum, unsigned csum)
+{
+	unsigned sum;
+
+	/* Pseudo header: source and destination address, protocol, length */
+	sum = ip_checksum_partial(&ip->ip_src, 2 * sizeof(ip->ip_src), 0);
+	sum += htons(IPPROTO_UDP) + ip->udp_len;
+
+	if (hw_csum)
+		sum += csum;
+	else
+		sum = ip_checksum_partial(&ip->udp_src, ntohs(ip->udp_len),
+					  sum);
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	if (sum != 0 && sum != 0xffff) {
+		printf(" UDP wrong checksum %04x %04x\n", sum,
+		       ntohs(ip->udp_xsum));
+		return 0;
+	}
+
+	return 1;
+}
+#endif
+
 void
 NetReceive(uchar *inpkt, int len)
 {
@@ -961,6 +1004,11 @@ NetReceive(uchar *inpkt, int len)
 	int iscdp;
 #endif
 	ushort cti = 0, vlanid = VLAN_NONE, myvlanid, mynvlanid;
+#ifdef CONFIG_UDP_CHECKSUM
+	struct eth_device *dev = eth_get_dev();
+	struct ip_udp_hdr *rx_ip = NULL;
+	int hw_csum = 0;
+#endif
 
 	debug_cond(DEBUG_NET_PKT, "packet received\n");
 
@@ -1007,6 +1055,10 @@ NetReceive(uchar *inpkt, int len)
 	} else if (eth_proto != PROT_VLAN) {	/* normal packet */
 		ip = (struct ip_udp_hdr *)(inpkt + ETHER_HDR_SIZE);
 		len -= ETHER_HDR_SIZE;
+#ifdef CONFIG_UDP_CHECKSUM
+		/* The hardware sum starts right after the Ethernet header */
+		hw_csum = dev && (dev->features & ETH_FEATURE_RX_CSUM);
+#endif
 
 	} else {			/* VLAN packet */
 		struct vlan_ethernet_hdr *vet =
@@ -1075,6 +1127,12 @@ NetReceive(uchar *inpkt, int len)
 			debug("len bad %d < %d\n", len, ntohs(ip->ip_len));
 			return;
 		}
+#ifdef CONFIG_UDP_CHECKSUM
+		/* Padding after the datagram is included in the hardware sum */
+		if (len != ntohs(ip->ip_len))
+			hw_csum = 0;
+		rx_ip = ip;
+#endif
 		len = ntohs(ip->ip_len);
 		debug_cond(DEBUG_NET_PKT, "len=%d, v=%02x\n",
 			len, ip->ip_hl_v & 0xff);
@@ -1141,45 +1199,13 @@ NetReceive(uchar *inpkt, int len)
 			&dst_ip, &src_ip, len);
 
 #ifdef CONFIG_UDP_CHECKSUM
-		if (ip->udp_xsum != 0) {
-			ulong   xsum;
-			ushort *sumptr;
-			ushort  sumlen;
-
-			xsum  = ip->ip_p;
-			xsum += (ntohs(ip->udp_len));
-			xsum += (ntohl(ip->ip_src) >> 16) & 0x0000ffff;
-			xsum += (ntohl(ip->ip_src) >>  0) & 0x0000ffff;
-			xsum += (ntohl(ip->ip_dst) >> 16) & 0x0000ffff;
-			xsum += (ntohl(ip->ip_dst) >>  0) & 0x0000ffff;
-
-			sumlen = ntohs(ip->udp_len);
-			sumptr = (ushort *) &(ip->udp_src);
-
-			while (sumlen > 1) {
-				ushort sumdata;
-
-				sumdata = *sumptr++;
-				xsum += ntohs(sumdata);
-				sumlen -= 2;
-			}
-			if (sumlen > 0) {
-				ushort sumdata;
-
-				sumdata = *(unsigned char *) sumptr;
-				sumdata = (sumdata << 8) & 0xff00;
-				xsum += sumdata;
-			}
-			while ((xsum >> 16) != 0) {
-				xsum = (xsum & 0x0000ffff) +
-				       ((xsum >> 16) & 0x0000ffff);
-			}
-			if ((xsum != 0x00000000) && (xsum != 0x0000ffff)) {
-				printf(" UDP wrong checksum %08lx %08x\n",
-					xsum, ntohs(ip->udp_xsum));
-				return;
-			}
-		}
+		/* A reassembled datagram was not summed by the hardware */
+		if (ip != rx_ip ||
+		    ntohs(ip->udp_len) != len - IP_HDR_SIZE)
+			hw_csum = 0;
+		if (ip->udp_xsum != 0 &&
+		    !udp_checksum_ok(ip, hw_csum, dev ? dev->rx_csum : 0))
+			return;
 #endif
 
 
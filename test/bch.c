@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <linux/bch.h>
+
+#define PAGE_SIZE	2048
+#define TRIALS		200
+
+struct bch_test {
+	int m;
+	int t;
+	int len;	/* ecc step size */
+};
+
+static const struct bch_test tests[] = {
+	{ 13, 4, 512 },
+	{ 13, 8, 512 },
+	{ 14, 16, 1024 },
+};
+
+static u32 seed;
+
+static u32 test_rand(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/* A control structure limited to the bit-serial syndrome computation */
+static struct bch_control *init_ref_bch(int m, int t)
+{
+	struct bch_control *bch = init_bch(m, t, 0);
+
+	if (bch) {
+		free(bch->syn_tab);
+		bch->syn_tab = NULL;
+	}
+
+	return bch;
+}
+
+/* Flip @count distinct bits of the data and ecc, recording the locations */
+static void flip_bits(const struct bch_test *test, struct bch_control *bch,
+		      u8 *data, u8 *ecc, unsigned int *loc, int count)
+{
+	const unsigned int nbits = 8 * test->len + bch->ecc_bits;
+	unsigned int bit;
+	int i, j;
+
+	for (i = 0; i < count; i++) {
+		do {
+			bit = test_rand() % nbits;
+			for (j = 0; j < i && loc[j] != bit; j++)
+				;
+		} while (j < i);
+		loc[i] = bit;
+		if (bit < 8 * test->len)
+			data[bit / 8] ^= 1 << (bit % 8);
+		else
+			ecc[bit / 8 - test->len] ^= 1 << (bit % 8);
+	}
+}
+
+static int same_locations(unsigned int *a, unsigned int *b, int count)
+{
+	int i, j;
+
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < count && a[i] != b[j]; j++)
+			;
+		if (j == count)
+			return 0;
+	}
+
+	return 1;
+}
+
+/* Check the decoders against the flipped bits and against each other */
+static int check_decode(const struct bch_test *test, struct bch_control *bch,
+			struct bch_control *ref, const u8 *data, const u8 *ecc)
+{
+	unsigned int loc[test->t + 1], errloc[test->t], refloc[test->t];
+	u8 buf[test->len], recv[bch->ecc_bytes], calc[bch->ecc_bytes];
+	int count, ret, ref_ret, i;
+
+	for (i = 0; i < TRIALS; i++) {
+		count = i % (test->t + 2);
+		memcpy(buf, data, test->len);
+		memcpy(recv, ecc, bch->ecc_bytes);
+		flip_bits(test, bch, buf, recv, loc, count);
+
+		memset(calc, 0, bch->ecc_bytes);
+		encode_bch(bch, buf, test->len, calc);
+		ret = decode_bch(bch, NULL, test->len, recv, calc, NULL,
+				 errloc);
+		ref_ret = decode_bch(ref, NULL, test->len, recv, calc, NULL,
+				     refloc);
+
+		if (ret != ref_ret || (ret > 0 &&
+				       !same_locations(errloc, refloc, ret))) {
+			printf(" m=%d t=%d: %d errors, decoded %d, reference %d\n",
+			       test->m, test->t, count, ret, ref_ret);
+			return -1;
+		}
+		if (count <= test->t &&
+		    (ret != count || !same_locations(errloc, loc, count))) {
+			printf(" m=%d t=%d: %d errors, decoded %d\n",
+			       test->m, test->t, count, ret);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/* Report how many pages per second are decoded with @count errors per step */
+static void bench_decode(const struct bch_test *test, struct bch_control *bch,
+			 const u8 *data, const u8 *ecc, int count)
+{
+	const int steps = PAGE_SIZE / test->len;
+	unsigned int loc[test->t], errloc[test->t];
+	u8 buf[test->len], recv[bch->ecc_bytes], calc[bch->ecc_bytes];
+	unsigned long start, us;
+	int i;
+
+	memcpy(buf, data, test->len);
+	memcpy(recv, ecc, bch->ecc_bytes);
+	flip_bits(test, bch, buf, recv, loc, count);
+
+	start = timer_get_us();
+	for (i = 0; i < TRIALS * steps; i++) {
+		memset(calc, 0, bch->ecc_bytes);
+		encode_bch(bch, buf, test->len, calc);
+		decode_bch(bch, NULL, test->len, recv, calc, NULL, errloc);
+	}
+	us = max(timer_get_us() - start, 1UL);
+
+	printf(" %8lu", TRIALS * 1000000UL / us);
+}
+
+static int run_test(const struct bch_test *test)
+{
+	struct bch_control *bch, *ref;
+	u8 data[test->len];
+	u8 *ecc;
+	int ret = -1;
+	int i;
+
+	bch = init_bch(test->m, test->t, 0);
+	ref = init_ref_bch(test->m, test->t);
+	if (!bch || !ref)
+		goto out;
+
+	for (i = 0; i < test->len; i++)
+		data[i] = test_rand();
+	ecc = calloc(1, bch->ecc_bytes);
+	if (!ecc)
+		goto out;
+	encode_bch(bch, data, test->len, ecc);
+
+	ret = check_decode(test, bch, ref, data, ecc);
+	if (!ret) {
+		printf(" m=%-2d t=%-2d %4d ", test->m, test->t, test->len);
+		bench_decode(test, bch, data, ecc, 0);
+		bench_decode(test, bch, data, ecc, test->t / 2);
+		bench_decode(test, bch, data, ecc, test->t);
+		bench_decode(test, ref, data, ecc, test->t / 2);
+		bench_decode(test, ref, data, ecc, test->t);
+		printf("\n");
+	}
+	free(ecc);
+out:
+	free_bch(bch);
+	free_bch(ref);
+
+	return ret;
+}
+
+static int do_ut_bch(cmd_tbl_t *cmdtp, int flag, int argc, char *const argv[])
+{
+	int ret = 0;
+	int i;
+
+	seed = 1;
+	printf(" pages/s                 clean   t/2 err     t err"
+	       "  ref t/2    ref t\n");
+	for (i = 0; i < ARRAY_SIZE(tests); i++)
+		ret |= run_test(&tests[i]);
+
+	printf("ut_bch %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_bch,	1,	1,	do_ut_bch,
+	"Check BCH decoding and report its speed", ""
+);
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <net.h>
+
+#define BENCH_SIZE	(1 << 20)
+#define BENCH_LOOPS	64
+
+/* Straightforward 16-bit implementation to check the fast one against */
+static unsigned ref_ip_checksum(const void *vptr, unsigned nbytes)
+{
+	const u8 *ptr = vptr;
+	unsigned sum = 0;
+	u16 word;
+
+	while (nbytes > 1) {
+		memcpy(&word, ptr, sizeof(word));
+		sum += word;
+		ptr += 2;
+		nbytes -= 2;
+	}
+	if (nbytes == 1) {
+		word = 0;
+		((u8 *)&word)[0] = *ptr;
+		sum += word;
+	}
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	return ~sum & 0xffff;
+}
+
+static int run_compare(u8 *buf)
+{
+	unsigned offset, len, expect, actual;
+
+	for (offset = 0; offset < 8; offset++) {
+		for (len = 0; len < 1600; len++) {
+			expect = ref_ip_checksum(buf + offset, len);
+			actual = compute_ip_checksum(buf + offset, len);
+			if (expect != actual) {
+				printf(" offset %u len %u: expected %04x, got %04x\n",
+				       offset, len, expect, actual);
+				return -1;
+			}
+		}
+	}
+
+	/* Check that the sum of a buffer and its checksum verifies */
+	expect = compute_ip_checksum(buf, 1500);
+	memcpy(buf + 1500, &expect, 2);
+	if (!ip_checksum_ok(buf, 1502)) {
+		printf(" checksum does not verify\n");
+		return -1;
+	}
+
+	/* A split computation must give the same answer */
+	actual = ip_checksum_partial(buf, 12, 0);
+	actual = ip_checksum_partial(buf + 12, 1000, actual);
+	if ((~actual & 0xffff) != compute_ip_checksum(buf, 1012)) {
+		printf(" partial checksum mismatch\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static ulong run_bench(const char *name,
+		       unsigned (*func)(const void *, unsigned), u8 *buf)
+{
+	ulong start, duration;
+	unsigned sum = 0;
+	int i;
+
+	start = get_timer(0);
+	for (i = 0; i < BENCH_LOOPS; i++)
+		sum += func(buf + 2, BENCH_SIZE);
+	duration = get_timer(start);
+
+	printf(" %-10s %lu ms, %lu KiB/ms (%x)\n", name, duration,
+	       duration ? (BENCH_SIZE / 1024) * BENCH_LOOPS / duration : 0,
+	       sum);
+
+	return duration;
+}
+
+static int do_ut_checksum(cmd_tbl_t *cmdtp, int flag, int argc,
+			  char *const argv[])
+{
+	u8 *buf;
+	int ret;
+	int i;
+
+	buf = malloc(BENCH_SIZE + 8);
+	if (!buf)
+		return CMD_RET_FAILURE;
+	for (i = 0; i < BENCH_SIZE + 8; i++)
+		buf[i] = i * 7 + (i >> 8);
+
+	ret = run_compare(buf);
+	if (!ret) {
+		run_bench("16-bit", ref_ip_checksum, buf);
+		run_bench("word-wide", compute_ip_checksum, buf);
+	}
+	free(buf);
+
+	printf("ut_checksum %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_checksum,	1,	1,	do_ut_checksum,
+	"Check and benchmark the IP checksum routines", ""
+);
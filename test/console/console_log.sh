@@ -0,0 +1,42 @@
+#!/bin/sh
+#
+# Copyright (C) 2015 Renesas Electronics Corporation
+#
+# SPDX-License-Identifier:	GPL-2.0+
+#
+
+# Console output buffer test using sandbox
+#
+# Usage: console_log.sh
+#
+# Output must reach the console once, in order, and be kept for
+# 'console log'. In quiet mode it must only be kept.
+
+BASE="$(dirname $0)/.."
+. $BASE/common.sh
+
+UBOOT=./${OUTPUT_DIR}/u-boot
+
+tmp="$(mktemp)"
+trap 'rm -f ${tmp}' EXIT
+
+run() {
+	${UBOOT} -c "$1" 2>&1 | tr -d '\r' >${tmp}
+}
+
+echo "Console output buffer test using sandbox"
+echo
+[ -x ${UBOOT} ] || build_uboot
+
+echo "Output and log"
+run "echo first; md.b 0 800; echo second; console log"
+[ "$(grep -c '^first$' ${tmp})" = 2 ] || fail "output not logged once"
+[ "$(grep -c '^000007f0:' ${tmp})" = 2 ] || fail "output lost"
+grep -A1 '^000007f0:' ${tmp} | grep -q '^second$' || fail "output reordered"
+
+echo "Quiet mode"
+run "console quiet on; echo hidden; console quiet off; echo shown; console log"
+[ "$(grep -c '^hidden$' ${tmp})" = 1 ] || fail "quiet output sent"
+[ "$(grep -c '^shown$' ${tmp})" = 2 ] || fail "output not sent after quiet"
+
+echo "Test passed"
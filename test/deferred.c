@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <deferred.h>
+#include <errno.h>
+
+#define READY_US	50000
+#define SLACK_US	20000
+
+/* Hardware which becomes ready READY_US after it is started */
+struct test_hw {
+	ulong ready_us;
+	int completed;
+	int ret;
+};
+
+static void test_hw_start(struct test_hw *hw, int ret)
+{
+	hw->ready_us = timer_get_us() + READY_US;
+	hw->completed = 0;
+	hw->ret = ret;
+}
+
+static int test_hw_complete(void *arg)
+{
+	struct test_hw *hw = arg;
+
+	while ((long)(hw->ready_us - timer_get_us()) > 0)
+		;
+	hw->completed++;
+
+	return hw->ret;
+}
+
+/* These stay on the list of operations, so must outlive the test */
+static struct deferred early, late, failing, unused, never;
+static struct test_hw early_hw, late_hw, failing_hw, unused_hw;
+
+static int run_test(void)
+{
+	/* Nothing to complete before the operation is started */
+	if (deferred_pending(&never) || deferred_complete(&never) != -ENOENT)
+		return -1;
+
+	test_hw_start(&early_hw, 0);
+	deferred_start(&early, "early", test_hw_complete, &early_hw);
+	test_hw_start(&failing_hw, -EIO);
+	deferred_start(&failing, "failing", test_hw_complete, &failing_hw);
+	test_hw_start(&unused_hw, 0);
+	deferred_start(&unused, "unused", test_hw_complete, &unused_hw);
+	if (!deferred_pending(&early) || early_hw.completed)
+		return -1;
+
+	/* Used straight away, so the whole wait falls on the first use */
+	if (deferred_complete(&early) || early_hw.completed != 1)
+		return -1;
+	if (deferred_pending(&early) ||
+	    early.wait_us < READY_US - SLACK_US)
+		return -1;
+
+	/* Later uses do not wait again */
+	if (deferred_complete(&early) || early_hw.completed != 1)
+		return -1;
+
+	/* Used once ready, so the wait was hidden */
+	test_hw_start(&late_hw, 0);
+	deferred_start(&late, "late", test_hw_complete, &late_hw);
+	udelay(READY_US + SLACK_US);
+	if (deferred_complete(&late) || late_hw.completed != 1)
+		return -1;
+	if (late.wait_us > SLACK_US ||
+	    late.used_us - late.start_us < READY_US)
+		return -1;
+
+	/* Errors are kept for later uses */
+	if (deferred_complete(&failing) != -EIO ||
+	    deferred_complete(&failing) != -EIO || failing_hw.completed != 1)
+		return -1;
+
+	/* Starting again resets the operation */
+	test_hw_start(&late_hw, 0);
+	deferred_start(&late, "late again", test_hw_complete, &late_hw);
+	if (!deferred_pending(&late) || late.used_us || late.wait_us)
+		return -1;
+	deferred_complete(&late);
+
+	deferred_report();
+	if (!deferred_pending(&unused) || unused_hw.completed)
+		return -1;
+
+	return 0;
+}
+
+static int do_ut_deferred(cmd_tbl_t *cmdtp, int flag, int argc,
+			  char *const argv[])
+{
+	int ret;
+
+	ret = run_test();
+	printf("ut_deferred %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_deferred,	1,	1,	do_ut_deferred,
+	"Check completion of operations at first use", ""
+);
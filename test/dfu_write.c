@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <dfu.h>
+#include <malloc.h>
+
+#define RAM_SIZE	0x10000
+#define BUF_SIZE	0x1000
+#define CHUNK_SIZE	0x200
+
+static u8 *ram;
+static u8 *image;
+
+static struct dfu_entity *setup_entity(int count, ulong size)
+{
+	char cmd[64];
+
+	setenv_ulong("dfu_bufsiz", BUF_SIZE);
+	setenv_ulong("dfu_bufcnt", count);
+
+	snprintf(cmd, sizeof(cmd), "ram_test ram %lx %lx", (ulong)ram, size);
+	if (dfu_config_entities(cmd, "ram", "0"))
+		return NULL;
+
+	return dfu_get_entity(0);
+}
+
+/*
+ * Send the image in chunks of varying size, as a gadget would, optionally
+ * writing back up to write_behind bytes of queued data in between and
+ * receiving in place.
+ */
+static int send_image(struct dfu_entity *dfu, int len, int write_behind,
+		      int in_place)
+{
+	int pos, size, seq = 0, ret;
+	void *buf;
+
+	for (pos = 0; pos < len; pos += size) {
+		/* in-place reception needs chunks of the same size */
+		size = CHUNK_SIZE;
+		if (!in_place)
+			size -= (seq % 3) * 0x40;
+		size = min(size, len - pos);
+		buf = image + pos;
+		if (in_place) {
+			buf = dfu_get_write_buf(dfu);
+			memcpy(buf, image + pos, size);
+		}
+		ret = dfu_write(dfu, buf, size, seq++);
+		if (ret)
+			return ret;
+		if (write_behind) {
+			ret = dfu_write_pending(dfu, write_behind);
+			if (ret) {
+				dfu_write_transaction_cleanup(dfu);
+				return ret;
+			}
+		}
+	}
+
+	return dfu_flush(dfu, NULL, 0, seq);
+}
+
+static int check_write(int count, int write_behind, int in_place)
+{
+	struct dfu_entity *dfu;
+	int len = RAM_SIZE - 100;
+	int ret;
+
+	memset(ram, 0, RAM_SIZE);
+	dfu = setup_entity(count, RAM_SIZE);
+	if (!dfu)
+		return -1;
+
+	ret = send_image(dfu, len, write_behind * CHUNK_SIZE, in_place);
+	if (!ret && dfu_get_buf_count() != count)
+		ret = -1;
+	if (!ret && memcmp(ram, image, len))
+		ret = -1;
+	dfu_free_entities();
+
+	if (ret)
+		printf(" write: %d buffers, write-behind %d, in place %d failed\n",
+		       count, write_behind, in_place);
+
+	return ret;
+}
+
+/* A medium error must be reported and cancel the transfer */
+static int check_error(int count, int write_behind)
+{
+	struct dfu_entity *dfu;
+	int ret;
+
+	dfu = setup_entity(count, RAM_SIZE / 2);
+	if (!dfu)
+		return -1;
+
+	ret = send_image(dfu, RAM_SIZE, write_behind * CHUNK_SIZE, 0);
+	ret = (ret && !dfu->inited) ? 0 : -1;
+	dfu_free_entities();
+
+	if (ret)
+		printf(" error: %d buffers, write-behind %d not reported\n",
+		       count, write_behind);
+
+	return ret;
+}
+
+/* Medium writes from part of a slot must start on a write unit */
+#define WRITE_UNIT	0x300
+
+static int (*ram_write_medium)(struct dfu_entity *dfu, u64 offset, void *buf,
+			       long *len);
+static int unaligned;
+
+static int write_medium_unit(struct dfu_entity *dfu, u64 offset, void *buf,
+			     long *len)
+{
+	/* the slots start on multiples of BUF_SIZE with in-place reception */
+	if ((offset % BUF_SIZE) % WRITE_UNIT)
+		unaligned++;
+
+	return ram_write_medium(dfu, offset, buf, len);
+}
+
+static int check_unit(int write_unit)
+{
+	struct dfu_entity *dfu;
+	int len = RAM_SIZE - 100;
+	int ret;
+
+	memset(ram, 0, RAM_SIZE);
+	dfu = setup_entity(2, RAM_SIZE);
+	if (!dfu)
+		return -1;
+	dfu->write_unit = write_unit;
+	ram_write_medium = dfu->write_medium;
+	dfu->write_medium = write_medium_unit;
+	unaligned = 0;
+
+	ret = send_image(dfu, len, 2 * CHUNK_SIZE, 1);
+	if (!ret && (unaligned || memcmp(ram, image, len)))
+		ret = -1;
+	dfu_free_entities();
+
+	if (ret)
+		printf(" write unit %#x: %d unaligned writes\n", write_unit,
+		       unaligned);
+
+	return ret;
+}
+
+static int check_sequence(void)
+{
+	struct dfu_entity *dfu;
+	int ret;
+
+	dfu = setup_entity(2, RAM_SIZE);
+	if (!dfu)
+		return -1;
+
+	ret = dfu_write(dfu, image, CHUNK_SIZE, 0);
+	if (!ret)
+		ret = dfu_write(dfu, image, CHUNK_SIZE, 2) ? 0 : -1;
+	if (!ret && dfu->inited)
+		ret = -1;
+	dfu_free_entities();
+
+	if (ret)
+		printf(" wrong sequence number not reported\n");
+
+	return ret;
+}
+
+static int do_ut_dfu(cmd_tbl_t *cmdtp, int flag, int argc, char *const argv[])
+{
+	int count, ret = 0;
+	int i;
+
+	ram = malloc(RAM_SIZE);
+	image = malloc(RAM_SIZE);
+	if (!ram || !image) {
+		free(ram);
+		free(image);
+		return CMD_RET_FAILURE;
+	}
+	for (i = 0; i < RAM_SIZE; i++)
+		image[i] = i * 7 + (i >> 8);
+
+	for (count = 1; count <= 3 && !ret; count++) {
+		ret |= check_write(count, 0, 0);
+		ret |= check_write(count, 1, 0);
+		ret |= check_write(count, 1, 1);
+		ret |= check_error(count, 0);
+		ret |= check_error(count, 1);
+	}
+	if (!ret)
+		ret = check_unit(WRITE_UNIT);
+	if (!ret)
+		ret = check_unit(0);
+	if (!ret)
+		ret = check_sequence();
+
+	setenv("dfu_bufsiz", NULL);
+	setenv("dfu_bufcnt", NULL);
+	free(ram);
+	free(image);
+
+	printf("ut_dfu %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_dfu,	1,	1,	do_ut_dfu,
+	"Check DFU write buffering using a RAM entity", ""
+);
@@ -15,6 +15,7 @@
 #include <dm/root.h>
 #include <dm/test.h>
 #include <dm/uclass-internal.h>
+#include <dm/util.h>
 
 static void show_devices(struct udevice *dev, int depth, int last_flag)
 {
@@ -108,6 +109,39 @@ static int do_dm_dump_uclass(cmd_tbl_t *cmdtp, int flag, int argc,
 	return 0;
 }
 
+#ifdef CONFIG_DM_TIMING
+static int do_dm_timing(cmd_tbl_t *cmdtp, int flag, int argc,
+			char * const argv[])
+{
+	struct driver *drv = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	struct dm_timing *t, total;
+	int i;
+
+	memset(&total, '\0', sizeof(total));
+	printf(" Driver               Bound  Bind us  Probed  Probe us\n");
+	printf("------------------------------------------------------\n");
+	for (i = 0; i < n_ents; i++, drv++) {
+		t = dm_timing_get(drv);
+		if (!t || (!t->binds && !t->probes))
+			continue;
+		printf(" %-20.20s %5u %8lu %7u %9lu\n", drv->name, t->binds,
+		       t->bind_us, t->probes, t->probe_us);
+		total.binds += t->binds;
+		total.bind_us += t->bind_us;
+		total.probes += t->probes;
+		total.probe_us += t->probe_us;
+	}
+	printf(" %-20s %5u %8lu %7u %9lu\n", "Total", total.binds,
+	       total.bind_us, total.probes, total.probe_us);
+
+	return 0;
+}
+#define TIMING_HELP "\ndm timing        Show bind and probe times per driver"
+#else
+#define TIMING_HELP
+#endif
+
 #ifdef CONFIG_DM_TEST
 static int do_dm_test(cmd_tbl_t *cmdtp, int flag, int argc,
 			  char * const argv[])
@@ -122,6 +156,9 @@ static int do_dm_test(cmd_tbl_t *cmdtp, int flag, int argc,
 static cmd_tbl_t test_commands[] = {
 	U_BOOT_CMD_MKENT(tree, 0, 1, do_dm_dump_all, "", ""),
 	U_BOOT_CMD_MKENT(uclass, 1, 1, do_dm_dump_uclass, "", ""),
+#ifdef CONFIG_DM_TIMING
+	U_BOOT_CMD_MKENT(timing, 1, 1, do_dm_timing, "", ""),
+#endif
 #ifdef CONFIG_DM_TEST
 	U_BOOT_CMD_MKENT(test, 1, 1, do_dm_test, "", ""),
 #endif
@@ -151,5 +188,6 @@ U_BOOT_CMD(
 	"Driver model low level access",
 	"tree         Dump driver model tree ('*' = activated)\n"
 	"dm uclass        Dump list of instances for each uclass"
+	TIMING_HELP
 	TEST_HELP
 );
@@ -9,6 +9,7 @@
 #include <fdtdec.h>
 #include <spi.h>
 #include <spi_flash.h>
+#include <asm/io.h>
 #include <asm/state.h>
 #include <dm/ut.h>
 #include <dm/test.h>
@@ -41,3 +42,32 @@ static int dm_test_spi_flash(struct dm_test_state *dms)
 	return 0;
 }
 DM_TEST(dm_test_spi_flash, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test that bulk reads return the same data as reads through xfer() */
+static int dm_test_spi_flash_read_flash(struct dm_test_state *dms)
+{
+	struct sandbox_state *state = state_get_current();
+	const int size = 0x200000;
+	u8 *buf;
+	int i;
+
+	buf = map_sysmem(0, size);
+	for (i = 0; i < size; i++)
+		buf[i] = i * 7 + (i >> 9);
+	unmap_sysmem(buf);
+
+	ut_asserteq(0, run_command_list(
+		"sb save hostfs - 0 spi.bin 200000;"
+		"sf probe;"
+		"sf read 400000 1234 10003", -1, 0));
+	state->spi_pio = true;
+	ut_asserteq(0, run_command("sf read 600000 1234 10003", 0));
+	state->spi_pio = false;
+	ut_asserteq(0, run_command("cmp.b 400000 600000 10003", 0));
+	ut_asserteq(0, run_command("cmp.b 400000 1234 10003", 0));
+
+	sandbox_sf_unbind_emul(state, 0, 0);
+
+	return 0;
+}
+DM_TEST(dm_test_spi_flash_read_flash, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
@@ -10,6 +10,8 @@
 #include <fdtdec.h>
 #include <malloc.h>
 #include <asm/io.h>
+#include <dm/device-internal.h>
+#include <dm/lists.h>
 #include <dm/test.h>
 #include <dm/root.h>
 #include <dm/ut.h>
@@ -238,6 +240,38 @@ static int dm_test_fdt_uclass_seq(struct dm_test_state *dms)
 }
 DM_TEST(dm_test_fdt_uclass_seq, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
 
+/* Test that sequence numbers go away with the devices which had them */
+static int dm_test_fdt_seq_remove(struct dm_test_state *dms)
+{
+	struct udevice *dev, *found;
+
+	ut_assertok(uclass_get_device_by_seq(UCLASS_TEST_FDT, 3, &dev));
+	ut_asserteq_str("b-test", dev->name);
+
+	/* Once removed it only requests its seq */
+	ut_assertok(device_remove(dev));
+	ut_asserteq(-ENODEV, uclass_find_device_by_seq(UCLASS_TEST_FDT, 3,
+						       false, &found));
+	ut_assertok(uclass_find_device_by_seq(UCLASS_TEST_FDT, 3, true,
+					      &found));
+	ut_asserteq_ptr(dev, found);
+
+	/* Probing it again gives it the same seq */
+	ut_assertok(uclass_get_device_by_seq(UCLASS_TEST_FDT, 3, &found));
+	ut_asserteq_ptr(dev, found);
+	ut_asserteq(3, dev->seq);
+
+	ut_assertok(device_remove(dev));
+	ut_assertok(device_unbind(dev));
+	ut_asserteq(-ENODEV, uclass_find_device_by_seq(UCLASS_TEST_FDT, 3,
+						       true, &found));
+	ut_asserteq(-ENODEV, uclass_get_device_by_seq(UCLASS_TEST_FDT, 3,
+						      &found));
+
+	return 0;
+}
+DM_TEST(dm_test_fdt_seq_remove, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
 /* Test that we can find a device by device tree offset */
 static int dm_test_fdt_offset(struct dm_test_state *dms)
 {
@@ -266,3 +300,38 @@ static int dm_test_fdt_offset(struct dm_test_state *dms)
 	return 0;
 }
 DM_TEST(dm_test_fdt_offset, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+#ifdef CONFIG_DM_TIMING
+/* Test that devices are probed when first used, and that this is timed */
+static int dm_test_fdt_timing(struct dm_test_state *dms)
+{
+	struct driver *drv = lists_driver_lookup_name("testfdt_drv");
+	struct dm_timing *t = dm_timing_get(drv);
+	struct udevice *dev;
+	uint binds, probes;
+	struct uclass *uc;
+
+	ut_assert(t);
+	binds = t->binds;
+	probes = t->probes;
+	ut_assertok(dm_scan_fdt(gd->fdt_blob, false));
+	ut_assert(t->binds > binds);
+
+	/* Binding probes nothing */
+	ut_assertok(uclass_get(UCLASS_TEST_FDT, &uc));
+	list_for_each_entry(dev, &uc->dev_head, uclass_node)
+		ut_assert(!device_active(dev));
+	ut_asserteq(probes, t->probes);
+
+	/* Only the device asked for is probed, and only once */
+	ut_assertok(uclass_get_device(UCLASS_TEST_FDT, 1, &dev));
+	ut_asserteq(probes + 1, t->probes);
+	ut_assertok(uclass_get_device(UCLASS_TEST_FDT, 1, &dev));
+	ut_asserteq(probes + 1, t->probes);
+	ut_assertok(uclass_find_device(UCLASS_TEST_FDT, 2, &dev));
+	ut_assert(!device_active(dev));
+
+	return 0;
+}
+DM_TEST(dm_test_fdt_timing, 0);
+#endif
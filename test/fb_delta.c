@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <errno.h>
+#include <fb_delta.h>
+#include <hash.h>
+#include <malloc.h>
+#include <part.h>
+
+/*
+ * The partition starts after the first 16 blocks of host device 0, which
+ * must be bound to a file of at least 8 MiB first ('sb bind 0 <file>').
+ */
+#define PART_START	16
+#define PART_BLOCKS	0x3000
+#define CHUNK_SIZE	0x10000
+#define IMAGE_SIZE	(0x500000 - 3 * 512)	/* the last chunk is short */
+#define CHUNK_COUNT	DIV_ROUND_UP(IMAGE_SIZE, CHUNK_SIZE)
+#define MANIFEST_SIZE	(sizeof(struct fb_delta_header) + \
+			 CHUNK_COUNT * FB_DELTA_DIGEST_SIZE)
+#define BUF_SIZE	(4 * CHUNK_SIZE)
+
+/* Chunks changed in the new image, and the map that describes them */
+static const unsigned int changed[] = { 0, 7, 8, 40, CHUNK_COUNT - 1 };
+#define CHANGED_MAP	"81800000008000000001"
+
+static u32 seed;
+
+static u32 test_rand(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+static unsigned int chunk_len(unsigned int chunk)
+{
+	return min_t(unsigned int, CHUNK_SIZE, IMAGE_SIZE - chunk * CHUNK_SIZE);
+}
+
+static void *make_manifest(const u8 *image)
+{
+	struct fb_delta_header *hdr;
+	u8 *digest;
+	int i;
+
+	hdr = malloc(MANIFEST_SIZE);
+	if (!hdr)
+		return NULL;
+	hdr->magic = cpu_to_le32(FB_DELTA_MANIFEST_MAGIC);
+	hdr->chunk_size = cpu_to_le32(CHUNK_SIZE);
+	hdr->chunk_count = cpu_to_le32(CHUNK_COUNT);
+	hdr->first = 0;
+	hdr->image_size = cpu_to_le64(IMAGE_SIZE);
+
+	digest = (u8 *)(hdr + 1);
+	for (i = 0; i < CHUNK_COUNT; i++, digest += FB_DELTA_DIGEST_SIZE)
+		hash_block("sha256", image + i * CHUNK_SIZE, chunk_len(i),
+			   digest, NULL);
+
+	return hdr;
+}
+
+/* Send chunks @first .. @first + @n - 1 of @image, as the host would */
+static int send_chunks(block_dev_desc_t *dev_desc, disk_partition_t *info,
+		       u8 *buf, const u8 *image, unsigned int first,
+		       unsigned int n)
+{
+	struct fb_delta_header *hdr = (void *)buf;
+	unsigned int len = 0;
+	int i;
+
+	for (i = first; i < first + n; i++)
+		len += chunk_len(i);
+	hdr->magic = cpu_to_le32(FB_DELTA_CHUNKS_MAGIC);
+	hdr->chunk_size = cpu_to_le32(CHUNK_SIZE);
+	hdr->chunk_count = cpu_to_le32(n);
+	hdr->first = cpu_to_le32(first);
+	hdr->image_size = cpu_to_le64(IMAGE_SIZE);
+	memcpy(hdr + 1, image + first * CHUNK_SIZE, len);
+
+	return fb_delta_write(dev_desc, info, buf, sizeof(*hdr) + len);
+}
+
+static int check_map(const char *expect)
+{
+	char str[60];
+
+	if (fb_delta_map(0, str, sizeof(str)) || strcmp(str, expect)) {
+		printf(" map %s, expected %s\n", str, expect);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int run_test(block_dev_desc_t *dev_desc, u8 *image, u8 *buf)
+{
+	disk_partition_t info, other;
+	void *manifest;
+	int ret, i;
+
+	memset(&info, 0, sizeof(info));
+	info.start = PART_START;
+	info.size = PART_BLOCKS;
+	info.blksz = dev_desc->blksz;
+	other = info;
+	other.start += PART_BLOCKS;
+
+	/* The old image on the partition, then the new one */
+	for (i = 0; i < IMAGE_SIZE; i++)
+		image[i] = test_rand();
+	if (dev_desc->block_write(dev_desc->dev, info.start,
+				  IMAGE_SIZE / info.blksz, image) !=
+	    IMAGE_SIZE / info.blksz)
+		return -1;
+	for (i = 0; i < ARRAY_SIZE(changed); i++) {
+		unsigned int chunk = changed[i];
+
+		image[chunk * CHUNK_SIZE + chunk_len(chunk) - 1] ^= 1;
+	}
+
+	manifest = make_manifest(image);
+	if (!manifest)
+		return -1;
+	memcpy(buf, manifest, MANIFEST_SIZE);
+	free(manifest);
+
+	/* The manifest is read from the buffer that is then reused */
+	ret = fb_delta_check(dev_desc, &info, buf, MANIFEST_SIZE, buf,
+			     BUF_SIZE);
+	if (ret != ARRAY_SIZE(changed)) {
+		printf(" %d chunks differ, expected %d\n", ret,
+		       (int)ARRAY_SIZE(changed));
+		return -1;
+	}
+	if (check_map(CHANGED_MAP))
+		return -1;
+
+	/* A corrupt chunk, or one for another partition, is not written */
+	image[7 * CHUNK_SIZE] ^= 0x80;
+	ret = send_chunks(dev_desc, &info, buf, image, 7, 2);
+	image[7 * CHUNK_SIZE] ^= 0x80;
+	if (ret != -EBADMSG || check_map(CHANGED_MAP)) {
+		printf(" corrupt chunk: %d\n", ret);
+		return -1;
+	}
+	ret = send_chunks(dev_desc, &other, buf, image, 0, 1);
+	if (ret != -ENOENT) {
+		printf(" other partition: %d\n", ret);
+		return -1;
+	}
+
+	ret = send_chunks(dev_desc, &info, buf, image, 0, 1);
+	ret |= send_chunks(dev_desc, &info, buf, image, 7, 2);
+	ret |= send_chunks(dev_desc, &info, buf, image, 40, 1);
+	ret |= send_chunks(dev_desc, &info, buf, image, CHUNK_COUNT - 1, 1);
+	if (ret || check_map("00000000000000000000"))
+		return -1;
+
+	/* The partition now holds the new image */
+	for (i = 0; i < IMAGE_SIZE; i += BUF_SIZE) {
+		unsigned int len = min(BUF_SIZE, IMAGE_SIZE - i);
+
+		if (dev_desc->block_read(dev_desc->dev, info.start +
+					 i / info.blksz, len / info.blksz,
+					 buf) != len / info.blksz ||
+		    memcmp(buf, image + i, len)) {
+			printf(" data differs near %#x\n", i);
+			return -1;
+		}
+	}
+
+	manifest = make_manifest(image);
+	if (!manifest)
+		return -1;
+	ret = fb_delta_check(dev_desc, &info, manifest, MANIFEST_SIZE, buf,
+			     BUF_SIZE);
+	free(manifest);
+	if (ret) {
+		printf(" %d chunks differ after writing\n", ret);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int do_ut_fb_delta(cmd_tbl_t *cmdtp, int flag, int argc,
+			  char *const argv[])
+{
+	block_dev_desc_t *dev_desc;
+	u8 *image, *buf;
+	int ret = -1;
+
+	dev_desc = host_get_dev(0);
+	if (!dev_desc || dev_desc->lba < PART_START + PART_BLOCKS) {
+		printf("Bind host device 0 to a file of 8 MiB first\n");
+		return CMD_RET_FAILURE;
+	}
+
+	seed = 1;
+	image = malloc(IMAGE_SIZE);
+	buf = malloc(BUF_SIZE + sizeof(struct fb_delta_header));
+	if (image && buf)
+		ret = run_test(dev_desc, image, buf);
+	free(image);
+	free(buf);
+
+	printf("ut_fb_delta %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_fb_delta,	1,	1,	do_ut_fb_delta,
+	"Check fastboot delta flashing on host device 0", ""
+);
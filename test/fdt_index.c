@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <libfdt.h>
+#include <malloc.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/*
+ * A tree shaped like an SoC device tree: devices under /soc, some with
+ * ports, most with a phandle and all with two compatible strings. Lookups
+ * in an indexed copy must give the same results as in one without.
+ */
+#define DEVICES		600
+#define COMPATS		16
+#define FDT_SIZE	0x40000
+#define PATH_LEN	64
+
+static int make_tree(void *fdt)
+{
+	char name[32], compat[32];
+	int i, len, ret;
+
+	ret = fdt_create(fdt, FDT_SIZE);
+	ret |= fdt_finish_reservemap(fdt);
+	ret |= fdt_begin_node(fdt, "");
+	ret |= fdt_property_string(fdt, "compatible", "test,root");
+	ret |= fdt_begin_node(fdt, "soc");
+	for (i = 0; i < DEVICES; i++) {
+		snprintf(name, sizeof(name), "dev@%x", 0xe6000000 + i * 0x1000);
+		len = snprintf(compat, sizeof(compat), "test,dev-%d",
+			       i % COMPATS) + 1;
+		strcpy(compat + len, "test,common");
+		len += strlen("test,common") + 1;
+
+		ret |= fdt_begin_node(fdt, name);
+		ret |= fdt_property(fdt, "compatible", compat, len);
+		ret |= fdt_property_u32(fdt, "reg", 0xe6000000 + i * 0x1000);
+		if (i % 7)
+			ret |= fdt_property_u32(fdt, "phandle", i + 1);
+		if (!(i % 4)) {
+			ret |= fdt_begin_node(fdt, "port@0");
+			ret |= fdt_end_node(fdt);
+			ret |= fdt_begin_node(fdt, "port@1");
+			ret |= fdt_end_node(fdt);
+		}
+		ret |= fdt_end_node(fdt);
+	}
+	ret |= fdt_end_node(fdt);
+	ret |= fdt_end_node(fdt);
+	ret |= fdt_finish(fdt);
+
+	return ret;
+}
+
+static void compat_name(char *compat, int len, int i)
+{
+	if (i < COMPATS)
+		snprintf(compat, len, "test,dev-%d", i);
+	else
+		strcpy(compat, i == COMPATS ? "test,common" : "test,none");
+}
+
+/* Look everything up in @fdt, comparing with @ref if it is not NULL */
+static int lookup_all(const void *fdt, const void *ref)
+{
+	char path[PATH_LEN], compat[32], *at;
+	int offset, expect, i;
+
+	for (offset = 0; offset >= 0; offset = fdt_next_node(fdt, offset,
+							      NULL)) {
+		if (fdt_get_path(fdt, offset, path, sizeof(path)))
+			return -1;
+		if (fdt_path_offset(fdt, path) != offset) {
+			printf(" path %s\n", path);
+			return -1;
+		}
+		/* Without the unit address the first match is found */
+		at = strrchr(path, '@');
+		if (at && ref) {
+			*at = '\0';
+			if (fdt_path_offset(fdt, path) !=
+			    fdt_path_offset(ref, path)) {
+				printf(" path %s\n", path);
+				return -1;
+			}
+		}
+	}
+
+	for (i = 0; i <= DEVICES + 1; i++) {
+		offset = fdt_node_offset_by_phandle(fdt, i);
+		expect = ref ? fdt_node_offset_by_phandle(ref, i) : offset;
+		if (offset != expect) {
+			printf(" phandle %d: %d, expected %d\n", i, offset,
+			       expect);
+			return -1;
+		}
+	}
+
+	for (i = 0; i <= COMPATS + 1; i++) {
+		compat_name(compat, sizeof(compat), i);
+		offset = expect = -1;
+		do {
+			offset = fdt_node_offset_by_compatible(fdt, offset,
+							       compat);
+			if (ref)
+				expect = fdt_node_offset_by_compatible(ref,
+							expect, compat);
+			else
+				expect = offset;
+			if (offset != expect) {
+				printf(" %s: %d, expected %d\n", compat, offset,
+				       expect);
+				return -1;
+			}
+		} while (offset >= 0);
+	}
+
+	return 0;
+}
+
+/* Time the lookups a driver model scan of the tree would make */
+static ulong time_lookups(const void *fdt)
+{
+	char path[PATH_LEN], compat[32];
+	ulong start = timer_get_us();
+	int offset, i;
+
+	for (i = 0; i < DEVICES; i++) {
+		snprintf(path, sizeof(path), "/soc/dev@%x/port@1",
+			 0xe6000000 + i * 0x1000);
+		fdt_path_offset(fdt, path);
+		fdt_node_offset_by_phandle(fdt, i + 1);
+	}
+	for (i = 0; i <= COMPATS; i++) {
+		compat_name(compat, sizeof(compat), i);
+		offset = -1;
+		do {
+			offset = fdt_node_offset_by_compatible(fdt, offset,
+							       compat);
+		} while (offset >= 0);
+	}
+
+	return timer_get_us() - start;
+}
+
+static int run_test(void *fdt, void *ref)
+{
+	ulong start, scan, indexed;
+	int offset, ret;
+
+	ret = make_tree(fdt);
+	if (!ret)
+		ret = fdt_open_into(fdt, fdt, FDT_SIZE);
+	if (ret) {
+		printf(" make_tree: %s\n", fdt_strerror(ret));
+		return -1;
+	}
+	memcpy(ref, fdt, FDT_SIZE);
+
+	start = timer_get_us();
+	ret = fdt_index_build(fdt);
+	printf(" %d byte tree indexed in %lu us\n", fdt_totalsize(fdt),
+	       timer_get_us() - start);
+	if (ret || lookup_all(fdt, ref))
+		return -1;
+
+	/* Names without a unit address, and ones which are not there */
+	if (fdt_path_offset(fdt, "/soc/dev/port") !=
+	    fdt_path_offset(fdt, "/soc/dev@e6000000/port@0") ||
+	    fdt_path_offset(fdt, "/soc/dev@e6000000/port@2") !=
+	    -FDT_ERR_NOTFOUND || fdt_path_offset(fdt, "/soc/dev@e6") !=
+	    -FDT_ERR_NOTFOUND || fdt_path_offset(fdt, "/port@0") !=
+	    -FDT_ERR_NOTFOUND) {
+		printf(" unit address lookups\n");
+		return -1;
+	}
+
+	scan = time_lookups(ref);
+	indexed = time_lookups(fdt);
+	printf(" lookups: %lu us scanning, %lu us indexed\n", scan, indexed);
+
+	/* A change moves the nodes after it, and drops the index */
+	offset = fdt_path_offset(fdt, "/soc/dev@e6000000");
+	ret = fdt_setprop_string(fdt, offset, "status", "okay");
+	if (ret) {
+		printf(" setprop: %s\n", fdt_strerror(ret));
+		return -1;
+	}
+	if (lookup_all(fdt, NULL))
+		return -1;
+
+	return 0;
+}
+
+static int do_ut_fdt_index(cmd_tbl_t *cmdtp, int flag, int argc,
+			   char *const argv[])
+{
+	void *fdt, *ref;
+	int ret = -1;
+
+	fdt = malloc(FDT_SIZE);
+	ref = malloc(FDT_SIZE);
+	if (fdt && ref)
+		ret = run_test(fdt, ref);
+	fdt_index_free();
+	free(fdt);
+	free(ref);
+
+	/* Put back the index of the control tree */
+	if (gd->fdt_blob)
+		fdt_index_build(gd->fdt_blob);
+
+	printf("ut_fdt_index %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_fdt_index,	1,	1,	do_ut_fdt_index,
+	"Check the libfdt lookup index against scanning the tree", ""
+);
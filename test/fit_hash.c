@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <image.h>
+#include <jobs.h>
+#include <libfdt.h>
+#include <malloc.h>
+#include <asm/io.h>
+#include <u-boot/sha256.h>
+
+#define FIT_ADDR	0x1000000
+#define FIT_SIZE	0x200000
+#define KERNEL_SIZE	0x40000
+#define RAMDISK_SIZE	0x80000
+#define SEGMENT_SIZE	0x10000
+
+static void fill(uint8_t *buf, int size)
+{
+	uint32_t x = 1;
+	int i;
+
+	for (i = 0; i < size; i++) {
+		x = x * 1103515245 + 12345;
+		buf[i] = x >> 16;
+	}
+}
+
+/* The tree hash worked out the slow way */
+static void segment_sha256(const uint8_t *data, int size, uint8_t *value)
+{
+	uint8_t list[(RAMDISK_SIZE / SEGMENT_SIZE) * SHA256_SUM_LEN];
+	int count = 0, pos;
+
+	for (pos = 0; pos < size; pos += SEGMENT_SIZE, count++) {
+		sha256_csum_wd(data + pos, min(size - pos, SEGMENT_SIZE),
+			       list + count * SHA256_SUM_LEN, CHUNKSZ_SHA256);
+	}
+	sha256_csum_wd(list, count * SHA256_SUM_LEN, value, CHUNKSZ_SHA256);
+}
+
+static int add_image(void *fit, const char *name, const char *type,
+		     const uint8_t *data, int size, ulong segment_size)
+{
+	uint8_t value[FIT_MAX_HASH_LEN];
+	int node, hash, value_len;
+
+	node = fdt_add_subnode(fit, fdt_path_offset(fit, FIT_IMAGES_PATH),
+			       name);
+	if (node < 0)
+		return node;
+	fdt_setprop(fit, node, FIT_DATA_PROP, data, size);
+	fdt_setprop_string(fit, node, FIT_TYPE_PROP, type);
+	fdt_setprop_string(fit, node, FIT_ARCH_PROP, "sandbox");
+	fdt_setprop_string(fit, node, FIT_OS_PROP, "linux");
+	fdt_setprop_string(fit, node, FIT_COMP_PROP, "none");
+	if (!strcmp(type, "kernel"))
+		fdt_setprop_u32(fit, node, FIT_LOAD_PROP, 0);
+
+	hash = fdt_add_subnode(fit, node, "hash@1");
+	fdt_setprop_string(fit, hash, FIT_ALGO_PROP, "sha1");
+	calculate_hash(data, size, "sha1", value, &value_len);
+	fdt_setprop(fit, hash, FIT_VALUE_PROP, value, value_len);
+
+	if (segment_size) {
+		hash = fdt_add_subnode(fit, node, "hash@2");
+		fdt_setprop_string(fit, hash, FIT_ALGO_PROP, "sha256");
+		fdt_setprop_u32(fit, hash, FIT_SEGMENT_SIZE_PROP,
+				segment_size);
+		segment_sha256(data, size, value);
+		fdt_setprop(fit, hash, FIT_VALUE_PROP, value, SHA256_SUM_LEN);
+	}
+
+	return 0;
+}
+
+static int make_fit(void *fit, uint8_t *buf)
+{
+	int node, ret;
+
+	fill(buf, RAMDISK_SIZE);
+	ret = fdt_create_empty_tree(fit, FIT_SIZE);
+	if (ret)
+		return ret;
+	fdt_setprop_string(fit, 0, FIT_DESC_PROP, "hash test");
+	fdt_setprop_u32(fit, 0, FIT_TIMESTAMP_PROP, 0);
+	fdt_add_subnode(fit, 0, "images");
+	ret = add_image(fit, "kernel@1", "kernel", buf, KERNEL_SIZE, 0);
+	if (!ret)
+		ret = add_image(fit, "ramdisk@1", "ramdisk", buf + KERNEL_SIZE,
+				RAMDISK_SIZE - KERNEL_SIZE, SEGMENT_SIZE);
+	if (ret)
+		return ret;
+
+	node = fdt_add_subnode(fit, 0, "configurations");
+	fdt_setprop_string(fit, node, FIT_DEFAULT_PROP, "conf@1");
+	node = fdt_add_subnode(fit, node, "conf@1");
+	fdt_setprop_string(fit, node, FIT_KERNEL_PROP, "kernel@1");
+	fdt_setprop_string(fit, node, FIT_RAMDISK_PROP, "ramdisk@1");
+
+	return fdt_pack(fit);
+}
+
+static int image_data(void *fit, const char *name, const void **datap,
+		      size_t *sizep)
+{
+	return fit_image_get_data(fit, fit_image_get_node(fit, name), datap,
+				  sizep);
+}
+
+static int load(ulong addr, int type)
+{
+	bootm_headers_t images;
+	const char *conf = "conf@1";
+	ulong data, len;
+
+	memset(&images, '\0', sizeof(images));
+	images.verify = 1;
+
+	return fit_image_load(&images, addr, NULL, &conf, IH_ARCH_SANDBOX,
+			      type, BOOTSTAGE_ID_FIT_KERNEL_START,
+			      type == IH_TYPE_KERNEL ? FIT_LOAD_REQUIRED :
+			      FIT_LOAD_IGNORED, &data, &len);
+}
+
+static int run_test(void)
+{
+	uint8_t value[FIT_MAX_HASH_LEN], expect[SHA256_SUM_LEN];
+	const void *data;
+	uint8_t *buf;
+	size_t size;
+	void *fit;
+	int value_len, node;
+	int ret = -1;
+
+	buf = malloc(RAMDISK_SIZE);
+	fit = map_sysmem(FIT_ADDR, FIT_SIZE);
+	if (!buf || make_fit(fit, buf))
+		goto out;
+
+	/* The tree hash, spread over the CPUs, matches the slow way */
+	printf(" %d secondary CPUs\n", jobs_cpus());
+	segment_sha256(buf, RAMDISK_SIZE, expect);
+	if (calculate_segment_hash(buf, RAMDISK_SIZE, SEGMENT_SIZE, "sha256",
+				   value, &value_len) ||
+	    value_len != SHA256_SUM_LEN || memcmp(value, expect, value_len))
+		goto out;
+
+	/* A last segment which is short, and no segments at all */
+	segment_sha256(buf, RAMDISK_SIZE - 5, expect);
+	if (calculate_segment_hash(buf, RAMDISK_SIZE - 5, SEGMENT_SIZE,
+				   "sha256", value, &value_len) ||
+	    memcmp(value, expect, value_len))
+		goto out;
+	segment_sha256(buf, 0, expect);
+	if (calculate_segment_hash(buf, 0, SEGMENT_SIZE, "sha256", value,
+				   &value_len) || memcmp(value, expect, value_len))
+		goto out;
+	if (!calculate_segment_hash(buf, 16, SEGMENT_SIZE, "none", value,
+				    &value_len))
+		goto out;
+
+	if (!fit_all_image_verify(fit))
+		goto out;
+
+	/*
+	 * The kernel is loaded over the ramdisk after the ramdisk's hashes
+	 * have been started ahead; the ramdisk must then fail
+	 */
+	if (image_data(fit, "ramdisk@1", &data, &size))
+		goto out;
+	node = fit_image_get_node(fit, "kernel@1");
+	fdt_setprop_inplace_u32(fit, node, FIT_LOAD_PROP,
+				map_to_sysmem((void *)data));
+	if (load(FIT_ADDR, IH_TYPE_KERNEL) < 0)
+		goto out;
+	if (load(FIT_ADDR, IH_TYPE_RAMDISK) != -EACCES)
+		goto out;
+
+	/* With the data back, the ramdisk checks out again */
+	memcpy((void *)data, buf + KERNEL_SIZE, size);
+	if (load(FIT_ADDR, IH_TYPE_RAMDISK) < 0)
+		goto out;
+
+	/* A bad segment size is an error, not a plain hash */
+	node = fdt_subnode_offset(fit, fit_image_get_node(fit, "ramdisk@1"),
+				  "hash@2");
+	fdt_setprop_inplace_u32(fit, node, FIT_SEGMENT_SIZE_PROP, 0);
+	if (fit_all_image_verify(fit))
+		goto out;
+
+	ret = 0;
+out:
+	fit_image_hash_flush();
+	unmap_sysmem(fit);
+	free(buf);
+
+	return ret;
+}
+
+static int do_ut_fit_hash(cmd_tbl_t *cmdtp, int flag, int argc,
+			  char *const argv[])
+{
+	int ret;
+
+	ret = run_test();
+	printf("ut_fit_hash %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_fit_hash,	1,	1,	do_ut_fit_hash,
+	"Check FIT hashes over segments and on other CPUs", ""
+);
@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <hash.h>
+#include <image.h>
+#include <libfdt.h>
+#include <malloc.h>
+#include <os.h>
+#include <asm/io.h>
+#include <u-boot/crc.h>
+#include <u-boot/sha256.h>
+
+#define BUF_SIZE	0x10000
+#define CHUNK_SIZE	0x1000
+#define LOAD_ADDR	0x1000000
+#define FILE_NAME	"/tmp/u-boot-hash-read.bin"
+
+static void fill(uint8_t *buf, int size, uint32_t x)
+{
+	int i;
+
+	for (i = 0; i < size; i++) {
+		x = x * 1103515245 + 12345;
+		buf[i] = x >> 16;
+	}
+}
+
+/* Hash a read of @buf, whose chunks arrive in the order given */
+static int read_chunks(const char *algo, uint8_t *buf, const int *order,
+		       int count)
+{
+	int i;
+
+	if (hash_read_start(algo, buf))
+		return -1;
+	for (i = 0; i < count; i++)
+		hash_read_data(buf + order[i] * CHUNK_SIZE, CHUNK_SIZE);
+
+	return 0;
+}
+
+static int check_sha256(uint8_t *buf, ulong len)
+{
+	uint8_t expect[SHA256_SUM_LEN], value[SHA256_SUM_LEN];
+	int value_len;
+
+	sha256_csum_wd(buf, len, expect, CHUNKSZ_SHA256);
+	if (hash_read_lookup("sha256", buf, len, value, &value_len) ||
+	    value_len != SHA256_SUM_LEN || memcmp(value, expect, value_len))
+		return -1;
+
+	return 0;
+}
+
+static int test_chunks(uint8_t *buf)
+{
+	static const int in_order[] = { 0, 1, 2, 3 };
+	static const int out_of_order[] = { 0, 2, 1, 3 };
+	static const int again[] = { 0, 1, 0, 2, 3 };
+	uint8_t expect[SHA256_SUM_LEN], value[SHA256_SUM_LEN];
+	uint32_t crc;
+	int i;
+
+	/* Chunks in order are hashed as they arrive, not from memory */
+	fill(buf, BUF_SIZE, 1);
+	sha256_csum_wd(buf, 4 * CHUNK_SIZE, expect, CHUNKSZ_SHA256);
+	if (read_chunks("sha256", buf, in_order, ARRAY_SIZE(in_order)))
+		return -1;
+	buf[0] ^= 1;
+	if (hash_read_finish(4 * CHUNK_SIZE) ||
+	    hash_read_lookup("sha256", buf, 4 * CHUNK_SIZE, value, NULL) ||
+	    memcmp(value, expect, SHA256_SUM_LEN))
+		return -1;
+
+	/* Anything out of order is picked up from memory */
+	fill(buf, BUF_SIZE, 2);
+	if (read_chunks("sha256", buf, out_of_order,
+			ARRAY_SIZE(out_of_order)) ||
+	    hash_read_finish(4 * CHUNK_SIZE) ||
+	    check_sha256(buf, 4 * CHUNK_SIZE))
+		return -1;
+
+	/* So is everything once a chunk has been read again */
+	fill(buf, BUF_SIZE, 3);
+	if (read_chunks("sha256", buf, again, 2))
+		return -1;
+	fill(buf, CHUNK_SIZE, 4);
+	for (i = 2; i < ARRAY_SIZE(again); i++)
+		hash_read_data(buf + again[i] * CHUNK_SIZE, CHUNK_SIZE);
+	if (hash_read_finish(4 * CHUNK_SIZE) ||
+	    check_sha256(buf, 4 * CHUNK_SIZE))
+		return -1;
+
+	/* And when more was read than is wanted */
+	if (read_chunks("sha256", buf, in_order, ARRAY_SIZE(in_order)) ||
+	    hash_read_finish(3 * CHUNK_SIZE + 5) ||
+	    check_sha256(buf, 3 * CHUNK_SIZE + 5))
+		return -1;
+
+	/* crc32 comes out the same way as from hash_block() */
+	if (read_chunks("crc32", buf, in_order, ARRAY_SIZE(in_order)) ||
+	    hash_read_finish(4 * CHUNK_SIZE))
+		return -1;
+	crc32_wd_buf(buf, 4 * CHUNK_SIZE, (uint8_t *)&crc, CHUNKSZ_CRC32);
+	if (hash_read_lookup("crc32", buf, 4 * CHUNK_SIZE, value, NULL) ||
+	    memcmp(value, &crc, sizeof(crc)))
+		return -1;
+
+	/* Only the same data with the same algorithm has a digest */
+	if (!hash_read_lookup("sha256", buf, 4 * CHUNK_SIZE, value, NULL) ||
+	    !hash_read_lookup("crc32", buf, 4 * CHUNK_SIZE - 1, value, NULL) ||
+	    !hash_read_lookup("crc32", buf + 1, 4 * CHUNK_SIZE, value, NULL))
+		return -1;
+
+	/* Reading next to the data keeps the digest */
+	hash_read_data(buf + 4 * CHUNK_SIZE, CHUNK_SIZE);
+	if (hash_read_lookup("crc32", buf, 4 * CHUNK_SIZE, value, NULL))
+		return -1;
+
+	/* Reading over the data, or changing it, drops the digest */
+	hash_read_data(buf + CHUNK_SIZE, 1);
+	if (!hash_read_lookup("crc32", buf, 4 * CHUNK_SIZE, value, NULL))
+		return -1;
+	if (read_chunks("crc32", buf, in_order, ARRAY_SIZE(in_order)) ||
+	    hash_read_finish(4 * CHUNK_SIZE))
+		return -1;
+	hash_read_drop(buf + 4 * CHUNK_SIZE - 1, 1);
+	if (!hash_read_lookup("crc32", buf, 4 * CHUNK_SIZE, value, NULL))
+		return -1;
+
+	/* Nothing is kept for a read which is stopped or never hashed */
+	if (read_chunks("sha256", buf, in_order, ARRAY_SIZE(in_order)))
+		return -1;
+	hash_read_stop();
+	if (hash_read_finish(4 * CHUNK_SIZE) != -ENOENT ||
+	    !hash_read_lookup("sha256", buf, 4 * CHUNK_SIZE, value, NULL))
+		return -1;
+	if (hash_read_start("none", buf) != -EPROTONOSUPPORT)
+		return -1;
+
+	return 0;
+}
+
+static int write_file(const uint8_t *buf, int size)
+{
+	int fd, ret;
+
+	os_unlink(FILE_NAME);
+	fd = os_open(FILE_NAME, OS_O_WRONLY | OS_O_CREAT);
+	if (fd < 0)
+		return -1;
+	ret = os_write(fd, buf, size) != size;
+	os_close(fd);
+
+	return ret ? -1 : 0;
+}
+
+static int test_load(uint8_t *buf)
+{
+	uint8_t *addr;
+	char cmd[80];
+	int ret = 0;
+
+	fill(buf, BUF_SIZE, 5);
+	if (write_file(buf, BUF_SIZE))
+		return -1;
+
+	/* The digest of the file is ready once it is loaded */
+	setenv("loadhash", "sha256");
+	snprintf(cmd, sizeof(cmd), "load hostfs - %x %s", LOAD_ADDR,
+		 FILE_NAME);
+	addr = map_sysmem(LOAD_ADDR, BUF_SIZE);
+	if (run_command(cmd, 0) || check_sha256(addr, BUF_SIZE))
+		ret = -1;
+
+	/* A later hash command uses it rather than the data in memory */
+	addr[0] ^= 1;
+	snprintf(cmd, sizeof(cmd), "hash sha256 %x %x sum", LOAD_ADDR,
+		 BUF_SIZE);
+	if (!ret && (run_command(cmd, 0) ||
+		     strcmp(getenv("sum"), getenv("loadsum"))))
+		ret = -1;
+	addr[0] ^= 1;
+
+	/* Changing the data with a command forgets it */
+	snprintf(cmd, sizeof(cmd), "mw.b %x 0 1; hash -v sha256 %x %x $loadsum",
+		 LOAD_ADDR + BUF_SIZE - 1, LOAD_ADDR, BUF_SIZE);
+	if (!ret && (!run_command(cmd, 0) ||
+		     !hash_read_lookup("sha256", addr, BUF_SIZE, buf, NULL)))
+		ret = -1;
+
+	/* A failed load leaves no digest behind */
+	snprintf(cmd, sizeof(cmd), "load hostfs - %x %s", LOAD_ADDR,
+		 FILE_NAME);
+	if (!ret && (run_command(cmd, 0) || !getenv("loadsum")))
+		ret = -1;
+	snprintf(cmd, sizeof(cmd), "load hostfs - %x %s.none", LOAD_ADDR,
+		 FILE_NAME);
+	if (!ret && (!run_command(cmd, 0) || getenv("loadsum")))
+		ret = -1;
+
+	/* Nor does a load without the variable, which hashes nothing */
+	snprintf(cmd, sizeof(cmd), "load hostfs - %x %s", LOAD_ADDR,
+		 FILE_NAME);
+	if (!ret && run_command(cmd, 0))
+		ret = -1;
+	setenv("loadhash", NULL);
+	if (!ret && (run_command(cmd, 0) || getenv("loadsum") ||
+		     !hash_read_lookup("sha256", addr, BUF_SIZE, buf, NULL)))
+		ret = -1;
+
+	unmap_sysmem(addr);
+	setenv("sum", NULL);
+	os_unlink(FILE_NAME);
+
+	return ret;
+}
+
+/* Build a FIT with one image of @size bytes, with its SHA256 in it */
+static int make_fit(uint8_t *fit, int fit_size, const uint8_t *data, int size)
+{
+	uint8_t value[SHA256_SUM_LEN];
+
+	sha256_csum_wd(data, size, value, CHUNKSZ_SHA256);
+	if (fdt_create(fit, fit_size) ||
+	    fdt_finish_reservemap(fit) ||
+	    fdt_begin_node(fit, "") ||
+	    fdt_begin_node(fit, FIT_IMAGES_PATH + 1) ||
+	    fdt_begin_node(fit, "kernel@1") ||
+	    fdt_property(fit, FIT_DATA_PROP, data, size) ||
+	    fdt_begin_node(fit, FIT_HASH_NODENAME "@1") ||
+	    fdt_property_string(fit, FIT_ALGO_PROP, "sha256") ||
+	    fdt_property(fit, FIT_VALUE_PROP, value, sizeof(value)) ||
+	    fdt_end_node(fit) ||
+	    fdt_end_node(fit) ||
+	    fdt_end_node(fit) ||
+	    fdt_end_node(fit) ||
+	    fdt_finish(fit))
+		return -1;
+
+	return 0;
+}
+
+static int test_fit(uint8_t *buf)
+{
+	const int fit_size = BUF_SIZE / 2;
+	const void *data;
+	uint8_t *addr;
+	char cmd[80];
+	int noffset, size, ret = 0;
+
+	fill(buf + fit_size, 2 * CHUNK_SIZE, 6);
+	if (make_fit(buf, fit_size, buf + fit_size, 2 * CHUNK_SIZE) ||
+	    write_file(buf, fdt_totalsize(buf)))
+		return -1;
+
+	setenv("loadhash", "sha256");
+	snprintf(cmd, sizeof(cmd), "load hostfs - %x %s", LOAD_ADDR,
+		 FILE_NAME);
+	addr = map_sysmem(LOAD_ADDR, fit_size);
+	noffset = -1;
+	if (!run_command(cmd, 0))
+		noffset = fdt_path_offset(addr, FIT_IMAGES_PATH "/kernel@1");
+	data = noffset < 0 ? NULL : fdt_getprop(addr, noffset, FIT_DATA_PROP,
+						&size);
+	if (!data || check_sha256((uint8_t *)data, size))
+		ret = -1;
+
+	/* The image is checked against the digest taken as it was read */
+	if (!ret) {
+		((uint8_t *)data)[0] ^= 1;
+		if (!fit_image_verify(addr, noffset))
+			ret = -1;
+		((uint8_t *)data)[0] ^= 1;
+	}
+
+	/* Until a command changes it */
+	snprintf(cmd, sizeof(cmd), "mw.b %lx 0 1",
+		 (ulong)map_to_sysmem(data) + size - 1);
+	if (!ret && (run_command(cmd, 0) || fit_image_verify(addr, noffset)))
+		ret = -1;
+
+	unmap_sysmem(addr);
+	setenv("loadhash", NULL);
+	os_unlink(FILE_NAME);
+
+	return ret;
+}
+
+static int do_ut_hash_read(cmd_tbl_t *cmdtp, int flag, int argc,
+			   char *const argv[])
+{
+	uint8_t *buf;
+	int ret = -1;
+
+	buf = malloc(BUF_SIZE);
+	if (buf)
+		ret = test_chunks(buf);
+	if (!ret)
+		ret = test_load(buf);
+	if (!ret)
+		ret = test_fit(buf);
+	hash_read_stop();
+	free(buf);
+	printf("ut_hash_read %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_hash_read,	1,	1,	do_ut_hash_read,
+	"Check hashing of data as it is read", ""
+);
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <errno.h>
+#include <jobs.h>
+#include <malloc.h>
+
+#define SLEEP_US	100000
+#define LOCK_LOOPS	2000
+#define MALLOC_LOOPS	2000
+
+static struct job_lock test_lock;
+static volatile int counter;
+
+static int sleep_job(void *arg)
+{
+	udelay(SLEEP_US);
+
+	return (long)arg;
+}
+
+/* Add to the counter the slow way, so that racing CPUs would lose counts */
+static int count_job(void *arg)
+{
+	int i, val;
+
+	for (i = 0; i < LOCK_LOOPS; i++) {
+		job_lock(&test_lock);
+		val = counter;
+		if (!(i % 100))
+			udelay(10);
+		counter = val + 1;
+		job_unlock(&test_lock);
+	}
+
+	return 0;
+}
+
+static int malloc_job(void *arg)
+{
+	void *ptr[8] = { NULL };
+	size_t size;
+	int i, slot;
+
+	for (i = 0; i < MALLOC_LOOPS; i++) {
+		slot = i % ARRAY_SIZE(ptr);
+		free(ptr[slot]);
+		size = 16 + (i * 37 + (long)arg) % 2000;
+		ptr[slot] = malloc(size);
+		if (!ptr[slot])
+			return -ENOMEM;
+		if (malloc_usable_size(ptr[slot]) < size)
+			return -EINVAL;
+		memset(ptr[slot], i, 16);
+	}
+	for (slot = 0; slot < ARRAY_SIZE(ptr); slot++)
+		free(ptr[slot]);
+
+	return 0;
+}
+
+static int nested_job(void *arg)
+{
+	struct job *inner = arg;
+
+	job_start(inner);
+
+	return job_wait(inner) == 7 ? job_cpu() : -1;
+}
+
+static int run_test(void)
+{
+	struct job jobs[JOB_MAX_CPUS + 2], inner;
+	struct mallinfo before;
+	int cpus = jobs_cpus();
+	ulong start, elapsed;
+	int i, ret;
+
+	printf(" %d secondary CPUs\n", cpus);
+	if (cpus < 2 || cpus > JOB_MAX_CPUS - 1)
+		return -1;
+
+	/* A job which was never started */
+	job_init(&jobs[0], "sleep", sleep_job, (void *)1L);
+	if (job_wait(&jobs[0]) != -ENOENT)
+		return -1;
+
+	/*
+	 * One job per CPU runs at once. With them all busy the next runs in
+	 * place, and the last goes to whichever CPU is free by then.
+	 */
+	start = timer_get_us();
+	for (i = 0; i < cpus + 2; i++) {
+		job_init(&jobs[i], "sleep", sleep_job, (void *)(long)i);
+		job_start(&jobs[i]);
+		if (!i && job_start(&jobs[0]) != -EBUSY)
+			return -1;
+	}
+	for (i = 0; i < cpus + 2; i++) {
+		ret = job_wait(&jobs[i]);
+		if (ret != i || (i < cpus && !jobs[i].cpu) ||
+		    (i == cpus && jobs[i].cpu)) {
+			printf(" job %d: returned %d on CPU %d\n", i, ret,
+			       jobs[i].cpu);
+			return -1;
+		}
+	}
+	elapsed = timer_get_us() - start;
+	printf(" %d jobs of %d us in %lu us\n", cpus + 2, SLEEP_US, elapsed);
+	if (elapsed >= 4 * SLEEP_US)
+		return -1;
+
+	/* Each secondary CPU ran one of them */
+	for (i = 0; i < cpus; i++) {
+		if (jobs[i].cpu < 1 || jobs[i].cpu > cpus)
+			return -1;
+		for (ret = 0; ret < i; ret++) {
+			if (jobs[ret].cpu == jobs[i].cpu)
+				return -1;
+		}
+	}
+
+	/* A job's own job runs on the same CPU */
+	job_init(&inner, "inner", sleep_job, (void *)7L);
+	job_init(&jobs[0], "nested", nested_job, &inner);
+	job_start(&jobs[0]);
+	ret = job_wait(&jobs[0]);
+	if (ret < 1 || ret != jobs[0].cpu || inner.cpu != ret) {
+		printf(" nested job on CPU %d\n", ret);
+		return -1;
+	}
+
+	/* The lock keeps every count, with the boot CPU joining in */
+	counter = 0;
+	for (i = 0; i < cpus; i++) {
+		job_init(&jobs[i], "count", count_job, NULL);
+		job_start(&jobs[i]);
+	}
+	count_job(NULL);
+	for (i = 0; i < cpus; i++)
+		job_wait(&jobs[i]);
+	if (counter != (cpus + 1) * LOCK_LOOPS) {
+		printf(" counter %d, expected %d\n", counter,
+		       (cpus + 1) * LOCK_LOOPS);
+		return -1;
+	}
+
+	/* Allocating on all CPUs at once, leaving the heap as it was */
+	before = mallinfo();
+	for (i = 0; i < cpus; i++) {
+		job_init(&jobs[i], "malloc", malloc_job, (void *)(long)i);
+		job_start(&jobs[i]);
+	}
+	ret = malloc_job((void *)99L);
+	for (i = 0; i < cpus; i++)
+		ret |= job_wait(&jobs[i]);
+	if (ret || mallinfo().uordblks != before.uordblks)
+		return -1;
+
+	return 0;
+}
+
+static int do_ut_jobs(cmd_tbl_t *cmdtp, int flag, int argc,
+		      char *const argv[])
+{
+	int ret;
+
+	ret = run_test();
+	printf("ut_jobs %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_jobs,	1,	1,	do_ut_jobs,
+	"Run jobs on secondary CPUs and check the results", ""
+);
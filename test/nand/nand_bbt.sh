@@ -0,0 +1,66 @@
+#!/bin/sh
+#
+# Copyright (C) 2015 Renesas Electronics Corporation
+#
+# SPDX-License-Identifier:	GPL-2.0+
+#
+
+# Bad block table test using the sandbox NAND simulator
+#
+# Usage: nand_bbt.sh
+#
+# Blocks marked bad by the simulator must be found by the scan and by
+# 'nand read' and 'ubi part', must be stored in the nand0bbt variable, and
+# a table read back from that variable must be used instead of a scan.
+
+BASE="$(dirname $0)/.."
+. $BASE/common.sh
+
+UBOOT=./${OUTPUT_DIR}/u-boot
+BAD="3,17,200"
+BBT_VAR="nand0bbt=20000:200:3,11,c8"
+
+work="$(mktemp -d)"
+trap 'rm -rf ${work}' EXIT
+tmp=${work}/bbt.log
+
+run() {
+	${UBOOT} --nand ${work}/nand.bin:size=64:bad=${BAD} -c "$1" 2>&1 |
+		tr -d '\r' >${tmp}
+}
+
+echo "NAND bad block table test using sandbox"
+echo
+[ -x ${UBOOT} ] || build_uboot
+
+echo "Scan with injected bad blocks"
+run "nand bad; printenv nand0bbt"
+for ofs in 00060000 00220000 01900000; do
+	grep -q "^  ${ofs}$" ${tmp} || fail "bad block ${ofs} not found"
+done
+grep -q "^${BBT_VAR}$" ${tmp} || fail "nand0bbt not set"
+
+echo "Skip bad blocks when reading"
+run "setenv nand0bbt ${BBT_VAR#*=}; nand read 1000000 40000 40000"
+grep -q "Skipping bad block 0x00060000" ${tmp} || fail "bad block read"
+
+echo "Table from the environment"
+run "setenv nand0bbt 20000:200:5; nand bad; mtdparts default; ubi part ubi"
+grep -q "^  000a0000$" ${tmp} || fail "table from nand0bbt not used"
+grep -q "^  00060000$" ${tmp} && fail "table from nand0bbt not used"
+grep -q "bad PEBs: 1," ${tmp} || fail "UBI does not use the table"
+
+echo "Marking a block bad"
+run "nand bad; nand markbad 40000; printenv nand0bbt"
+grep -q "^nand0bbt=20000:200:2,3,11,c8$" ${tmp} ||
+	fail "nand0bbt not updated"
+
+echo "Other geometry and scrub"
+run "setenv nand0bbt 20000:100:5; nand bad; nand scrub.chip -y;
+printenv nand0bbt"
+grep -q "Ignoring 'nand0bbt' for another geometry" ${tmp} ||
+	fail "stale nand0bbt used"
+grep -q "^  00060000$" ${tmp} || fail "no scan for stale nand0bbt"
+grep -q "nand0bbt\" not defined" ${tmp} || fail "nand0bbt kept by scrub"
+
+echo "Test passed"
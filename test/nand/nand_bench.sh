@@ -0,0 +1,116 @@
+#!/bin/sh
+#
+# Copyright (C) 2015 Renesas Electronics Corporation
+#
+# SPDX-License-Identifier:	GPL-2.0+
+#
+
+# Flash stack benchmark using the sandbox NAND simulator
+#
+# Usage: nand_bench.sh [<simulator options>]
+#
+# e.g.	nand_bench.sh tr=25:tprog=200:terase=2000:tbyte=25
+#
+# The options are appended to the --nand argument, see
+# board/sandbox/README.sandbox. A UBI image with a raw data volume is
+# prepared first, then 'ubi part', 'nand read' and 'ubi read' are timed.
+# If mkfs.ubifs is available, 'ubifsmount' and 'ubifsload' are timed too.
+
+BASE="$(dirname $0)/.."
+. $BASE/common.sh
+
+MODEL="$1"
+BAD=$(echo "${MODEL}" | tr ':' '\n' | grep "^bad=")
+CHIP_MB=64
+DATA_SIZE=0x800000
+LOAD_ADDR=0x1000000
+CHECK_ADDR=0x2000000
+LEB_SIZE=129024
+PAGE_SIZE=2048
+
+UBOOT=./${OUTPUT_DIR}/u-boot
+
+work="$(mktemp -d)"
+trap 'rm -rf ${work}' EXIT
+tmp=${work}/bench.log
+
+nand_opt() {
+	echo "${work}/nand.bin:size=${CHIP_MB}${1:+:$1}"
+}
+
+# Create the UBI volumes, without timing or bit-flips to keep this quick
+prepare() {
+	echo "Prepare UBI image"
+	dd if=/dev/urandom of=${work}/data.bin bs=1M count=$((DATA_SIZE >> 20)) \
+		2>/dev/null || fail "cannot create data"
+
+	ubifs=
+	if which mkfs.ubifs >/dev/null 2>&1; then
+		mkdir ${work}/root
+		cp ${work}/data.bin ${work}/root/
+		mkfs.ubifs -m ${PAGE_SIZE} -e ${LEB_SIZE} -c 200 -x lzo \
+			-r ${work}/root -o ${work}/fs.ubifs ||
+			fail "mkfs.ubifs failed"
+		ubifs_size=$(printf "%x" $(stat -c %s ${work}/fs.ubifs))
+		ubifs="ubi create fs ${ubifs_size};
+sb load hostfs - ${LOAD_ADDR} ${work}/fs.ubifs;
+ubi write ${LOAD_ADDR} fs ${ubifs_size};"
+	else
+		echo "mkfs.ubifs not found, skipping UBIFS"
+	fi
+
+	${UBOOT} --nand $(nand_opt ${BAD}) -c "nand erase.chip; mtdparts default;
+ubi part ubi; ubi create data ${DATA_SIZE};
+sb load hostfs - ${LOAD_ADDR} ${work}/data.bin;
+ubi write ${LOAD_ADDR} data ${DATA_SIZE}; ${ubifs}" >${work}/prepare.log 2>&1
+	grep -q "bytes written to volume data" ${work}/prepare.log ||
+		fail "cannot write UBI volume"
+}
+
+run_bench() {
+	ubifs=
+	if [ -f ${work}/fs.ubifs ]; then
+		ubifs="echo bench ubifsmount 0; time ubifsmount ubi0:fs;
+echo bench ubifsload $((DATA_SIZE)); time ubifsload ${LOAD_ADDR} data.bin;
+cmp.b ${LOAD_ADDR} ${CHECK_ADDR} ${DATA_SIZE};"
+	fi
+
+	${UBOOT} --nand $(nand_opt ${MODEL}) -c "mtdparts default;
+sb load hostfs - ${CHECK_ADDR} ${work}/data.bin;
+echo bench ubi_part 0; time ubi part ubi; ubi info;
+echo bench nand_read $((DATA_SIZE)); time nand read ${LOAD_ADDR} 0 ${DATA_SIZE};
+echo bench ubi_read $((DATA_SIZE)); time ubi read ${LOAD_ADDR} data ${DATA_SIZE};
+cmp.b ${LOAD_ADDR} ${CHECK_ADDR} ${DATA_SIZE}; ${ubifs}" 2>&1
+}
+
+# Print the time of each step and the throughput of those moving data
+report() {
+	checks=1
+	[ -f ${work}/fs.ubifs ] && checks=2
+	if [ $(grep -c "were the same" $1) -ne ${checks} ]; then
+		fail "data read back differs"
+	fi
+
+	tr -d '\r' <$1 | awk '
+	/^bench / { name = $2; size = $3 }
+	/^time:/ {
+		secs = $(NF - 1)
+		if ($3 == "minutes,")
+			secs += $2 * 60
+		if (size && secs > 0)
+			printf "%-12s %8.3f s %8.2f MiB/s\n", name, secs,
+				size / secs / 1048576
+		else
+			printf "%-12s %8.3f s\n", name, secs
+	}'
+	grep "attach time" $1 | tr -d '\r' | grep . ||
+		fail "no attach time from 'ubi info'"
+}
+
+echo "NAND/UBI/UBIFS benchmark using sandbox"
+echo
+[ -x ${UBOOT} ] || build_uboot
+prepare
+run_bench >${tmp}
+report ${tmp}
+echo "Test passed"
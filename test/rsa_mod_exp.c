@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ *
+ * Check the 64-bit word and exponent window code in rsa-mod-exp.c against
+ * the original 32-bit pow_mod(). The keys are random odd moduli, which is
+ * all the arithmetic needs.
+ */
+
+#include <common.h>
+#include <command.h>
+
+/* A private copy, to reach the static functions */
+#define rsa_mod_exp_sw	test_rsa_mod_exp_sw
+#include "../lib/rsa/rsa-mod-exp.c"
+
+#define MAX_WORDS	(RSA_MAX_KEY_BITS / 32)
+
+static const int test_bits[] = {
+	2048,
+	4096,
+	2080,		/* odd number of words, left to pow_mod() */
+	4064,
+};
+
+static const uint64_t test_exponents[] = {
+	RSA_DEFAULT_PUBEXP,
+	3,				/* single-bit windows */
+	0xfedcba9876543211ULL,		/* full windows */
+	0x8000000000000001ULL,		/* a long run of squares */
+	0x1000a5c3ULL,
+};
+
+static uint32_t rand_state = 1;
+
+static uint32_t test_rand(void)
+{
+	rand_state = rand_state * 1103515245 + 12345;
+
+	return rand_state >> 16 | rand_state << 16;
+}
+
+/* Make a random odd modulus of @len words, with n0inv and R^2 to go */
+static void make_key(struct rsa_public_key *key, uint len)
+{
+	uint32_t inv, carry, n0;
+	uint i, j;
+
+	key->len = len;
+	for (i = 0; i < len; i++)
+		key->modulus[i] = test_rand();
+	key->modulus[0] |= 1;
+	key->modulus[len - 1] |= 1U << 31;
+
+	/* Each Newton step doubles the bits of 1 / n0 which are right */
+	n0 = key->modulus[0];
+	inv = n0;
+	for (i = 0; i < 5; i++)
+		inv *= 2 - n0 * inv;
+	key->n0inv = -inv;
+
+	/* rr = 2^(64 * len) mod n, by doubling 1 */
+	memset(key->rr, '\0', len * sizeof(uint32_t));
+	key->rr[0] = 1;
+	for (i = 0; i < 64 * len; i++) {
+		carry = key->rr[len - 1] >> 31;
+		for (j = len - 1; j > 0; j--)
+			key->rr[j] = key->rr[j] << 1 | key->rr[j - 1] >> 31;
+		key->rr[0] <<= 1;
+		if (carry || greater_equal_modulus(key, key->rr))
+			subtract_modulus(key, key->rr);
+	}
+}
+
+/* Check one value of one key and exponent, in every way there is */
+static int check(const struct rsa_public_key *key)
+{
+	uint32_t modulus[MAX_WORDS], rr[MAX_WORDS], val[MAX_WORDS];
+	uint32_t ref[MAX_WORDS], out[MAX_WORDS];
+	uint64_t exponent = cpu_to_fdt64(key->exponent);
+	struct key_prop prop;
+	uint len = key->len;
+	uint i;
+
+	/* Big endian, as in a signature and the device tree */
+	for (i = 0; i < len; i++) {
+		val[i] = cpu_to_fdt32(test_rand());
+		modulus[i] = cpu_to_fdt32(key->modulus[len - 1 - i]);
+		rr[i] = cpu_to_fdt32(key->rr[len - 1 - i]);
+	}
+	val[0] &= cpu_to_fdt32(0x7fffffff);	/* below the modulus */
+
+	memcpy(ref, val, len * sizeof(uint32_t));
+	if (pow_mod(key, ref))
+		return -1;
+
+#ifdef __SIZEOF_INT128__
+	if (!(len & 1)) {
+		memcpy(out, val, len * sizeof(uint32_t));
+		if (pow_mod64(key, out) ||
+		    memcmp(out, ref, len * sizeof(uint32_t)))
+			return -1;
+	}
+#endif
+
+	/* And through the entry point, which picks one or the other */
+	prop.modulus = modulus;
+	prop.rr = rr;
+	prop.public_exponent = &exponent;
+	prop.n0inv = key->n0inv;
+	prop.num_bits = len * 32;
+	prop.exp_len = sizeof(exponent);
+	if (rsa_mod_exp_sw((uint8_t *)val, len * sizeof(uint32_t), &prop,
+			   (uint8_t *)out) ||
+	    memcmp(out, ref, len * sizeof(uint32_t)))
+		return -1;
+
+	return 0;
+}
+
+static int run_test(void)
+{
+	uint32_t modulus[MAX_WORDS], rr[MAX_WORDS];
+	struct rsa_public_key key;
+	int i, j, k;
+
+	key.modulus = modulus;
+	key.rr = rr;
+	for (i = 0; i < ARRAY_SIZE(test_bits); i++) {
+		make_key(&key, test_bits[i] / 32);
+		for (j = 0; j < ARRAY_SIZE(test_exponents); j++) {
+			key.exponent = test_exponents[j];
+			for (k = 0; k < 3; k++) {
+				if (!check(&key))
+					continue;
+				printf(" %d bits, exponent %#llx: mismatch\n",
+				       test_bits[i],
+				       (unsigned long long)key.exponent);
+				return -1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int do_ut_rsa_mod_exp(cmd_tbl_t *cmdtp, int flag, int argc,
+			     char *const argv[])
+{
+	int ret;
+
+	ret = run_test();
+	printf("ut_rsa_mod_exp %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_rsa_mod_exp,	1,	1,	do_ut_rsa_mod_exp,
+	"Check 64-bit RSA exponentiation against the 32-bit code", ""
+);
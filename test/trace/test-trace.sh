@@ -23,6 +23,8 @@ trace resume
 hash sha256 0 10000
 trace pause
 trace stats
+trace calls 2000000 1000000
+trace marks
 reset
 END
 }
@@ -50,6 +52,11 @@ check_results() {
 	if [ "${counts}" != "1 1 0 1 " ]; then
 		fail "trace collection error: ${counts}"
 	fi
+
+	# Boot stages are appended after the call list
+	if [ $(grep -c "Boot stages dumped to" ${tmp}) -ne 1 ]; then
+		fail "boot stage output error"
+	fi
 }
 
 echo "Simple trace test / sanity check using sandbox"
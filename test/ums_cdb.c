@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <usb_mass_storage.h>
+
+struct cdb_test {
+	const char *name;
+	u8 cmnd[16];
+	int is_16;
+	u32 lba;
+	u32 blocks;		/* only checked for 16-byte commands */
+};
+
+static const struct cdb_test cdb_tests[] = {
+	{ "READ(10)",
+	  { 0x28, 0, 0x12, 0x34, 0x56, 0x78, 0, 0x01, 0x00, 0 },
+	  0, 0x12345678 },
+	{ "WRITE(12)",
+	  { 0xaa, 0, 0xff, 0xff, 0xff, 0xfe, 0, 0, 0, 0x10, 0, 0 },
+	  0, 0xfffffffe },
+	{ "READ(16) below 2 TiB",
+	  { 0x88, 0, 0, 0, 0, 0, 0xff, 0xff, 0xff, 0xfe,
+	    0, 0, 0x01, 0x00, 0, 0 },
+	  1, 0xfffffffe, 0x100 },
+	{ "READ(16) at 2 TiB",
+	  { 0x88, 0, 0, 0, 0, 0x01, 0, 0, 0, 0,
+	    0, 0, 0, 0x08, 0, 0 },
+	  1, ~0, 8 },
+	{ "WRITE(16) small LBA",
+	  { 0x8a, 0, 0, 0, 0, 0, 0, 0, 0, 0x10,
+	    0xff, 0xff, 0xff, 0xff, 0, 0 },
+	  1, 0x10, 0xffffffff },
+	{ "WRITE(16) top bit of LBA",
+	  { 0x8a, 0, 0x80, 0, 0, 0, 0, 0, 0, 0x10,
+	    0, 0, 0, 0x01, 0, 0 },
+	  1, ~0, 1 },
+};
+
+static int do_ut_ums_cdb(cmd_tbl_t *cmdtp, int flag, int argc,
+			 char *const argv[])
+{
+	const struct cdb_test *t;
+	int i, ret = 0;
+
+	for (i = 0; i < ARRAY_SIZE(cdb_tests); i++) {
+		t = &cdb_tests[i];
+		if (ums_cdb_is_16(t->cmnd) != t->is_16 ||
+		    ums_cdb_lba(t->cmnd) != t->lba ||
+		    (t->is_16 && ums_cdb16_blocks(t->cmnd) != t->blocks)) {
+			printf(" %s: LBA %#x blocks %#x\n", t->name,
+			       ums_cdb_lba(t->cmnd),
+			       ums_cdb16_blocks(t->cmnd));
+			ret = -1;
+		}
+	}
+
+	printf("ut_ums_cdb %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_ums_cdb,	1,	1,	do_ut_ums_cdb,
+	"Check the LBA handling of mass storage READ/WRITE commands", ""
+);
@@ -0,0 +1,413 @@
+/*
+ * Copyright (C) 2015 Renesas Electronics Corporation
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ *
+ * Run READ(16) and WRITE(16) through the mass storage function against a
+ * file-backed host block device. Sandbox has no UDC, so the bulk endpoints
+ * are stand-ins which complete each request as soon as it is queued.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <os.h>
+#include <part.h>
+#include <sandboxblockdev.h>
+
+#include "../drivers/usb/gadget/f_mass_storage.c"
+
+#define FILE_NAME	"/tmp/u-boot-ums-data.img"
+#define DISK_BLOCKS	256
+/* The function is given the blocks of the file from here... */
+#define START_SECTOR	16
+/* ...up to this many before its end */
+#define END_SECTORS	8
+/* Several buffers' worth, starting off a page boundary */
+#define TEST_LBA	9
+#define TEST_BLOCKS	(3 * FSG_BUFLEN / SECTOR_SIZE + 5)
+
+/* What the host sends on bulk-out, as a list of transfers */
+static struct {
+	const u8 *buf[2];
+	unsigned int len[2];
+	int count, cur;
+	unsigned int pos;
+} host_out;
+
+/* and what it gets on bulk-in */
+static struct {
+	u8 *buf;
+	unsigned int size, len;
+} host_in;
+
+static struct usb_ep test_bulk_in, test_bulk_out;
+
+static int test_ep_enable(struct usb_ep *ep,
+			  const struct usb_endpoint_descriptor *desc)
+{
+	return 0;
+}
+
+static int test_ep_disable(struct usb_ep *ep)
+{
+	return 0;
+}
+
+static struct usb_request *test_alloc_request(struct usb_ep *ep,
+					      gfp_t gfp_flags)
+{
+	return calloc(1, sizeof(struct usb_request));
+}
+
+static void test_free_request(struct usb_ep *ep, struct usb_request *req)
+{
+	free(req);
+}
+
+/*
+ * Complete a request at once. An OUT request takes data until it is full
+ * or the host's transfer ends, as with a short packet.
+ */
+static int test_ep_queue(struct usb_ep *ep, struct usb_request *req,
+			 gfp_t gfp_flags)
+{
+	unsigned int len;
+
+	if (ep == &test_bulk_in) {
+		len = min(req->length, host_in.size - host_in.len);
+		memcpy(host_in.buf + host_in.len, req->buf, len);
+		host_in.len += len;
+	} else {
+		if (host_out.cur >= host_out.count)
+			return -ESHUTDOWN;
+		len = min(req->length, host_out.len[host_out.cur] -
+			  host_out.pos);
+		memcpy(req->buf, host_out.buf[host_out.cur] + host_out.pos,
+		       len);
+		host_out.pos += len;
+		if (host_out.pos == host_out.len[host_out.cur]) {
+			host_out.cur++;
+			host_out.pos = 0;
+		}
+	}
+	req->actual = len;
+	req->status = 0;
+	req->complete(ep, req);
+
+	return 0;
+}
+
+static int test_ep_dequeue(struct usb_ep *ep, struct usb_request *req)
+{
+	return 0;
+}
+
+static int test_ep_set_halt(struct usb_ep *ep, int value)
+{
+	return 0;
+}
+
+static const struct usb_ep_ops test_ep_ops = {
+	.enable		= test_ep_enable,
+	.disable	= test_ep_disable,
+	.alloc_request	= test_alloc_request,
+	.free_request	= test_free_request,
+	.queue		= test_ep_queue,
+	.dequeue	= test_ep_dequeue,
+	.set_halt	= test_ep_set_halt,
+};
+
+static struct usb_ep test_bulk_in = {
+	.name		= "bulk-in",
+	.ops		= &test_ep_ops,
+	.maxpacket	= 64,
+};
+
+static struct usb_ep test_bulk_out = {
+	.name		= "bulk-out",
+	.ops		= &test_ep_ops,
+	.maxpacket	= 64,
+};
+
+/*
+ * What the function calls outside of the data path, there being no UDC
+ * driver or composite gadget here. Binding is not tested.
+ */
+int usb_gadget_handle_interrupts(void)
+{
+	return 0;
+}
+
+int g_dnl_board_usb_cable_connected(void)
+{
+	return 1;
+}
+
+int usb_add_function(struct usb_configuration *c, struct usb_function *f)
+{
+	return -ENODEV;
+}
+
+int usb_interface_id(struct usb_configuration *c, struct usb_function *f)
+{
+	return -ENODEV;
+}
+
+int usb_string_id(struct usb_composite_dev *c)
+{
+	return -ENODEV;
+}
+
+struct usb_ep *usb_ep_autoconfig(struct usb_gadget *gadget,
+				 struct usb_endpoint_descriptor *desc)
+{
+	return NULL;
+}
+
+static int test_read_sector(struct ums *ums_dev, ulong start,
+			    lbaint_t blkcnt, void *buf)
+{
+	block_dev_desc_t *block_dev = ums_dev->block_dev;
+
+	return block_dev->block_read(block_dev->dev,
+				     start + ums_dev->start_sector, blkcnt,
+				     buf);
+}
+
+static int test_write_sector(struct ums *ums_dev, ulong start,
+			     lbaint_t blkcnt, const void *buf)
+{
+	block_dev_desc_t *block_dev = ums_dev->block_dev;
+
+	return block_dev->block_write(block_dev->dev,
+				      start + ums_dev->start_sector, blkcnt,
+				      buf);
+}
+
+static struct ums test_ums = {
+	.read_sector	= test_read_sector,
+	.write_sector	= test_write_sector,
+	.start_sector	= START_SECTOR,
+	.num_sectors	= DISK_BLOCKS - START_SECTOR - END_SECTORS,
+	.name		= "UMS test disk",
+};
+
+static struct fsg_common test_common;
+static struct fsg_dev test_fsg;
+static struct usb_gadget test_gadget = {
+	.speed		= USB_SPEED_FULL,
+};
+
+static int test_setup(void)
+{
+	struct fsg_common *common = &test_common;
+	struct fsg_buffhd *bh;
+	int i;
+
+	/* As usb_ep_autoconfig() would, for a full speed gadget */
+	fsg_fs_bulk_in_desc.wMaxPacketSize = cpu_to_le16(64);
+	fsg_fs_bulk_out_desc.wMaxPacketSize = cpu_to_le16(64);
+
+	ums = &test_ums;
+	memset(common, 0, sizeof(*common));
+	common->gadget = &test_gadget;
+	common->nluns = 1;
+	common->can_stall = 1;
+	if (fsg_lun_open(&common->luns[0], ""))
+		return -1;
+
+	for (i = 0; i < FSG_NUM_BUFFERS; i++) {
+		bh = &common->buffhds[i];
+		bh->next = &common->buffhds[(i + 1) % FSG_NUM_BUFFERS];
+		bh->buf = memalign(CONFIG_SYS_CACHELINE_SIZE, FSG_BUFLEN);
+		if (!bh->buf)
+			return -1;
+	}
+	common->next_buffhd_to_fill = common->buffhds;
+	common->next_buffhd_to_drain = common->buffhds;
+
+	test_fsg.common = common;
+	test_fsg.gadget = &test_gadget;
+	test_fsg.bulk_in = &test_bulk_in;
+	test_fsg.bulk_out = &test_bulk_out;
+	the_fsg_common = common;
+
+	return do_set_interface(common, &test_fsg);
+}
+
+static void test_cleanup(void)
+{
+	int i;
+
+	do_set_interface(&test_common, NULL);
+	for (i = 0; i < FSG_NUM_BUFFERS; i++)
+		free(test_common.buffhds[i].buf);
+	ums = NULL;
+	the_fsg_common = NULL;
+}
+
+/*
+ * Have the host send a 16-byte READ or WRITE command, with @data as the
+ * data to write, and run it. Returns the CSW status, or -1 if the function
+ * did not answer with a proper CSW. Data read ends up in host_in.buf.
+ */
+static int test_command(u8 opcode, u64 lba, u32 blocks, const u8 *data)
+{
+	struct fsg_bulk_cb_wrap cbw;
+	struct bulk_cs_wrap csw;
+	u32 len = blocks * SECTOR_SIZE;
+	int dir_in = opcode == SC_READ_16;
+
+	memset(&cbw, 0, sizeof(cbw));
+	cbw.Signature = cpu_to_le32(USB_BULK_CB_SIG);
+	cbw.Tag = 0x1234;
+	cbw.DataTransferLength = cpu_to_le32(len);
+	cbw.Flags = dir_in ? USB_BULK_IN_FLAG : 0;
+	cbw.Length = 16;
+	cbw.CDB[0] = opcode;
+	put_unaligned_be64(lba, &cbw.CDB[2]);
+	put_unaligned_be32(blocks, &cbw.CDB[10]);
+
+	host_out.buf[0] = (const u8 *)&cbw;
+	host_out.len[0] = USB_BULK_CB_WRAP_LEN;
+	host_out.buf[1] = data;
+	host_out.len[1] = len;
+	host_out.count = dir_in ? 1 : 2;
+	host_out.cur = 0;
+	host_out.pos = 0;
+	host_in.len = 0;
+
+	if (fsg_main_thread(NULL) || test_common.state != FSG_STATE_IDLE ||
+	    host_in.len < USB_BULK_CS_WRAP_LEN)
+		return -1;
+
+	/* The CSW follows the data */
+	memcpy(&csw, host_in.buf + host_in.len - USB_BULK_CS_WRAP_LEN,
+	       USB_BULK_CS_WRAP_LEN);
+	host_in.len -= USB_BULK_CS_WRAP_LEN;
+	if (le32_to_cpu(csw.Signature) != USB_BULK_CS_SIG ||
+	    csw.Tag != cbw.Tag)
+		return -1;
+
+	return csw.Status;
+}
+
+static void fill(u8 *buf, int size, u32 x)
+{
+	int i;
+
+	for (i = 0; i < size; i++) {
+		x = x * 1103515245 + 12345;
+		buf[i] = x >> 16;
+	}
+}
+
+static int read_file(u8 *disk)
+{
+	int fd, ret;
+
+	fd = os_open(FILE_NAME, OS_O_RDONLY);
+	if (fd < 0)
+		return -1;
+	ret = os_read(fd, disk, DISK_BLOCKS * SECTOR_SIZE) !=
+		DISK_BLOCKS * SECTOR_SIZE;
+	os_close(fd);
+
+	return ret ? -1 : 0;
+}
+
+static int test_data(u8 *disk, u8 *data)
+{
+	const u32 len = TEST_BLOCKS * SECTOR_SIZE;
+	const loff_t offset = (START_SECTOR + TEST_LBA) * SECTOR_SIZE;
+	const loff_t end = (DISK_BLOCKS - END_SECTORS) * SECTOR_SIZE;
+	int i;
+
+	/* WRITE(16) lands in the file, after the start sector */
+	fill(data, len, 1);
+	if (test_command(SC_WRITE_16, TEST_LBA, TEST_BLOCKS, data) !=
+	    USB_STATUS_PASS || read_file(disk) ||
+	    memcmp(disk + offset, data, len) ||
+	    disk[offset - 1] || disk[offset + len])
+		return -1;
+
+	/* READ(16) gets it back */
+	if (test_command(SC_READ_16, TEST_LBA, TEST_BLOCKS, NULL) !=
+	    USB_STATUS_PASS || host_in.len != len ||
+	    memcmp(host_in.buf, data, len))
+		return -1;
+
+	/* Commands reaching past the end stop there */
+	if (test_command(SC_READ_16, test_ums.num_sectors - 2, 4, NULL) !=
+	    USB_STATUS_FAIL || host_in.len != 2 * SECTOR_SIZE ||
+	    memcmp(host_in.buf, disk + end - 2 * SECTOR_SIZE,
+		   2 * SECTOR_SIZE) ||
+	    test_common.luns[0].sense_data !=
+	    SS_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE)
+		return -1;
+	if (test_command(SC_WRITE_16, test_ums.num_sectors - 2, 4, data) !=
+	    USB_STATUS_FAIL || read_file(disk) ||
+	    memcmp(disk + end - 2 * SECTOR_SIZE, data, 2 * SECTOR_SIZE))
+		return -1;
+	for (i = end; i < DISK_BLOCKS * SECTOR_SIZE; i++) {
+		if (disk[i])
+			return -1;
+	}
+
+	/* Commands addressing 2 TiB and above fail without any data */
+	if (test_command(SC_READ_16, 1ULL << 32, 1, NULL) !=
+	    USB_STATUS_FAIL || host_in.len ||
+	    test_command(SC_WRITE_16, (1ULL << 32) + TEST_LBA, 1, data) !=
+	    USB_STATUS_FAIL || read_file(disk) ||
+	    memcmp(disk + offset, data, len))
+		return -1;
+
+	return 0;
+}
+
+static int do_ut_ums_data(cmd_tbl_t *cmdtp, int flag, int argc,
+			  char *const argv[])
+{
+	u8 *disk, *data;
+	int fd, ret = -1;
+
+	disk = calloc(1, DISK_BLOCKS * SECTOR_SIZE);
+	data = malloc(TEST_BLOCKS * SECTOR_SIZE);
+	host_in.size = TEST_BLOCKS * SECTOR_SIZE + FSG_BUFLEN;
+	host_in.buf = malloc(host_in.size);
+	if (!disk || !data || !host_in.buf)
+		goto out;
+
+	os_unlink(FILE_NAME);
+	fd = os_open(FILE_NAME, OS_O_WRONLY | OS_O_CREAT);
+	if (fd < 0)
+		goto out;
+	ret = os_write(fd, disk, DISK_BLOCKS * SECTOR_SIZE) !=
+		DISK_BLOCKS * SECTOR_SIZE;
+	os_close(fd);
+	if (ret || host_dev_bind(0, FILE_NAME)) {
+		ret = -1;
+		goto out;
+	}
+	test_ums.block_dev = host_get_dev(0);
+
+	ret = test_setup();
+	if (!ret)
+		ret = test_data(disk, data);
+	test_cleanup();
+	host_dev_bind(0, NULL);
+	os_unlink(FILE_NAME);
+out:
+	free(host_in.buf);
+	free(data);
+	free(disk);
+	printf("ut_ums_data %s\n", ret == 0 ? "ok" : "FAILED");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	ut_ums_data,	1,	1,	do_ut_ums_data,
+	"Check READ(16)/WRITE(16) through the mass storage function", ""
+);
@@ -52,7 +52,6 @@ keys="${dir}/dev-keys"
 echo ${mkimage} -D "${dtc}"
 
 echo "Build keys"
-mkdir -p ${keys}
 
 PUBLIC_EXPONENT=${1}
 
@@ -61,17 +60,26 @@ if [ -z "${PUBLIC_EXPONENT}" ]; then
 fi
 
 # Create an RSA key pair
-openssl genpkey -algorithm RSA -out ${keys}/dev.key \
-    -pkeyopt rsa_keygen_bits:2048 \
-    -pkeyopt rsa_keygen_pubexp:${PUBLIC_EXPONENT} 2>/dev/null
+# Args:
+#	$1:	Directory to put the keys in
+#	$2:	Number of bits in the key
+create_keys() {
+	mkdir -p $1
+	openssl genpkey -algorithm RSA -out $1/dev.key \
+	    -pkeyopt rsa_keygen_bits:$2 \
+	    -pkeyopt rsa_keygen_pubexp:${PUBLIC_EXPONENT} 2>/dev/null
+
+	# Create a certificate containing the public key
+	openssl req -batch -new -x509 -key $1/dev.key -out $1/dev.crt
+}
 
-# Create a certificate containing the public key
-openssl req -batch -new -x509 -key ${keys}/dev.key -out ${keys}/dev.crt
+create_keys ${keys} 2048
+create_keys ${keys}-rsa4096 4096
 
 pushd ${dir} >/dev/null
 
 function do_test {
-	echo do $sha test
+	echo do $sha$rsa test
 	# Compile our device tree files for kernel and U-Boot
 	dtc -p 0x1000 sandbox-kernel.dts -O dtb -o sandbox-kernel.dtb
 	dtc -p 0x1000 sandbox-u-boot.dts -O dtb -o sandbox-u-boot.dtb
@@ -81,13 +89,13 @@ function do_test {
 
 	# Build the FIT, but don't sign anything yet
 	echo Build FIT with signed images
-	${mkimage} -D "${dtc}" -f sign-images-$sha.its test.fit >${tmp}
+	${mkimage} -D "${dtc}" -f sign-images-$sha$rsa.its test.fit >${tmp}
 
 	run_uboot "unsigned signatures:" "dev-"
 
 	# Sign images with our dev keys
 	echo Sign images
-	${mkimage} -D "${dtc}" -F -k dev-keys -K sandbox-u-boot.dtb \
+	${mkimage} -D "${dtc}" -F -k dev-keys$rsa -K sandbox-u-boot.dtb \
 		-r test.fit >${tmp}
 
 	run_uboot "signed images" "dev+"
@@ -97,13 +105,13 @@ function do_test {
 	dtc -p 0x1000 sandbox-u-boot.dts -O dtb -o sandbox-u-boot.dtb
 
 	echo Build FIT with signed configuration
-	${mkimage} -D "${dtc}" -f sign-configs-$sha.its test.fit >${tmp}
+	${mkimage} -D "${dtc}" -f sign-configs-$sha$rsa.its test.fit >${tmp}
 
 	run_uboot "unsigned config" $sha"+ OK"
 
 	# Sign images with our dev keys
 	echo Sign images
-	${mkimage} -D "${dtc}" -F -k dev-keys -K sandbox-u-boot.dtb \
+	${mkimage} -D "${dtc}" -F -k dev-keys$rsa -K sandbox-u-boot.dtb \
 		-r test.fit >${tmp}
 
 	run_uboot "signed config" "dev+"
@@ -137,9 +145,12 @@ function do_test {
 }
 
 sha=sha1
+rsa=
 do_test
 sha=sha256
 do_test
+rsa=-rsa4096
+do_test
 
 popd >/dev/null
 
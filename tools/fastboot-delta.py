@@ -0,0 +1,118 @@
+#!/usr/bin/env python
+#
+# Copyright (C) 2015 Renesas Electronics Corporation
+#
+# SPDX-License-Identifier:      GPL-2.0+
+#
+# Flash only the chunks of an image which differ from the partition, using
+# U-Boot's fastboot delta flashing (see doc/README.android-fastboot)
+
+from optparse import OptionParser
+import hashlib
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+MANIFEST_MAGIC = 0x544c4446
+CHUNKS_MAGIC = 0x4b434446
+HEADER = '<IIIIQ'
+HEADER_SIZE = struct.calcsize(HEADER)
+BLOCK_SIZE = 512
+
+def Fastboot(options, *args):
+    """Run the fastboot client and return what it printed"""
+    cmd = [options.fastboot]
+    if options.serial:
+        cmd += ['-s', options.serial]
+    cmd += list(args)
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE,
+                            stderr=subprocess.STDOUT)
+    out = proc.communicate()[0].decode('utf-8', 'replace')
+    if proc.returncode or 'FAILED' in out:
+        raise ValueError('%s failed:\n%s' % (' '.join(cmd), out))
+    return out
+
+def GetVar(options, name):
+    """Return the value of a fastboot variable"""
+    for line in Fastboot(options, 'getvar', name).splitlines():
+        if line.startswith(name + ':'):
+            return line[len(name) + 1:].strip()
+    raise ValueError('No value for %s' % name)
+
+def FlashData(options, part, data):
+    """Download and flash a manifest or chunk run"""
+    fd, fname = tempfile.mkstemp()
+    try:
+        os.write(fd, data)
+        os.close(fd)
+        Fastboot(options, 'flash', part, fname)
+    finally:
+        os.remove(fname)
+
+def ChangedChunks(options, count):
+    """Return the list of chunks which the device reports as different"""
+    changed = []
+    first = 0
+    while first < count:
+        digits = GetVar(options, 'delta-map:%x' % first)
+        if not digits:
+            raise ValueError('Empty delta map at chunk %d' % first)
+        for digit in digits:
+            value = int(digit, 16)
+            for i in range(4):
+                if value & (8 >> i) and first + i < count:
+                    changed.append(first + i)
+            first += 4
+    return changed
+
+def Runs(changed, max_chunks):
+    """Group consecutive chunks into runs of at most max_chunks"""
+    runs = []
+    for chunk in changed:
+        if runs and runs[-1][0] + runs[-1][1] == chunk and \
+                runs[-1][1] < max_chunks:
+            runs[-1][1] += 1
+        else:
+            runs.append([chunk, 1])
+    return runs
+
+def Flash(options, part, fname):
+    data = open(fname, 'rb').read()
+    data += b'\0' * (-len(data) % BLOCK_SIZE)
+    size = options.chunk_size
+    count = (len(data) + size - 1) // size
+
+    manifest = struct.pack(HEADER, MANIFEST_MAGIC, size, count, 0, len(data))
+    for i in range(count):
+        manifest += hashlib.sha256(data[i * size:(i + 1) * size]).digest()
+    FlashData(options, part, manifest)
+
+    changed = ChangedChunks(options, count)
+    print('%d of %d chunks differ' % (len(changed), count))
+
+    max_bytes = int(GetVar(options, 'max-download-size'), 0)
+    max_chunks = max(1, (max_bytes - HEADER_SIZE) // size)
+    for first, n in Runs(changed, max_chunks):
+        header = struct.pack(HEADER, CHUNKS_MAGIC, size, n, first, len(data))
+        FlashData(options, part, header + data[first * size:(first + n) * size])
+        print('Flashed chunks %d to %d' % (first, first + n - 1))
+
+parser = OptionParser(usage='%prog [options] <partition> <image>')
+parser.add_option('-c', '--chunk-size', type='int', default=1 << 20,
+        help='Chunk size in bytes, a multiple of %d (default 1MiB)' %
+        BLOCK_SIZE)
+parser.add_option('-f', '--fastboot', default='fastboot',
+        help='Fastboot client to use')
+parser.add_option('-s', '--serial', help='Serial number of the device')
+(options, args) = parser.parse_args()
+
+if len(args) != 2 or options.chunk_size % BLOCK_SIZE:
+    parser.print_usage()
+    sys.exit(1)
+try:
+    Flash(options, args[0], args[1])
+except ValueError as e:
+    print(e)
+    sys.exit(1)
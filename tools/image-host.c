@@ -62,6 +62,7 @@ static int fit_image_process_hash(void *fit, const char *image_name,
 {
 	uint8_t value[FIT_MAX_HASH_LEN];
 	const char *node_name;
+	ulong segment_size;
 	int value_len;
 	char *algo;
 
@@ -73,7 +74,14 @@ static int fit_image_process_hash(void *fit, const char *image_name,
 		return -1;
 	}
 
-	if (calculate_hash(data, size, algo, value, &value_len)) {
+	if (fit_image_hash_get_segment_size(fit, noffset, &segment_size)) {
+		printf("Invalid segment size for '%s' hash node in '%s' image node\n",
+		       node_name, image_name);
+		return -1;
+	}
+
+	if (calculate_segment_hash(data, size, segment_size, algo, value,
+				   &value_len)) {
 		printf("Unsupported hash algorithm (%s) for '%s' hash node in '%s' image node\n",
 		       algo, node_name, image_name);
 		return -1;
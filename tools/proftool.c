@@ -55,6 +55,8 @@ struct func_info *func_list;
 int func_count;
 struct trace_call *call_list;
 int call_count;
+struct trace_output_mark *mark_list;
+int mark_count;
 int verbose;	/* Verbosity level 0=none, 1=warn, 2=notice, 3=info, 4=debug */
 unsigned long text_offset;		/* text address of first function */
 
@@ -85,6 +87,7 @@ static void usage(void)
 		"\n"
 		"Commands\n"
 		"   dump-ftrace\t\tDump out textual data in ftrace format\n"
+		"   dump-chrome\t\tDump out a timeline in Chrome trace format\n"
 		"\n"
 		"Options:\n"
 		"   -m <map>\tSpecify Systen.map file\n"
@@ -226,6 +229,29 @@ static int read_calls(FILE *fin, int count)
 	return 0;
 }
 
+static int read_marks(FILE *fin, int count)
+{
+	struct trace_output_mark *mark;
+	int i;
+
+	notice("mark count: %d\n", count);
+	mark_list = realloc(mark_list, (mark_count + count) * sizeof(*mark));
+	if (!mark_list) {
+		error("Cannot allocate mark_list\n");
+		return -1;
+	}
+
+	mark = &mark_list[mark_count];
+	for (i = 0; i < count; i++, mark++) {
+		if (read_data(fin, mark, sizeof(*mark)))
+			return 1;
+		mark->name[sizeof(mark->name) - 1] = '\0';
+	}
+	mark_count += count;
+
+	return 0;
+}
+
 static int read_profile(FILE *fin, int *not_found)
 {
 	struct trace_output_hdr hdr;
@@ -243,12 +269,25 @@ static int read_profile(FILE *fin, int *not_found)
 		switch (hdr.type) {
 		case TRACE_CHUNK_FUNCS:
 			/* Ignored at present */
+			if (fseek(fin, hdr.rec_count *
+				  sizeof(struct trace_output_func), SEEK_CUR))
+				return 1;
 			break;
 
 		case TRACE_CHUNK_CALLS:
 			if (read_calls(fin, hdr.rec_count))
 				return 1;
 			break;
+
+		case TRACE_CHUNK_MARKS:
+			if (read_marks(fin, hdr.rec_count))
+				return 1;
+			break;
+
+		default:
+			error("Unknown chunk type %d in profile file\n",
+			      hdr.type);
+			return 1;
 		}
 	}
 	return 0;
@@ -531,6 +570,219 @@ static int make_ftrace(void)
 	return 0;
 }
 
+/* Chrome trace threads, used to put each kind of record on its own line */
+enum {
+	CHROME_TID_MARKS,
+	CHROME_TID_FUNCS,
+	CHROME_TID_STORAGE,
+	CHROME_TID_NETWORK,
+
+	CHROME_TID_COUNT,
+};
+
+static const char *const chrome_thread_name[CHROME_TID_COUNT] = {
+	"bootstage",
+	"functions",
+	"storage",
+	"network",
+};
+
+static const struct {
+	const char *name;
+	int tid;
+} chrome_event[TRACE_EVENT_COUNT] = {
+	[TRACE_EVENT_BLK_READ]	= { "block read", CHROME_TID_STORAGE },
+	[TRACE_EVENT_BLK_WRITE]	= { "block write", CHROME_TID_STORAGE },
+	[TRACE_EVENT_NET]	= { "network load", CHROME_TID_NETWORK },
+};
+
+/*
+ * Timestamps only have 30 bits, so work out the full time from the
+ * distance to a time we already know
+ */
+static long long unwrap_time(long long prev, uint32_t time)
+{
+	long delta = (time - prev) & FUNCF_TIMESTAMP_MASK;
+
+	if (delta > FUNCF_TIMESTAMP_MASK / 2)
+		delta -= FUNCF_TIMESTAMP_MASK + 1L;
+
+	return prev + delta;
+}
+
+static void out_json_string(const char *str)
+{
+	putchar('"');
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			printf("\\%c", *str);
+		else if ((unsigned char)*str < ' ')
+			printf("\\u%04x", *str);
+		else
+			putchar(*str);
+	}
+	putchar('"');
+}
+
+static void out_chrome_event(const char *name, const char *phase,
+			     long long time, int tid, const char *extra)
+{
+	static int count;
+
+	printf("%s\n{\"name\":", count++ ? "," : "");
+	out_json_string(name);
+	printf(",\"ph\":\"%s\",\"ts\":%lld,\"pid\":1,\"tid\":%d%s}", phase,
+	       time, tid, extra ? extra : "");
+}
+
+/*
+ * Write the function calls, I/O events and boot stages as a single timeline
+ * in the Chrome trace event format, as read by chrome://tracing and Perfetto
+ *
+ * Function calls and I/O events become duration events on their own
+ * threads, boot stages become instant events and accumulated boot stage
+ * times go in the metadata.
+ */
+static int make_chrome(void)
+{
+	int depth[CHROME_TID_COUNT] = { 0 };
+	long long *call_time, *mark_time;
+	long long prev = 0, ref, first = 0, last = 0;
+	struct trace_output_mark *mark;
+	struct trace_call *call;
+	int missing_count = 0, skip_count = 0;
+	int have_time = 0, accum_count = 0;
+	char extra[40];
+	int i, tid;
+
+	call_time = calloc(call_count + 1, sizeof(*call_time));
+	mark_time = calloc(mark_count + 1, sizeof(*mark_time));
+	if (!call_time || !mark_time) {
+		error("Cannot allocate times\n");
+		return -1;
+	}
+
+	/*
+	 * Work out full times, each call from the one before and each boot
+	 * stage from the first call, then start the timeline at zero
+	 */
+	for (i = 0, call = call_list; i < call_count; i++, call++) {
+		uint32_t time = call->flags & FUNCF_TIMESTAMP_MASK;
+
+		if (TRACE_CALL_TYPE(call) == FUNCF_TEXTBASE)
+			continue;
+		prev = have_time ? unwrap_time(prev, time) : time;
+		call_time[i] = prev;
+		if (!have_time || prev < first)
+			first = prev;
+		if (!have_time || prev > last)
+			last = prev;
+		have_time = 1;
+	}
+	ref = have_time ? first : 0;
+	for (i = 0, mark = mark_list; i < mark_count; i++, mark++) {
+		if (mark->flags & TRACE_MARKF_ACCUM)
+			continue;
+		mark_time[i] = unwrap_time(ref, mark->time_us);
+		if (!have_time || mark_time[i] < first)
+			first = mark_time[i];
+		if (!have_time || mark_time[i] > last)
+			last = mark_time[i];
+		have_time = 1;
+	}
+
+	printf("{\"traceEvents\":[");
+	for (tid = 0; tid < CHROME_TID_COUNT; tid++) {
+		snprintf(extra, sizeof(extra), ",\"args\":{\"name\":\"%s\"}",
+			 chrome_thread_name[tid]);
+		out_chrome_event("thread_name", "M", 0, tid, extra);
+	}
+
+	for (i = 0, mark = mark_list; i < mark_count; i++, mark++) {
+		if (!(mark->flags & TRACE_MARKF_ACCUM))
+			out_chrome_event(mark->name, "i", mark_time[i] - first,
+					 CHROME_TID_MARKS, ",\"s\":\"g\"");
+	}
+
+	for (i = 0, call = call_list; i < call_count; i++, call++) {
+		long long time = call_time[i] - first;
+		struct func_info *func;
+		int is_entry;
+
+		switch (TRACE_CALL_TYPE(call)) {
+		case FUNCF_EVENT: {
+			uint32_t event = call->func & ~TRACE_EVENT_END;
+
+			if (event >= TRACE_EVENT_COUNT) {
+				warn("Unknown event %#x\n", call->func);
+				continue;
+			}
+			tid = chrome_event[event].tid;
+			if (!(call->func & TRACE_EVENT_END)) {
+				out_chrome_event(chrome_event[event].name, "B",
+						 time, tid, NULL);
+				depth[tid]++;
+			} else if (depth[tid]) {
+				snprintf(extra, sizeof(extra),
+					 ",\"args\":{\"bytes\":%u}",
+					 call->caller);
+				out_chrome_event(chrome_event[event].name, "E",
+						 time, tid, extra);
+				depth[tid]--;
+			}
+			continue;
+		}
+		case FUNCF_ENTRY:
+		case FUNCF_EXIT:
+			break;
+		default:
+			continue;
+		}
+
+		func = find_func_by_offset(call->func);
+		if (!func) {
+			missing_count++;
+			continue;
+		}
+		if (!(func->flags & FUNCF_TRACE)) {
+			skip_count++;
+			continue;
+		}
+
+		/* Drop exits from calls made before tracing started */
+		tid = CHROME_TID_FUNCS;
+		is_entry = TRACE_CALL_TYPE(call) == FUNCF_ENTRY;
+		if (!is_entry && !depth[tid])
+			continue;
+		out_chrome_event(func->name, is_entry ? "B" : "E", time, tid,
+				 NULL);
+		depth[tid] += is_entry ? 1 : -1;
+	}
+
+	/* Close anything still open when the trace stopped */
+	for (tid = 0; tid < CHROME_TID_COUNT; tid++) {
+		for (; depth[tid]; depth[tid]--)
+			out_chrome_event("", "E", last - first, tid, NULL);
+	}
+
+	printf("\n],\n\"displayTimeUnit\":\"ms\",\n"
+	       "\"otherData\":{\"accumulated_us\":{");
+	for (i = 0, mark = mark_list; i < mark_count; i++, mark++) {
+		if (!(mark->flags & TRACE_MARKF_ACCUM))
+			continue;
+		printf("%s", accum_count++ ? "," : "");
+		out_json_string(mark->name);
+		printf(":%u", mark->time_us);
+	}
+	printf("}}}\n");
+	info("chrome: %d functions not found, %d excluded\n", missing_count,
+	     skip_count);
+	free(call_time);
+	free(mark_time);
+
+	return 0;
+}
+
 static int prof_tool(int argc, char * const argv[],
 		     const char *prof_fname, const char *map_fname,
 		     const char *trace_config_fname)
@@ -551,6 +803,8 @@ static int prof_tool(int argc, char * const argv[],
 
 		if (0 == strcmp(cmd, "dump-ftrace"))
 			err = make_ftrace();
+		else if (0 == strcmp(cmd, "dump-chrome"))
+			err = make_chrome();
 		else
 			warn("Unknown command '%s'\n", cmd);
 	}